@@ -5,6 +5,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Info.h"
+#include "Utils/SLImageWriter.h"
 #include "SLCVScanner.generated.h"
 
 // Forward declarations
@@ -183,8 +184,8 @@ private:
 	// Print progress to terminal
 	void PrintProgress() const;
 
-	// Save image to file
-	void SaveToFile(const TArray<uint8>& CompressedBitmap) const;
+	// Get the file paths of the current image
+	TArray<FString> GetImageFilePaths() const;
 
 protected:
 	// Skip auto init and start
@@ -255,6 +256,10 @@ protected:
 	UPROPERTY(EditAnywhere, Category = "Semantic Logger|Image")
 	FColor CustomBackgroundColor = FColor::Black;
 
+	// Compression format of the saved images
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger|Image")
+	ESLImageCodec ImageCodec = ESLImageCodec::PNG;
+
 	// If true, instead of rendereing the backgorund, replace the black pixels with the value
 	UPROPERTY(EditAnywhere, Category = "Semantic Logger|Image")
 	uint8 bReplaceBackgroundPixels : 1;
@@ -351,6 +356,9 @@ protected:
 	AStaticMeshActor* BackgroundSMA;
 
 private:
+	// Compresses and saves the images in the background
+	FSLImageWriter ImageWriter;
+
 	// Camera poses on the unit sphere (this will be multiplied with each scenes bounds spehre radius)
 	TArray<FTransform> CameraScanUnitPoses;
 
@@ -0,0 +1,125 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "HAL/ThreadSafeBool.h"
+#include "Containers/Queue.h"
+#include "Owl/SLOwlNode.h"
+
+// Forward declarations
+class FRunnableThread;
+class FEvent;
+
+/**
+ * Finished event data needed to write the experiment owl and the timelines
+ */
+struct FSLEventJournalRecord
+{
+	// Event id
+	FString Id;
+
+	// Owl individuals of the event (written with one indentation step)
+	FString OwlStr;
+
+	// True if the event is included in the timelines
+	bool bInTimeline = false;
+
+	// Timeline row context
+	FString Context;
+
+	// Timeline row tooltip
+	FString Tooltip;
+
+	// Event start time
+	float StartTime = 0.f;
+
+	// Event end time
+	float EndTime = 0.f;
+
+	// Read or write the record
+	friend FArchive& operator<<(FArchive& Ar, FSLEventJournalRecord& Record)
+	{
+		Ar << Record.Id << Record.OwlStr << Record.bInTimeline << Record.Context << Record.Tooltip
+			<< Record.StartTime << Record.EndTime;
+		return Ar;
+	}
+};
+
+/**
+ * Appends the finished events to a journal file on a worker thread (flushed to disk periodically),
+ * the records are size prefixed, after a crash the journal can be read up to the last complete record
+ */
+class FSLEventJournal : public FRunnable
+{
+public:
+	// Ctor
+	FSLEventJournal();
+
+	// Dtor
+	virtual ~FSLEventJournal();
+
+	// Create the journal file and start the writer thread
+	bool Open(const FString& InPath, float InFlushInterval = 1.f);
+
+	// Queue the event for writing (game thread), the owl nodes are converted to text on the writer thread
+	void Append(FSLEventJournalRecord&& Record, TArray<FSLOwlNode>&& OwlNodes);
+
+	// Write the queued events, flush and close the file
+	void Close();
+
+	// True if the writer thread is running
+	bool IsOpen() const { return Thread != nullptr; };
+
+	// Path of the journal file
+	const FString& GetPath() const { return Path; };
+
+	// Number of appended records
+	int32 Num() const { return NumRecords; };
+
+	// Read the records in order, stops at the first incomplete record (returns the number of read records)
+	static int32 ForEachRecord(const FString& InPath, TFunctionRef<void(FSLEventJournalRecord&)> Visitor);
+
+	/* Begin FRunnable interface */
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+	/* End FRunnable interface */
+
+private:
+	// Convert and write the queued events (writer thread)
+	void WritePending();
+
+private:
+	// Event waiting to be written
+	struct FSLEventJournalPending
+	{
+		FSLEventJournalRecord Record;
+		TArray<FSLOwlNode> OwlNodes;
+	};
+
+	// Writer thread
+	FRunnableThread* Thread;
+
+	// Events written by the game thread and read by the writer
+	TQueue<FSLEventJournalPending, EQueueMode::Spsc> Pending;
+
+	// Wakes the writer when the journal is closed
+	FEvent* WakeEvent;
+
+	// Set from the game thread to stop the writer
+	FThreadSafeBool bStopRequested;
+
+	// Journal file (used by the writer thread only)
+	TUniquePtr<FArchive> Writer;
+
+	// Path of the journal file
+	FString Path;
+
+	// Seconds between flushing the journal to disk
+	float FlushInterval;
+
+	// Number of appended records
+	int32 NumRecords;
+};
@@ -63,6 +63,28 @@ struct FSLGoogleCharts
 			return false;
 		}
 
+		FString TimelineStr = GetTimelineHeader(Params);
+
+		// Add event times
+		for (const auto& Ev : InEvents)
+		{
+			if (!ShouldEventBeWritten(Ev, Params.EventsSelection))
+			{
+				continue;
+			}
+			TimelineStr.Append(GetTimelineRow(Ev->Context(), Ev->Id, Ev->StartTime, Ev->EndTime,
+				Params.bTooltips ? Ev->Tooltip() : FString(), Params));
+		}
+
+		TimelineStr.Append(GetTimelineFooter(Params));
+
+		// Write map to file
+		return FFileHelper::SaveStringToFile(TimelineStr, *FullFilePath);
+	}
+
+	// Timeline boilerplate and the episode duration row (the event rows can be streamed after it)
+	static FString GetTimelineHeader(const FSLGoogleChartsParameters& Params)
+	{
 		// Timeline boilerplate 
 		FString TimelineStr =
 			"<script type=\"text/javascript\" src=\"https://www.gstatic.com/charts/loader.js\"></script>\n"
@@ -95,8 +117,6 @@ struct FSLGoogleCharts
 		// Add episode duration
 		if (Params.StartTime >= 0 && Params.EndTime > 0)
 		{
-			const FString StartStr = FString::Printf(TEXT("%.3f"), Params.StartTime); 
-			const FString EndStr = FString::Printf(TEXT("%.3f"), Params.EndTime); 
 			const FString StartMsStr = FString::Printf(TEXT("%.3f"), Params.StartTime * 1000.f); //FString::SanitizeFloat(Ev->Start * 1000.f);
 			const FString EndMsStr = FString::Printf(TEXT("%.3f"), Params.EndTime * 1000.f);  //FString::SanitizeFloat(Ev->End * 1000.f);
 			
@@ -107,33 +127,35 @@ struct FSLGoogleCharts
 			}
 			TimelineStr.Append(StartMsStr + " , " + EndMsStr + " ],\n");  // google charts needs millisecods
 		}
+		return TimelineStr;
+	}
 
-		// Add event times
-		for (const auto& Ev : InEvents)
-		{
-			if (!ShouldEventBeWritten(Ev, Params.EventsSelection))
-			{
-				continue;
-			}
-
-			const FString StartStr = FString::Printf(TEXT("%.3f"), Ev->StartTime); //FString::SanitizeFloat(Ev->Start);
-			const FString EndStr = FString::Printf(TEXT("%.3f"), Ev->EndTime); //FString::SanitizeFloat(Ev->End);
-			const FString StartMsStr = FString::Printf(TEXT("%.3f"), Ev->StartTime * 1000.f); //FString::SanitizeFloat(Ev->Start * 1000.f);
-			const FString EndMsStr = FString::Printf(TEXT("%.3f"), Ev->EndTime * 1000.f);  //FString::SanitizeFloat(Ev->End * 1000.f);
+	// Timeline row of an event
+	static FString GetTimelineRow(const FString& Context, const FString& Id, float StartTime, float EndTime,
+		const FString& Tooltip, const FSLGoogleChartsParameters& Params)
+	{
+		const FString StartStr = FString::Printf(TEXT("%.3f"), StartTime); //FString::SanitizeFloat(Ev->Start);
+		const FString EndStr = FString::Printf(TEXT("%.3f"), EndTime); //FString::SanitizeFloat(Ev->End);
+		const FString StartMsStr = FString::Printf(TEXT("%.3f"), StartTime * 1000.f); //FString::SanitizeFloat(Ev->Start * 1000.f);
+		const FString EndMsStr = FString::Printf(TEXT("%.3f"), EndTime * 1000.f);  //FString::SanitizeFloat(Ev->End * 1000.f);
 
-			TimelineStr.Append("\t\t [ \'" + Ev->Context() + "\' , \'" + Ev->Id + "\' , " );
-			if (Params.bTooltips)
-			{
-				TimelineStr.Append(
-					"createTooltipHTMLContent("
-					+ StartStr + ", "
-					+ EndStr + ", "
-					+ Ev->Tooltip() + "), " );
-			}
-			TimelineStr.Append(StartMsStr + " , " + EndMsStr + " ],\n");  // google charts needs millisecods
+		FString RowStr = "\t\t [ \'" + Context + "\' , \'" + Id + "\' , ";
+		if (Params.bTooltips)
+		{
+			RowStr.Append(
+				"createTooltipHTMLContent("
+				+ StartStr + ", "
+				+ EndStr + ", "
+				+ Tooltip + "), " );
 		}
+		RowStr.Append(StartMsStr + " , " + EndMsStr + " ],\n");  // google charts needs millisecods
+		return RowStr;
+	}
 
-		TimelineStr.Append(
+	// Timeline closing part (chart options, tooltip functions, legend)
+	static FString GetTimelineFooter(const FSLGoogleChartsParameters& Params)
+	{
+		FString TimelineStr =
 			"\n"
 			"\t\t]);\n"
 			"\n"
@@ -143,7 +165,7 @@ struct FSLGoogleCharts
 			"\t\t\t tooltip: {isHtml: true}\n"
 			"\t\t };\n"
 			"\t\t chart.draw(dataTable, options);\n"
-			"\t }\n");
+			"\t }\n";
 
 		if (Params.bTooltips)
 		{
@@ -178,22 +200,9 @@ struct FSLGoogleCharts
 
 		if (Params.bLegend)
 		{
-			TimelineStr.Append(FSLGoogleCharts::GetLengend(InEvents));
+			TimelineStr.Append(FSLGoogleCharts::GetLengend(TArray<TSharedPtr<ISLEvent>>()));
 		}
-
-		// Write map to file
-		return FFileHelper::SaveStringToFile(TimelineStr, *FullFilePath);
-	}
-
-private:
-
-	// Table showing the legend of the symbols
-	static FString GetLengend(const TArray<TSharedPtr<ISLEvent>>& InEvents)
-	{
-		FString Legend =
-			"\n"
-			"\n";
-		return Legend;
+		return TimelineStr;
 	}
 
 	// Should the event be written
@@ -290,4 +299,14 @@ private:
 		//UE_LOG(LogTemp, Error, TEXT("%s::%d Unknown event %s.."), *FString(__FUNCTION__), __LINE__, *Event.Get()->ToString());
 		//return false;
 	}
+
+private:
+	// Table showing the legend of the symbols
+	static FString GetLengend(const TArray<TSharedPtr<ISLEvent>>& InEvents)
+	{
+		FString Legend =
+			"\n"
+			"\n";
+		return Legend;
+	}
 };
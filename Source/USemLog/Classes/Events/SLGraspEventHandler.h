@@ -5,6 +5,7 @@
 
 #include "Events/ISLEventHandler.h"
 #include "Events/SLGraspEvent.h"
+#include "Events/SLInFlightEventStore.h"
 
 /**
  * Listens to grasp events input, and outputs finished semantic grasp events
@@ -26,7 +27,7 @@ private:
 	void AddNewEvent(USLBaseIndividual* Self, USLBaseIndividual* Other, float StartTime, const FString& Type);
 
 	// Finish then publish the event
-	bool FinishEvent(USLBaseIndividual* Other, float EndTime);
+	bool FinishEvent(const uint64 InPairId, float EndTime);
 
 	// Terminate and publish started events (this usually is called at end play)
 	void FinishAllEvents(float EndTime);
@@ -41,8 +42,8 @@ private:
 	// Parent
 	class USLManipulatorMonitor* Parent;
 
-	// Array of started events
-	TArray<TSharedPtr<FSLGraspEvent>> StartedEvents;
+	// Started events
+	TSLInFlightEventStore<FSLGraspEvent> StartedEvents;
 	
 	/* Constant values */
 	constexpr static float GraspEventMin = 0.25f;
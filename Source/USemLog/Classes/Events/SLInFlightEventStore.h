@@ -0,0 +1,237 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Started (not yet finished) events of one type, indexed by their pair id in an open addressing hash table,
+ * events of the same pair are finished in their start order, events which are not kept by anyone after
+ * they finish are reused for the next started events
+ */
+template<typename EventType>
+class TSLInFlightEventStore
+{
+public:
+	// Ctor
+	TSLInFlightEventStore() : FreeEntryIdx(INDEX_NONE), NumEvents(0), NumAllocated(0), NumReused(0) {};
+
+	// Get an event to start (reused if available), the id is empty, it is only set for the published events
+	TSharedPtr<EventType> Acquire()
+	{
+		if (FreeEvents.Num() > 0)
+		{
+			NumReused++;
+			TSharedPtr<EventType> Event = FreeEvents.Pop(false);
+			Event->Id.Empty();
+			return Event;
+		}
+		NumAllocated++;
+		return MakeShareable(new EventType());
+	}
+
+	// Give back a finished event, it is only reused if nobody else references it (e.g. it was not published)
+	void Release(TSharedPtr<EventType>&& Event)
+	{
+		if (Event.IsValid() && Event.IsUnique() && FreeEvents.Num() < MaxNumFreeEvents)
+		{
+			FreeEvents.Emplace(MoveTemp(Event));
+		}
+		Event.Reset();
+	}
+
+	// Add the started event of the pair
+	void Add(uint64 PairId, const TSharedPtr<EventType>& Event)
+	{
+		// Get a free entry
+		int32 EntryIdx = FreeEntryIdx;
+		if (EntryIdx != INDEX_NONE)
+		{
+			FreeEntryIdx = Entries[EntryIdx].Next;
+		}
+		else
+		{
+			EntryIdx = Entries.AddDefaulted();
+		}
+		FEntry& Entry = Entries[EntryIdx];
+		Entry.PairId = PairId;
+		Entry.Event = Event;
+		Entry.Next = INDEX_NONE;
+		NumEvents++;
+
+		if (NumEvents * 2 > Slots.Num())
+		{
+			Rehash(FMath::Max(MinNumSlots, Slots.Num() * 2));
+		}
+
+		// Append to the events of the same pair, or take a new slot
+		int32 SlotIdx = FindSlot(PairId);
+		if (Slots[SlotIdx] != INDEX_NONE)
+		{
+			int32 TailIdx = Slots[SlotIdx];
+			while (Entries[TailIdx].Next != INDEX_NONE)
+			{
+				TailIdx = Entries[TailIdx].Next;
+			}
+			Entries[TailIdx].Next = EntryIdx;
+		}
+		else
+		{
+			Slots[SlotIdx] = EntryIdx;
+		}
+	}
+
+	// Remove and return the first started event of the pair (invalid if none)
+	TSharedPtr<EventType> Remove(uint64 PairId)
+	{
+		if (NumEvents == 0)
+		{
+			return nullptr;
+		}
+
+		const int32 SlotIdx = FindSlot(PairId);
+		const int32 EntryIdx = Slots[SlotIdx];
+		if (EntryIdx == INDEX_NONE)
+		{
+			return nullptr;
+		}
+
+		FEntry& Entry = Entries[EntryIdx];
+		if (Entry.Next != INDEX_NONE)
+		{
+			// The next event of the pair takes the slot
+			Slots[SlotIdx] = Entry.Next;
+		}
+		else
+		{
+			RemoveSlot(SlotIdx);
+		}
+
+		TSharedPtr<EventType> Event = MoveTemp(Entry.Event);
+		Entry.Event.Reset();
+		Entry.Next = FreeEntryIdx;
+		FreeEntryIdx = EntryIdx;
+		NumEvents--;
+		return Event;
+	}
+
+	// Remove all the started events and pass them to the function
+	template<typename FuncType>
+	void RemoveAll(FuncType Func)
+	{
+		for (FEntry& Entry : Entries)
+		{
+			if (Entry.Event.IsValid())
+			{
+				Func(MoveTemp(Entry.Event));
+				Entry.Event.Reset();
+			}
+		}
+		Entries.Reset();
+		for (int32& Slot : Slots)
+		{
+			Slot = INDEX_NONE;
+		}
+		FreeEntryIdx = INDEX_NONE;
+		NumEvents = 0;
+	}
+
+	// Number of started events
+	int32 Num() const { return NumEvents; };
+
+	// Number of events created
+	int32 GetNumAllocated() const { return NumAllocated; };
+
+	// Number of events reused
+	int32 GetNumReused() const { return NumReused; };
+
+private:
+	// Started event, chained with the next started event of the same pair
+	struct FEntry
+	{
+		uint64 PairId = 0;
+		TSharedPtr<EventType> Event;
+		int32 Next = INDEX_NONE;
+	};
+
+	// Spread the pair ids over the table (cantor pairs of close unique ids are close as well)
+	static uint32 HashPairId(uint64 PairId)
+	{
+		PairId ^= PairId >> 33;
+		PairId *= 0xff51afd7ed558ccdULL;
+		PairId ^= PairId >> 33;
+		PairId *= 0xc4ceb9fe1a85ec53ULL;
+		PairId ^= PairId >> 33;
+		return static_cast<uint32>(PairId);
+	}
+
+	// Slot of the pair, or the empty slot where it should be added
+	int32 FindSlot(uint64 PairId) const
+	{
+		const int32 Mask = Slots.Num() - 1;
+		int32 SlotIdx = HashPairId(PairId) & Mask;
+		while (Slots[SlotIdx] != INDEX_NONE && Entries[Slots[SlotIdx]].PairId != PairId)
+		{
+			SlotIdx = (SlotIdx + 1) & Mask;
+		}
+		return SlotIdx;
+	}
+
+	// Empty the slot and shift back the following entries of the probe sequence (no tombstones)
+	void RemoveSlot(int32 SlotIdx)
+	{
+		const int32 Mask = Slots.Num() - 1;
+		int32 NextIdx = (SlotIdx + 1) & Mask;
+		while (Slots[NextIdx] != INDEX_NONE)
+		{
+			const int32 HomeIdx = HashPairId(Entries[Slots[NextIdx]].PairId) & Mask;
+			// Move if the home slot is not within (SlotIdx, NextIdx] (cyclically)
+			if (((NextIdx - HomeIdx) & Mask) >= ((NextIdx - SlotIdx) & Mask))
+			{
+				Slots[SlotIdx] = Slots[NextIdx];
+				SlotIdx = NextIdx;
+			}
+			NextIdx = (NextIdx + 1) & Mask;
+		}
+		Slots[SlotIdx] = INDEX_NONE;
+	}
+
+	// Resize the table and re-insert the pairs
+	void Rehash(int32 NewNumSlots)
+	{
+		TArray<int32> OldSlots = MoveTemp(Slots);
+		Slots.Init(INDEX_NONE, NewNumSlots);
+		for (const int32 EntryIdx : OldSlots)
+		{
+			if (EntryIdx != INDEX_NONE)
+			{
+				Slots[FindSlot(Entries[EntryIdx].PairId)] = EntryIdx;
+			}
+		}
+	}
+
+private:
+	// Started events (stable indexes, the removed ones are chained in a free list)
+	TArray<FEntry> Entries;
+
+	// Hash table of the first started event of each pair (power of two size, at most half full)
+	TArray<int32> Slots;
+
+	// First free entry
+	int32 FreeEntryIdx;
+
+	// Number of started events
+	int32 NumEvents;
+
+	// Finished events ready to be reused
+	TArray<TSharedPtr<EventType>> FreeEvents;
+
+	// Stats
+	int32 NumAllocated;
+	int32 NumReused;
+
+	/* Constants */
+	static constexpr int32 MinNumSlots = 16;
+	static constexpr int32 MaxNumFreeEvents = 1024;
+};
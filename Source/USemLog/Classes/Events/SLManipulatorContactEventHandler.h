@@ -5,6 +5,7 @@
 
 #include "Events/ISLEventHandler.h"
 #include "Events/SLContactEvent.h"
+#include "Events/SLInFlightEventStore.h"
 #include "TimerManager.h"
 
 // Forward declarations
@@ -32,7 +33,7 @@ private:
 	void AddNewEvent(const FSLContactResult& InResult);
 
 	// Finish then publish the event
-	bool FinishEvent(USLBaseIndividual* InOther, float EndTime);
+	bool FinishEvent(const uint64 InPairId, float EndTime);
 
 	// Terminate and publish started events (this usually is called at end play)
 	void FinishAllEvents(float EndTime);
@@ -47,6 +48,6 @@ private:
 	// Parent semantic overlap area
 	class USLManipulatorMonitor* Parent = nullptr;
 
-	// Array of started contact events
-	TArray<TSharedPtr<FSLContactEvent>> StartedEvents;
+	// Started contact events
+	TSLInFlightEventStore<FSLContactEvent> StartedEvents;
 };
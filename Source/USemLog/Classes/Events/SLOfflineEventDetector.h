@@ -0,0 +1,164 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "Events/ISLEventHandler.h"
+#include "Runtime/SLLoggerStructs.h"
+
+// Forward declarations
+class USLBaseIndividual;
+class FSLContactEvent;
+class FSLSupportedByEvent;
+class FSLMongoEpisodeStreamer;
+
+/**
+ * Re-detects the contact and supported by events from a logged world state (no physics or rendering needed),
+ * the episode frames are streamed from the database and replayed through geometric equivalents of the contact monitors
+ * (oriented bounding box overlaps, relative vertical speed), as fast as the frames can be read;
+ * the manipulator, pick-and-place and container events are not re-detected (reduced scope, the logged bone and constraint
+ * individual poses are not used yet)
+ */
+class FSLOfflineEventDetector : public ISLEventHandler
+{
+public:
+	// Ctor
+	FSLOfflineEventDetector(const FSLOfflineEventParams& InParams, bool bInDetectSupportedBy = true);
+
+	// Dtor
+	virtual ~FSLOfflineEventDetector();
+
+	// Init parent (individual manager)
+	void Init(UObject* InParent) override;
+
+	// Start streaming the world state of the episode from the database
+	void Start() override;
+
+	// Terminate the replay, finish and publish remaining events
+	void Finish(float EndTime, bool bForced = false) override;
+
+	// Replay the available frames within the time budget (ms, 0 for no limit), returns false when the replay is done
+	bool ReplayQueuedFrames(float BudgetMs);
+
+	// Update the individual poses and the events with the world state frame (only the changed poses are required)
+	void ReplayFrame(float Ts, const TMap<FString, FTransform>& Poses);
+
+	// True if all the frames have been replayed
+	bool IsReplayFinished() const;
+
+	// Timestamp of the first replayed frame
+	float GetFirstFrameTime() const { return FirstFrameTs; };
+
+	// Timestamp of the last replayed frame
+	float GetLastFrameTime() const { return LastFrameTs; };
+
+	// Task (database) and episode (collection) to replay
+	FString TaskId;
+
+private:
+	// Individual replayed as an oriented box
+	struct FBody
+	{
+		// Replayed individual
+		USLBaseIndividual* Individual = nullptr;
+
+		// Center of the bounds in the local frame (scaled)
+		FVector LocalCenter = FVector::ZeroVector;
+
+		// Half size of the bounds (scaled, includes the contact tolerance)
+		FVector LocalExtent = FVector::ZeroVector;
+
+		// Current pose
+		FTransform Pose = FTransform::Identity;
+
+		// World bounds of the oriented box
+		FBox WorldBox = FBox(ForceInit);
+
+		// Vertical speed from the last pose update
+		float VertSpeed = 0.f;
+
+		// Time of the last pose update
+		float LastMoveTs = -1.f;
+
+		// True if the individual has a contact monitor (otherwise it can only be contacted or support)
+		bool bMonitored = false;
+	};
+
+	// Contact between two bodies
+	struct FContact
+	{
+		// Monitored body
+		int32 SelfIdx = INDEX_NONE;
+
+		// Other body
+		int32 OtherIdx = INDEX_NONE;
+
+		// Started contact event
+		TSharedPtr<FSLContactEvent> ContactEvent;
+
+		// Started supported by event
+		TSharedPtr<FSLSupportedByEvent> SupportedByEvent;
+
+		// Time when the overlap ended (negative while overlapping), kept for concatenating jittering contacts
+		float EndTs = -1.f;
+	};
+
+	// Create the bodies from the rigid individuals of the world
+	void InitBodies(class ASLIndividualManager* IndividualManager);
+
+	// Set the world bounds of the body from its current pose
+	void UpdateWorldBox(FBody& Body) const;
+
+	// Check the overlaps of the bodies (sort and sweep, then oriented box test), X is the monitored body index
+	void FindOverlaps(TArray<FIntPoint>& OutPairs);
+
+	// Start new contacts, resume or mark the ended ones from the current overlaps
+	void UpdateContacts(float Ts, const TArray<FIntPoint>& Pairs);
+
+	// Publish the contacts which ended longer than the concatenation time ago
+	void FinishEndedContacts(float Ts);
+
+	// Start the supported by events of the stable contacts
+	void UpdateSupportedBy(float Ts);
+
+	// Publish the contact and its supported by event
+	void FinishContact(FContact& Contact, float EndTs);
+
+	// Key of the two bodies
+	static uint64 GetPairKey(int32 IdxA, int32 IdxB);
+
+	// True if the oriented boxes overlap (separating axis test)
+	static bool OrientedBoxesOverlap(const FBody& A, const FBody& B);
+
+private:
+	// Detection parameters
+	FSLOfflineEventParams Params;
+
+	// Publish supported by events
+	bool bDetectSupportedBy;
+
+	// Streams the world state frames
+	TSharedPtr<FSLMongoEpisodeStreamer> Streamer;
+
+	// Replayed individuals
+	TArray<FBody> Bodies;
+
+	// Id to body index
+	TMap<FString, int32> BodyIndexes;
+
+	// Body indexes sorted by the min x of their bounds (kept between frames, nearly sorted for coherent motion)
+	TArray<int32> SweepOrder;
+
+	// Current contacts
+	TMap<uint64, FContact> Contacts;
+
+	// True if poses changed since the last overlap check
+	bool bPosesDirty;
+
+	// Replay stats
+	float FirstFrameTs;
+	float LastFrameTs;
+	int32 NumFrames;
+	int32 NumPublished;
+	double ReplayExecTime;
+};
@@ -82,6 +82,9 @@ public:
 	// Get the cached transform of the individual
 	FTransform GetCachedPose() const { return CachedPose; };
 
+	// Cache an externally calculated transform (e.g. batched bone poses), returns true on a new value
+	bool SetCachedPose(const FTransform& NewPose, float Tolerance);
+
 	// Get actor represented by the individual
 	AActor* GetParentActor() const { return ParentActor; };
 
@@ -78,6 +78,10 @@ public:
     // Search and return the bone (virtual or non-virtual) with the given index as a base individual (nullptr if not found)
     USLBaseIndividual* GetBoneIndividual(int32 Index) const;
 
+    // Cache the poses of all the bones (first the visible then the virtual ones) from a single read of the component space
+    // transforms, a bit is appended for every bone (true if moved), returns the number of moved bones
+    int32 UpdateCachedBonePoses(float Tolerance, TBitArray<>& OutMovedBones);
+
     // Get the type name as string
     virtual FString GetTypeName() const override { return FString("SkeletalIndividual"); };
 
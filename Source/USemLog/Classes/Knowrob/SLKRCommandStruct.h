@@ -0,0 +1,70 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Viz/SLVizStructs.h"
+
+// Function requested by knowrob
+enum class ESLKRCommandType : uint8
+{
+	None,
+	SetTask,
+	SetEpisode,
+	DrawMarkerAt,
+	DrawMarkerTraj,
+	LoadLevel,
+	StartSimulation,
+	StopSimulation,
+	StartLogging,
+	StopLogging,
+	GetEpisodeData,
+	SetIndividualPose,
+	ApplyForceTo,
+	Highlight,
+	RemoveHighlight,
+	RemoveAllHighlight
+};
+
+// Decoded and converted knowrob message, ready to be executed on the game thread
+struct FSLKRCommand
+{
+	// Function to call
+	ESLKRCommandType Type = ESLKRCommandType::None;
+
+	// Individual, task or level id
+	FString Id;
+
+	// Episode id
+	FString EpisodeId;
+
+	// Individual ids (simulation selection)
+	TArray<FString> Ids;
+
+	// Marker type
+	ESLVizPrimitiveMarkerType MarkerType = ESLVizPrimitiveMarkerType::NONE;
+
+	// Marker material type
+	ESLVizMaterialType MaterialType = ESLVizMaterialType::NONE;
+
+	// Marker or highlight color
+	FLinearColor Color = FLinearColor::White;
+
+	// Marker scale
+	float Scale = 1.f;
+
+	// Timestamp, or the start of the time interval
+	float Start = 0.f;
+
+	// End of the time interval
+	float End = 0.f;
+
+	// Simulation duration
+	int32 Duration = 0;
+
+	// Location or force
+	FVector Vector = FVector::ZeroVector;
+
+	// Rotation
+	FQuat Quat = FQuat::Identity;
+};
@@ -0,0 +1,81 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+
+#pragma once
+
+#include <string>
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "HAL/ThreadSafeBool.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "Containers/Queue.h"
+#include "Knowrob/SLKRCommandStruct.h"
+
+// Forward declarations
+class FRunnableThread;
+class FEvent;
+
+// Triggered on the game thread when new commands are decoded
+DECLARE_DELEGATE(FSLKRMsgDecoderNewCommands);
+
+/**
+ * Parses the knowrob protobuf messages on a worker thread, in the order they were received,
+ * only the decoded commands are queued for the game thread
+ */
+class FSLKRMsgDecoder : public FRunnable
+{
+public:
+	// Ctor
+	FSLKRMsgDecoder();
+
+	// Dtor
+	virtual ~FSLKRMsgDecoder();
+
+	// Start the decoder thread
+	bool Start();
+
+	// Stop the decoder thread, the queued messages are dropped
+	void Close();
+
+	// True if the decoder thread is running
+	bool IsRunning() const { return Thread != nullptr; };
+
+	// Queue the message for decoding (game thread)
+	void Enqueue(std::string&& ProtoStr);
+
+	// Get the next decoded command (game thread)
+	bool Dequeue(FSLKRCommand& OutCommand);
+
+	// Number of messages which could not be decoded
+	int32 GetNumInvalid() const { return NumInvalid.GetValue(); };
+
+	/* Begin FRunnable interface */
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+	/* End FRunnable interface */
+
+public:
+	// Triggered on the game thread when new commands are decoded
+	FSLKRMsgDecoderNewCommands OnNewCommands;
+
+private:
+	// Decoder thread
+	FRunnableThread* Thread;
+
+	// Wakes the decoder when new messages are queued
+	FEvent* WakeEvent;
+
+	// Set from the game thread to stop the decoder
+	FThreadSafeBool bStopRequested;
+
+	// Checked by the game thread tasks before calling into the decoder
+	TSharedRef<FThreadSafeBool, ESPMode::ThreadSafe> bIsAlive;
+
+	// Received messages (written by the game thread, read by the decoder)
+	TQueue<std::string, EQueueMode::Spsc> Messages;
+
+	// Decoded commands (written by the decoder, read by the game thread)
+	TQueue<FSLKRCommand, EQueueMode::Spsc> Commands;
+
+	// Number of messages which could not be decoded
+	FThreadSafeCounter NumInvalid;
+};
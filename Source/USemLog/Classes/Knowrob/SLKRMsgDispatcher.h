@@ -9,6 +9,7 @@
 #include "Runtime/SLLoggerStructs.h"
 #include "Knowrob/SLKRWSClient.h"
 #include "SLKRResponseStruct.h"
+#include "SLKRCommandStruct.h"
 #include "CoreMinimal.h"
 
 // Forward declarations
@@ -19,9 +20,6 @@ class ASLLevelManager;
 class ASLSymbolicLogger;
 class ASLWorldStateLogger;
 
-enum class ESLVizPrimitiveMarkerType : uint8;
-enum class ESLVizMaterialType : uint8;
-
 /**
  * 
  */
@@ -48,66 +46,72 @@ public:
 
 public:
 	// Parse the proto sequence and trigger function
-	void ProcessProtobuf(std::string ProtoStr);
+	void ProcessProtobuf(const std::string& ProtoStr);
+
+	// Parse the proto sequence and convert its parameters, thread safe (false if the message is not valid)
+	static bool DecodeCommand(const std::string& ProtoStr, FSLKRCommand& OutCommand);
+
+	// Call the function of the decoded command (game thread)
+	void ExecuteCommand(FSLKRCommand& Command);
 
 private:
-#if SL_WITH_PROTO
 	// Load the level 
-	void LoadLevel(sl_pb::LoadLevelParams params);
+	void LoadLevel(const FSLKRCommand& Command);
 
 	// Set the task of MongoManager
-	void SetTask(sl_pb::SetTaskParams params);
+	void SetTask(const FSLKRCommand& Command);
 
 	// Set the episode of MongoManager
-	void SetEpisode(sl_pb::SetEpisodeParams params);
+	void SetEpisode(const FSLKRCommand& Command);
 	
 	// Draw the individual marker
-	void DrawMarker(sl_pb::DrawMarkerAtParams);
+	void DrawMarker(const FSLKRCommand& Command);
 
 	// Draw the individual trajectory
-	void DrawMarkerTraj(sl_pb::DrawMarkerTrajParams params);
+	void DrawMarkerTraj(const FSLKRCommand& Command);
 
 	// Hightlight the individual
-	void HighlightIndividual(sl_pb::HighlightParams params);
+	void HighlightIndividual(const FSLKRCommand& Command);
 
 	// Remove the individual hightlight
-	void RemoveIndividualHighlight(sl_pb::RemoveHighlightParams params);
+	void RemoveIndividualHighlight(const FSLKRCommand& Command);
 
 	// Hightlight the individual
 	void RemoveAllIndividualHighlight();
 
 	// Start Symbolic and World State Logger
-	void StartLogging(sl_pb::StartLoggingParams params);
+	void StartLogging(const FSLKRCommand& Command);
 
 	// Stop Symbolic and World Logger
 	void StopLogging();
 
 	// Send the Episode data
-	void SendEpisodeData(sl_pb::GetEpisodeDataParams params);
+	void SendEpisodeData(const FSLKRCommand& Command);
 
 	// Start Simulation
-	void StartSimulation(sl_pb::StartSimulationParams params);
+	void StartSimulation(const FSLKRCommand& Command);
 
 	// Stop Simulation
-	void StopSimulation(sl_pb::StopSimulationParams params);
+	void StopSimulation(const FSLKRCommand& Command);
 
 	// Set the pose of the idividual
-	void SetIndividualPose(sl_pb::SetIndividualPoseParams params);
+	void SetIndividualPose(const FSLKRCommand& Command);
 	
 	// Apply force to individual
-	void ApplyForceTo(sl_pb::ApplyForceToParams params);
+	void ApplyForceTo(const FSLKRCommand& Command);
 
 private:
 	// -----  helper function  ------//
+#if SL_WITH_PROTO
 	// Transform the maker type
-	ESLVizPrimitiveMarkerType GetMarkerType(sl_pb::MarkerType Marker);
+	static ESLVizPrimitiveMarkerType GetMarkerType(sl_pb::MarkerType Marker);
 #endif // SL_WITH_PROTO	
 
 	// Transform the string to color
-	FLinearColor GetMarkerColor(const FString& Color);
+	static FLinearColor GetMarkerColor(const FString& Color);
 
 	// Transform the material type
-	ESLVizMaterialType GetMarkerMaterialType(const FString& MaterialType);
+	static ESLVizMaterialType GetMarkerMaterialType(const FString& MaterialType);
 
 	// Send response when simulation start
 	void SimulationStartResponse();
@@ -6,6 +6,8 @@
 #include "CoreMinimal.h"
 #include "IWebSocket.h"
 #include "Containers/Queue.h"
+#include "HAL/ThreadSafeBool.h"
+#include "HAL/ThreadSafeCounter.h"
 #include "SLKRResponseStruct.h"
 #include <string>
 
@@ -15,8 +17,27 @@ DECLARE_DELEGATE(FSLKRWSClientNewMsg);
 // Triggered when connected / disconnected
 DECLARE_DELEGATE_OneParam(FSLKRWSClientConnection, bool /*bConnected*/);
 
+/**
+ * Serialized messages prepared on a worker thread, sent from the game thread
+ */
+struct FSLKRWSOutgoingFrames
+{
+	// Serialized messages in sending order
+	TQueue<std::string, EQueueMode::Spsc> Frames;
+
+	// Number of queued messages (the worker waits if there are too many)
+	FThreadSafeCounter NumQueued;
+
+	// Unset when the client is destroyed, the workers stop and their messages are dropped
+	FThreadSafeBool bIsAlive = true;
+};
+
 /**
  * Knowrob websocket client communication
+ * Files are sent in order, one at a time, as:
+ *	FileCreation:	file name, file size (dataLength), "zlib" (text) if the chunks can be compressed
+ *	FileData:		chunk bytes, uncompressed chunk size (dataLength), the chunk is compressed if it has fewer bytes
+ *	FileFinish:		file name, file size (dataLength), "crc32:<hex>" (text) checksum of the uncompressed file
  */
 class USEMLOG_API FSLKRWSClient
 {
@@ -42,9 +63,18 @@ public:
 	// Clear the webscosket 
 	void Clear();
 
-	// Send message via websocket
+	// Send message via websocket (file responses are sent in the background)
 	void SendResponse(const FSLKRResponse& Response);
 
+	// Set the file transfer parameters (chunk size in bytes, compress the chunks with zlib)
+	void SetFileTransferParams(int32 InChunkSize, bool bInCompressChunks);
+
+	// Read and send the file in chunks from a worker thread
+	void SendFileAsync(const FString& FileName, const FString& FilePath);
+
+	// True if any file is being sent or waiting to be sent
+	bool IsSendingFiles() const { return bIsSendingFile || PendingFileTransfers.Num() > 0; };
+
 protected:
 	/* IWebSocket delegate handlers */
 	// Called on connection
@@ -62,6 +92,25 @@ protected:
 	// Called when the full data has been received
 	void HandleWebSocketFullData(const uint8* Data, SIZE_T Length);
 
+private:
+	// File waiting to be sent (read from the path if the data is empty)
+	struct FSLKRFileTransfer
+	{
+		FString FileName;
+		FString FilePath;
+		TArray<uint8> FileData;
+	};
+
+	// Start sending the next file if none is being sent (game thread)
+	void StartNextFileTransfer();
+
+	// Read, slice, compress and serialize the file (worker thread)
+	static void PrepareFileFrames(FSLKRFileTransfer& Transfer, int32 ChunkSize, bool bCompress,
+		TSharedRef<FSLKRWSOutgoingFrames, ESPMode::ThreadSafe> Outgoing, TFunctionRef<void()> OnFrameQueued);
+
+	// Send the messages prepared by the workers (game thread)
+	void SendQueuedFrames();
+
 public:
 	// Triggered when a new processed message is added to the queue
 	FSLKRWSClientNewMsg OnNewProcessedMsg;
@@ -78,4 +127,19 @@ private:
 
 	// Received message binary
 	TArray<uint8> ReceiveBuffer;
+
+	// Files waiting to be sent
+	TArray<FSLKRFileTransfer> PendingFileTransfers;
+
+	// True while a file is being sent
+	bool bIsSendingFile;
+
+	// Size of the file chunks in bytes
+	int32 FileChunkSize;
+
+	// Compress the file chunks
+	bool bCompressFileChunks;
+
+	// Messages prepared by the file transfer worker
+	TSharedRef<FSLKRWSOutgoingFrames, ESPMode::ThreadSafe> OutgoingFrames;
 };
\ No newline at end of file
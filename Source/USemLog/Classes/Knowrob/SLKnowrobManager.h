@@ -8,6 +8,7 @@
 #include "Knowrob/SLLevelManager.h"
 #include "Knowrob/SLKRWSClient.h"
 #include "Knowrob/SLKRMsgDispatcher.h"
+#include "Knowrob/SLKRMsgDecoder.h"
 #include "Viz/SLVizStructs.h"
 #include "VizQ/SLVizQBase.h"
 #include "Runtime/SLLoggerStructs.h"
@@ -97,6 +98,9 @@ protected:
 	// Called when a new message is received from knowrob
 	void OnKRMsg();
 
+	// Called when new commands are decoded, executes them within the frame time budget
+	void OnKRCommands();
+
 private:
 	// Get the mongo query manager from the world (or spawn a new one)
 	bool SetMongoQueryManager();
@@ -170,6 +174,18 @@ private:
 	UPROPERTY(EditAnywhere, Category = "Semantic Logger", meta = (editcondition = "bKRConnectRetry"))
 	int32 KRConnectRetryMaxNum = INDEX_NONE;
 
+	// Size of the file chunks sent to knowrob (in KB)
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger", meta = (ClampMin = 1))
+	int32 KRFileChunkSizeKB = 256;
+
+	// Compress the file chunks sent to knowrob (zlib)
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger")
+	bool bKRCompressFileChunks = false;
+
+	// Max game thread time spent on executing knowrob commands per frame (ms), the rest continue next frame (0 = no limit)
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger", meta = (ClampMin = 0))
+	float KRCommandBudgetMs = 4.f;
+
 
 	// Mongo server ip addres
 	UPROPERTY(EditAnywhere, Category = "Semantic Logger")
@@ -196,6 +212,12 @@ private:
 	// Handle the protobuf message
 	TSharedPtr<SLKRMsgDispatcher> KRMsgDispatcher;
 
+	// Parses the protobuf messages on a worker thread
+	TSharedPtr<FSLKRMsgDecoder> KRMsgDecoder;
+
+	// True if the remaining commands are scheduled for the next frame
+	bool bKRCommandsScheduled;
+
 	/* Managers */
 	// Delegates mongo queries
 	UPROPERTY(VisibleAnywhere, Transient, Category = "Semantic Logger")
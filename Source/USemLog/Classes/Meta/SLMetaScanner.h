@@ -6,6 +6,7 @@
 #include "CoreMinimal.h"
 #include "SLMetaScannerStructs.h"
 #include "SLMetaScannerToolkit.h"
+#include "Utils/SLImageWriter.h"
 #include "SLMetaScanner.generated.h"
 
 // Forward declarations
@@ -110,8 +111,8 @@ private:
 	// Clean exit, all the Finish() methods will be triggered
 	void QuitEditor();
 
-	// Save the compressed screenshot image locally
-	void SaveImageLocally(const TArray<uint8>& CompressedBitmap);
+	// Get the path where to save the compressed screenshot image locally
+	FString GetLocalImagePath() const;
 
 	// Print progress
 	void PrintProgress() const;
@@ -143,6 +144,9 @@ private:
 	// Scanner image handler
 	FSLMetaScannerToolkit ScanToolkit;
 
+	// Compresses and saves the images in the background
+	FSLImageWriter ImageWriter;
+
 	// Contains the data of the current scan in a given camera pose
 	FSLScanPoseData ScanPoseData;
 
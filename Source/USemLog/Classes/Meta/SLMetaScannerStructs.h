@@ -4,6 +4,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Utils/SLImageWriter.h"
 
 /**
 * View modes
@@ -43,6 +44,9 @@ struct FSLMetaScannerParams
 	// Save the scanned images locally
 	bool bIncludeScansLocally;
 
+	// Compression format of the images
+	ESLImageCodec ImageCodec = ESLImageCodec::PNG;
+
 	// Default constructor
 	FSLMetaScannerParams() {};
 
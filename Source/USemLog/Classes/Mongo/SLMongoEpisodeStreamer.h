@@ -0,0 +1,81 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "HAL/ThreadSafeBool.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "Containers/Queue.h"
+
+// Forward declarations
+class FRunnableThread;
+
+/**
+ * Streams the episode frames from the database on a worker thread (using its own connection),
+ * the frames are prefetched in windows ahead of the playhead and consumed on the game thread
+ * through a lock-free single-producer single-consumer queue with a bounded number of frames
+ */
+class FSLMongoEpisodeStreamer : public FRunnable
+{
+public:
+	// Ctor
+	FSLMongoEpisodeStreamer();
+
+	// Dtor
+	virtual ~FSLMongoEpisodeStreamer();
+
+	// Start streaming the frames between the timestamps, the first frame holds the full world state at the start time
+	bool Start(const FString& InServerIp, uint16 InServerPort, const FString& InDBName, const FString& InCollName,
+		float InStartTs = -1.f, float InEndTs = -1.f, int32 InMaxNumQueuedFrames = 512);
+
+	// Restart streaming from the start time with the same parameters (used for looping)
+	bool Restart();
+
+	// Stop the worker and clear the queued frames
+	void Shutdown();
+
+	// Get the next frame (game thread), false if no frame is available yet
+	bool Dequeue(TPair<float, TMap<FString, FTransform>>& OutFrame);
+
+	// True if all the frames have been read and consumed
+	bool IsFinished() const { return bReadFinished && NumQueuedFrames.GetValue() == 0; };
+
+	// Number of prefetched frames
+	int32 NumQueued() const { return NumQueuedFrames.GetValue(); };
+
+	/* Begin FRunnable interface */
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+	/* End FRunnable interface */
+
+private:
+	// Worker thread
+	FRunnableThread* Thread;
+
+	// Prefetched frames, written by the worker and read by the game thread
+	TQueue<TPair<float, TMap<FString, FTransform>>, EQueueMode::Spsc> Frames;
+
+	// Number of frames in the queue
+	FThreadSafeCounter NumQueuedFrames;
+
+	// Set from the game thread to stop the worker
+	FThreadSafeBool bStopRequested;
+
+	// Set by the worker when there are no more frames to read
+	FThreadSafeBool bReadFinished;
+
+	// Connection parameters
+	FString ServerIp;
+	uint16 ServerPort;
+	FString DBName;
+	FString CollName;
+
+	// Streamed timeline (negative values mean the episode start/end)
+	float StartTs;
+	float EndTs;
+
+	// Max number of prefetched frames (bounds the memory)
+	int32 MaxNumQueuedFrames;
+};
@@ -18,6 +18,43 @@ THIRD_PARTY_INCLUDES_START
 THIRD_PARTY_INCLUDES_END
 #endif //SL_WITH_LIBMONGO_C
 
+// Forward declarations
+class FSLMongoEpisodeStreamer;
+
+/**
+ * Hit / miss statistics of the pose cache
+ */
+struct FSLMongoPoseCacheStats
+{
+	// Queries answered from the cache
+	int32 NumHits = 0;
+
+	// Queries which needed the database (window loads and last known poses before the window)
+	int32 NumMisses = 0;
+
+	// Number of loaded time windows
+	int32 NumWindowLoads = 0;
+
+	// Number of frames in the current window
+	int32 NumFrames = 0;
+
+	// Number of individuals with poses in the current window
+	int32 NumTracks = 0;
+
+	// Time window of the cached frames
+	double WindowStart = 0.0;
+	double WindowEnd = 0.0;
+
+	// Get the stats as string
+	FString ToString() const
+	{
+		const int32 NumQueries = NumHits + NumMisses;
+		return FString::Printf(TEXT("Hits=%d; Misses=%d; HitRate=%.2f%%; WindowLoads=%d; Window=[%.3f, %.3f]; Frames=%d; Tracks=%d;"),
+			NumHits, NumMisses, NumQueries > 0 ? 100.f * NumHits / NumQueries : 0.f,
+			NumWindowLoads, WindowStart, WindowEnd, NumFrames, NumTracks);
+	}
+};
+
 /**
  * 
  */
@@ -45,6 +82,12 @@ public:
 	// Everything is set in order to query the data
 	bool IsReady() const { return bConnected && bDatabaseSet && bCollectionSet; };
 
+	// Get the server ip of the current connection
+	FString GetServerIp() const { return ConnServerIp; };
+
+	// Get the server port of the current connection
+	uint16 GetServerPort() const { return ConnServerPort; };
+
 	/* Queries */
 	// Get the pose of the individual at the given time
 	FTransform GetIndividualPoseAt(const FString& Id, float Ts) const;
@@ -55,19 +98,94 @@ public:
 	// Get skeletal individual pose
 	TPair<FTransform, TMap<int32, FTransform>> GetSkeletalIndividualPoseAt(const FString& Id, float Ts) const;
 
-	// Get skeletal individual trajectory
-	TArray<TPair<FTransform, TMap<int32, FTransform>>> GetSkeletalIndividualTrajectory(const FString& Id, float StartTs, float EndTs, float DeltaT = -1.f) const;
+	// Get skeletal individual trajectory (only the given bones if the array is not empty)
+	TArray<TPair<FTransform, TMap<int32, FTransform>>> GetSkeletalIndividualTrajectory(const FString& Id, float StartTs, float EndTs, float DeltaT = -1.f,
+		const TArray<int32>& BoneIndexes = TArray<int32>()) const;
 
 	// Get the whole episode data
 	TArray<TPair<float, TMap<FString, FTransform>>> GetEpisodeData() const;
 
-	// Get the whole episode data in an async thread
-	TArray<TPair<float, TMap<FString, FTransform>>> GetEpisodeDataAsync() const;
+	// Stream the episode data between the given timestamps in an async thread (uses its own connection, nullptr if the handler is not ready)
+	TSharedPtr<FSLMongoEpisodeStreamer> GetEpisodeDataAsync(float StartTs = -1.f, float EndTs = -1.f, int32 MaxNumQueuedFrames = 512) const;
+
+	// Get the frames after the given timestamp (at most MaxNumFrames), the timestamp is set to the last read one (false on errors)
+	bool GetEpisodeDataWindow(double& InOutTs, int32 MaxNumFrames, TArray<TPair<float, TMap<FString, FTransform>>>& OutFrames) const;
 
-	// Get the episode data at the given timestamp (frame)
-	TMap<FString, FTransform> GetFrameData(float Ts);
+	// Get the full world state at the given timestamp (latest pose of every individual at or before the timestamp)
+	TMap<FString, FTransform> GetFrameData(float Ts) const;
+
+	// Get the number of documents and the last timestamp of the collection (used to detect changes of the episode)
+	bool GetCollectionFingerprint(int64& OutNumDocs, double& OutLastTs) const;
+
+	/* Pose cache */
+	// Answer the pose and short trajectory queries from a cached time window of frames (at most InMaxNumFrames per window)
+	void SetPoseCache(bool bEnable, float InWindowSize = 10.f, int32 InMaxNumFrames = 8192);
+
+	// Drop the cached frames (and the statistics)
+	void ClearPoseCache(bool bResetStats = false);
+
+	// Get the hit / miss statistics of the pose cache
+	const FSLMongoPoseCacheStats& GetPoseCacheStats() const { return PoseCacheStats; };
+
+#if SL_WITH_LIBMONGO_C
+	// Read the id table document of the world state collection, false if the collection has none or its poses are not compact encoded
+	static bool ReadIdTable(mongoc_collection_t* coll, TArray<FString>& OutIds, TArray<FString>& OutSkelIds, float& OutPositionResolution,
+		bool& bOutSparseBones, bool& bOutLocalBones);
+
+	// Decode a binary pose (with the ROS conversion if enabled), false if the encoding is unknown
+	static bool DecodePose(const bson_iter_t* p_iter, float InPositionResolution, FTransform& OutPose);
+
+	// Get the pose of the array element, the binary pose if the poses are compact, or the loc/quat sub documents
+	static FTransform GetPose(const bson_iter_t* iter, bool bInCompactPoses, float InPositionResolution);
+
+	// Get the shared (thread safe) client pool of the server uri, created on first use, the handlers pop their clients from it
+	static mongoc_client_pool_t* GetClientPool(const FString& InUri);
+#endif // SL_WITH_LIBMONGO_C
+
+	// Destroy the shared client pools, called at module shutdown after every handler is disconnected
+	static void DestroyClientPools();
 
 private:
+	// Cached poses of an individual in the current window
+	struct FSLMongoPoseTrack
+	{
+		// Sorted timestamps of the frames in which the individual moved
+		TArray<double> Timestamps;
+
+		// Poses of the individual at the timestamps
+		TArray<FTransform> Poses;
+
+		// Pose before the window (queried once, if needed)
+		FTransform LastKnownPose;
+
+		// True if the pose before the window is queried
+		bool bHasLastKnownPose = false;
+	};
+
+	// Query the pose of the individual at the given time from the database
+	FTransform QueryIndividualPoseAt(const FString& Id, float Ts) const;
+
+	// Query the skeletal individual pose and its bones at the given time (sparse bones are carried forward, local bones are not converted)
+	void QuerySkeletalIndividualPoseAt(const FString& Id, float Ts, FTransform& OutPose, TMap<int32, FTransform>& OutBones) const;
+
+	// Get the world poses of the bones (the local bone poses are relative to the skeletal individual)
+	TMap<int32, FTransform> GetWorldBonePoses(const FTransform& SkelPose, const TMap<int32, FTransform>& Bones) const;
+
+	// Get the pose from the cache, loads the window around the timestamp if needed (false if the cache could not answer)
+	bool GetCachedPoseAt(const FString& Id, float Ts, FTransform& OutPose) const;
+
+	// Get the poses between the timestamps from the cache (false if the interval is longer than the window or could not be loaded)
+	bool GetCachedTrajectory(const FString& Id, float StartTs, float EndTs, float DeltaT, TArray<FTransform>& OutTrajectory) const;
+
+	// Load the window of frames around the timestamp if it is not already cached (false if the timestamp is not covered)
+	bool LoadPoseCacheWindowAt(float Ts) const;
+
+	// True if the cached window covers the interval
+	bool IsInPoseCacheWindow(float StartTs, float EndTs) const
+	{
+		return bPoseCacheValid && PoseCacheStats.WindowStart <= StartTs && EndTs <= PoseCacheStats.WindowEnd;
+	};
+
 #if SL_WITH_LIBMONGO_C
 	/* Helpers */
 	// Get the pose data from bson document
@@ -78,6 +196,31 @@ private:
 
 	// Get the timestamp value from document (used for trajectory delta time comparison)
 	double GetTs(const bson_t* doc) const;
+
+	// Get the individual id of the array element (resolved through the id table if the poses are compact)
+	FString GetId(const bson_iter_t* iter) const;
+
+	// Create the filter matching the individual in the given array (false if the id is not in the id table)
+	bool CreateIdFilter(const FString& Id, const char* ArrayName, bson_t* out_filter) const;
+
+	// Create the timestamp filters of a trajectory query (with a delta time only the selected frames are matched)
+	void CreateTrajectoryTimeFilters(const bson_t* id_filter, float StartTs, float EndTs, float DeltaT, TArray<bson_t*>& OutFilters) const;
+
+	// Read the bones of a skeletal individual entry, returns true if the entry has all the bones (older values are not needed)
+	bool ReadSkeletalBones(const bson_t* doc, bool bOverwrite, TMap<int32, FTransform>& InOutBones) const;
+
+	// Read the timestamp and the individual poses of a world state document
+	void ReadFrame(const bson_t* doc, double& OutTs, TMap<FString, FTransform>& OutIndividualPoses) const;
+
+	/* Trajectory buckets */
+	// Get the pose at the given time from the trajectory buckets (false if there is no sample)
+	bool GetBucketPoseAt(const FString& Id, float Ts, FTransform& OutPose) const;
+
+	// Get the poses between the given timestamps from the trajectory buckets (false if there is no sample)
+	bool GetBucketTrajectory(const FString& Id, float StartTs, float EndTs, float DeltaT, TArray<FTransform>& OutTrajectory) const;
+
+	// Decode the packed timestamps and poses of a trajectory bucket document
+	bool ReadTrajectoryBucket(const bson_t* doc, TArray<float>& OutTimestamps, TArray<FTransform>& OutPoses) const;
 #endif // SL_WITH_LIBMONGO_C
 
 private:
@@ -90,11 +233,54 @@ private:
 	// Connected to a database
 	bool bCollectionSet;
 
+	// Connection parameters (used by the async streamers to open their own connection)
+	FString ConnServerIp;
+	uint16 ConnServerPort;
+	FString ConnDBName;
+	FString ConnCollName;
+
+	// The collection poses are binary encoded and the individuals are referenced by their id table index
+	bool bCompactPoses;
+
+	// Position resolution of the quantized encoding
+	float PositionResolution;
+
+	// Only the moved bones are written, the skeletal individual entries with all the bones are marked as key entries
+	bool bSparseBones;
+
+	// The bone poses are relative to their skeletal individual
+	bool bLocalBones;
+
+	// Id table of the compact encoding (individuals and skeletal individuals)
+	TArray<FString> IdTable;
+	TArray<FString> SkelIdTable;
+	TMap<FString, int32> IdToIdx;
+	TMap<FString, int32> SkelIdToIdx;
+
+	/* Pose cache */
+	// Answer the pose and short trajectory queries from the cache
+	bool bPoseCacheEnabled;
+
+	// Duration of the cached windows (seconds)
+	float PoseCacheWindowSize;
+
+	// Max number of frames loaded for a window
+	int32 PoseCacheMaxNumFrames;
+
+	// True if the cache holds a loaded window
+	mutable bool bPoseCacheValid;
+
+	// Per individual poses of the current window
+	mutable TMap<FString, FSLMongoPoseTrack> PoseCacheTracks;
+
+	// Hit / miss statistics
+	mutable FSLMongoPoseCacheStats PoseCacheStats;
+
 #if SL_WITH_LIBMONGO_C
-	// Server uri
-	mongoc_uri_t* uri;
+	// Shared client pool of the server (not owned)
+	mongoc_client_pool_t* pool;
 
-	// MongoC connection client
+	// MongoC connection client (popped from the pool)
 	mongoc_client_t* client;
 
 	// Database to access
@@ -103,6 +289,9 @@ private:
 	// World state data collection
 	mongoc_collection_t* collection;
 
+	// Per individual trajectory buckets collection (nullptr if the episode has none)
+	mongoc_collection_t* trj_collection;
+
 	// Entity ids meta data collection
 	mongoc_collection_t* meta_collection;
 #endif // SL_WITH_LIBMONGO_C
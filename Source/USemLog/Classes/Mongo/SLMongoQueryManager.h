@@ -41,6 +41,12 @@ public:
 	// Get init state
 	bool IsConnected() const { return bConnected; };
 
+	// Get the server ip of the current connection
+	FString GetServerIp() const { return DBHandler.GetServerIp(); };
+
+	// Get the server port of the current connection
+	uint16 GetServerPort() const { return DBHandler.GetServerPort(); };
+
 	// Check if the task is selected
 	bool IsTaskSet() const { return bTaskSet; };
 
@@ -63,16 +69,26 @@ public:
 	TPair<FTransform, TMap<int32, FTransform>> GetSkeletalIndividualPoseAt(const FString& InEpisodeId, const FString& IndividualId, float Ts);
 	TPair<FTransform, TMap<int32, FTransform>> GetSkeletalIndividualPoseAt(const FString& IndividualId, float Ts) const;
 
-	// Get skeletal individual trajectory
-	TArray<TPair<FTransform, TMap<int32, FTransform>>>  GetSkeletalIndividualTrajectory(const FString& InTaskId, const FString& InEpisodeId, const FString& IndividualId, float StartTs, float EndTs, float DeltaT = -1.f);
-	TArray<TPair<FTransform, TMap<int32, FTransform>>>  GetSkeletalIndividualTrajectory(const FString& InEpisodeId, const FString& IndividualId, float StartTs, float EndTs, float DeltaT = -1.f);
-	TArray<TPair<FTransform, TMap<int32, FTransform>>>  GetSkeletalIndividualTrajectory(const FString& IndividualId, float StartTs, float EndTs, float DeltaT = -1.f) const;
+	// Get skeletal individual trajectory (only the given bones if the array is not empty)
+	TArray<TPair<FTransform, TMap<int32, FTransform>>>  GetSkeletalIndividualTrajectory(const FString& InTaskId, const FString& InEpisodeId, const FString& IndividualId, float StartTs, float EndTs, float DeltaT = -1.f, const TArray<int32>& BoneIndexes = TArray<int32>());
+	TArray<TPair<FTransform, TMap<int32, FTransform>>>  GetSkeletalIndividualTrajectory(const FString& InEpisodeId, const FString& IndividualId, float StartTs, float EndTs, float DeltaT = -1.f, const TArray<int32>& BoneIndexes = TArray<int32>());
+	TArray<TPair<FTransform, TMap<int32, FTransform>>>  GetSkeletalIndividualTrajectory(const FString& IndividualId, float StartTs, float EndTs, float DeltaT = -1.f, const TArray<int32>& BoneIndexes = TArray<int32>()) const;
 
 	// Get the episode data
 	TArray<TPair<float, TMap<FString, FTransform>>> GetEpisodeData(const FString& InTaskId, const FString& InEpisodeId);
 	TArray<TPair<float, TMap<FString, FTransform>>> GetEpisodeData(const FString& InEpisodeId);
 	TArray<TPair<float, TMap<FString, FTransform>>> GetEpisodeData() const;
 
+	// Get the number of documents and the last timestamp of the episode (used to detect changes of the episode)
+	bool GetEpisodeFingerprint(const FString& InTaskId, const FString& InEpisodeId, int64& OutNumDocs, double& OutLastTs);
+
+	// Stream the episode data in an async thread (nullptr if the episode could not be set)
+	TSharedPtr<FSLMongoEpisodeStreamer> GetEpisodeDataAsync(const FString& InTaskId, const FString& InEpisodeId, float StartTs = -1.f, float EndTs = -1.f);
+	TSharedPtr<FSLMongoEpisodeStreamer> GetEpisodeDataAsync(float StartTs = -1.f, float EndTs = -1.f) const;
+
+	// Get the hit / miss statistics of the pose cache
+	const FSLMongoPoseCacheStats& GetPoseCacheStats() const { return DBHandler.GetPoseCacheStats(); };
+
 	// Spawn or get manager from the world
 	static ASLMongoQueryManager* GetExistingOrSpawnNew(UWorld* World);
 
@@ -96,6 +112,18 @@ private:
 	// Database handler
 	FSLMongoQueryDBHandler DBHandler;
 
+	// Answer the pose and short trajectory queries from a cached time window of frames
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger")
+	bool bUsePoseCache = true;
+
+	// Duration of the cached time windows (seconds)
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger", meta = (editcondition = "bUsePoseCache", ClampMin = 0.1))
+	float PoseCacheWindowSize = 10.f;
+
+	// Max number of frames loaded for a cached window
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger", meta = (editcondition = "bUsePoseCache", ClampMin = 1))
+	int32 PoseCacheMaxNumFrames = 8192;
+
 	///* Editor button hacks */
 	//// Server ip to connect to
 	//UPROPERTY(EditAnywhere, Category = "Semantic Logger|Buttons")
@@ -5,6 +5,7 @@
 
 #include "USemLog.h"
 #include "Components/SphereComponent.h"
+#include "Monitors/SLMonitorScheduler.h"
 #include "SLBoneContactMonitor.generated.h"
 
 // Forward declarations
@@ -244,15 +245,18 @@ private:
 	TArray<AStaticMeshActor*> IgnoreList;
 
 
+	// Owns the delayed end event calls
+	USLMonitorScheduler* MonitorScheduler;
+
 	// Send finished events with a delay to check for possible concatenation of equal and consecutive events with small time gaps in between
-	FTimerHandle GraspDelayTimerHandle;
+	FSLDelayedCallHandle GraspDelayTimerHandle;
 
 	// Array of recently ended events
 	TArray<FSLBoneContactEndEvent> RecentlyEndedGraspOverlapEvents;
 	
 	
 	// Send finished events with a delay to check for possible concatenation of equal and consecutive events with small time gaps in between
-	FTimerHandle ContactDelayTimerHandle;
+	FSLDelayedCallHandle ContactDelayTimerHandle;
 
 	// Array of recently ended events
 	TArray<FSLBoneContactEndEvent> RecentlyEndedContactOverlapEvents;
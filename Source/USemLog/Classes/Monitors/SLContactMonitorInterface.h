@@ -7,6 +7,7 @@
 #include "Components/ShapeComponent.h"
 #include "TimerManager.h"
 #include "Monitors/SLMonitorStructs.h"
+#include "Monitors/SLMonitorScheduler.h"
 #include "SLContactMonitorInterface.generated.h"
 
 // Forward declaration
@@ -55,6 +56,9 @@ class ISLContactMonitorInterface
 {
 	GENERATED_BODY()
 
+	// Checks the supported by candidates of all the monitors
+	friend class USLMonitorScheduler;
+
 public:
 	// Initialize trigger area for runtime, check if outer is valid and semantically annotated
 	virtual void Init(bool bLogSupportedByEvents = true) = 0;
@@ -107,11 +111,8 @@ protected:
 	// Publish currently overlapping components
 	void TriggerInitialOverlaps();
 
-	// Start checking for supported by events
-	void StartSupportedByUpdateCheck();
-
-	// Check for supported by events
-	void SupportedByUpdateCheckBegin();
+	// Broadcast the supported by event of the (vertically stable) candidate, called by the scheduler
+	void BeginSupportedByEvent(const FSLContactResult& Candidate, float Time);
 
 	// Check if Other is a supported by candidate
 	bool CheckAndRemoveIfJustCandidate(USLBaseIndividual* InOther);
@@ -184,17 +185,11 @@ protected:
 	// Semantic individual object
 	USLBaseIndividual* OwnerIndividualObject;
 
-	// SupportedBy contact candidates
-	TArray<FSLContactResult> SupportedByCandidates;
-	
-	// Supported by event update timer handle
-	FTimerHandle SupportedByTimerHandle;
-
-	// Allow binding against non-UObject functions
-	FTimerDelegate SupportedByTimerDelegate;
+	// Owns the supported by candidates and the delayed end event calls of the monitors
+	USLMonitorScheduler* MonitorScheduler;
 
 	// Send finished events with a delay to check for possible concatenation of equal and consecutive events with small time gaps in between
-	FTimerHandle DelayTimerHandle;
+	FSLDelayedCallHandle DelayTimerHandle;
 
 	// Can only bind the timer handle to UObjects or FTimerDelegates
 	FTimerDelegate DelayTimerDelegate;
@@ -204,8 +199,6 @@ protected:
 
 	/* Constants */
 	static constexpr auto TagTypeName = TEXT("SemLogColl");
-	static constexpr float SupportedByUpdateRate = 0.11f;
-	static constexpr float SupportedByMaxVertSpeed = 0.5f;
 	static constexpr float ConcatenateIfSmaller = 0.21f;
 	static constexpr float ConcatenateIfSmallerDelay = 0.05f;
 };
\ No newline at end of file
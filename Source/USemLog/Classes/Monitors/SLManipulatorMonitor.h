@@ -6,7 +6,7 @@
 #include "USemLog.h"
 #include "Components/ActorComponent.h"
 #include "Monitors/SLMonitorStructs.h"
-#include "TimerManager.h"
+#include "Monitors/SLMonitorScheduler.h"
 #include "Monitors/SLGraspHelper.h"
 #include "SLManipulatorMonitor.generated.h"
 
@@ -316,8 +316,11 @@ private:
 	// Active grasp type
 	FString ActiveGraspType;
 	
+	// Owns the delayed end event calls
+	USLMonitorScheduler* MonitorScheduler;
+
 	// Send finished events with a delay to check for possible concatenation of equal and consecutive events with small time gaps in between
-	FTimerHandle GraspDelayTimerHandle;
+	FSLDelayedCallHandle GraspDelayTimerHandle;
 
 	// Array of recently ended events
 	TArray<FSLGraspEndEvent> RecentlyEndedGraspEvents;
@@ -327,7 +330,7 @@ private:
 	TMap<USLBaseIndividual*, int32> ManipulatorNumContacts;
 
 	// Send finished events with a delay to check for possible concatenation of equal and consecutive events with small time gaps in between
-	FTimerHandle ContactDelayTimerHandle;
+	FSLDelayedCallHandle ContactDelayTimerHandle;
 
 	// Array of recently ended events
 	TArray<FSLContactEndEvent> RecentlyEndedContactEvents;
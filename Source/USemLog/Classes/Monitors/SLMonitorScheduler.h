@@ -0,0 +1,145 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Runtime/Launch/Resources/Version.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "TimerManager.h"
+#include "Monitors/SLMonitorStructs.h"
+#include "SLMonitorScheduler.generated.h"
+
+// The scheduler is a world subsystem (UE 4.24+), the monitors no longer support UE 4.23
+#if ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION < 24
+#error "USemLog monitors require UE 4.24 or newer (USLMonitorScheduler is a UWorldSubsystem)"
+#endif
+
+// Forward declarations
+class ISLContactMonitorInterface;
+class USLBaseIndividual;
+class UMeshComponent;
+
+/**
+ * Handle of a delayed call in the monitor scheduler (invalid if zero)
+ */
+struct FSLDelayedCallHandle
+{
+	// Unique id of the scheduled call
+	uint64 Id = 0;
+
+	// True if it was set (the call might have already been executed)
+	bool IsValid() const { return Id != 0; };
+
+	// Clear the handle
+	void Invalidate() { Id = 0; };
+};
+
+/**
+ * Single per-world owner of the periodic supported by checks and of the delayed (jitter) end event callbacks of the monitors,
+ * the supported by candidates are kept in a flat array and checked in one batch, the delayed calls are kept in a time wheel
+ */
+UCLASS()
+class USEMLOG_API USLMonitorScheduler : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	// Get the scheduler of the world
+	static USLMonitorScheduler* Get(UWorld* World);
+
+	/* Begin USubsystem interface */
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	/* End USubsystem interface */
+
+	/* Begin FTickableGameObject interface */
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	/* End FTickableGameObject interface */
+
+	// Add a supported by candidate, the monitor is called back once the pair is vertically stable
+	void AddSupportedByCandidate(ISLContactMonitorInterface* Monitor, const FSLContactResult& Candidate);
+
+	// Remove the candidate of the monitor with the other individual, false if it was not a candidate
+	bool RemoveSupportedByCandidate(ISLContactMonitorInterface* Monitor, USLBaseIndividual* Other);
+
+	// Remove all the candidates of the monitor
+	void RemoveSupportedByCandidates(ISLContactMonitorInterface* Monitor);
+
+	// Call the delegate after the delay (a pending call of the handle is replaced)
+	void SetDelayedCall(FSLDelayedCallHandle& InOutHandle, const FTimerDelegate& Delegate, float Delay);
+
+	// Call the object method after the delay (a pending call of the handle is replaced)
+	template<class UserClass>
+	void SetDelayedCall(FSLDelayedCallHandle& InOutHandle, UserClass* Obj,
+		typename FTimerDelegate::TUObjectMethodDelegate<UserClass>::FMethodPtr Method, float Delay)
+	{
+		SetDelayedCall(InOutHandle, FTimerDelegate::CreateUObject(Obj, Method), Delay);
+	}
+
+	// True if the call of the handle is still pending
+	bool IsDelayedCallActive(const FSLDelayedCallHandle& Handle) const { return Handle.IsValid() && ActiveCallIds.Contains(Handle.Id); };
+
+	// Cancel the pending call of the handle
+	void ClearDelayedCall(FSLDelayedCallHandle& InOutHandle);
+
+	/* Constants */
+	static constexpr float SupportedByUpdateRate = 0.11f;
+	static constexpr float SupportedByMaxVertSpeed = 0.5f;
+
+private:
+	// Check the candidates and start the supported by events of the stable ones
+	void UpdateSupportedByCandidates(float CurrTime);
+
+	// Execute the delayed calls which are due
+	void UpdateDelayedCalls(float CurrTime);
+
+	// Slot of the time wheel
+	int64 GetWheelTick(float Time) const { return FMath::FloorToInt(Time / WheelSlotDuration); };
+
+private:
+	// Supported by candidate with its monitor
+	struct FSupportedByCandidate
+	{
+		ISLContactMonitorInterface* Monitor;
+		FSLContactResult Result;
+	};
+
+	// Delayed call
+	struct FDelayedCall
+	{
+		uint64 Id;
+		float DueTime;
+		FTimerDelegate Delegate;
+	};
+
+	// Pending supported by candidates of all the monitors
+	TArray<FSupportedByCandidate> SupportedByCandidates;
+
+	// Next time the candidates are checked
+	float NextSupportedByUpdateTime;
+
+	// Time wheel of the delayed calls (calls further than one revolution stay in their slot until due)
+	static constexpr int32 NumWheelSlots = 64;
+	static constexpr float WheelSlotDuration = 0.05f;
+	TArray<FDelayedCall> WheelSlots[NumWheelSlots];
+
+	// Last processed wheel slot (absolute)
+	int64 LastWheelTick;
+
+	// Ids of the pending calls (cleared calls are dropped when their slot is processed)
+	TSet<uint64> ActiveCallIds;
+
+	// Id of the next delayed call
+	uint64 NextCallId;
+
+	// Tick cost stats
+	int64 NumTicks;
+	double TotalTickTime;
+	double MaxTickTime;
+	int32 MaxNumCandidates;
+	int32 MaxNumDelayedCalls;
+};
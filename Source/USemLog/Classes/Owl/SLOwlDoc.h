@@ -186,19 +186,12 @@ public:
 		Individuals.Append(InChildNodes);
 	}
 
-	// Return document as string
+	// Return document as string (use FSLOwlWriter::WriteToFile to stream it to a file)
 	FString ToString() const
 	{
-		FString Indent = "";
-		FString DocStr = TEXT("<?xml version=\"1.0\" encoding=\"utf-8\"?>\n\n");
-		DocStr += EntityDefinitions.ToString();
-		FSLOwlNode Root(FSLOwlPrefixName("rdf", "RDF"), Namespaces);
-		Root.AddChildNode(OntologyImports);
-		Root.AddChildNodes(PropertyDefinitions);
-		Root.AddChildNodes(DatatypeDefinitions);
-		Root.AddChildNodes(ClassDefinitions);
-		Root.AddChildNodes(Individuals);
-		DocStr += Root.ToString(Indent);
+		FString DocStr;
+		FSLOwlWriter Writer(DocStr);
+		Writer.WriteDoc(*this);
 		return DocStr;
 	}
 };
@@ -5,6 +5,7 @@
 
 #include "CoreMinimal.h"
 #include "Owl/SLOwlStructs.h"
+#include "Owl/SLOwlWriter.h"
 
 /**
 * Owl/Xml node
@@ -148,81 +149,12 @@ public:
 	// Destructor
 	~FSLOwlNode() {}
 
-	// Return node as string
+	// Return node as string (use FSLOwlWriter to stream large nodes)
 	FString ToString(FString& Indent) const
 	{
 		FString NodeStr;
-		// Add comment
-		if (!Comment.IsEmpty())
-		{
-			NodeStr += TEXT("\n") + Indent + TEXT("<!-- ") + Comment + TEXT(" -->\n");
-		}
-
-		// Comment only OR empty node
-		if (Name.ToString().IsEmpty())
-		{
-			return NodeStr;
-		}
-
-		// Add node name
-		NodeStr += Indent + TEXT("<") + Name.ToString();
-
-		// Add attributes to tag
-		for (int32 i = 0; i < Attributes.Num(); ++i)
-		{
-			if (Attributes.Num() == 1)
-			{
-				NodeStr += TEXT(" ") + Attributes[i].ToString();
-			}
-			else
-			{
-				if (i < (Attributes.Num() - 1))
-				{
-					NodeStr += TEXT(" ") + Attributes[i].ToString() + TEXT("\n") + Indent + INDENT_STEP;
-				}
-				else
-				{
-					// Last attribute does not have new line
-					NodeStr += TEXT(" ") + Attributes[i].ToString();
-				}
-			}
-		}
-
-		// Check node data (children/value)
-		bool bHasChildren = ChildNodes.Num() != 0;
-		bool bHasValue = !Value.IsEmpty();
-			
-		// Node cannot have value and children
-		if (!bHasChildren && !bHasValue)
-		{
-			// No children nor value, close tag
-			NodeStr += TEXT("/>\n");
-		}
-		else if (bHasValue)
-		{
-			// Node has a value, add value
-			NodeStr += TEXT(">") + Value + TEXT("</") + Name.ToString() + TEXT(">\n");
-		}
-		else if(bHasChildren)
-		{
-			// Node has children, add children
-			NodeStr += TEXT(">\n");
-			
-			// Increase indentation
-			Indent += INDENT_STEP;
-			
-			// Iterate children and add nodes
-			for (auto& ChildItr : ChildNodes)
-			{
-				NodeStr += ChildItr.ToString(Indent);
-			}
-			
-			// Decrease indentation
-			Indent.RemoveFromEnd(INDENT_STEP);
-			
-			// Close tag
-			NodeStr += Indent + Value + TEXT("</") + Name.ToString() + TEXT(">\n");
-		}
+		FSLOwlWriter Writer(NodeStr, Indent);
+		Writer.WriteNode(*this);
 		return NodeStr;
 	}
 
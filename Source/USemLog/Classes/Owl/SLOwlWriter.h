@@ -0,0 +1,90 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Owl/SLOwlStructs.h"
+
+// Forward declarations
+struct FSLOwlNode;
+struct FSLOwlDoc;
+
+/**
+* Writes owl nodes and documents without building intermediate per-node strings,
+* the output is either appended to a string or streamed as utf-8 to an archive (in blocks)
+*/
+class USEMLOG_API FSLOwlWriter
+{
+public:
+	// Append the output to the string
+	explicit FSLOwlWriter(FString& InOutString, const FString& InIndent = FString());
+
+	// Stream the output as utf-8 to the archive
+	explicit FSLOwlWriter(FArchive& InOutArchive, int32 InBlockSize = 1024 * 1024);
+
+	// Dtor (flushes the remaining data)
+	~FSLOwlWriter();
+
+	// Write the document (xml declaration, entity definitions, rdf root with all the nodes)
+	void WriteDoc(const FSLOwlDoc& Doc);
+
+	// Write the document up to and including its individuals (more nodes can be written before closing it)
+	void WriteDocBegin(const FSLOwlDoc& Doc);
+
+	// Close the document root
+	void WriteDocEnd();
+
+	// Write the node and its children
+	void WriteNode(const FSLOwlNode& Node);
+
+	// Write already converted nodes
+	void WriteRaw(const FString& Str) { Write(Str); };
+
+	// Write the buffered data to the archive
+	void Flush();
+
+	// Number of bytes streamed to the archive (or chars appended to the string)
+	int64 GetNumWritten() const { return NumWritten + Buffer.Num(); };
+
+	// Stream the document to the file as utf-8
+	static bool WriteToFile(const FSLOwlDoc& Doc, const FString& Path);
+
+	// Current indentation
+	FString Indent;
+
+private:
+	// Write the tag name and its attributes (without closing the tag)
+	void WriteStartTag(const FSLOwlPrefixName& Name, const TArray<FSLOwlAttribute>& Attributes);
+
+	// Write prefixed name (e.g. "rdf:about")
+	void WritePrefixName(const FSLOwlPrefixName& Name);
+
+	// Write attribute (e.g. rdf:about="&log;abc")
+	void WriteAttribute(const FSLOwlAttribute& Attribute);
+
+	// Write the chars
+	void Write(const TCHAR* Chars, int32 Len);
+
+	// Write the string
+	void Write(const FString& Str) { Write(*Str, Str.Len()); };
+
+	// Write the null terminated literal
+	void Write(const TCHAR* Literal) { Write(Literal, FCString::Strlen(Literal)); };
+
+private:
+	// String output (nullptr if streaming to an archive)
+	FString* OutString;
+
+	// Archive output (nullptr if appending to a string)
+	FArchive* OutArchive;
+
+	// Utf-8 data waiting to be written to the archive
+	TArray<ANSICHAR> Buffer;
+
+	// Buffer size at which the data is written to the archive
+	int32 BlockSize;
+
+	// Data already written to the archive
+	int64 NumWritten;
+};
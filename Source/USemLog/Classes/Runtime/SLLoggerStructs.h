@@ -94,6 +94,33 @@ struct FSLLoggerStartParams
 	FName UserInputActionName = TEXT("SLTrigger");
 };
 
+/* World state writer behaviour when all frame buffers are in use */
+UENUM()
+enum class ESLWorldStateOverflowPolicy : uint8
+{
+	Block				UMETA(DisplayName = "Block"),
+	Coalesce			UMETA(DisplayName = "Coalesce"),
+	SpillToDisk			UMETA(DisplayName = "SpillToDisk"),
+};
+
+/* Write concern of the world state inserts */
+UENUM()
+enum class ESLWorldStateWriteConcern : uint8
+{
+	Unacknowledged		UMETA(DisplayName = "Unacknowledged (w:0)"),
+	Acknowledged		UMETA(DisplayName = "Acknowledged (w:1)"),
+	Journaled			UMETA(DisplayName = "Journaled (w:1, j:true)"),
+};
+
+/* Pose encoding of the world state documents */
+UENUM()
+enum class ESLWorldStatePoseEncoding : uint8
+{
+	Default				UMETA(DisplayName = "Default (loc, quat, pose as doubles)"),
+	Float32				UMETA(DisplayName = "Float32 (binary, smallest-three quat)"),
+	Quantized			UMETA(DisplayName = "Quantized (binary, fixed point position)"),
+};
+
 /* Holds the data needed to setup the world state logger */
 USTRUCT()
 struct FSLWorldStateLoggerParams
@@ -112,6 +139,54 @@ struct FSLWorldStateLoggerParams
 	UPROPERTY(EditAnywhere, Category = "Semantic Logger")
 	bool bWriteSparse = true;
 
+	// Write only the bones which moved since their last written pose (the readers carry forward the previous values)
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger", meta = (editcondition = "bWriteSparse"))
+	bool bWriteSparseBones = false;
+
+	// Time (in seconds) after which all the bones of a skeletal individual are written again (bounds the reader look-back)
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger", meta = (editcondition = "bWriteSparse && bWriteSparseBones", ClampMin = 0))
+	float BoneKeyFrameInterval = 1.f;
+
+	// Write the bone poses relative to their skeletal individual (idle bones of a moving skeleton are not rewritten)
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger")
+	bool bWriteLocalBonePoses = false;
+
+	// Number of pre-allocated frames the game thread can queue before the writer catches up
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger", meta = (ClampMin = 2))
+	int32 FrameBufferSize = 128;
+
+	// Block the game thread, merge into the newest queued frame, or spill the frames to disk when the buffers are full
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger")
+	ESLWorldStateOverflowPolicy OverflowPolicy = ESLWorldStateOverflowPolicy::Block;
+
+	// Number of world state documents uploaded together as an unordered bulk insert (1 uploads every document separately)
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger", meta = (ClampMin = 1))
+	int32 BatchSize = 1;
+
+	// Max time (in seconds) a document waits in a batch which is not full
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger", meta = (editcondition = "BatchSize>1", ClampMin = 0))
+	float BatchMaxDelay = 0.5f;
+
+	// Acknowledgment requested from the server for the world state inserts
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger")
+	ESLWorldStateWriteConcern WriteConcern = ESLWorldStateWriteConcern::Acknowledged;
+
+	// Encoding of the individual poses, the binary encodings reference the individuals by their index in the id table document
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger")
+	ESLWorldStatePoseEncoding PoseEncoding = ESLWorldStatePoseEncoding::Default;
+
+	// Position resolution of the quantized encoding (in the written units)
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger", meta = (editcondition = "PoseEncoding==ESLWorldStatePoseEncoding::Quantized", ClampMin = 0.000001))
+	float PositionResolution = 0.0001f;
+
+	// Additionally write time bucketed per-individual trajectories (packed arrays) to the <episode>.trj collection
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger")
+	bool bWriteTrajectoryBuckets = false;
+
+	// Max time span (in seconds) of a trajectory bucket
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger", meta = (editcondition = "bWriteTrajectoryBuckets", ClampMin = 0.1))
+	float TrajectoryBucketDuration = 10.f;
+
 	// Include individuals metadata 
 	UPROPERTY(EditAnywhere, Category = "Semantic Logger")
 	bool bIncludeMetadata = true;
@@ -167,6 +242,47 @@ struct FLSymbolicEventsSelection
 };
 
 
+/* Offline event detection from a logged world state */
+USTRUCT()
+struct FSLOfflineEventParams
+{
+	GENERATED_BODY();
+
+	// Detect the contact and supported by events from the world state of the (custom) episode id instead of the live overlaps
+	// (only these two, the manipulator, pick-and-place and container events are not re-detected)
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger")
+	bool bDetectFromWorldState = false;
+
+	// Server of the world state database (the task id is the database, the episode id the collection)
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger", meta = (editcondition = "bDetectFromWorldState"))
+	FSLLoggerDBServerParams DBServerParams;
+
+	// Distance (cm) between the bounding boxes at which the individuals are in contact
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger", meta = (editcondition = "bDetectFromWorldState", ClampMin = 0))
+	float ContactTolerance = 0.5f;
+
+	// Max relative vertical speed (cm/s) of two individuals in contact for a supported by event
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger", meta = (editcondition = "bDetectFromWorldState", ClampMin = 0))
+	float SupportedByMaxVertSpeed = 0.5f;
+
+	// Contacts ending and restarting within this time (s) are concatenated
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger", meta = (editcondition = "bDetectFromWorldState", ClampMin = 0))
+	float ConcatenateIfSmaller = 0.21f;
+
+	// Shorter contact events (s) are not published
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger", meta = (editcondition = "bDetectFromWorldState", ClampMin = 0))
+	float ContactEventMin = 0.3f;
+
+	// Shorter supported by events (s) are not published
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger", meta = (editcondition = "bDetectFromWorldState", ClampMin = 0))
+	float SupportedByEventMin = 0.4f;
+
+	// Time (ms) spent per tick on replaying frames (0 replays all the available frames)
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger", meta = (editcondition = "bDetectFromWorldState", ClampMin = 0))
+	float FrameBudgetMs = 0.f;
+};
+
+
 /* Holds the types of events to be logged by the symbolic logger */
 USTRUCT()
 struct FSLSymbolicLoggerParams
@@ -184,6 +300,21 @@ struct FSLSymbolicLoggerParams
 	UPROPERTY(EditAnywhere, Category = "Semantic Logger|Events", meta = (editcondition = "bWriteTimelines"))
 	FLSymbolicEventsSelection TimelineEventsSelection;
 
+	/* Journal */
+	// Append the finished events to a journal on a background thread instead of keeping them in memory,
+	// the owl and timeline outputs are written from the journal when the logger finishes
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger")
+	bool bJournalEvents = false;
+
+	// Seconds between flushing the journal to disk
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger", meta = (editcondition = "bJournalEvents", ClampMin = 0.01))
+	float JournalFlushInterval = 1.f;
+
+	/* Offline */
+	// Re-detect the events from an already logged world state (headless, faster than real time)
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger")
+	FSLOfflineEventParams OfflineParams;
+
 	/* ROS */
 	UPROPERTY(EditAnywhere, Category = "Semantic Logger")
 	bool bPublishToROS = false;
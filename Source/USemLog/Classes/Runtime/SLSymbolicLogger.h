@@ -9,10 +9,12 @@
 #include "Events/ISLEventHandler.h"
 #include "ROSProlog/SLPrologClient.h"
 #include "Owl/SLOwlExperiment.h"
+#include "Events/SLEventJournal.h"
 #include "SLSymbolicLogger.generated.h"
 
 // Forward declarations
 class ASLIndividualManager;
+class FSLOfflineEventDetector;
 
 /**
  * Subsymbolic data logger
@@ -83,6 +85,9 @@ protected:
 	// Write data to file
 	void WriteToFile();
 
+	// Write the owl and timeline outputs by streaming the events journal
+	void WriteToFileFromJournal(const FString& DirPath);
+
 	// Create events doc template
 	TSharedPtr<FSLOwlExperiment> CreateEventsDocTemplate(
 		ESLOwlExperimentTemplate TemplateType, const FString& InDocId);
@@ -115,6 +120,12 @@ private:
 	// Iterate and init the slicing monitors
 	void InitSlicingMonitors();
 
+	// Init the detector replaying the logged world state instead of the live monitors
+	void InitOfflineEventDetector();
+
+	// Replay the streamed world state frames, finishes the logger at the end of the episode
+	void ReplayOfflineFrames();
+
 	// Publish data through ROS
 	void InitROSPublisher();
 
@@ -156,6 +167,9 @@ private:
 	// Array of finished events
 	TArray<TSharedPtr<ISLEvent>> FinishedEvents;
 
+	// Finished events journal (used instead of the finished events array if journaling is enabled)
+	TSharedPtr<FSLEventJournal> EventJournal;
+
 	// Owl document of the finished events
 	TSharedPtr<FSLOwlExperiment> ExperimentDoc;
 
@@ -177,6 +191,9 @@ private:
 	//// Cache of the container manipulation Monitors
 	//TArray<class USLContainerMonitor*> ContainerMonitors;
 
+	// Re-detects the events from the logged world state (also part of the event handlers)
+	TSharedPtr<FSLOfflineEventDetector> OfflineDetector;
+
 	// Episode start time
 	float EpisodeStartTime;
 
@@ -5,6 +5,8 @@
 
 #include "CoreMinimal.h"
 #include "Runtime/SLLoggerStructs.h"
+#include "Runtime/SLWorldStateFrameQueue.h"
+#include "Runtime/SLWorldStateSnapshot.h"
 #include "Async/AsyncWork.h"
 #if SL_WITH_LIBMONGO_C
 class ASLVisionPoseableMeshActor;
@@ -27,52 +29,85 @@ class USLVirtualBoneIndividual;
 class USLBoneConstraintIndividual;
 
 /**
- * Async task to write to the database
+ * Trajectory samples of one individual, written as packed little endian float32 arrays
+ */
+struct FSLWorldStateTrajectoryBucket
+{
+	// Max number of samples in a bucket (keeps the documents small)
+	static constexpr int32 MaxSamples = 4096;
+
+	// Timestamps
+	TArray<float> Timestamps;
+
+	// Locations as [x y z]
+	TArray<float> Locations;
+
+	// Rotations as [qx qy qz qw]
+	TArray<float> Rotations;
+
+	// Number of samples
+	int32 Num() const { return Timestamps.Num(); };
+
+	// Clear the samples but keep the allocations
+	void Reset() { Timestamps.Reset(); Locations.Reset(); Rotations.Reset(); };
+};
+
+/**
+ * Async task to write to the database (drains the frame queue)
  */
 class FSLWorldStateDBWriterAsyncTask : public FNonAbandonableTask
 {
 public:
+	// Ctor
+	FSLWorldStateDBWriterAsyncTask();
+
+	// Dtor
+	~FSLWorldStateDBWriterAsyncTask();
+
 #if SL_WITH_LIBMONGO_C
-	// Set the individuals
-	bool Init(mongoc_collection_t* in_collection, ASLIndividualManager* Manager, float PoseTolerance, bool bInWriteSparse);
+	// Set the frames layout, the queue to read the frames from, and the upload parameters
+	bool Init(mongoc_collection_t* in_collection, mongoc_collection_t* in_trj_collection, ASLIndividualManager* Manager,
+		const FSLWorldStateLayout* InLayout, FSLWorldStateFrameQueue* InFrameQueue,
+		const FSLWorldStateLoggerParams& InLoggerParameters);
 #endif //SL_WITH_LIBMONGO_C	
 
 	// Do the db writing here
 	void DoWork();
 
+	// Upload the batched documents (return the number of documents uploaded)
+	int32 FlushBatch();
+
+	// True if batched documents waited longer than the max delay (only call while the task is idle)
+	bool IsBatchExpired() const;
+
+	// Log the upload statistics
+	void LogStats(const FString& Prefix) const;
+
+	// Upload all the non-empty trajectory buckets
+	void FlushTrajectoryBuckets();
+
 	// Needed internally
 	FORCEINLINE TStatId GetStatId() const { RETURN_QUICK_DECLARE_CYCLE_STAT(FAnalyzeMaterialTreeAsyncTask, STATGROUP_ThreadPoolAsyncTasks); }
 
-	// Set the simulation time
-	void SetTimestamp(float InTs) { Timestamp = InTs; };
-
 private:
-	// First write where all the individuals are written irregardresly of their previous position
-	int32 FirstWrite();
-
-	// Write sparse (only individuals that moved)
-	int32 WriteSparse();
+	// Write the frame as a world state document (return the number of entries written)
+	int32 WriteFrame(const FSLWorldStateFrame& Frame);
 
-	// Write all individuals (event if they did not move)
-	int32 WriteAll();
+	// Write the frames spilled to the given file, remove the file afterwards (return the number of frames written)
+	int32 WriteSpilledFrames(const FString& FilePath);
 
 #if SL_WITH_LIBMONGO_C
 	// Add timestamp to the bson doc
-	void AddTimestamp(bson_t* doc);
+	void AddTimestamp(float Timestamp, bson_t* doc);
 
-	// Add all individuals (return the number of individuals added)
-	int32 AddAllIndividuals(bson_t* doc);
+	// Add the individuals of the frame (return the number of individuals added)
+	int32 AddIndividuals(const FSLWorldStateFrame& Frame, bson_t* doc);
 
-	// Add only the individuals that moved (return the number of individuals added)
-	int32 AddIndividualsThatMoved(bson_t* doc);
+	// Add skeletal individuals of the frame (return the number of individuals added)
+	int32 AddSkeletalIndividals(const FSLWorldStateFrame& Frame, bson_t* doc);
 
-	// Add skeletal individuals (return the number of individuals added)
-	int32 AddSkeletalIndividals(bson_t* doc);
-
-	// Add skeletal bones to the document
-	void AddSkeletalBoneIndividuals(const TArray<USLBoneIndividual*>& BoneIndividuals,
-		const TArray<USLVirtualBoneIndividual*>& VirtualBoneIndividuals,
-		bson_t* doc);
+	// Add the given skeletal bones to the document (flattened layout indexes)
+	void AddSkeletalBoneIndividuals(const FSLWorldStateFrame& Frame, const TArray<int32>& BoneIdxs, bson_t* doc);
 
 	// Add skeletal bone constraints to the document
 	void AddSkeletalConstraintIndividuals(const TArray<USLBoneConstraintIndividual*>& ConstraintIndividuals,
@@ -84,31 +119,100 @@ private:
 	// Add pose document
 	void AddPose(FTransform Pose, bson_t* doc);
 
+	// Add pose document from the frame buffer values (binary pose if a compact encoding is used)
+	void AddPose(const FVector& Location, const FQuat& Rotation, bson_t* doc);
+
+	// Add the individual reference, the id or the id table index if a compact encoding is used
+	void AddIndividualRef(const char* Id, int32 Idx, bson_t* doc);
+
 	// Write the bson doc to the collection
 	bool UploadDoc(bson_t* doc);
+
+	// Add the bson doc to the batch (takes ownership), flush if the batch is full
+	void AddToBatch(bson_t* doc);
+
+	// Append the frame poses to the trajectory buckets, upload the buckets which are full
+	void AddToTrajectoryBuckets(const FSLWorldStateFrame& Frame);
+
+	// Upload the trajectory bucket of the individual and clear it
+	bool UploadTrajectoryBucket(int32 IndividualIdx);
 #endif //SL_WITH_LIBMONGO_C
 
 
 private:
-	// DoWork function pointers
-	typedef int32 (FSLWorldStateDBWriterAsyncTask::*WriteTypeFunctionPtr)();
-	WriteTypeFunctionPtr WriteFunctionPtr;
-
-	// Access to the individual manager
+	// Access to the individual manager (only used for the robot individuals)
 	ASLIndividualManager* IndividualManager;
 
-	// The timestamp to write to the collection
-	float Timestamp;
+	// Ids and bone indexes of the frames (owned by the handler)
+	const FSLWorldStateLayout* Layout;
 
-	// Pose diff tolerance
-	float MinPoseDiff;
+	// Frames to be written (owned by the handler)
+	FSLWorldStateFrameQueue* FrameQueue;
 
-	// Write mode
-	bool bWriteSparse;
+	// Number of documents uploaded together
+	int32 BatchSize;
+
+	// Max time a document waits in a batch
+	double BatchMaxDelay;
+
+	// Time when the first document of the current batch was added
+	double BatchStartTime;
+
+	// Per individual trajectory samples (layout order)
+	TArray<FSLWorldStateTrajectoryBucket> TrajectoryBuckets;
+
+	// Max time span of a trajectory bucket
+	float TrajectoryBucketDuration;
+
+	// Encoding of the poses
+	ESLWorldStatePoseEncoding PoseEncoding;
+
+	// Position resolution of the quantized encoding
+	float PositionResolution;
+
+	// Only the moved bones are written, all of them at every bone key frame
+	bool bWriteSparseBones;
+
+	// Bone poses are written relative to their skeletal individual
+	bool bWriteLocalBonePoses;
+
+	// Time between the bone key frames of a skeletal individual
+	float BoneKeyFrameInterval;
+
+	// Min pose difference of the skeletal individuals and of the local bone poses to be written again
+	float PoseTolerance;
+
+	// Last written skeletal individual poses and the time of their last bone key frame (negative if none)
+	TArray<FTransform> LastSkelPoses;
+	TArray<float> LastBoneKeyFrameTimes;
+
+	// Last written local bone poses (flattened layout order)
+	TArray<FTransform> LastLocalBonePoses;
+
+	// Bones to write of the current skeletal individual (reused between frames)
+	TArray<int32> BoneIdxsToWrite;
+
+	/* Upload stats */
+	int32 NumFlushes;
+	int32 NumFlushedDocs;
+	double TotalFlushSeconds;
+	double MaxFlushSeconds;
 
 #if SL_WITH_LIBMONGO_C
 	// Database collection
 	mongoc_collection_t* mongo_collection;
+
+	// Write concern of the single inserts
+	bson_t* write_opts;
+
+	// Write concern and unordered flag of the bulk inserts
+	bson_t* bulk_opts;
+
+	// Per individual trajectory buckets collection (nullptr if not written)
+	mongoc_collection_t* trj_collection;
+
+	// Documents waiting to be uploaded
+	TArray<bson_t*> batch_docs;
 #endif //SL_WITH_LIBMONGO_C	
 };
 
@@ -126,7 +230,7 @@ public:
 	~FSLWorldStateDBHandler();
 
 	// Connect to the db and set up the async writer
-	bool Init(ASLIndividualManager* IndividualManager,
+	bool Init(ASLIndividualManager* InIndividualManager,
 		const FSLWorldStateLoggerParams& InLoggerParameters,
 		const FSLLoggerLocationParams& InLocationParameters,
 		const FSLLoggerDBServerParams& InDBServerParameters);
@@ -134,22 +238,34 @@ public:
 	// Delegate first job to the async task
 	void FirstWrite(float Timestamp);
 
-	// Delegate job to the async task (true if the previous job was done)
+	// Queue the current world state and delegate the job to the async task (false if the frame was dropped)
 	bool Write(float Timestamp);
 
 	// Disconnect from db, clear task
 	void Finish();
 
 private:
+	// Snapshot the poses into a frame buffer (game thread) and apply the overflow policy if needed
+	bool EnqueueFrame(float Timestamp, bool bWriteAllIndividuals);
+
+	// Start the async writer if it is idle and there are queued frames or expired batched documents
+	void StartWriter();
+
 	// Connect to the database
 	bool Connect(const FString& DBName, const FString& CollName, const FString& ServerIp,
 		uint16 ServerPort, bool bOverwrite);
 
+	// Create the trajectory buckets collection (<episode>.trj)
+	bool CreateTrajectoryCollection(const FString& DBName, const FString& CollName, bool bOverwrite);
+
+	// Write the id table document used by the compact pose encodings and the sparse or local bone poses
+	bool WriteIdTable(ESLWorldStatePoseEncoding Encoding, float PositionResolution, bool bSparseBones, bool bLocalBonePoses);
+
 	// Write metadata
-	bool WriteMetadata(ASLIndividualManager* IndividualManager, const FString& MetaCollName, bool bOverwrite);
+	bool WriteMetadata(ASLIndividualManager* InIndividualManager, const FString& MetaCollName, bool bOverwrite);
 
 #if SL_WITH_LIBMONGO_C
-	int32 AddIndividualsMetadata(ASLIndividualManager* IndividualManager, bson_t* doc);
+	int32 AddIndividualsMetadata(ASLIndividualManager* InIndividualManager, bson_t* doc);
 #endif //SL_WITH_LIBMONGO_C	
 
 	// Disconnect and clean db connection
@@ -171,6 +287,27 @@ private:
 	// Async writing to the database
 	FAsyncTask<FSLWorldStateDBWriterAsyncTask>* DBWriterTask;
 
+	// Copies the individual poses into the frame buffers on the game thread
+	FSLWorldStateSnapshot PoseSnapshot;
+
+	// Frames waiting to be written
+	FSLWorldStateFrameQueue FrameQueue;
+
+	// Frame used for snapshots which do not fit in the queue
+	FSLWorldStateFrame OverflowFrame;
+
+	// Access to the individuals
+	ASLIndividualManager* IndividualManager;
+
+	// Pose diff tolerance
+	float MinPoseDiff;
+
+	// Write mode
+	bool bWriteSparse;
+
+	// Encoding of the poses
+	ESLWorldStatePoseEncoding PoseEncoding;
+
 #if SL_WITH_LIBMONGO_C
 	// Server uri
 	mongoc_uri_t* uri;
@@ -183,5 +320,8 @@ private:
 
 	// Database collection
 	mongoc_collection_t* collection;
+
+	// Per individual trajectory buckets collection (nullptr if not written)
+	mongoc_collection_t* trj_collection;
 #endif //SL_WITH_LIBMONGO_C	
 };
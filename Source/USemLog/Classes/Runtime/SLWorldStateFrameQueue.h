@@ -0,0 +1,173 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "HAL/ThreadSafeBool.h"
+#include "Runtime/SLLoggerStructs.h"
+
+/**
+ * Poses of one world state update, filled on the game thread and serialized by the writer,
+ * stored as structure of arrays, the ids and bone indexes are in the (constant) world state layout
+ */
+struct FSLWorldStateFrame
+{
+	// Simulation time of the frame
+	float Timestamp = 0.f;
+
+	// Layout index of the written individuals
+	TArray<int32> IndividualIndexes;
+
+	// Locations of the written individuals (same order as the indexes)
+	TArray<FVector> IndividualLocations;
+
+	// Rotations of the written individuals (same order as the indexes)
+	TArray<FQuat> IndividualRotations;
+
+	// Locations of all the skeletal individuals (layout order)
+	TArray<FVector> SkelLocations;
+
+	// Rotations of all the skeletal individuals (layout order)
+	TArray<FQuat> SkelRotations;
+
+	// Locations of all the skeletal bones (layout order, flattened)
+	TArray<FVector> BoneLocations;
+
+	// Rotations of all the skeletal bones (layout order, flattened)
+	TArray<FQuat> BoneRotations;
+
+	// Bones which moved more than the tolerance since their previous frame (layout order, flattened)
+	TBitArray<> MovedBones;
+
+	// Clear the data but keep the allocations
+	void Reset();
+
+	// True if there is nothing to write
+	bool IsEmpty() const { return IndividualIndexes.Num() == 0 && SkelLocations.Num() == 0; };
+
+	// Merge a newer frame into this one (newer poses and timestamp overwrite the current ones)
+	void Coalesce(const FSLWorldStateFrame& Newer);
+
+	// Serialization (used for spilling to disk)
+	friend FArchive& operator<<(FArchive& Ar, FSLWorldStateFrame& Frame);
+};
+
+/**
+ * Bounded single-producer (game thread) single-consumer (writer) queue of pre-allocated frames,
+ * frames that do not fit are handled using the overflow policy
+ */
+class FSLWorldStateFrameQueue
+{
+public:
+	// Ctor
+	FSLWorldStateFrameQueue();
+
+	// Dtor
+	~FSLWorldStateFrameQueue();
+
+	// Allocate the frame buffers
+	void Init(int32 InCapacity, ESLWorldStateOverflowPolicy InPolicy, const FString& InSpillFilePath);
+
+	// Get the overflow policy
+	ESLWorldStateOverflowPolicy GetOverflowPolicy() const { return OverflowPolicy; };
+
+	/* Producer (game thread) */
+	// Get the next free frame buffer (nullptr if full, or if frames are being spilled)
+	FSLWorldStateFrame* BeginWrite();
+
+	// Publish the frame returned by BeginWrite
+	void EndWrite();
+
+	// Merge the frame into the newest queued frame (false if there is no safe frame to merge into)
+	bool CoalesceIntoLast(const FSLWorldStateFrame& Frame);
+
+	// Append the frame to the spill file (false if the frame had to be dropped)
+	bool Spill(FSLWorldStateFrame& Frame);
+
+	// Count a frame that could not be stored
+	void CountDropped() { NumDropped.Increment(); };
+
+	// Count the time the producer waited for free buffers
+	void CountBlocked(double Seconds) { NumBlocked.Increment(); BlockedSeconds += Seconds; };
+
+	/* Consumer (writer) */
+	// Get the oldest queued frame and claim it until it is popped (nullptr if empty)
+	const FSLWorldStateFrame* Peek() const;
+
+	// Release the frame returned by Peek
+	void Pop();
+
+	// Move the spilled frames into a file ready to be read (false if nothing is spilled)
+	bool TakeSpill(FString& OutFilePath);
+
+	// Count a frame uploaded by the writer
+	void CountWritten() { NumWritten.Increment(); };
+
+	/* State */
+	// Number of queued frames
+	int32 Num() const { return Tail.GetValue() - Head.GetValue(); };
+
+	// True if all buffers are used
+	bool IsFull() const { return Num() >= Capacity; };
+
+	// True if there is no queued or spilled frame
+	bool IsEmpty() const { return Num() == 0 && NumPendingSpill.GetValue() == 0; };
+
+	// True if new frames go to the spill file
+	bool IsSpilling() const { return bSpilling; };
+
+	// Log the drop accounting counters
+	void LogStats(const FString& Prefix) const;
+
+private:
+	// Pre-allocated frame buffers
+	TArray<FSLWorldStateFrame> Frames;
+
+	// Number of buffers
+	int32 Capacity;
+
+	// What to do when the buffers are full
+	ESLWorldStateOverflowPolicy OverflowPolicy;
+
+	// Read position (written only by the consumer)
+	FThreadSafeCounter Head;
+
+	// Write position (written only by the producer)
+	FThreadSafeCounter Tail;
+
+	/* Coalesce */
+	// Guards the claimed position (the producer never merges into the frame read by the consumer)
+	mutable FCriticalSection ClaimLock;
+
+	// Position of the frame read by the consumer (INDEX_NONE if none)
+	mutable int32 ClaimedIdx;
+
+	/* Spill */
+	// Guards the spill file and flag
+	FCriticalSection SpillLock;
+
+	// Location of the spill file
+	FString SpillFilePath;
+
+	// Open spill file (nullptr if nothing is spilled)
+	FArchive* SpillWriter;
+
+	// Index used to create unique file names for taken spills
+	int32 SpillTakeIdx;
+
+	// Set while frames are redirected to the spill file (keeps the writing order)
+	FThreadSafeBool bSpilling;
+
+	/* Stats */
+	FThreadSafeCounter NumEnqueued;
+	FThreadSafeCounter NumWritten;
+	FThreadSafeCounter NumCoalesced;
+	FThreadSafeCounter NumSpilled;
+	FThreadSafeCounter NumPendingSpill;
+	FThreadSafeCounter NumDropped;
+	FThreadSafeCounter NumBlocked;
+	int32 MaxNum;
+	double BlockedSeconds;
+};
@@ -0,0 +1,78 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Runtime/SLWorldStateFrameQueue.h"
+
+// Forward declarations
+class ASLIndividualManager;
+class USLBaseIndividual;
+class USLSkeletalIndividual;
+
+/**
+ * Per episode constant data of the world state frames (read only after init, safe to access from the writer)
+ */
+struct FSLWorldStateLayout
+{
+	// Null terminated utf8 ids of the individuals (indexed by the frame individual indexes)
+	TArray<TArray<ANSICHAR>> IndividualIds;
+
+	// Null terminated utf8 ids of the skeletal individuals
+	TArray<TArray<ANSICHAR>> SkelIds;
+
+	// Number of bones of each skeletal individual
+	TArray<int32> SkelBoneNums;
+
+	// Bone indexes of all the skeletal individuals (flattened)
+	TArray<int32> BoneIndexes;
+
+	// Clear the data
+	void Reset();
+
+	// Get the individual id as a c string
+	const char* GetIndividualId(int32 Idx) const { return IndividualIds[Idx].GetData(); };
+
+	// Get the skeletal individual id as a c string
+	const char* GetSkelId(int32 Idx) const { return SkelIds[Idx].GetData(); };
+};
+
+/**
+ * Game thread stage copying the individual poses into flat frame buffers
+ */
+class FSLWorldStateSnapshot
+{
+public:
+	// Ctor
+	FSLWorldStateSnapshot();
+
+	// Cache the individuals and build the layout
+	bool Init(ASLIndividualManager* IndividualManager);
+
+	// Get the layout of the frames
+	const FSLWorldStateLayout& GetLayout() const { return Layout; };
+
+	// Copy the poses of the moved (or all) individuals and the poses of all skeletal bones (with their moved flags) into the frame
+	void Snapshot(FSLWorldStateFrame& Frame, float Timestamp, float Tolerance, bool bWriteAllIndividuals);
+
+private:
+	// Convert the id to a null terminated utf8 buffer
+	static void ToUTF8(const FString& Id, TArray<ANSICHAR>& OutBuffer);
+
+private:
+	// Frame constant data
+	FSLWorldStateLayout Layout;
+
+	// Individuals in the order of the layout
+	TArray<USLBaseIndividual*> Individuals;
+
+	// Skeletal slot of each individual (INDEX_NONE if it is not skeletal)
+	TArray<int32> SkelSlots;
+
+	// Flattened bone slot of each individual (INDEX_NONE if it is not a bone)
+	TArray<int32> BoneSlots;
+
+	// Skeletal individuals in the order of the layout (their bone poses are updated in one batch)
+	TArray<USLSkeletalIndividual*> SkelIndividuals;
+};
@@ -13,6 +13,7 @@
 #include "Vision/SLVisionDBHandler.h"
 #include "Vision/SLVisionMaskImageHandler.h"
 #include "Vision/SLVisionOverlapCalc.h"
+#include "Utils/SLImageWriter.h"
 
 #include "SLVisionLogger.generated.h"
 
@@ -130,8 +131,11 @@ private:
 	// Clean exit, all the Finish() methods will be triggered
 	void QuitEditor();
 	
-	// Save the compressed screenshot image locally
-	void SaveImageLocally(const TArray<uint8>& CompressedBitmap);
+	// Hand the image over to the writer, the compressed data is added to the current view when ready
+	void EnqueueImage(TArray<FColor>&& Bitmap, int32 SizeX, int32 SizeY);
+
+	// Get the path where to save the compressed screenshot image locally
+	FString GetLocalImagePath() const;
 	
 	// Output progress to terminal
 	void PrintProgress() const;
@@ -159,6 +163,9 @@ private:
 	// Gathers semantics from the images
 	FSLVisionMaskImageHandler MaskImgHandler;
 
+	// Compresses and saves the images in the background
+	FSLImageWriter ImageWriter;
+
 	// Calculates entities overlap percentages in images
 	UPROPERTY() // Avoid GC
 	USLVisionOverlapCalc* OverlapCalc;
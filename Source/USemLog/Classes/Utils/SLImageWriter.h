@@ -0,0 +1,146 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/AsyncWork.h"
+
+// Forward declarations
+class IImageWrapperModule;
+
+/**
+* Image compression formats
+*/
+UENUM()
+enum class ESLImageCodec : uint8
+{
+	PNG						UMETA(DisplayName = "PNG"),
+	JPEG					UMETA(DisplayName = "JPEG"),
+};
+
+/**
+ * Async task compressing one raw bitmap and writing it to the given files
+ */
+class FSLImageEncodeAsyncTask : public FNonAbandonableTask
+{
+public:
+	// Ctor (takes ownership of the bitmap)
+	FSLImageEncodeAsyncTask(IImageWrapperModule* InImageWrapperModule, ESLImageCodec InCodec, int32 InQuality,
+		TArray<FColor>&& InBitmap, int32 InSizeX, int32 InSizeY, TArray<FString>&& InPaths);
+
+	// Compress and write the image
+	void DoWork();
+
+	// Needed internally
+	FORCEINLINE TStatId GetStatId() const { RETURN_QUICK_DECLARE_CYCLE_STAT(FSLImageEncodeAsyncTask, STATGROUP_ThreadPoolAsyncTasks); }
+
+	// Compressed image (valid after the task is done)
+	TArray<uint8> CompressedData;
+
+	// Time spent compressing
+	double EncodeSeconds;
+
+	// Time spent writing the files
+	double IOSeconds;
+
+private:
+	// Access to the image compressors (loaded on the game thread)
+	IImageWrapperModule* ImageWrapperModule;
+
+	// Compression format
+	ESLImageCodec Codec;
+
+	// Compression quality (JPEG only)
+	int32 Quality;
+
+	// Raw image, released after compressing
+	TArray<FColor> Bitmap;
+
+	// Image resolution
+	int32 SizeX;
+	int32 SizeY;
+
+	// Files to write the compressed image to
+	TArray<FString> Paths;
+};
+
+/**
+ * Compresses the screenshots on a bounded number of worker tasks and writes them to the disk,
+ * the compressed images are handed back on the game thread in the order they were added
+ */
+class FSLImageWriter
+{
+public:
+	// Ctor
+	FSLImageWriter();
+
+	// Dtor
+	~FSLImageWriter();
+
+	// Load the compressors and set the format (game thread)
+	bool Init(ESLImageCodec InCodec = ESLImageCodec::PNG, int32 InMaxNumInFlight = 4, int32 InQuality = 90);
+
+	// Compress and write the bitmap asynchronously (takes ownership), OnCompressed is called on the game thread,
+	// blocks on the oldest image if the max number of images are already in flight
+	void Enqueue(TArray<FColor>&& Bitmap, int32 SizeX, int32 SizeY, TArray<FString>&& Paths,
+		TFunction<void(TArray<uint8>&&)> OnCompressed = nullptr);
+
+	// Hand over the finished images in order (stops at the first unfinished one), returns the number of images processed
+	int32 ProcessCompleted();
+
+	// Wait for all the images in flight and hand them over
+	void Flush();
+
+	// Flush and log the stats
+	void Finish(const FString& Prefix);
+
+	// File extension of the compressed images (including the dot)
+	FString GetFileExtension() const;
+
+	// True if initialized
+	bool IsInit() const { return bIsInit; };
+
+private:
+	// Remove the oldest image from the queue and call its callback
+	void CompleteOldest();
+
+private:
+	// An image in flight
+	struct FSLImageWriterJob
+	{
+		// Compress and write task
+		FAsyncTask<FSLImageEncodeAsyncTask>* Task;
+
+		// Called on the game thread with the compressed data
+		TFunction<void(TArray<uint8>&&)> OnCompressed;
+	};
+
+	// True if initialized
+	bool bIsInit;
+
+	// Access to the image compressors
+	IImageWrapperModule* ImageWrapperModule;
+
+	// Compression format
+	ESLImageCodec Codec;
+
+	// Compression quality (JPEG only)
+	int32 Quality;
+
+	// Max number of images in flight (bounds the memory)
+	int32 MaxNumInFlight;
+
+	// Images in flight in the order they were added
+	TArray<FSLImageWriterJob> Jobs;
+
+	// Time when the previous image was handed over by the caller (the rest is render time)
+	double LastEnqueueTime;
+
+	/* Stats */
+	int32 NumImages;
+	double TotalRenderSeconds;
+	double TotalEncodeSeconds;
+	double TotalIOSeconds;
+	double TotalWaitSeconds;
+};
@@ -0,0 +1,36 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/*
+* Compact binary pose encoding (position + smallest-three quaternion), little endian
+*	Float32:	3 x float32 position, 2 bit largest component index + 3 x 20 bit components (8 bytes)
+*	Quantized:	3 x int32 position (in PositionResolution units), 2 bit largest component index + 3 x 10 bit components (4 bytes)
+*/
+struct USEMLOG_API FSLPoseCodec
+{
+	// Size of a float32 encoded pose
+	static constexpr int32 Float32Size = 20;
+
+	// Size of a quantized encoded pose
+	static constexpr int32 QuantizedSize = 16;
+
+	// Max size of an encoded pose
+	static constexpr int32 MaxSize = Float32Size;
+
+	// Encode the pose into the buffer (at least MaxSize bytes), returns the number of written bytes
+	static int32 Encode(const FVector& Location, const FQuat& Rotation, bool bQuantized, float PositionResolution, uint8* OutData);
+
+	// Decode the pose, the encoding is deduced from the size (false if the size is not known)
+	static bool Decode(const uint8* Data, uint32 Size, float PositionResolution, FVector& OutLocation, FQuat& OutRotation);
+
+private:
+	// Pack the smallest three quaternion components using the given number of bits per component
+	static uint64 PackQuat(FQuat Rotation, int32 NumBits);
+
+	// Unpack the smallest three quaternion components
+	static FQuat UnpackQuat(uint64 Packed, int32 NumBits);
+};
@@ -55,16 +55,21 @@ private:
 	void DropPreviousEntries(const FString& DBName, const FString& CollName) const;
 
 #if SL_WITH_LIBMONGO_C
-	// Helper function to get the entities data out of the bson iterator, returns false if there are no entities
+	// Helper function to get the individuals data out of the bson iterator, returns false if there are no entities
 	bool GetEntitiesData(bson_iter_t* doc,
 		TMap<AStaticMeshActor*, FTransform>& OutEntityPoses,
 		TMap<ASLVirtualCameraView*, FTransform>& OutVirtualCameraPoses) const;
 
-	// Helper function to get the entities data out of the bson iterator, returns false if there are no entities
+	// Helper function to get the skeletal individuals data out of the bson iterator, returns false if there are no entities
+	// (the last local bone poses are carried forward and moved with the skeletal individual when the bones are local)
 	bool GetSkeletalEntitiesData(bson_iter_t* doc,
-		const TMap<ASkeletalMeshActor*, ASLVisionPoseableMeshActor*>& InSkelToPoseableMap,
+		const TMap<FString, ASLVisionPoseableMeshActor*>& InIdToPoseableMap,
+		TMap<ASLVisionPoseableMeshActor*, TMap<FName, FTransform>>& InOutLocalBonePoses,
 		TMap<ASLVisionPoseableMeshActor*, TMap<FName, FTransform>>& OutSkeletalPoses) const;
 
+	// Get the id of the array element (resolved through the given id table if the poses are compact)
+	FString GetId(const bson_iter_t* iter, const TArray<FString>& InIdTable) const;
+
 	// Save image to gridfs, get the file oid and return true if succeeded
 	bool AddToGridFs(const TArray<uint8>& InData, bson_oid_t* out_oid) const;
 
@@ -98,4 +103,19 @@ private:
 	// Store image binaries
 	mongoc_gridfs_t* gridfs;
 #endif //SL_WITH_LIBMONGO_C	
+
+	// The world state poses are binary encoded and the entities are referenced by their id table index
+	bool bCompactPoses = false;
+
+	// Position resolution of the quantized encoding
+	float PositionResolution = 0.0001f;
+
+	// Id table of the compact encoding
+	TArray<FString> IdTable;
+
+	// Skeletal id table of the compact encoding
+	TArray<FString> SkelIdTable;
+
+	// The bone poses are written relative to their skeletal individual
+	bool bLocalBones = false;
 };
@@ -79,11 +79,103 @@ struct FSLVisionImageColorInfo
 	FColor OriginalMaskColor;
 };
 
+/**
+* Rendered color data of an image stripe, the stripes are decoded independently and merged in row order
+*/
+struct FSLVisionMaskStripeColor
+{
+	// Rendered color (packed)
+	uint32 Key = 0;
+
+	// Original mask color the pixels are restored to (packed)
+	uint32 RestoredKey = 0;
+
+	// True if the color is mapped to an entity or a bone
+	bool bKnown = false;
+
+	// Number of pixels in the stripe
+	int64 Num = 0;
+
+	// Bounding box as [MinX, MinY, -MaxX, -MaxY] (all four values are updated with a single min),
+	// the first pixel of the stripe is not included (merged or skipped as the sequential restore does)
+	int32 Bounds[4];
+
+	// Position of the first pixel in the stripe
+	FIntPoint FirstPixel;
+};
+
+/**
+* Colors of an image stripe with a flat open addressing color to index table
+*/
+struct FSLVisionMaskStripeData
+{
+	// Colors in order of appearance
+	TArray<FSLVisionMaskStripeColor> Colors;
+
+	// Open addressing table of color indexes (INDEX_NONE if empty), size is a power of two
+	TArray<int32> Slots;
+
+	// Get the index of the color (INDEX_NONE if not found)
+	int32 Find(uint32 Key) const
+	{
+		const uint32 Mask = Slots.Num() - 1;
+		for (uint32 SlotIdx = Hash(Key) & Mask; ; SlotIdx = (SlotIdx + 1) & Mask)
+		{
+			const int32 ColorIdx = Slots[SlotIdx];
+			if (ColorIdx == INDEX_NONE || Colors[ColorIdx].Key == Key)
+			{
+				return ColorIdx;
+			}
+		}
+	};
+
+	// Add a new color (the key should not be in the table), returns its index
+	int32 Add(const FSLVisionMaskStripeColor& Color)
+	{
+		if ((Colors.Num() + 1) * 2 > Slots.Num())
+		{
+			Rehash(FMath::Max(Slots.Num() * 2, 256));
+		}
+		const int32 ColorIdx = Colors.Add(Color);
+		Insert(Color.Key, ColorIdx);
+		return ColorIdx;
+	};
+
+private:
+	// Fibonacci hashing of the packed color
+	static uint32 Hash(uint32 Key) { return (Key * 2654435761u) >> 7; };
+
+	// Insert the index in the first empty slot
+	void Insert(uint32 Key, int32 ColorIdx)
+	{
+		const uint32 Mask = Slots.Num() - 1;
+		uint32 SlotIdx = Hash(Key) & Mask;
+		while (Slots[SlotIdx] != INDEX_NONE)
+		{
+			SlotIdx = (SlotIdx + 1) & Mask;
+		}
+		Slots[SlotIdx] = ColorIdx;
+	};
+
+	// Resize the table and re-insert the colors
+	void Rehash(int32 NewNum)
+	{
+		Slots.Init(INDEX_NONE, NewNum);
+		for (int32 ColorIdx = 0; ColorIdx < Colors.Num(); ++ColorIdx)
+		{
+			Insert(Colors[ColorIdx].Key, ColorIdx);
+		}
+	};
+};
+
 /**
  * 
  */
 class FSLVisionMaskImageHandler
 {
+	// Compares the stripe decoder against the sequential restore on fixed images
+	friend class FSLVisionMaskImageHandlerEquivalenceTest;
+
 public:
 	// Ctor
 	FSLVisionMaskImageHandler();
@@ -98,6 +190,13 @@ public:
 	void GetDataAndRestoreImage(TArray<FColor>& MaskBitmap, int32 ImgWidth, int32 ImgHeight, FSLVisionViewData& OutViewData) const;
 
 private:
+	// Restore the pixels of the rows and collect the colors data of the stripe
+	void DecodeStripe(uint32* Pixels, int32 NumPixels, int32 ImgWidth, int32 ImgHeight,
+		int32 FirstRow, int32 EndRow, FSLVisionMaskStripeData& OutStripeData) const;
+
+	// Get the original mask color of the rendered color (false if the color is not mapped to any entity)
+	bool GetOriginalMaskColor(const FColor& RenderedColor, FColor& OutOriginalMaskColor) const;
+
 	/* Helper functions */
 	// Restore the color of the pixel to its original mask value (offseted by screenshot rendering artifacts), returns true if restoration happened
 	bool RestoreColorValueFromArray(FColor& PixelColor, const TArray<FColor>& InOriginalMaskColors, uint8 Tolerance = 13) const;
@@ -183,4 +183,10 @@ private:
 
 	// Current frame index from the vision logger
 	int32 CurrFrameIdx;
+
+	/* Throughput stats */
+	double CurrFrameStartTime;
+	int32 NumCalculatedFrames;
+	int32 NumCalculatedScreenshots;
+	double TotalCalcSeconds;
 };
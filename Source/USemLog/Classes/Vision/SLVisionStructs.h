@@ -7,6 +7,7 @@
 #include "Engine/StaticMeshActor.h"
 #include "Vision/SLVisionPoseableMeshActor.h"
 #include "Vision/SLVirtualCameraView.h"
+#include "Utils/SLImageWriter.h"
 
 /**
 * View modes
@@ -43,6 +44,9 @@ struct FSLVisionLoggerParams
 	// Make screenshots for calculating overlaps smaller for faster logging
 	uint8 OverlapResolutionDivisor;
 
+	// Compression format of the images
+	ESLImageCodec ImageCodec = ESLImageCodec::PNG;
+
 	// Default ctor
 	FSLVisionLoggerParams() {};
 
@@ -12,6 +12,38 @@
 class USkeletalMesh;
 class UPoseableMeshComponent;
 
+/**
+ * Hidden poseable mesh components kept for reuse by the skeletal markers,
+ * avoids creating and registering new components for every visualized trajectory
+ */
+USTRUCT()
+struct USEMLOG_API FSLVizPoseableMeshPool
+{
+	GENERATED_BODY()
+
+	// Get a visible component with the mesh and materials of the reference (reuse a hidden one if available)
+	UPoseableMeshComponent* Acquire(UObject* Outer, UPoseableMeshComponent* Reference);
+
+	// Hide the component and keep it for reuse (destroyed if the pool is full)
+	void Release(UPoseableMeshComponent* PMC);
+
+	// Destroy the hidden components
+	void Empty();
+
+	// Max number of hidden components kept for reuse
+	int32 MaxNumFree = 512;
+
+	// Number of components created by the pool
+	int32 NumCreated = 0;
+
+	// Number of times a hidden component was reused
+	int32 NumReused = 0;
+
+	// Hidden components ready for reuse
+	UPROPERTY(Transient)
+	TArray<UPoseableMeshComponent*> FreeComponents;
+};
+
 /**
  * Class capable of visualizing skeletal meshes as arrays of poseable meshes
  */
@@ -49,6 +81,17 @@ public:
 	void AddInstances(const TArray<TPair<FTransform, TMap<int32, FTransform>>>& SkeletalPoses,
 		const FSLVizTimelineParams& TimelineParams);
 
+	// Only keep the key poses of the added trajectories (max number of instances and/or max deviation in cm, negative values ignored), timelines keep all the poses
+	void SetKeyPoseParams(int32 InMaxNumKeyPoses, float InKeyPoseTolerance);
+
+	// Reuse hidden poseable mesh components from the pool instead of creating new ones (nullptr to disable)
+	void SetPoseableMeshPool(FSLVizPoseableMeshPool* InPool) { PMCPool = InPool; };
+
+	// Select the poses which deviate the most from the interpolation of their neighbouring key poses,
+	// the first and last poses are always kept, stops at the max number of key poses or if the deviation is below the tolerance
+	static void SelectKeyPoses(const TArray<TPair<FTransform, TMap<int32, FTransform>>>& SkeletalPoses,
+		int32 MaxNumKeyPoses, float Tolerance, TArray<int32>& OutIndexes);
+
 	//~ Begin ActorComponent Interface
 	// Unregister the component, remove it from its outer Actor's Components array and mark for pending kill
 	virtual void DestroyComponent(bool bPromoteChildren = false) override;
@@ -90,6 +133,13 @@ protected:
 	// Create poseable mesh component instance attached and registered to this marker
 	UPoseableMeshComponent* CreateNewPoseableMeshInstance();
 
+	// Return the instance to the pool, or destroy it if there is no pool
+	void ReleasePoseableMeshInstance(UPoseableMeshComponent* PMC);
+
+	// Apply the key pose selection to the poses (returns false if all the poses are kept)
+	bool GetKeyPoses(const TArray<TPair<FTransform, TMap<int32, FTransform>>>& SkeletalPoses,
+		TArray<TPair<FTransform, TMap<int32, FTransform>>>& OutKeyPoses) const;
+
 protected:
 	// Poseable mesh reference
 	UPROPERTY()
@@ -101,4 +151,13 @@ protected:
 
 	// Timeline poses
 	TArray<TPair<FTransform, TMap<int32, FTransform>>> TimelinePoses;
+
+	// Max number of key poses to visualize from a trajectory (negative values ignored)
+	int32 MaxNumKeyPoses;
+
+	// Poses closer than this (cm) to the interpolation of the neighbouring key poses are skipped (negative values ignored)
+	float KeyPoseTolerance;
+
+	// Shared pool of hidden poseable mesh components (owned by the marker manager)
+	FSLVizPoseableMeshPool* PMCPool;
 };
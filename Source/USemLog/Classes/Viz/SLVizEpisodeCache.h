@@ -0,0 +1,116 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Viz/SLVizEpisodeManager.h"
+#include "HAL/ThreadSafeBool.h"
+
+/**
+ * Called on the game thread when an episode fetch finished (the episode is cached if the fetch succeeded)
+ */
+using FSLVizEpisodeCachedCallback = TFunction<void(const FString& /*EpisodeId*/, bool /*bSuccess*/)>;
+
+/**
+ * Replay episodes cache with a memory budget (least recently used episodes are evicted first),
+ * the episodes can be fetched and converted on worker threads, each with its own database connection
+ */
+class FSLVizEpisodeCache
+{
+public:
+	// Ctor
+	FSLVizEpisodeCache();
+
+	// Dtor
+	~FSLVizEpisodeCache();
+
+	// Set the memory budget (evicts episodes if needed) and the number of episodes fetched in parallel
+	void SetLimits(float InMemoryBudgetMB, int32 InMaxNumConcurrentFetches);
+
+	// Check if the episode is cached
+	bool Contains(const FString& Id) const { return Entries.Contains(Id); };
+
+	// Check if the episode is being fetched or waiting to be fetched
+	bool IsFetching(const FString& Id) const;
+
+	// Add the episode (evicts the least recently used episodes if the budget is exceeded)
+	void Add(const FString& Id, FSLVizEpisodeData&& Data);
+
+	// Get the episode and mark it as the most recently used one (nullptr if not cached)
+	const FSLVizEpisodeData* Get(const FString& Id);
+
+	// Fetch and convert the episodes in the background, the handles need to be resolved beforehand on the game thread
+	void FetchAsync(const FString& ServerIp, uint16 ServerPort, const FString& TaskId, const TArray<FString>& EpisodeIds,
+		TSharedRef<const FSLVizEpisodeHandleTable, ESPMode::ThreadSafe> HandleTable,
+		FSLVizEpisodeCachedCallback OnCached = nullptr);
+
+	// Remove all cached episodes, drop the fetches waiting to be started and discard the results of the running ones
+	void Empty();
+
+	// Approximate memory used by the cached episodes (in bytes)
+	SIZE_T GetUsedMemory() const { return UsedBytes; };
+
+private:
+	// Episode waiting to be fetched
+	struct FSLVizEpisodeFetch
+	{
+		FString ServerIp;
+		uint16 ServerPort;
+		FString TaskId;
+		FString EpisodeId;
+		TSharedPtr<const FSLVizEpisodeHandleTable, ESPMode::ThreadSafe> HandleTable;
+		FSLVizEpisodeCachedCallback OnCached;
+		uint32 Generation;
+	};
+
+	// Cached episode with its size
+	struct FSLVizEpisodeCacheEntry
+	{
+		FSLVizEpisodeData Data;
+		SIZE_T Size;
+	};
+
+	// Start fetches until the concurrency limit is reached
+	void StartPendingFetches();
+
+	// Fetch and convert the episode (worker thread)
+	static bool FetchEpisode(const FSLVizEpisodeFetch& Fetch, FSLVizEpisodeData& OutData);
+
+	// Cache the fetched episode and start the next fetch (game thread)
+	void OnFetchFinished(const FSLVizEpisodeFetch& Fetch, TSharedPtr<FSLVizEpisodeData, ESPMode::ThreadSafe> Data, bool bSuccess);
+
+	// Evict the least recently used episodes until the given number of bytes fit in the budget
+	void EvictToFit(SIZE_T NumBytes);
+
+private:
+	// Cached episodes
+	TMap<FString, FSLVizEpisodeCacheEntry> Entries;
+
+	// Cached episode ids, least recently used first
+	TArray<FString> UsageOrder;
+
+	// Approximate memory used by the cached episodes
+	SIZE_T UsedBytes;
+
+	// Memory budget of the cached episodes
+	SIZE_T BudgetBytes;
+
+	// Max number of episodes fetched in parallel (bounds the memory of the raw database data)
+	int32 MaxNumConcurrentFetches;
+
+	// Episodes waiting to be fetched
+	TArray<FSLVizEpisodeFetch> PendingFetches;
+
+	// Episodes being fetched (since the last empty)
+	TArray<FString> ActiveFetchIds;
+
+	// Number of running fetches, including the discarded ones (bounds the concurrency)
+	int32 NumActiveFetches;
+
+	// Incremented on empty, the results of the fetches started before are discarded
+	uint32 FetchGeneration;
+
+	// Unset in the dtor, the worker results are dropped if the cache no longer exists
+	TSharedRef<FThreadSafeBool, ESPMode::ThreadSafe> bIsAlive;
+};
@@ -0,0 +1,66 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Forward declarations
+struct FSLVizEpisodeData;
+struct FSLVizEpisodeHandleTable;
+
+/**
+ * State of the episode collection the file was written from (the file is invalid if it changes)
+ */
+struct FSLVizEpisodeFileFingerprint
+{
+	// Number of documents in the collection
+	int64 NumDocs = 0;
+
+	// Last world state timestamp in the collection
+	double LastTs = -1.0;
+
+	// Ctor
+	FSLVizEpisodeFileFingerprint() {};
+
+	// Init ctor
+	FSLVizEpisodeFileFingerprint(int64 InNumDocs, double InLastTs) : NumDocs(InNumDocs), LastTs(InLastTs) {};
+
+	// Check if the fingerprint was read from the database
+	bool IsValid() const { return NumDocs > 0; };
+
+	// Compare the fingerprints
+	bool operator==(const FSLVizEpisodeFileFingerprint& Other) const { return NumDocs == Other.NumDocs && LastTs == Other.LastTs; };
+};
+
+/**
+ * Local binary copy of the mongo episode data, avoids re-querying the database in later sessions
+ *	Header:		magic, version, fingerprint, number of ids, frames and chunks, frames per chunk, section offsets
+ *	Ids:		id table (int32 length + utf8 chars), the poses reference the ids by their index
+ *	Timestamps:	float32 array
+ *	Chunks:		offset and size of every chunk, followed by the chunks holding FramesPerChunk frames each
+ *	Frame:		int32 number of poses + packed poses (int32 id index, 3 x float32 location, 4 x float32 quaternion)
+ * The chunks are memory mapped one at a time when reading (the pages are loaded lazily by the OS)
+ */
+struct USEMLOG_API FSLVizEpisodeFile
+{
+	// Identifies the file type
+	static constexpr uint32 Magic = 0x50454C53; // "SLEP"
+
+	// Increased when the layout changes (older files are rewritten)
+	static constexpr uint32 Version = 1;
+
+	// Number of frames stored in a chunk
+	static constexpr int32 FramesPerChunk = 1024;
+
+	// Get the local file path of the episode
+	static FString GetPath(const FString& TaskId, const FString& EpisodeId);
+
+	// Write the mongo episode data to the file (written to a temporary file first, then renamed)
+	static bool Write(const FString& Path, const FSLVizEpisodeFileFingerprint& Fingerprint,
+		const TArray<TPair<float, TMap<FString, FTransform>>>& InMongoEpisodeData);
+
+	// Build the replay episode data from the file if it exists and matches the fingerprint (the handles are resolved beforehand)
+	static bool Read(const FString& Path, const FSLVizEpisodeFileFingerprint& Fingerprint,
+		const FSLVizEpisodeHandleTable& ResolvedHandleTable, FSLVizEpisodeData& OutVizEpisodeData);
+};
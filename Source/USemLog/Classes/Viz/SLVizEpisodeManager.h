@@ -11,6 +11,8 @@
 // Forward declaration
 class UPoseableMeshComponent;
 class APlayerController;
+class ASLIndividualManager;
+class FSLMongoEpisodeStreamer;
 
 /*
 * Holds the poses of all the individuals in the world
@@ -25,37 +27,129 @@ struct FSLVizEpisodeFrameData
 };
 
 /*
-* Holds the frames from the recorded episode
+* Replay target kind of an individual
+*/
+enum class ESLVizEpisodeHandleKind : uint8
+{
+	None,
+	Actor,
+	Bone,
+	VirtualBone
+};
+
+/*
+* Individual ids resolved once per episode into dense integer handles with their pre-classified replay targets
+*/
+struct FSLVizEpisodeHandleTable
+{
+	// Id to handle (INDEX_NONE for unknown individuals, so they are only looked up once)
+	TMap<FString, int32> IdToHandle;
+
+	// Kind of the target (handle indexed, None for individuals which are not replayed)
+	TArray<ESLVizEpisodeHandleKind> Kinds;
+
+	// Target actors (handle indexed, nullptr for bones)
+	TArray<AActor*> Actors;
+
+	// Target poseable mesh components (handle indexed, nullptr for actors)
+	TArray<UPoseableMeshComponent*> PoseableMeshes;
+
+	// Target bone indexes (handle indexed, INDEX_NONE for actors)
+	TArray<int32> BoneIndexes;
+
+	// Number of handles
+	int32 Num() const { return Kinds.Num(); };
+
+	// Add the pose of the handle target to the frame
+	void AddPose(int32 Handle, const FTransform& Pose, FSLVizEpisodeFrameData& OutFrame) const
+	{
+		if (Kinds[Handle] == ESLVizEpisodeHandleKind::Actor)
+		{
+			OutFrame.ActorPoses.Emplace(Actors[Handle], Pose);
+		}
+		else if (Kinds[Handle] != ESLVizEpisodeHandleKind::None)
+		{
+			OutFrame.BonePoses.FindOrAdd(PoseableMeshes[Handle]).Add(BoneIndexes[Handle], Pose);
+		}
+	};
+
+	// Clear all the handles
+	void Empty()
+	{
+		IdToHandle.Empty();
+		Kinds.Empty();
+		Actors.Empty();
+		PoseableMeshes.Empty();
+		BoneIndexes.Empty();
+	};
+};
+
+/*
+* Holds the frames from the recorded episode as keyframes (full snapshots every KeyFrameInterval frames) and deltas
 */
 struct FSLVizEpisodeData
 {
 	// Id of the episode
 	FString Id;
 
+	// Number of frames between two keyframes
+	int32 KeyFrameInterval = 64;
+
 	// Array of the timestamps
 	TArray<float> Timestamps;
 
-	// Array of the compact frames (used for fast gotos)
-	TArray<FSLVizEpisodeFrameData> FullFrames;
+	// Array of the full frames at every KeyFrameInterval frame (used for fast gotos)
+	TArray<FSLVizEpisodeFrameData> KeyFrames;
 
-	// Array of the compact frames (used for fast replays)
+	// Array of the compact frames, the changes from the previous frame (used for fast replays)
 	TArray<FSLVizEpisodeFrameData> CompactFrames;
 
 	// Default ctor
 	FSLVizEpisodeData() {};
 
 	// Reserve array size ctor
-	FSLVizEpisodeData(int32 ArraySize)
+	FSLVizEpisodeData(int32 ArraySize, int32 InKeyFrameInterval = 64) : KeyFrameInterval(FMath::Max(InKeyFrameInterval, 1))
 	{
 		Timestamps.Reserve(ArraySize);
-		FullFrames.Reserve(ArraySize);
+		KeyFrames.Reserve(ArraySize / KeyFrameInterval + 1);
 		CompactFrames.Reserve(ArraySize);
 	};
 
 	// Check if there is data in the episode and it is in sync
 	bool IsValid() const 
 	{
-		return Timestamps.Num() > 2 && Timestamps.Num() == FullFrames.Num();
+		return Timestamps.Num() > 2 && Timestamps.Num() == CompactFrames.Num()
+			&& KeyFrames.Num() == (Timestamps.Num() - 1) / KeyFrameInterval + 1;
+	};
+
+	// True if a keyframe is stored for the given frame
+	bool IsKeyFrame(int32 FrameIndex) const { return FrameIndex % KeyFrameInterval == 0; };
+
+	// Index of the keyframe at or before the given frame
+	int32 GetKeyFrameIndex(int32 FrameIndex) const { return FrameIndex / KeyFrameInterval; };
+
+	// Approximate memory used by the frames (in bytes)
+	SIZE_T GetAllocatedSize() const
+	{
+		auto GetFrameSize = [](const FSLVizEpisodeFrameData& Frame)
+		{
+			SIZE_T Size = Frame.ActorPoses.GetAllocatedSize() + Frame.BonePoses.GetAllocatedSize();
+			for (const auto& Pair : Frame.BonePoses)
+			{
+				Size += Pair.Value.GetAllocatedSize();
+			}
+			return Size;
+		};
+		SIZE_T Size = Timestamps.GetAllocatedSize() + KeyFrames.GetAllocatedSize() + CompactFrames.GetAllocatedSize();
+		for (const auto& Frame : KeyFrames)
+		{
+			Size += GetFrameSize(Frame);
+		}
+		for (const auto& Frame : CompactFrames)
+		{
+			Size += GetFrameSize(Frame);
+		}
+		return Size;
 	};
 
 	// Clear all the data in the episode
@@ -63,7 +157,7 @@ struct FSLVizEpisodeData
 	{
 		Id = "";
 		Timestamps.Empty(); 
-		FullFrames.Empty();
+		KeyFrames.Empty();
 		CompactFrames.Empty();
 	};
 };
@@ -122,6 +216,13 @@ public:
 	// Play the episode timeline
 	bool PlayTimeline(float StartTime, float EndTime);
 
+	// Play the frames from the episode streamer (the episode does not need to be loaded)
+	bool PlayStream(TSharedPtr<FSLMongoEpisodeStreamer> InEpisodeStreamer, ASLIndividualManager* InIndividualManager,
+		const FSLVizEpisodePlayParams& PlayParams = FSLVizEpisodePlayParams());
+
+	// True if the replay frames are streamed
+	bool IsStreaming() const { return EpisodeStreamer.IsValid(); };
+
 	// Set replay parameters (loop replay, frame update rate, number of steps per frame)
 	void SetReplayParams(bool bLoop, float UpdateRate = -1.f, int32 StepSize = 1);
 
@@ -138,9 +239,18 @@ private:
 	// Apply frame poses
 	void ApplyPoses(const FSLVizEpisodeFrameData& Frame);
 
+	// Merge the changes of the given frame into the accumulated changes
+	static void MergeFrameChanges(const FSLVizEpisodeFrameData& Changes, FSLVizEpisodeFrameData& OutAccumulated);
+
 	// Apply next frame changes (return false if there are no more frames)
 	bool ApplyNextFrameChanges();
 
+	// Apply the next streamed frame (return false if there are no more frames)
+	bool ApplyNextStreamedFrame();
+
+	// Stop the streamer and clear the streaming data
+	void ClearStream();
+
 	// Calculate an approximation of the update rate value to coincide with realtime
 	void CalcRealtimeAproxUpdateRateValue(int32 MaxNumSteps);
 
@@ -174,6 +284,18 @@ protected:
 
 	// Default replay update rate
 	float EpisodeDefaultUpdateRate;
+
+	// Prefetches the frames when streaming (invalid if the cached episode data is replayed)
+	TSharedPtr<FSLMongoEpisodeStreamer> EpisodeStreamer;
+
+	// Used to map the streamed individual ids to actors and bones
+	ASLIndividualManager* StreamIndividualManager;
+
+	// Number of streamed frames with unknown individuals
+	int32 NumStreamFramesWithUnknownIds;
+
+	// Resolved individuals of the streamed frames
+	FSLVizEpisodeHandleTable StreamHandleTable;
 };
 
 
@@ -11,6 +11,8 @@ class UWorld;
 class AActor;
 class ASLIndividualManager;
 struct FSLVizEpisodeData;
+struct FSLVizEpisodeFrameData;
+struct FSLVizEpisodeHandleTable;
 
 /**
  * Viz visual parameters (color and material type)
@@ -29,10 +31,38 @@ public:
 		const TArray<TPair<float, TMap<FString, FTransform>>>& InMongoEpisodeData,
 		FSLVizEpisodeData& OutVizEpisodeData);
 
+	// Build the full replay episode data using already resolved handles (does not access the individuals, safe to call from worker threads)
+	static bool BuildEpisodeData(const FSLVizEpisodeHandleTable& ResolvedHandleTable,
+		const TArray<TPair<float, TMap<FString, FTransform>>>& InMongoEpisodeData,
+		FSLVizEpisodeData& OutVizEpisodeData);
+
+	// Build the full replay episode data from frames of handle poses (GetFrame returns false on errors)
+	static bool BuildEpisodeData(const FSLVizEpisodeHandleTable& HandleTable, int32 NumFrames,
+		TFunctionRef<bool(int32 /*FrameIndex*/, float& /*OutTs*/, TArray<TPair<int32, FTransform>>& /*OutHandlePoses*/)> GetFrame,
+		FSLVizEpisodeData& OutVizEpisodeData);
+
+	// Resolve the handles of all the individuals from the manager (game thread)
+	static void BuildHandleTable(ASLIndividualManager* IndividualManager, FSLVizEpisodeHandleTable& OutHandleTable);
+
+	// Build the replay frame data from a single mongo frame (returns false if some individuals are unknown)
+	static bool BuildFrameData(ASLIndividualManager* IndividualManager,
+		FSLVizEpisodeHandleTable& HandleTable,
+		const TMap<FString, FTransform>& InMongoFrameData,
+		FSLVizEpisodeFrameData& OutFrameData);
+
+	// Get the handle of the individual, resolve and classify it on the first call (INDEX_NONE if it is unknown or not replayable)
+	static int32 GetOrAddHandle(ASLIndividualManager* IndividualManager, const FString& Id, FSLVizEpisodeHandleTable& HandleTable);
+
 	// Executes a binary search for element Item in array Array using the <= operator (from ProfilerCommon::FBinaryFindIndex)
 	static int32 BinarySearchLessEqual(const TArray<float>& Array, float Value);
 
 private:
+	// Build the episode data, the handles are provided by the given function
+	static bool BuildEpisodeData(const FSLVizEpisodeHandleTable& HandleTable,
+		TFunctionRef<int32(const FString&)> GetHandle,
+		const TArray<TPair<float, TMap<FString, FTransform>>>& InMongoEpisodeData,
+		FSLVizEpisodeData& OutVizEpisodeData);
+
 	// Check if actor requires any special attention when switching to visual only world (return true if the components should be left alone)
 	static bool IsSpecialCaseActor(AActor* Actor);
 
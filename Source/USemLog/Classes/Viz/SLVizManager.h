@@ -7,6 +7,8 @@
 #include "GameFramework/Info.h"
 #include "Viz/SLVizStructs.h"
 #include "Viz/SLVizEpisodeManager.h"
+#include "Viz/SLVizEpisodeCache.h"
+#include "Viz/SLVizEpisodeFile.h"
 #include "SLVizManager.generated.h"
 
 // Forward declarations
@@ -14,6 +16,7 @@ class ASLVizHighlightManager;
 class ASLVizMarkerManager;
 //class ASLVizEpisodeManager;
 class ASLIndividualManager;
+class FSLMongoEpisodeStreamer;
 class ASLVizCameraDirector;
 class USLVizBaseMarker;
 class UMeshComponent;
@@ -164,8 +167,22 @@ public:
 	// Cache the mongo data into an episode format
 	bool CacheEpisodeData(const FString& Id, const TArray<TPair<float, TMap<FString, FTransform>>>& InMongoEpisodeData);
 
+	// Cache the mongo data into an episode format and store it in the local episode file for later sessions
+	bool CacheEpisodeData(const FString& TaskId, const FString& Id, const FSLVizEpisodeFileFingerprint& Fingerprint,
+		const TArray<TPair<float, TMap<FString, FTransform>>>& InMongoEpisodeData);
+
+	// Cache the episode from the local episode file (false if it is missing or outdated)
+	bool CacheEpisodeDataFromFile(const FString& TaskId, const FString& Id, const FSLVizEpisodeFileFingerprint& Fingerprint);
+
+	// Fetch and cache the episodes in the background (OnCached is called on the game thread for every episode)
+	bool CacheEpisodesAsync(const FString& ServerIp, uint16 ServerPort, const FString& TaskId, const TArray<FString>& EpisodeIds,
+		FSLVizEpisodeCachedCallback OnCached = nullptr);
+
 	// Check if the episode is already cached
-	bool IsEpisodeCached(const FString& Id) const { return CachedEpisodeData.Contains(Id); };
+	bool IsEpisodeCached(const FString& Id) const { return EpisodeCache.Contains(Id); };
+
+	// Check if the episode is being fetched in the background
+	bool IsEpisodeCaching(const FString& Id) const { return EpisodeCache.IsFetching(Id); };
 
 	// Load cached episode data
 	bool LoadCachedEpisodeData(const FString& Id);
@@ -176,6 +193,9 @@ public:
 	// Goto cached episode frame
 	bool GotoCachedEpisodeFrame(const FString& Id, float Ts);
 
+	// Replay the frames from the episode streamer (no caching needed)
+	bool ReplayEpisodeStream(TSharedPtr<FSLMongoEpisodeStreamer> EpisodeStreamer, const FSLVizEpisodePlayParams& Params = FSLVizEpisodePlayParams());
+
 	// Change the data into an episode format and load it to the episode replay manager
 	void LoadEpisodeData(const TArray<TPair<float, TMap<FString, FTransform>>>& InCompactEpisodeData);
 
@@ -265,6 +285,14 @@ private:
 
 
 	/* Cached data */
+	// Memory budget of the cached episodes, the least recently used ones are evicted first
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger|Cache")
+	float EpisodeCacheBudgetMB = 4096.f;
+
+	// Number of episodes fetched and converted in parallel when caching in the background
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger|Cache")
+	int32 MaxNumConcurrentEpisodeFetches = 4;
+
 	// Episode id to viz episode data
-	TMap<FString, FSLVizEpisodeData> CachedEpisodeData;
+	FSLVizEpisodeCache EpisodeCache;
 };
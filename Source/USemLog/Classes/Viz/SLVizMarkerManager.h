@@ -36,6 +36,13 @@ public:
 	// Clear all markers
 	void ClearAllMarkers();
 
+	// Only visualize the key poses of the skeletal trajectories created from now on (negative values disable the selection)
+	void SetSkeletalKeyPoseParams(int32 InMaxNumKeyPoses, float InKeyPoseTolerance)
+	{
+		SkeletalMaxNumKeyPoses = InMaxNumKeyPoses;
+		SkeletalKeyPoseTolerance = InKeyPoseTolerance;
+	};
+
 
 	/* Static mesh markers */
 	// Create a static mesh visual marker at the given pose (use original material)
@@ -142,8 +149,23 @@ private:
 		return Marker;
 	}
 
+	// Create a skeletal marker using the shared poseable mesh pool and the key pose parameters
+	USLVizSkeletalMeshMarker* CreateAndAddNewSkeletalMarker();
+
 protected:
 	// Collection of the markers
 	UPROPERTY(VisibleAnywhere, Transient, Category = "Semantic Logger")
 	TSet<USLVizBaseMarker*> Markers;
+
+	// Max number of key poses visualized from a skeletal trajectory (negative values ignored, opt-in)
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger|Skeletal")
+	int32 SkeletalMaxNumKeyPoses;
+
+	// Skeletal trajectory poses closer than this (cm) to the interpolation of their neighbouring key poses are skipped (negative values ignored)
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger|Skeletal")
+	float SkeletalKeyPoseTolerance;
+
+	// Hidden poseable mesh components reused by the skeletal markers
+	UPROPERTY(Transient)
+	FSLVizPoseableMeshPool PoseableMeshPool;
 };
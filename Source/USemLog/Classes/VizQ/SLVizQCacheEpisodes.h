@@ -28,4 +28,8 @@ protected:
 
 	UPROPERTY(EditAnywhere, Category = "Cache Episodes")
 	TArray<FString> Episodes;
+
+	// Fetch and convert the episodes in parallel in the background (the following queries do not wait for the episodes)
+	UPROPERTY(EditAnywhere, Category = "Cache Episodes")
+	bool bAsync = false;
 };
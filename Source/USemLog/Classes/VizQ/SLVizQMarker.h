@@ -80,6 +80,10 @@ public:
 	UPROPERTY(EditAnywhere, Category = "Marker|Data", meta = (editcondition = "Type==ESLVizQMarkerType::Trajectory || Type==ESLVizQMarkerType::Timeline"))
 	float DeltaT = -1.f;
 
+	// Skeletal trajectory bones to read (all if empty)
+	UPROPERTY(EditAnywhere, Category = "Marker|Data", meta = (editcondition = "MeshType==ESLVizQMarkerMeshType::SkeletalMesh"))
+	TArray<int32> BoneIndexes;
+
 
 	/* Timeline */
 	UPROPERTY(EditAnywhere, Category = "Marker|Data", meta = (editcondition = "Type==ESLVizQMarkerType::Timeline"))
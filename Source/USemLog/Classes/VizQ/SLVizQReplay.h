@@ -60,6 +60,10 @@ protected:
 	UPROPERTY(EditAnywhere, Category = "Replay", meta = (editcondition = "Type==ESLVizQReplayType::Replay"))
 	int32 StepSize = 1;
 
+	// Stream the frames from the database instead of caching the whole episode (replay starts without waiting for the episode)
+	UPROPERTY(EditAnywhere, Category = "Replay", meta = (editcondition = "Type==ESLVizQReplayType::Replay"))
+	bool bStream = false;
+
 
 	/* Manual interaction */
 	UPROPERTY(EditAnywhere, Category = "Manual Interaction|Replay", meta = (editcondition = "Type==ESLVizQReplayType::Replay"))
@@ -277,6 +277,9 @@ void ASLCVScanner::Init()
 	// Bind screenshot callback
 	ViewportClient->OnScreenshotCaptured().AddUObject(this, &ASLCVScanner::ScreenshotCapturedCallback);
 
+	// Compress and save the images in the background
+	ImageWriter.Init(ImageCodec);
+
 	bIsInit = true;
 	UE_LOG(LogTemp, Warning, TEXT("%s::%d %s succesfully initialized.."),
 		*FString(__FUNCTION__), __LINE__, *GetName());
@@ -367,6 +370,9 @@ void ASLCVScanner::Finish(bool bForced)
 		return;
 	}
 
+	// Wait for the images in flight and log the timings
+	ImageWriter.Finish(GetName());
+
 	bIsStarted = false;
 	bIsInit = false;
 	bIsFinished = true;
@@ -410,28 +416,14 @@ void ASLCVScanner::ScreenshotCapturedCallback(int32 SizeX, int32 SizeY, const TA
 		PrintProgress();
 	}
 
-	// Compressed image
-	TArray<uint8> CompressedBitmap;
-
-	// Check if the background should be replaced or not
-	if (bReplaceBackgroundPixels)
-	{
-		// Switch pixel colors (switch black background color with a custom one)
-		TArray<FColor> NewImage  = FSLCVUtils::ReplacePixels(InBitmap, FColor::Black, CustomBackgroundColor, CustomBackgroundColorTolerance);
-
-		// Compress the modified image
-		FImageUtils::CompressImageArray(SizeX, SizeY, NewImage, CompressedBitmap);
-	}
-	else
-	{
-		// Compress the original image
-		FImageUtils::CompressImageArray(SizeX, SizeY, InBitmap, CompressedBitmap);
-	}
-
-	// Check if the image should be stored locally
+	// Check if the image should be stored locally, the writer compresses and saves a copy of the bitmap in the background
 	if (bSaveToFile)
 	{
-		SaveToFile(CompressedBitmap);
+		// Check if the background should be replaced or not (switch black background color with a custom one)
+		TArray<FColor> Image = bReplaceBackgroundPixels
+			? FSLCVUtils::ReplacePixels(InBitmap, FColor::Black, CustomBackgroundColor, CustomBackgroundColorTolerance)
+			: InBitmap;
+		ImageWriter.Enqueue(MoveTemp(Image), SizeX, SizeY, GetImageFilePaths());
 	}
 
 	// Set and trigger the next shot
@@ -1343,20 +1335,24 @@ void ASLCVScanner::PrintProgress() const
 		CurrScan, TotalNumScans);
 }
 
-// Save image to file
-void ASLCVScanner::SaveToFile(const TArray<uint8>& CompressedBitmap) const
+// Get the file paths of the current image
+TArray<FString> ASLCVScanner::GetImageFilePaths() const
 {
+	TArray<FString> Paths;
+	const FString Extension = ImageWriter.GetFileExtension();
+
 	//const FString TaskFolderPath = TaskId + "/Scans/" + IndividualId + "/" + ViewModeString + "/";
 	const FString TaskFolderPath = "/SL/" + TaskId + "/Scans/" + SceneNameString + /*"/" + ViewModeString*/ + "/";
-	FString Path = FPaths::ProjectDir() + TaskFolderPath + CurrImageName + ".png";
+	FString Path = FPaths::ProjectDir() + TaskFolderPath + CurrImageName + Extension;
 	FPaths::RemoveDuplicateSlashes(Path);
-	FFileHelper::SaveArrayToFile(CompressedBitmap, *Path);
+	Paths.Emplace(Path);
 
 	// Include image in a folder with all of them mixed
 	int32 CurrMixedIdx = CameraPoseIdx * RenderModes.Num() + RenderModeIdx + 1;
 	const FString CurrMixedImageName = "A/img" + FString::FromInt(10000 + CurrMixedIdx); //ffmpg friendly
 
-	FString MixedPath = FPaths::ProjectDir() + TaskFolderPath + CurrMixedImageName + ".png";
+	FString MixedPath = FPaths::ProjectDir() + TaskFolderPath + CurrMixedImageName + Extension;
 	FPaths::RemoveDuplicateSlashes(MixedPath);
-	FFileHelper::SaveArrayToFile(CompressedBitmap, *MixedPath);
+	Paths.Emplace(MixedPath);
+	return Paths;
 }
@@ -29,9 +29,6 @@ bool FSLAssetDBHandler::Connect(const FString& DBName, const FString& ServerIp,
 	const FString CollName = DBName + ".assets";
 
 #if SL_WITH_LIBMONGO_C
-	// Required to initialize libmongoc's internals	
-	mongoc_init();
-
 	// Stores any error that might appear during the connection
 	bson_error_t error;
 
@@ -221,7 +218,6 @@ void FSLAssetDBHandler::Disconnect() const
 	{
 		mongoc_collection_destroy(collection);
 	}
-	mongoc_cleanup();
 #endif //SL_WITH_LIBMONGO_C
 }
 
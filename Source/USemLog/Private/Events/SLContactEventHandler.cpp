@@ -70,106 +70,106 @@ void FSLContactEventHandler::Finish(float EndTime, bool bForced)
 // Start new contact event
 void FSLContactEventHandler::AddNewContactEvent(const FSLContactResult& InResult)
 {
-	// Start a semantic contact event
-	TSharedPtr<FSLContactEvent> Event = MakeShareable(new FSLContactEvent(
-		FSLUuid::NewGuidInBase64Url(), InResult.Time,
-		FSLUuid::PairEncodeCantor(InResult.Self->GetUniqueID(), InResult.Other->GetUniqueID()),
-		InResult.Self, InResult.Other));
+	// Start a semantic contact event (the id is only generated if the event is published)
+	TSharedPtr<FSLContactEvent> Event = StartedContactEvents.Acquire();
+	Event->StartTime = InResult.Time;
+	Event->PairId = FSLUuid::PairEncodeCantor(InResult.Self->GetUniqueID(), InResult.Other->GetUniqueID());
+	Event->Individual1 = InResult.Self;
+	Event->Individual2 = InResult.Other;
 	Event->EpisodeId = EpisodeId;
-	// Add event to the pending contacts array
-	StartedContactEvents.Emplace(Event);
+	// Add event to the pending contacts
+	StartedContactEvents.Add(Event->PairId, Event);
 }
 
 // Publish finished event
-bool FSLContactEventHandler::FinishContactEvent(USLBaseIndividual* InOther, float EndTime)
+bool FSLContactEventHandler::FinishContactEvent(const uint64 InPairId, float EndTime)
 {
-	// Use iterator to be able to remove the entry from the array
-	for (auto EventItr(StartedContactEvents.CreateIterator()); EventItr; ++EventItr)
+	TSharedPtr<FSLContactEvent> Event = StartedContactEvents.Remove(InPairId);
+	if (!Event.IsValid())
 	{
-		// It is enough to compare against the other id when searching
-		if ((*EventItr)->Individual2 == InOther)
-		{
-			// Set the event end time
-			(*EventItr)->EndTime = EndTime;
-
-			// Avoid publishing short events
-			if (((*EventItr)->EndTime - (*EventItr)->StartTime) > ContactEventMin)
-			{
-				OnSemanticEvent.ExecuteIfBound(*EventItr);
-			}
-			
-			// Remove event from the pending list
-			EventItr.RemoveCurrent();
-
-			return true;
-		}
+		return false;
+	}
+
+	// Set the event end time
+	Event->EndTime = EndTime;
+
+	// Avoid publishing short events
+	if ((Event->EndTime - Event->StartTime) > ContactEventMin)
+	{
+		Event->Id = FSLUuid::NewGuidInBase64Url();
+		OnSemanticEvent.ExecuteIfBound(Event);
 	}
-	return false;
+
+	// Reused if it was not kept by the listeners
+	StartedContactEvents.Release(MoveTemp(Event));
+	return true;
 }
 
 // Start new supported by event
 void FSLContactEventHandler::AddNewSupportedByEvent(USLBaseIndividual* Supported, USLBaseIndividual* Supporting, float StartTime, const uint64 EventPairId)
 {
-	// Start a supported by event
-	TSharedPtr<FSLSupportedByEvent> Event = MakeShareable(new FSLSupportedByEvent(
-		FSLUuid::NewGuidInBase64Url(), StartTime, EventPairId, Supported, Supporting));
+	// Start a supported by event (the id is only generated if the event is published)
+	TSharedPtr<FSLSupportedByEvent> Event = StartedSupportedByEvents.Acquire();
+	Event->StartTime = StartTime;
+	Event->PairId = EventPairId;
+	Event->SupportedIndividual = Supported;
+	Event->SupportingIndividual = Supporting;
 	Event->EpisodeId = EpisodeId;
-	// Add event to the pending array
-	StartedSupportedByEvents.Emplace(Event);
+	// Add event to the pending events
+	StartedSupportedByEvents.Add(EventPairId, Event);
 }
 
 // Finish then publish the event
 bool FSLContactEventHandler::FinishSupportedByEvent(const uint64 InPairId, float EndTime)
 {
-	// Use iterator to be able to remove the entry from the array
-	for (auto EventItr(StartedSupportedByEvents.CreateIterator()); EventItr; ++EventItr)
+	TSharedPtr<FSLSupportedByEvent> Event = StartedSupportedByEvents.Remove(InPairId);
+	if (!Event.IsValid())
 	{
-		// It is enough to compare against the other id when searching
-		if ((*EventItr)->PairId == InPairId)
-		{
-			// Ignore short events
-			if (EndTime - (*EventItr)->StartTime > SupportedByEventMin)
-			{
-				// Set end time and publish event
-				(*EventItr)->EndTime = EndTime;
-				OnSemanticEvent.ExecuteIfBound(*EventItr);
-			}
-			// Remove event from the pending list
-			EventItr.RemoveCurrent();
-			return true;
-		}
+		return false;
+	}
+
+	// Ignore short events
+	if (EndTime - Event->StartTime > SupportedByEventMin)
+	{
+		// Set end time and publish event
+		Event->EndTime = EndTime;
+		Event->Id = FSLUuid::NewGuidInBase64Url();
+		OnSemanticEvent.ExecuteIfBound(Event);
 	}
-	return false;
+
+	// Reused if it was not kept by the listeners
+	StartedSupportedByEvents.Release(MoveTemp(Event));
+	return true;
 }
 
 // Terminate and publish pending contact events (this usually is called at end play)
 void FSLContactEventHandler::FinishAllEvents(float EndTime)
 {
 	// Finish contact events
-	for (auto& Ev : StartedContactEvents)
+	StartedContactEvents.RemoveAll([this, EndTime](TSharedPtr<FSLContactEvent>&& Ev)
 	{
 		// Ignore short events
 		if (EndTime - Ev->StartTime > ContactEventMin)
 		{
 			// Set end time and publish event
 			Ev->EndTime = EndTime;
+			Ev->Id = FSLUuid::NewGuidInBase64Url();
 			OnSemanticEvent.ExecuteIfBound(Ev);
 		}
-	}
-	StartedContactEvents.Empty();
+	});
 
 	// Finish supported by events
-	for (auto& Ev : StartedSupportedByEvents)
+	StartedSupportedByEvents.RemoveAll([this, EndTime](TSharedPtr<FSLSupportedByEvent>&& Ev)
 	{
 		// Ignore short events
 		if ((EndTime - Ev->StartTime) > SupportedByEventMin)
 		{
 			// Set end time and publish event
 			Ev->EndTime = EndTime;
+			Ev->Id = FSLUuid::NewGuidInBase64Url();
 			OnSemanticEvent.ExecuteIfBound(Ev);
 		}
-	}
-	StartedSupportedByEvents.Empty();
+	});
 }
 
 // Event called when a semantic overlap event begins
@@ -181,7 +181,7 @@ void FSLContactEventHandler::OnSLOverlapBegin(const FSLContactResult& InResult)
 // Event called when a semantic overlap event ends
 void FSLContactEventHandler::OnSLOverlapEnd(USLBaseIndividual* Self, USLBaseIndividual* Other, float Time)
 {
-	FinishContactEvent(Other, Time);
+	FinishContactEvent(FSLUuid::PairEncodeCantor(Self->GetUniqueID(), Other->GetUniqueID()), Time);
 }
 
 // Event called when a supported by event begins
@@ -0,0 +1,197 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "Events/SLEventJournal.h"
+#include "Owl/SLOwlWriter.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/Event.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+
+// Ctor
+FSLEventJournal::FSLEventJournal()
+{
+	Thread = nullptr;
+	WakeEvent = nullptr;
+	bStopRequested = false;
+	FlushInterval = 1.f;
+	NumRecords = 0;
+}
+
+// Dtor
+FSLEventJournal::~FSLEventJournal()
+{
+	Close();
+}
+
+// Create the journal file and start the writer thread
+bool FSLEventJournal::Open(const FString& InPath, float InFlushInterval)
+{
+	if (Thread)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d Journal %s is already open.."), *FString(__FUNCTION__), __LINE__, *Path);
+		return false;
+	}
+
+	Path = InPath;
+	FPaths::RemoveDuplicateSlashes(Path);
+	Writer.Reset(IFileManager::Get().CreateFileWriter(*Path));
+	if (!Writer)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not create the journal %s.."), *FString(__FUNCTION__), __LINE__, *Path);
+		return false;
+	}
+
+	FlushInterval = FMath::Max(InFlushInterval, 0.01f);
+	NumRecords = 0;
+	bStopRequested = false;
+	WakeEvent = FPlatformProcess::GetSynchEventFromPool(false);
+	Thread = FRunnableThread::Create(this, TEXT("SLEventJournal"), 0, TPri_BelowNormal);
+	if (!Thread)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not create the journal thread.."), *FString(__FUNCTION__), __LINE__);
+		FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+		WakeEvent = nullptr;
+		Writer.Reset();
+		return false;
+	}
+	return true;
+}
+
+// Queue the event for writing (game thread)
+void FSLEventJournal::Append(FSLEventJournalRecord&& Record, TArray<FSLOwlNode>&& OwlNodes)
+{
+	if (!Thread)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Journal is not open, event %s is lost.."), *FString(__FUNCTION__), __LINE__, *Record.Id);
+		return;
+	}
+	FSLEventJournalPending Event;
+	Event.Record = MoveTemp(Record);
+	Event.OwlNodes = MoveTemp(OwlNodes);
+	Pending.Enqueue(MoveTemp(Event));
+	NumRecords++;
+}
+
+// Write the queued events, flush and close the file
+void FSLEventJournal::Close()
+{
+	if (Thread)
+	{
+		Stop();
+		Thread->WaitForCompletion();
+		delete Thread;
+		Thread = nullptr;
+	}
+	if (WakeEvent)
+	{
+		FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+		WakeEvent = nullptr;
+	}
+	if (Writer)
+	{
+		Writer->Close();
+		Writer.Reset();
+	}
+}
+
+// Read the records in order, stops at the first incomplete record
+int32 FSLEventJournal::ForEachRecord(const FString& InPath, TFunctionRef<void(FSLEventJournalRecord&)> Visitor)
+{
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*InPath));
+	if (!Reader)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not open the journal %s.."), *FString(__FUNCTION__), __LINE__, *InPath);
+		return 0;
+	}
+
+	const int64 TotalSize = Reader->TotalSize();
+	int32 NumRead = 0;
+	TArray<uint8> Buffer;
+	while (Reader->Tell() + (int64)sizeof(int32) <= TotalSize)
+	{
+		int32 Size = 0;
+		*Reader << Size;
+		if (Size < 0 || Reader->Tell() + Size > TotalSize)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("%s::%d Journal %s ends with an incomplete record, ignoring it.."),
+				*FString(__FUNCTION__), __LINE__, *InPath);
+			break;
+		}
+		Buffer.SetNumUninitialized(Size, false);
+		Reader->Serialize(Buffer.GetData(), Size);
+
+		FSLEventJournalRecord Record;
+		FMemoryReader RecordReader(Buffer);
+		RecordReader << Record;
+		if (RecordReader.IsError())
+		{
+			break;
+		}
+		Visitor(Record);
+		NumRead++;
+	}
+	return NumRead;
+}
+
+// Write the queued events and flush them periodically
+uint32 FSLEventJournal::Run()
+{
+	double LastFlushTime = FPlatformTime::Seconds();
+	while (!bStopRequested)
+	{
+		WakeEvent->Wait(static_cast<uint32>(FlushInterval * 1000.f));
+		WritePending();
+
+		// Flush to disk, the events are not lost if the process crashes
+		const double CurrTime = FPlatformTime::Seconds();
+		if (CurrTime - LastFlushTime >= FlushInterval)
+		{
+			Writer->Flush();
+			LastFlushTime = CurrTime;
+		}
+	}
+
+	// Events queued before the stop request
+	WritePending();
+	Writer->Flush();
+	return 0;
+}
+
+// Stop the writer, the queued events are still written
+void FSLEventJournal::Stop()
+{
+	bStopRequested = true;
+	if (WakeEvent)
+	{
+		WakeEvent->Trigger();
+	}
+}
+
+// Convert and write the queued events (writer thread)
+void FSLEventJournal::WritePending()
+{
+	FSLEventJournalPending Event;
+	TArray<uint8> Buffer;
+	while (Pending.Dequeue(Event))
+	{
+		{
+			FSLOwlWriter OwlWriter(Event.Record.OwlStr, INDENT_STEP);
+			for (const auto& Node : Event.OwlNodes)
+			{
+				OwlWriter.WriteNode(Node);
+			}
+		}
+
+		// Size prefixed, so an incomplete last record can be detected when reading
+		Buffer.Reset();
+		FMemoryWriter RecordWriter(Buffer);
+		RecordWriter << Event.Record;
+		int32 Size = Buffer.Num();
+		*Writer << Size;
+		Writer->Serialize(Buffer.GetData(), Size);
+	}
+}
@@ -62,55 +62,56 @@ void FSLGraspEventHandler::Finish(float EndTime, bool bForced)
 // Start new grasp event
 void FSLGraspEventHandler::AddNewEvent(USLBaseIndividual* Self, USLBaseIndividual* Other, float StartTime, const FString& InType)
 {
-	// Start a semantic grasp event
-	TSharedPtr<FSLGraspEvent> Event = MakeShareable(new FSLGraspEvent(
-		FSLUuid::NewGuidInBase64Url(), StartTime,
-		FSLUuid::PairEncodeCantor(Self->GetUniqueID(), Other->GetUniqueID()),
-		Self, Other, InType));
+	// Start a semantic grasp event (the id is only generated if the event is published)
+	TSharedPtr<FSLGraspEvent> Event = StartedEvents.Acquire();
+	Event->StartTime = StartTime;
+	Event->PairId = FSLUuid::PairEncodeCantor(Self->GetUniqueID(), Other->GetUniqueID());
+	Event->Manipulator = Self;
+	Event->Individual = Other;
+	Event->GraspType = InType;
 	Event->EpisodeId = EpisodeId;
-	// Add event to the pending array
-	StartedEvents.Emplace(Event);
+	// Add event to the pending events
+	StartedEvents.Add(Event->PairId, Event);
 }
 
 // Publish finished event
-bool FSLGraspEventHandler::FinishEvent(USLBaseIndividual* Other, float EndTime)
+bool FSLGraspEventHandler::FinishEvent(const uint64 InPairId, float EndTime)
 {
-	// Use iterator to be able to remove the entry from the array
-	for (auto EventItr(StartedEvents.CreateIterator()); EventItr; ++EventItr)
+	TSharedPtr<FSLGraspEvent> Event = StartedEvents.Remove(InPairId);
+	if (!Event.IsValid())
 	{
-		// It is enough to compare against the other id when searching
-		if ((*EventItr)->Individual == Other)
-		{
-			// Ignore short events
-			if ((EndTime - (*EventItr)->StartTime) > GraspEventMin)
-			{
-				// Set end time and publish event
-				(*EventItr)->EndTime = EndTime;
-				OnSemanticEvent.ExecuteIfBound(*EventItr);
-			}
-			// Remove event from the pending list
-			EventItr.RemoveCurrent();
-			return true;
-		}
+		return false;
 	}
-	return false;
+
+	// Ignore short events
+	if ((EndTime - Event->StartTime) > GraspEventMin)
+	{
+		// Set end time and publish event
+		Event->EndTime = EndTime;
+		Event->Id = FSLUuid::NewGuidInBase64Url();
+		OnSemanticEvent.ExecuteIfBound(Event);
+	}
+
+	// Reused if it was not kept by the listeners
+	StartedEvents.Release(MoveTemp(Event));
+	return true;
 }
 
 // Terminate and publish pending events (this usually is called at end play)
 void FSLGraspEventHandler::FinishAllEvents(float EndTime)
 {
 	// Finish events
-	for (auto& Ev : StartedEvents)
+	StartedEvents.RemoveAll([this, EndTime](TSharedPtr<FSLGraspEvent>&& Ev)
 	{
 		// Ignore short events
 		if ((EndTime - Ev->StartTime) > GraspEventMin)
 		{
 			// Set end time and publish event
 			Ev->EndTime = EndTime;
+			Ev->Id = FSLUuid::NewGuidInBase64Url();
 			OnSemanticEvent.ExecuteIfBound(Ev);
 		}
-	}
-	StartedEvents.Empty();
+	});
 }
 
 
@@ -123,5 +124,5 @@ void FSLGraspEventHandler::OnSLGraspBegin(USLBaseIndividual* Self, USLBaseIndivi
 // Event called when a semantic grasp event ends
 void FSLGraspEventHandler::OnSLGraspEnd(USLBaseIndividual* Self, USLBaseIndividual* Other, float Time)
 {
-	FinishEvent(Other, Time);
+	FinishEvent(FSLUuid::PairEncodeCantor(Self->GetUniqueID(), Other->GetUniqueID()), Time);
 }
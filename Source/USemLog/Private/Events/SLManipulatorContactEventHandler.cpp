@@ -63,49 +63,47 @@ void FSLManipulatorContactEventHandler::Finish(float EndTime, bool bForced)
 // Start new contact event
 void FSLManipulatorContactEventHandler::AddNewEvent(const FSLContactResult& InResult)
 {
-	// Start a semantic contact event
-	TSharedPtr<FSLContactEvent> Event = MakeShareable(new FSLContactEvent(
-		FSLUuid::NewGuidInBase64Url(), InResult.Time,
-		FSLUuid::PairEncodeCantor(InResult.Self->GetUniqueID(), InResult.Other->GetUniqueID()),
-		InResult.Self, InResult.Other));
+	// Start a semantic contact event (the id is only generated if the event is published)
+	TSharedPtr<FSLContactEvent> Event = StartedEvents.Acquire();
+	Event->StartTime = InResult.Time;
+	Event->PairId = FSLUuid::PairEncodeCantor(InResult.Self->GetUniqueID(), InResult.Other->GetUniqueID());
+	Event->Individual1 = InResult.Self;
+	Event->Individual2 = InResult.Other;
 	Event->EpisodeId = EpisodeId;
-	// Add event to the pending contacts array
-	StartedEvents.Emplace(Event);
+	// Add event to the pending contacts
+	StartedEvents.Add(Event->PairId, Event);
 }
 
 // Publish finished event
-bool FSLManipulatorContactEventHandler::FinishEvent(USLBaseIndividual* InOther, float EndTime)
+bool FSLManipulatorContactEventHandler::FinishEvent(const uint64 InPairId, float EndTime)
 {
-	// Use iterator to be able to remove the entry from the array
-	for (auto EventItr(StartedEvents.CreateIterator()); EventItr; ++EventItr)
+	TSharedPtr<FSLContactEvent> Event = StartedEvents.Remove(InPairId);
+	if (!Event.IsValid())
 	{
-		// It is enough to compare against the other id when searching
-		if ((*EventItr)->Individual2 == InOther)
-		{
-			// Set the event end time
-			(*EventItr)->EndTime = EndTime;
+		return false;
+	}
 
-			OnSemanticEvent.ExecuteIfBound(*EventItr);
+	// Set the event end time
+	Event->EndTime = EndTime;
+	Event->Id = FSLUuid::NewGuidInBase64Url();
+	OnSemanticEvent.ExecuteIfBound(Event);
 
-			// Remove event from the pending list
-			EventItr.RemoveCurrent();
-			return true;
-		}
-	}
-	return false;
+	// Reused if it was not kept by the listeners
+	StartedEvents.Release(MoveTemp(Event));
+	return true;
 }
 
 // Terminate and publish pending contact events (this usually is called at end play)
 void FSLManipulatorContactEventHandler::FinishAllEvents(float EndTime)
 {
 	// Finish contact events
-	for (auto& Ev : StartedEvents)
+	StartedEvents.RemoveAll([this, EndTime](TSharedPtr<FSLContactEvent>&& Ev)
 	{
 		// Set end time and publish event
 		Ev->EndTime = EndTime;
+		Ev->Id = FSLUuid::NewGuidInBase64Url();
 		OnSemanticEvent.ExecuteIfBound(Ev);
-	}
-	StartedEvents.Empty();
+	});
 }
 
 
@@ -118,5 +116,5 @@ void FSLManipulatorContactEventHandler::OnSLOverlapBegin(const FSLContactResult&
 // Event called when a semantic overlap event ends
 void FSLManipulatorContactEventHandler::OnSLOverlapEnd(USLBaseIndividual* Self, USLBaseIndividual* Other, float Time)
 {
-	FinishEvent(Other, Time);
+	FinishEvent(FSLUuid::PairEncodeCantor(Self->GetUniqueID(), Other->GetUniqueID()), Time);
 }
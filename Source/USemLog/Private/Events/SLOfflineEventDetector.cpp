@@ -0,0 +1,477 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "Events/SLOfflineEventDetector.h"
+#include "Events/SLContactEvent.h"
+#include "Events/SLSupportedByEvent.h"
+#include "Individuals/SLIndividualManager.h"
+#include "Individuals/Type/SLRigidIndividual.h"
+#include "Monitors/SLContactMonitorInterface.h"
+#include "Mongo/SLMongoEpisodeStreamer.h"
+#include "Components/ShapeComponent.h"
+#include "Utils/SLUuid.h"
+
+// Ctor
+FSLOfflineEventDetector::FSLOfflineEventDetector(const FSLOfflineEventParams& InParams, bool bInDetectSupportedBy) :
+	Params(InParams),
+	bDetectSupportedBy(bInDetectSupportedBy),
+	bPosesDirty(false),
+	FirstFrameTs(-1.f),
+	LastFrameTs(-1.f),
+	NumFrames(0),
+	NumPublished(0),
+	ReplayExecTime(0.0)
+{
+}
+
+// Dtor
+FSLOfflineEventDetector::~FSLOfflineEventDetector()
+{
+	if (Streamer.IsValid())
+	{
+		Streamer->Shutdown();
+	}
+}
+
+// Init parent (individual manager)
+void FSLOfflineEventDetector::Init(UObject* InParent)
+{
+	if (!bIsInit)
+	{
+		ASLIndividualManager* IndividualManager = Cast<ASLIndividualManager>(InParent);
+		if (IndividualManager && IndividualManager->IsLoaded())
+		{
+			InitBodies(IndividualManager);
+			if (Bodies.Num() > 0)
+			{
+				bIsInit = true;
+			}
+			else
+			{
+				UE_LOG(LogTemp, Error, TEXT("%s::%d No monitored individuals found, nothing to replay.."),
+					*FString(__FUNCTION__), __LINE__);
+			}
+		}
+	}
+}
+
+// Start streaming the world state of the episode from the database
+void FSLOfflineEventDetector::Start()
+{
+	if (!bIsStarted && bIsInit)
+	{
+		Streamer = MakeShareable(new FSLMongoEpisodeStreamer());
+		if (!Streamer->Start(Params.DBServerParams.Ip, Params.DBServerParams.Port, TaskId, EpisodeId))
+		{
+			UE_LOG(LogTemp, Error, TEXT("%s::%d Could not stream the world state of %s/%s from %s:%d.."),
+				*FString(__FUNCTION__), __LINE__, *TaskId, *EpisodeId, *Params.DBServerParams.Ip, Params.DBServerParams.Port);
+			Streamer.Reset();
+		}
+
+		// Mark as started
+		bIsStarted = true;
+	}
+}
+
+// Terminate the replay, finish and publish remaining events
+void FSLOfflineEventDetector::Finish(float EndTime, bool bForced)
+{
+	if (!bIsFinished && (bIsInit || bIsStarted))
+	{
+		if (Streamer.IsValid())
+		{
+			Streamer->Shutdown();
+			Streamer.Reset();
+		}
+
+		// Contacts waiting for a possible concatenation end at their overlap end time
+		for (auto& ContactPair : Contacts)
+		{
+			FContact& Contact = ContactPair.Value;
+			FinishContact(Contact, Contact.EndTs >= 0.f ? Contact.EndTs : EndTime);
+		}
+		Contacts.Empty();
+
+		UE_LOG(LogTemp, Log, TEXT("%s::%d Replayed %d frames ([%.2f, %.2f] s) of %d individuals in %.2f s, published %d events.."),
+			*FString(__FUNCTION__), __LINE__, NumFrames, FirstFrameTs, LastFrameTs, Bodies.Num(), ReplayExecTime, NumPublished);
+
+		// Mark finished
+		bIsStarted = false;
+		bIsInit = false;
+		bIsFinished = true;
+	}
+}
+
+// Replay the available frames within the time budget (ms, 0 for no limit), returns false when the replay is done
+bool FSLOfflineEventDetector::ReplayQueuedFrames(float BudgetMs)
+{
+	if (!Streamer.IsValid())
+	{
+		return false;
+	}
+
+	const double ExecBegin = FPlatformTime::Seconds();
+	TPair<float, TMap<FString, FTransform>> Frame;
+	while (Streamer->Dequeue(Frame))
+	{
+		ReplayFrame(Frame.Key, Frame.Value);
+		if (BudgetMs > 0.f && (FPlatformTime::Seconds() - ExecBegin) * 1000.0 > BudgetMs)
+		{
+			break;
+		}
+	}
+	ReplayExecTime += FPlatformTime::Seconds() - ExecBegin;
+	return !IsReplayFinished();
+}
+
+// Update the individual poses and the events with the world state frame
+void FSLOfflineEventDetector::ReplayFrame(float Ts, const TMap<FString, FTransform>& Poses)
+{
+	if (NumFrames == 0)
+	{
+		FirstFrameTs = Ts;
+	}
+
+	// Only the moved individuals are in the frame, the others keep their pose and have no speed
+	const float DeltaT = LastFrameTs >= 0.f ? Ts - LastFrameTs : 0.f;
+	for (const auto& PosePair : Poses)
+	{
+		if (const int32* BodyIdx = BodyIndexes.Find(PosePair.Key))
+		{
+			FBody& Body = Bodies[*BodyIdx];
+			const FVector Location = PosePair.Value.GetLocation();
+			Body.VertSpeed = DeltaT > 0.f ? (Location.Z - Body.Pose.GetLocation().Z) / DeltaT : 0.f;
+			Body.Pose = FTransform(PosePair.Value.GetRotation(), Location);
+			Body.LastMoveTs = Ts;
+			UpdateWorldBox(Body);
+			bPosesDirty = true;
+		}
+	}
+
+	// The overlaps can only change if something moved
+	if (bPosesDirty)
+	{
+		TArray<FIntPoint> Pairs;
+		FindOverlaps(Pairs);
+		UpdateContacts(Ts, Pairs);
+		bPosesDirty = false;
+	}
+	FinishEndedContacts(Ts);
+
+	if (bDetectSupportedBy)
+	{
+		UpdateSupportedBy(Ts);
+	}
+
+	LastFrameTs = Ts;
+	NumFrames++;
+}
+
+// True if all the frames have been replayed
+bool FSLOfflineEventDetector::IsReplayFinished() const
+{
+	return !Streamer.IsValid() || Streamer->IsFinished();
+}
+
+// Create the bodies from the rigid individuals of the world
+void FSLOfflineEventDetector::InitBodies(ASLIndividualManager* IndividualManager)
+{
+	int32 NumMonitored = 0;
+	for (USLBaseIndividual* Individual : IndividualManager->GetIndividuals())
+	{
+		// Skeletal and robot individuals are logged as bones/links, their root bounds would not represent them
+		if (!Individual || !Individual->IsLoaded() || !Individual->IsA(USLRigidIndividual::StaticClass()))
+		{
+			continue;
+		}
+
+		AActor* Actor = Individual->GetParentActor();
+		if (!Actor)
+		{
+			continue;
+		}
+
+		const FBox LocalBox = Actor->CalculateComponentsBoundingBoxInLocalSpace(true);
+		if (!LocalBox.IsValid)
+		{
+			continue;
+		}
+
+		FBody Body;
+		Body.Individual = Individual;
+		const FVector Scale = Actor->GetActorScale3D();
+		Body.LocalCenter = LocalBox.GetCenter() * Scale;
+		Body.LocalExtent = (LocalBox.GetExtent() * Scale).GetAbs() + FVector(Params.ContactTolerance * 0.5f);
+		Body.Pose = FTransform(Actor->GetActorQuat(), Actor->GetActorLocation());
+
+		// Same individuals as the ones with live contact monitors
+		TInlineComponentArray<UShapeComponent*> ShapeComponents(Actor);
+		for (UShapeComponent* ShapeComponent : ShapeComponents)
+		{
+			if (Cast<ISLContactMonitorInterface>(ShapeComponent))
+			{
+				Body.bMonitored = true;
+				NumMonitored++;
+				break;
+			}
+		}
+
+		UpdateWorldBox(Body);
+		const int32 BodyIdx = Bodies.Add(Body);
+		BodyIndexes.Add(Individual->GetIdValue(), BodyIdx);
+		SweepOrder.Add(BodyIdx);
+	}
+
+	if (NumMonitored == 0)
+	{
+		Bodies.Empty();
+		BodyIndexes.Empty();
+		SweepOrder.Empty();
+		return;
+	}
+
+	SweepOrder.Sort([this](int32 A, int32 B) { return Bodies[A].WorldBox.Min.X < Bodies[B].WorldBox.Min.X; });
+	bPosesDirty = true;
+}
+
+// Set the world bounds of the body from its current pose
+void FSLOfflineEventDetector::UpdateWorldBox(FBody& Body) const
+{
+	const FVector Center = Body.Pose.TransformPosition(Body.LocalCenter);
+	const FQuat Rotation = Body.Pose.GetRotation();
+	const FVector Extent = (Rotation.GetAxisX() * Body.LocalExtent.X).GetAbs()
+		+ (Rotation.GetAxisY() * Body.LocalExtent.Y).GetAbs()
+		+ (Rotation.GetAxisZ() * Body.LocalExtent.Z).GetAbs();
+	Body.WorldBox = FBox(Center - Extent, Center + Extent);
+}
+
+// Check the overlaps of the bodies (sort and sweep, then oriented box test)
+void FSLOfflineEventDetector::FindOverlaps(TArray<FIntPoint>& OutPairs)
+{
+	// Insertion sort, the order barely changes between frames
+	for (int32 SortIdx = 1; SortIdx < SweepOrder.Num(); ++SortIdx)
+	{
+		const int32 BodyIdx = SweepOrder[SortIdx];
+		const float MinX = Bodies[BodyIdx].WorldBox.Min.X;
+		int32 PrevIdx = SortIdx - 1;
+		while (PrevIdx >= 0 && Bodies[SweepOrder[PrevIdx]].WorldBox.Min.X > MinX)
+		{
+			SweepOrder[PrevIdx + 1] = SweepOrder[PrevIdx];
+			PrevIdx--;
+		}
+		SweepOrder[PrevIdx + 1] = BodyIdx;
+	}
+
+	for (int32 SweepIdx = 0; SweepIdx < SweepOrder.Num(); ++SweepIdx)
+	{
+		const int32 IdxA = SweepOrder[SweepIdx];
+		const FBody& A = Bodies[IdxA];
+		for (int32 OtherSweepIdx = SweepIdx + 1; OtherSweepIdx < SweepOrder.Num(); ++OtherSweepIdx)
+		{
+			const int32 IdxB = SweepOrder[OtherSweepIdx];
+			const FBody& B = Bodies[IdxB];
+			if (B.WorldBox.Min.X > A.WorldBox.Max.X)
+			{
+				break;
+			}
+
+			// At least one of them needs to be monitored
+			if (!A.bMonitored && !B.bMonitored)
+			{
+				continue;
+			}
+
+			if (A.WorldBox.Intersect(B.WorldBox) && OrientedBoxesOverlap(A, B))
+			{
+				if (A.bMonitored)
+				{
+					OutPairs.Emplace(IdxA, IdxB);
+				}
+				else
+				{
+					OutPairs.Emplace(IdxB, IdxA);
+				}
+			}
+		}
+	}
+}
+
+// Start new contacts, resume or mark the ended ones from the current overlaps
+void FSLOfflineEventDetector::UpdateContacts(float Ts, const TArray<FIntPoint>& Pairs)
+{
+	TSet<uint64> PairKeys;
+	PairKeys.Reserve(Pairs.Num());
+	for (const FIntPoint& Pair : Pairs)
+	{
+		const uint64 PairKey = GetPairKey(Pair.X, Pair.Y);
+		PairKeys.Add(PairKey);
+
+		// Jittering contact, continue the existing event
+		if (FContact* Contact = Contacts.Find(PairKey))
+		{
+			Contact->EndTs = -1.f;
+			continue;
+		}
+
+		USLBaseIndividual* Self = Bodies[Pair.X].Individual;
+		USLBaseIndividual* Other = Bodies[Pair.Y].Individual;
+		FContact NewContact;
+		NewContact.SelfIdx = Pair.X;
+		NewContact.OtherIdx = Pair.Y;
+		NewContact.ContactEvent = MakeShareable(new FSLContactEvent(
+			FSLUuid::NewGuidInBase64Url(), Ts,
+			FSLUuid::PairEncodeCantor(Self->GetUniqueID(), Other->GetUniqueID()),
+			Self, Other));
+		NewContact.ContactEvent->EpisodeId = EpisodeId;
+		Contacts.Add(PairKey, NewContact);
+	}
+
+	// Mark the end of the contacts which are not overlapping anymore
+	for (auto& ContactPair : Contacts)
+	{
+		if (ContactPair.Value.EndTs < 0.f && !PairKeys.Contains(ContactPair.Key))
+		{
+			ContactPair.Value.EndTs = Ts;
+		}
+	}
+}
+
+// Publish the contacts which ended longer than the concatenation time ago
+void FSLOfflineEventDetector::FinishEndedContacts(float Ts)
+{
+	for (auto ContactItr(Contacts.CreateIterator()); ContactItr; ++ContactItr)
+	{
+		FContact& Contact = ContactItr.Value();
+		if (Contact.EndTs >= 0.f && Ts - Contact.EndTs > Params.ConcatenateIfSmaller)
+		{
+			FinishContact(Contact, Contact.EndTs);
+			ContactItr.RemoveCurrent();
+		}
+	}
+}
+
+// Start the supported by events of the stable contacts
+void FSLOfflineEventDetector::UpdateSupportedBy(float Ts)
+{
+	for (auto& ContactPair : Contacts)
+	{
+		FContact& Contact = ContactPair.Value;
+		if (Contact.SupportedByEvent.IsValid() || Contact.EndTs >= 0.f)
+		{
+			continue;
+		}
+
+		// Check that the relative speed on Z between the two objects is smaller than the threshold
+		const FBody& Self = Bodies[Contact.SelfIdx];
+		const FBody& Other = Bodies[Contact.OtherIdx];
+		const float SelfVertSpeed = Self.LastMoveTs == Ts ? Self.VertSpeed : 0.f;
+		const float OtherVertSpeed = Other.LastMoveTs == Ts ? Other.VertSpeed : 0.f;
+		if (FMath::Abs(SelfVertSpeed - OtherVertSpeed) < Params.SupportedByMaxVertSpeed)
+		{
+			// Non monitored individuals can only support, otherwise the higher one is supported
+			const bool bSelfIsSupported = !Other.bMonitored || Self.Pose.GetLocation().Z > Other.Pose.GetLocation().Z;
+			USLBaseIndividual* Supported = bSelfIsSupported ? Self.Individual : Other.Individual;
+			USLBaseIndividual* Supporting = bSelfIsSupported ? Other.Individual : Self.Individual;
+			Contact.SupportedByEvent = MakeShareable(new FSLSupportedByEvent(
+				FSLUuid::NewGuidInBase64Url(), Ts,
+				FSLUuid::PairEncodeCantor(Supported->GetUniqueID(), Supporting->GetUniqueID()),
+				Supported, Supporting));
+			Contact.SupportedByEvent->EpisodeId = EpisodeId;
+		}
+	}
+}
+
+// Publish the contact and its supported by event
+void FSLOfflineEventDetector::FinishContact(FContact& Contact, float EndTs)
+{
+	// Avoid publishing short events
+	if (Contact.ContactEvent.IsValid() && EndTs - Contact.ContactEvent->StartTime > Params.ContactEventMin)
+	{
+		Contact.ContactEvent->EndTime = EndTs;
+		OnSemanticEvent.ExecuteIfBound(Contact.ContactEvent);
+		NumPublished++;
+	}
+	Contact.ContactEvent.Reset();
+
+	if (Contact.SupportedByEvent.IsValid() && EndTs - Contact.SupportedByEvent->StartTime > Params.SupportedByEventMin)
+	{
+		Contact.SupportedByEvent->EndTime = EndTs;
+		OnSemanticEvent.ExecuteIfBound(Contact.SupportedByEvent);
+		NumPublished++;
+	}
+	Contact.SupportedByEvent.Reset();
+}
+
+// Key of the two bodies
+uint64 FSLOfflineEventDetector::GetPairKey(int32 IdxA, int32 IdxB)
+{
+	return FSLUuid::PairEncodeCantor(FMath::Min(IdxA, IdxB), FMath::Max(IdxA, IdxB));
+}
+
+// True if the oriented boxes overlap (separating axis test over the 15 candidate axes)
+bool FSLOfflineEventDetector::OrientedBoxesOverlap(const FBody& A, const FBody& B)
+{
+	const FQuat RotA = A.Pose.GetRotation();
+	const FQuat RotB = B.Pose.GetRotation();
+	const FVector AxesA[3] = { RotA.GetAxisX(), RotA.GetAxisY(), RotA.GetAxisZ() };
+	const FVector AxesB[3] = { RotB.GetAxisX(), RotB.GetAxisY(), RotB.GetAxisZ() };
+	const float ExtA[3] = { A.LocalExtent.X, A.LocalExtent.Y, A.LocalExtent.Z };
+	const float ExtB[3] = { B.LocalExtent.X, B.LocalExtent.Y, B.LocalExtent.Z };
+
+	// Rotation of B in the frame of A (epsilon avoids false separations on near parallel edges)
+	float R[3][3];
+	float AbsR[3][3];
+	for (int32 I = 0; I < 3; ++I)
+	{
+		for (int32 J = 0; J < 3; ++J)
+		{
+			R[I][J] = FVector::DotProduct(AxesA[I], AxesB[J]);
+			AbsR[I][J] = FMath::Abs(R[I][J]) + KINDA_SMALL_NUMBER;
+		}
+	}
+
+	// Translation in the frame of A
+	const FVector Translation = B.Pose.TransformPosition(B.LocalCenter) - A.Pose.TransformPosition(A.LocalCenter);
+	const float T[3] = { FVector::DotProduct(Translation, AxesA[0]),
+		FVector::DotProduct(Translation, AxesA[1]),
+		FVector::DotProduct(Translation, AxesA[2]) };
+
+	// Axes of A
+	for (int32 I = 0; I < 3; ++I)
+	{
+		const float RadiusB = ExtB[0] * AbsR[I][0] + ExtB[1] * AbsR[I][1] + ExtB[2] * AbsR[I][2];
+		if (FMath::Abs(T[I]) > ExtA[I] + RadiusB)
+		{
+			return false;
+		}
+	}
+
+	// Axes of B
+	for (int32 J = 0; J < 3; ++J)
+	{
+		const float RadiusA = ExtA[0] * AbsR[0][J] + ExtA[1] * AbsR[1][J] + ExtA[2] * AbsR[2][J];
+		if (FMath::Abs(T[0] * R[0][J] + T[1] * R[1][J] + T[2] * R[2][J]) > RadiusA + ExtB[J])
+		{
+			return false;
+		}
+	}
+
+	// Cross products of the axes
+	for (int32 I = 0; I < 3; ++I)
+	{
+		const int32 I1 = (I + 1) % 3;
+		const int32 I2 = (I + 2) % 3;
+		for (int32 J = 0; J < 3; ++J)
+		{
+			const int32 J1 = (J + 1) % 3;
+			const int32 J2 = (J + 2) % 3;
+			const float RadiusA = ExtA[I1] * AbsR[I2][J] + ExtA[I2] * AbsR[I1][J];
+			const float RadiusB = ExtB[J1] * AbsR[I][J2] + ExtB[J2] * AbsR[I][J1];
+			if (FMath::Abs(T[I2] * R[I1][J] - T[I1] * R[I2][J]) > RadiusA + RadiusB)
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
@@ -194,6 +194,17 @@ bool USLBaseIndividual::ClearExportedValues()
 	return bNewValue;
 }
 
+// Cache an externally calculated transform (e.g. batched bone poses), returns true on a new value
+bool USLBaseIndividual::SetCachedPose(const FTransform& NewPose, float Tolerance)
+{
+	if (!CachedPose.Equals(NewPose, Tolerance))
+	{
+		CachedPose = NewPose;
+		return true;
+	}
+	return false;
+}
+
 // Cache the current transform of the individual (returns true on a new value)
 bool USLBaseIndividual::UpdateCachedPose(float Tolerance, FTransform* OutPose)
 {
@@ -195,6 +195,50 @@ USLBaseIndividual* USLSkeletalIndividual::GetBoneIndividual(int32 Index) const
 	return nullptr;
 }
 
+// Cache the poses of all the bones from a single read of the component space transforms
+int32 USLSkeletalIndividual::UpdateCachedBonePoses(float Tolerance, TBitArray<>& OutMovedBones)
+{
+	int32 NumMoved = 0;
+
+	// Component space transforms are only valid if the component computes its own pose
+	const TArray<FTransform>* ComponentSpaceTransforms = nullptr;
+#if (ENGINE_MINOR_VERSION > 0 && ENGINE_MAJOR_VERSION > 4) || ENGINE_MAJOR_VERSION > 5
+	if (IsInit() && HasValidSkeletalMeshComponent() && !SkeletalMeshComponent->LeaderPoseComponent.IsValid())
+#else
+	if (IsInit() && HasValidSkeletalMeshComponent() && !SkeletalMeshComponent->MasterPoseComponent.IsValid())
+#endif
+	{
+		ComponentSpaceTransforms = &SkeletalMeshComponent->GetComponentSpaceTransforms();
+	}
+
+	// Same composition as GetBoneTransform, without fetching the component transform for every bone
+	const FTransform ComponentToWorld = SkeletalMeshComponent ? SkeletalMeshComponent->GetComponentTransform() : FTransform::Identity;
+	auto UpdateBone = [&](USLBaseIndividual* Bone, int32 BoneIndex)
+	{
+		bool bMoved;
+		if (ComponentSpaceTransforms && Bone->IsInit() && ComponentSpaceTransforms->IsValidIndex(BoneIndex))
+		{
+			bMoved = Bone->SetCachedPose((*ComponentSpaceTransforms)[BoneIndex] * ComponentToWorld, Tolerance);
+		}
+		else
+		{
+			bMoved = Bone->UpdateCachedPose(Tolerance);
+		}
+		OutMovedBones.Add(bMoved);
+		NumMoved += bMoved ? 1 : 0;
+	};
+
+	for (const auto& BI : BoneIndividuals)
+	{
+		UpdateBone(BI, BI->GetBoneIndex());
+	}
+	for (const auto& VBI : VirtualBoneIndividuals)
+	{
+		UpdateBone(VBI, VBI->GetBoneIndex());
+	}
+	return NumMoved;
+}
+
 // Apply visual mask material
 bool USLSkeletalIndividual::ApplyMaskMaterials(bool bIncludeChildren)
 {
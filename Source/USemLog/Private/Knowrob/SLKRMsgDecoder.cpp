@@ -0,0 +1,131 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+
+#include "Knowrob/SLKRMsgDecoder.h"
+#include "Knowrob/SLKRMsgDispatcher.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/Event.h"
+#include "Async/Async.h"
+
+// Ctor
+FSLKRMsgDecoder::FSLKRMsgDecoder() : bIsAlive(MakeShareable(new FThreadSafeBool(true)))
+{
+	Thread = nullptr;
+	WakeEvent = nullptr;
+	bStopRequested = false;
+}
+
+// Dtor
+FSLKRMsgDecoder::~FSLKRMsgDecoder()
+{
+	Close();
+	*bIsAlive = false;
+}
+
+// Start the decoder thread
+bool FSLKRMsgDecoder::Start()
+{
+	if (Thread)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d Decoder is already running.."), *FString(__FUNCTION__), __LINE__);
+		return false;
+	}
+
+	bStopRequested = false;
+	WakeEvent = FPlatformProcess::GetSynchEventFromPool(false);
+	Thread = FRunnableThread::Create(this, TEXT("SLKRMsgDecoder"), 0, TPri_BelowNormal);
+	if (!Thread)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not create the decoder thread.."), *FString(__FUNCTION__), __LINE__);
+		FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+		WakeEvent = nullptr;
+		return false;
+	}
+	return true;
+}
+
+// Stop the decoder thread, the queued messages are dropped
+void FSLKRMsgDecoder::Close()
+{
+	if (Thread)
+	{
+		Stop();
+		Thread->WaitForCompletion();
+		delete Thread;
+		Thread = nullptr;
+	}
+	if (WakeEvent)
+	{
+		FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+		WakeEvent = nullptr;
+	}
+	Messages.Empty();
+	Commands.Empty();
+}
+
+// Queue the message for decoding (game thread)
+void FSLKRMsgDecoder::Enqueue(std::string&& ProtoStr)
+{
+	if (!Thread)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Decoder is not running, message is lost.."), *FString(__FUNCTION__), __LINE__);
+		return;
+	}
+	Messages.Enqueue(MoveTemp(ProtoStr));
+	WakeEvent->Trigger();
+}
+
+// Get the next decoded command (game thread)
+bool FSLKRMsgDecoder::Dequeue(FSLKRCommand& OutCommand)
+{
+	return Commands.Dequeue(OutCommand);
+}
+
+// Decode the queued messages
+uint32 FSLKRMsgDecoder::Run()
+{
+	std::string ProtoStr;
+	while (!bStopRequested)
+	{
+		WakeEvent->Wait();
+
+		int32 NumDecoded = 0;
+		while (!bStopRequested && Messages.Dequeue(ProtoStr))
+		{
+			FSLKRCommand Command;
+			if (SLKRMsgDispatcher::DecodeCommand(ProtoStr, Command))
+			{
+				Commands.Enqueue(MoveTemp(Command));
+				NumDecoded++;
+			}
+			else
+			{
+				NumInvalid.Increment();
+			}
+		}
+
+		// One notification for all the commands decoded in this batch
+		if (NumDecoded > 0)
+		{
+			TSharedRef<FThreadSafeBool, ESPMode::ThreadSafe> bIsAliveRef = bIsAlive;
+			AsyncTask(ENamedThreads::GameThread, [this, bIsAliveRef]()
+			{
+				if (*bIsAliveRef)
+				{
+					OnNewCommands.ExecuteIfBound();
+				}
+			});
+		}
+	}
+	return 0;
+}
+
+// Stop the decoder
+void FSLKRMsgDecoder::Stop()
+{
+	bStopRequested = true;
+	if (WakeEvent)
+	{
+		WakeEvent->Trigger();
+	}
+}
@@ -59,125 +59,247 @@ void SLKRMsgDispatcher::Reset()
 }
 
 // Parse the proto sequence and trigger function
-void  SLKRMsgDispatcher::ProcessProtobuf(std::string ProtoStr)
-{	
+void SLKRMsgDispatcher::ProcessProtobuf(const std::string& ProtoStr)
+{
+	FSLKRCommand Command;
+	if (DecodeCommand(ProtoStr, Command))
+	{
+		ExecuteCommand(Command);
+	}
+}
+
+// Parse the proto sequence and convert its parameters, thread safe
+bool SLKRMsgDispatcher::DecodeCommand(const std::string& ProtoStr, FSLKRCommand& OutCommand)
+{
 #if SL_WITH_PROTO
 	sl_pb::KRAmevaEvent AmevaEvent;
-	AmevaEvent.ParseFromString(ProtoStr);
+	if (!AmevaEvent.ParseFromString(ProtoStr))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not parse the message (%d bytes).."),
+			*FString(__FUNCTION__), __LINE__, static_cast<int32>(ProtoStr.size()));
+		return false;
+	}
+
+	// The parameters are read by reference, only the needed values are converted
 	if (AmevaEvent.functocall() == AmevaEvent.SetTask)
 	{
-		SetTask(AmevaEvent.settaskparam());
+		OutCommand.Type = ESLKRCommandType::SetTask;
+		OutCommand.Id = UTF8_TO_TCHAR(AmevaEvent.settaskparam().task().c_str());
 	}
 	else if (AmevaEvent.functocall() == AmevaEvent.SetEpisode)
 	{
-		SetEpisode(AmevaEvent.setepisodeparams());
+		OutCommand.Type = ESLKRCommandType::SetEpisode;
+		OutCommand.EpisodeId = UTF8_TO_TCHAR(AmevaEvent.setepisodeparams().episode().c_str());
 	}
 	else if (AmevaEvent.functocall() == AmevaEvent.DrawMarkerAt)
 	{
-		DrawMarker(AmevaEvent.drawmarkeratparams());
+		const sl_pb::DrawMarkerAtParams& Params = AmevaEvent.drawmarkeratparams();
+		OutCommand.Type = ESLKRCommandType::DrawMarkerAt;
+		OutCommand.Id = UTF8_TO_TCHAR(Params.id().c_str());
+		OutCommand.Start = Params.timestamp();
+		OutCommand.Scale = Params.scale();
+		OutCommand.MarkerType = GetMarkerType(Params.marker());
+		OutCommand.MaterialType = GetMarkerMaterialType(UTF8_TO_TCHAR(Params.material().c_str()));
+		OutCommand.Color = GetMarkerColor(UTF8_TO_TCHAR(Params.color().c_str()));
 	}
 	else if (AmevaEvent.functocall() == AmevaEvent.DrawMarkerTraj)
 	{
-		DrawMarkerTraj(AmevaEvent.drawmarkertrajparams());
+		const sl_pb::DrawMarkerTrajParams& Params = AmevaEvent.drawmarkertrajparams();
+		OutCommand.Type = ESLKRCommandType::DrawMarkerTraj;
+		OutCommand.Id = UTF8_TO_TCHAR(Params.id().c_str());
+		OutCommand.Start = Params.start();
+		OutCommand.End = Params.end();
+		OutCommand.Scale = Params.scale();
+		OutCommand.MarkerType = GetMarkerType(Params.marker());
+		OutCommand.MaterialType = GetMarkerMaterialType(UTF8_TO_TCHAR(Params.material().c_str()));
+		OutCommand.Color = GetMarkerColor(UTF8_TO_TCHAR(Params.color().c_str()));
 	}
 	else if (AmevaEvent.functocall() == AmevaEvent.LoadLevel)
 	{
-		LoadLevel(AmevaEvent.loadlevelparams());
+		OutCommand.Type = ESLKRCommandType::LoadLevel;
+		OutCommand.Id = UTF8_TO_TCHAR(AmevaEvent.loadlevelparams().level().c_str());
 	}
 	else if (AmevaEvent.functocall() == AmevaEvent.StartSimulation)
 	{
-		StartSimulation(AmevaEvent.startsimulationparams());
+		const sl_pb::StartSimulationParams& Params = AmevaEvent.startsimulationparams();
+		OutCommand.Type = ESLKRCommandType::StartSimulation;
+		OutCommand.Ids.Reserve(Params.id_size());
+		for (int32 Idx = 0; Idx < Params.id_size(); ++Idx)
+		{
+			OutCommand.Ids.Emplace(UTF8_TO_TCHAR(Params.id(Idx).c_str()));
+		}
+		OutCommand.Duration = Params.duration();
 	}
 	else if (AmevaEvent.functocall() == AmevaEvent.StopSimulation)
 	{
-		StopSimulation(AmevaEvent.stopsimulationparams());
+		const sl_pb::StopSimulationParams& Params = AmevaEvent.stopsimulationparams();
+		OutCommand.Type = ESLKRCommandType::StopSimulation;
+		OutCommand.Ids.Reserve(Params.id_size());
+		for (int32 Idx = 0; Idx < Params.id_size(); ++Idx)
+		{
+			OutCommand.Ids.Emplace(UTF8_TO_TCHAR(Params.id(Idx).c_str()));
+		}
 	}
 	else if (AmevaEvent.functocall() == AmevaEvent.StartLogging)
 	{
-		StartLogging(AmevaEvent.startloggingparams());
+		const sl_pb::StartLoggingParams& Params = AmevaEvent.startloggingparams();
+		OutCommand.Type = ESLKRCommandType::StartLogging;
+		OutCommand.Id = UTF8_TO_TCHAR(Params.taskid().c_str());
+		OutCommand.EpisodeId = UTF8_TO_TCHAR(Params.episodeid().c_str());
 	}
 	else if (AmevaEvent.functocall() == AmevaEvent.StopLogging)
 	{
-		StopLogging();
+		OutCommand.Type = ESLKRCommandType::StopLogging;
 	}
 	else if (AmevaEvent.functocall() == AmevaEvent.GetEpisodeData)
 	{
-		SendEpisodeData(AmevaEvent.getepisodedataparams());
+		const sl_pb::GetEpisodeDataParams& Params = AmevaEvent.getepisodedataparams();
+		OutCommand.Type = ESLKRCommandType::GetEpisodeData;
+		OutCommand.Id = UTF8_TO_TCHAR(Params.taskid().c_str());
+		OutCommand.EpisodeId = UTF8_TO_TCHAR(Params.episodeid().c_str());
 	}
 	else if (AmevaEvent.functocall() == AmevaEvent.SetIndividualPose)
 	{
-		SetIndividualPose(AmevaEvent.setindividualposeparams());
+		const sl_pb::SetIndividualPoseParams& Params = AmevaEvent.setindividualposeparams();
+		OutCommand.Type = ESLKRCommandType::SetIndividualPose;
+		OutCommand.Id = UTF8_TO_TCHAR(Params.id().c_str());
+		OutCommand.Vector = FVector(Params.vecx(), Params.vecy(), Params.vecz());
+		// TODO switch to X Y Z W, also in knowrob_ameva src/ue_control_cpp -> ue_set_individual_pose
+		OutCommand.Quat = FQuat(Params.quatw(), Params.quatx(), Params.quaty(), Params.quatz());
 	}
 	else if (AmevaEvent.functocall() == AmevaEvent.ApplyForceTo)
 	{
-		ApplyForceTo(AmevaEvent.applyforcetoparams());
+		const sl_pb::ApplyForceToParams& Params = AmevaEvent.applyforcetoparams();
+		OutCommand.Type = ESLKRCommandType::ApplyForceTo;
+		OutCommand.Id = UTF8_TO_TCHAR(Params.id().c_str());
+		OutCommand.Vector = FVector(Params.forcex(), Params.forcey(), Params.forcez());
 	}
 	else if (AmevaEvent.functocall() == AmevaEvent.Highlight)
 	{
-		HighlightIndividual(AmevaEvent.highlightparams());
+		const sl_pb::HighlightParams& Params = AmevaEvent.highlightparams();
+		OutCommand.Type = ESLKRCommandType::Highlight;
+		OutCommand.Id = UTF8_TO_TCHAR(Params.id().c_str());
+		OutCommand.MaterialType = GetMarkerMaterialType(UTF8_TO_TCHAR(Params.material().c_str()));
+		OutCommand.Color = GetMarkerColor(UTF8_TO_TCHAR(Params.color().c_str()));
 	}
 	else if (AmevaEvent.functocall() == AmevaEvent.RemoveHighlight)
 	{
-		RemoveIndividualHighlight(AmevaEvent.removehighlightparams());
+		OutCommand.Type = ESLKRCommandType::RemoveHighlight;
+		OutCommand.Id = UTF8_TO_TCHAR(AmevaEvent.removehighlightparams().id().c_str());
 	}
 	else if (AmevaEvent.functocall() == AmevaEvent.RemoveAllHighlight)
 	{
-		RemoveAllIndividualHighlight();
+		OutCommand.Type = ESLKRCommandType::RemoveAllHighlight;
 	}
-
+	else
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Unknown function (%d).."),
+			*FString(__FUNCTION__), __LINE__, static_cast<int32>(AmevaEvent.functocall()));
+		return false;
+	}
+	return true;
+#else
+	return false;
 #endif // SL_WITH_PROTO
 }
 
-#if SL_WITH_PROTO
+// Call the function of the decoded command (game thread)
+void SLKRMsgDispatcher::ExecuteCommand(FSLKRCommand& Command)
+{
+	switch (Command.Type)
+	{
+	case ESLKRCommandType::SetTask:
+		SetTask(Command);
+		break;
+	case ESLKRCommandType::SetEpisode:
+		SetEpisode(Command);
+		break;
+	case ESLKRCommandType::DrawMarkerAt:
+		DrawMarker(Command);
+		break;
+	case ESLKRCommandType::DrawMarkerTraj:
+		DrawMarkerTraj(Command);
+		break;
+	case ESLKRCommandType::LoadLevel:
+		LoadLevel(Command);
+		break;
+	case ESLKRCommandType::StartSimulation:
+		StartSimulation(Command);
+		break;
+	case ESLKRCommandType::StopSimulation:
+		StopSimulation(Command);
+		break;
+	case ESLKRCommandType::StartLogging:
+		StartLogging(Command);
+		break;
+	case ESLKRCommandType::StopLogging:
+		StopLogging();
+		break;
+	case ESLKRCommandType::GetEpisodeData:
+		SendEpisodeData(Command);
+		break;
+	case ESLKRCommandType::SetIndividualPose:
+		SetIndividualPose(Command);
+		break;
+	case ESLKRCommandType::ApplyForceTo:
+		ApplyForceTo(Command);
+		break;
+	case ESLKRCommandType::Highlight:
+		HighlightIndividual(Command);
+		break;
+	case ESLKRCommandType::RemoveHighlight:
+		RemoveIndividualHighlight(Command);
+		break;
+	case ESLKRCommandType::RemoveAllHighlight:
+		RemoveAllIndividualHighlight();
+		break;
+	default:
+		break;
+	}
+}
+
 // Set the task of MongoManager
-void SLKRMsgDispatcher::SetTask(sl_pb::SetTaskParams params)
+void SLKRMsgDispatcher::SetTask(const FSLKRCommand& Command)
 {
-	const FString TaskId = FString(UTF8_TO_TCHAR(params.task().c_str()));
+	const FString& TaskId = Command.Id;
 	bool bSuccess = MongoManager->SetTask(TaskId);
 	FSLKRResponse Response;
 	Response.Type = ResponseType::TEXT;
 	if (bSuccess)
 	{
-		Response.Text = FString::Printf(TEXT("[%.4f] Sucesfully set task id to %s .."), *TaskId, FPlatformTime::Seconds());
+		Response.Text = FString::Printf(TEXT("[%.4f] Sucesfully set task id to %s .."), FPlatformTime::Seconds(), *TaskId);
 	}
 	else
 	{
-		Response.Text = FString::Printf(TEXT("[%.4f] Failed to set task id to %s .."), *TaskId, FPlatformTime::Seconds());
+		Response.Text = FString::Printf(TEXT("[%.4f] Failed to set task id to %s .."), FPlatformTime::Seconds(), *TaskId);
 	}
 	KRWSClient->SendResponse(Response);	
 }
 
 // Set the episode of MongoManager
-void SLKRMsgDispatcher::SetEpisode(sl_pb::SetEpisodeParams params)
+void SLKRMsgDispatcher::SetEpisode(const FSLKRCommand& Command)
 {
-	const FString EpId = FString(UTF8_TO_TCHAR(params.episode().c_str()));
+	const FString& EpId = Command.EpisodeId;
 	bool bSuccess = MongoManager->SetEpisode(EpId);
 	FSLKRResponse Response;
 	Response.Type = ResponseType::TEXT;
 	if (bSuccess)
 	{
-		Response.Text = FString::Printf(TEXT("[%.4f] Sucesfully set episode id to %s .."), *EpId, FPlatformTime::Seconds());
+		Response.Text = FString::Printf(TEXT("[%.4f] Sucesfully set episode id to %s .."), FPlatformTime::Seconds(), *EpId);
 	}
 	else
 	{
-		Response.Text = FString::Printf(TEXT("[%.4f] Failed to set episode id to %s .."), *EpId, FPlatformTime::Seconds());
+		Response.Text = FString::Printf(TEXT("[%.4f] Failed to set episode id to %s .."), FPlatformTime::Seconds(), *EpId);
 	}
 	KRWSClient->SendResponse(Response);
 }
 
 // Draw the individual marker
-void SLKRMsgDispatcher::DrawMarker(sl_pb::DrawMarkerAtParams params)
+void SLKRMsgDispatcher::DrawMarker(const FSLKRCommand& Command)
 {
-	FString Id = UTF8_TO_TCHAR(params.id().c_str());
-	float TimeStamp = params.timestamp();
-	FVector Scale(params.scale());
-	ESLVizPrimitiveMarkerType Type = GetMarkerType(params.marker());
-	ESLVizMaterialType MaterialType = GetMarkerMaterialType(UTF8_TO_TCHAR(params.material().c_str()));
-	FLinearColor Color = GetMarkerColor(UTF8_TO_TCHAR(params.color().c_str()));
-	FTransform Pose = MongoManager->GetIndividualPoseAt(Id, TimeStamp);
 	TArray<FTransform> Poses;
-	Poses.Add(Pose);
-	VizManager->CreatePrimitiveMarker(Id, Poses, Type, params.scale(), Color, MaterialType);
+	Poses.Add(MongoManager->GetIndividualPoseAt(Command.Id, Command.Start));
+	VizManager->CreatePrimitiveMarker(Command.Id, Poses, Command.MarkerType, Command.Scale, Command.Color, Command.MaterialType);
 	FSLKRResponse Response;
 	Response.Type = ResponseType::TEXT;
 	Response.Text = TEXT("Completed - Draw marker");
@@ -185,29 +307,19 @@ void SLKRMsgDispatcher::DrawMarker(sl_pb::DrawMarkerAtParams params)
 }
 
 // Draw the individual trajectory
-void SLKRMsgDispatcher::DrawMarkerTraj(sl_pb::DrawMarkerTrajParams params)
+void SLKRMsgDispatcher::DrawMarkerTraj(const FSLKRCommand& Command)
 {
-	FString Id = UTF8_TO_TCHAR(params.id().c_str());
-	float Start = params.start();
-	float End = params.end();
-	FVector Scale(params.scale());
-	ESLVizPrimitiveMarkerType Type = GetMarkerType(params.marker());
-	ESLVizMaterialType MaterialType = GetMarkerMaterialType(UTF8_TO_TCHAR(params.material().c_str()));
-	FLinearColor Color = GetMarkerColor(UTF8_TO_TCHAR(params.color().c_str()));
-	TArray<FTransform> Poses = MongoManager->GetIndividualTrajectory(Id, Start, End);
-	VizManager->CreatePrimitiveMarker(Id, Poses, Type, params.scale(), Color, MaterialType);
+	TArray<FTransform> Poses = MongoManager->GetIndividualTrajectory(Command.Id, Command.Start, Command.End);
+	VizManager->CreatePrimitiveMarker(Command.Id, Poses, Command.MarkerType, Command.Scale, Command.Color, Command.MaterialType);
 	FSLKRResponse Response;
 	Response.Type = ResponseType::TEXT;
 	Response.Text = TEXT("Completed - Draw trajectory");
 	KRWSClient->SendResponse(Response);
 }
 // Hightlight the individual
-void SLKRMsgDispatcher::HighlightIndividual(sl_pb::HighlightParams params)
+void SLKRMsgDispatcher::HighlightIndividual(const FSLKRCommand& Command)
 {
-	FString Id = UTF8_TO_TCHAR(params.id().c_str());
-	ESLVizMaterialType MaterialType = GetMarkerMaterialType(UTF8_TO_TCHAR(params.material().c_str()));
-	FLinearColor Color = GetMarkerColor(UTF8_TO_TCHAR(params.color().c_str()));
-	VizManager->HighlightIndividual(Id, Color, MaterialType);
+	VizManager->HighlightIndividual(Command.Id, Command.Color, Command.MaterialType);
 	FSLKRResponse Response;
 	Response.Type = ResponseType::TEXT;
 	Response.Text = TEXT("Completed - Highlight individual");
@@ -215,10 +327,9 @@ void SLKRMsgDispatcher::HighlightIndividual(sl_pb::HighlightParams params)
 }
 
 // Remove the individual hightlight
-void SLKRMsgDispatcher::RemoveIndividualHighlight(sl_pb::RemoveHighlightParams params)
+void SLKRMsgDispatcher::RemoveIndividualHighlight(const FSLKRCommand& Command)
 {
-	FString Id = UTF8_TO_TCHAR(params.id().c_str());
-	VizManager->RemoveIndividualHighlight(Id);
+	VizManager->RemoveIndividualHighlight(Command.Id);
 	FSLKRResponse Response;
 	Response.Type = ResponseType::TEXT;
 	Response.Text = TEXT("Completed - Remove individual highlight");
@@ -236,10 +347,9 @@ void SLKRMsgDispatcher::RemoveAllIndividualHighlight()
 }
 
 // Load the Semantic Map
-void SLKRMsgDispatcher::LoadLevel(sl_pb::LoadLevelParams params)
+void SLKRMsgDispatcher::LoadLevel(const FSLKRCommand& Command)
 {
-	FString Level = UTF8_TO_TCHAR(params.level().c_str());
-	LevelManager->SwitchLevelTo(FName(*Level));
+	LevelManager->SwitchLevelTo(FName(*Command.Id));
 	FSLKRResponse Response;
 	Response.Type = ResponseType::TEXT;
 	Response.Text = TEXT("Completed - Switch level");
@@ -247,18 +357,16 @@ void SLKRMsgDispatcher::LoadLevel(sl_pb::LoadLevelParams params)
 }
 
 // Start Symbolic and World State Logger
-void SLKRMsgDispatcher::StartLogging(sl_pb::StartLoggingParams params)
+void SLKRMsgDispatcher::StartLogging(const FSLKRCommand& Command)
 {
-	FString TaskId = UTF8_TO_TCHAR(params.taskid().c_str());
-	FString EpisodeId = UTF8_TO_TCHAR(params.episodeid().c_str());
 	FSLSymbolicLoggerParams SymbolicLoggerParameters;
 	FSLLoggerLocationParams LocationParameters;
 	FSLWorldStateLoggerParams WorldStateLoggerParameters;
 	FSLLoggerDBServerParams DBServerParameters;
 	LocationParameters.bUseCustomTaskId = true;
-	LocationParameters.TaskId = TaskId;
+	LocationParameters.TaskId = Command.Id;
 	LocationParameters.bUseCustomEpisodeId = true;
-	LocationParameters.EpisodeId = EpisodeId;
+	LocationParameters.EpisodeId = Command.EpisodeId;
 	LocationParameters.bOverwrite = true;
 	DBServerParameters.Ip = MongoServerIP;
 	DBServerParameters.Port = MongoServerPort;
@@ -321,22 +429,18 @@ void SLKRMsgDispatcher::StopLogging()
 }
 
 // Send the Symbolic log owl file
-void SLKRMsgDispatcher::SendEpisodeData(sl_pb::GetEpisodeDataParams params)
+void SLKRMsgDispatcher::SendEpisodeData(const FSLKRCommand& Command)
 {
-	FString TaskId = UTF8_TO_TCHAR(params.taskid().c_str());
-	FString EpisodeId = UTF8_TO_TCHAR(params.episodeid().c_str());
+	const FString& TaskId = Command.Id;
+	const FString& EpisodeId = Command.EpisodeId;
 	const FString DirPath = FPaths::ProjectDir() + "/SL/Tasks/" + TaskId + "/";
 	// Write experiment to file
 	FString FullFilePath = DirPath + EpisodeId + TEXT("_ED.owl");
 	FPaths::RemoveDuplicateSlashes(FullFilePath);
 	if (FPaths::FileExists(FullFilePath))
 	{
-		TArray<uint8> FileBinary;
-		FSLKRResponse Response;
-		Response.Type = ResponseType::FILE;
-		Response.FileName = EpisodeId + TEXT("_ED.owl");
-		FFileHelper::LoadFileToArray(Response.FileData, *FullFilePath);
-		KRWSClient->SendResponse(Response);
+		// The file is read and sent in chunks in the background
+		KRWSClient->SendFileAsync(EpisodeId + TEXT("_ED.owl"), FullFilePath);
 	}
 	else 
 	{
@@ -348,43 +452,31 @@ void SLKRMsgDispatcher::SendEpisodeData(sl_pb::GetEpisodeDataParams params)
 }
 
 // Start Simulation
-void SLKRMsgDispatcher::StartSimulation(sl_pb::StartSimulationParams params)
+void SLKRMsgDispatcher::StartSimulation(const FSLKRCommand& Command)
 {
-	TArray<FString> Ids;
-	for (int i = 0; i < params.id_size(); i++) 
-	{
-		FString Id = UTF8_TO_TCHAR(params.id(i).c_str());
-		Ids.Add(Id);
-	}
-
-	int32 Secs = params.duration();
+	const TArray<FString>& Ids = Command.Ids;
+	const int32 Secs = Command.Duration;
 	bool bSuccess = ControlManager->StartSimulationSelectionOnly(Ids, Secs);
 
 	FSLKRResponse Response;
 	Response.Type = ResponseType::TEXT;
 	if (bSuccess)
 	{
-		Response.Text = FString::Printf(TEXT("[%.4f] Sucesfully started simulation of %d individuals for %f secs.."),
+		Response.Text = FString::Printf(TEXT("[%.4f] Sucesfully started simulation of %d individuals for %d secs.."),
 			FPlatformTime::Seconds(), Ids.Num(), Secs);
 	}
 	else
 	{
-		Response.Text = FString::Printf(TEXT("[%.4f] Failed to start simulation of %d individuals for %f secs.."),
+		Response.Text = FString::Printf(TEXT("[%.4f] Failed to start simulation of %d individuals for %d secs.."),
 			FPlatformTime::Seconds(), Ids.Num(), Secs);
 	}
 	KRWSClient->SendResponse(Response);
 }
 
 // Stop Simulation
-void SLKRMsgDispatcher::StopSimulation(sl_pb::StopSimulationParams params)
+void SLKRMsgDispatcher::StopSimulation(const FSLKRCommand& Command)
 {
-	TArray<FString> Ids;
-	for (int i = 0; i < params.id_size(); i++)
-	{
-		FString Id = UTF8_TO_TCHAR(params.id(i).c_str());
-		Ids.Add(Id);
-	}
-
+	const TArray<FString>& Ids = Command.Ids;
 	bool bSuccess = ControlManager->StopSimulationSelectionOnly(Ids);
 
 	FSLKRResponse Response;
@@ -403,12 +495,11 @@ void SLKRMsgDispatcher::StopSimulation(sl_pb::StopSimulationParams params)
 }
 
 // Move Individual
-void SLKRMsgDispatcher::SetIndividualPose(sl_pb::SetIndividualPoseParams params)
+void SLKRMsgDispatcher::SetIndividualPose(const FSLKRCommand& Command)
 {
-	FString Id = UTF8_TO_TCHAR(params.id().c_str());
-	FVector Loc = FVector(params.vecx(), params.vecy(), params.vecz());
-	// TODO switch to X Y Z W, also in knowrob_ameva src/ue_control_cpp -> ue_set_individual_pose
-	FQuat Quat = FQuat(params.quatw(), params.quatx(), params.quaty(), params.quatz());
+	const FString& Id = Command.Id;
+	const FVector& Loc = Command.Vector;
+	const FQuat& Quat = Command.Quat;
 	bool bSuccess = ControlManager->SetIndividualPose(Id, Loc, Quat);
 	FSLKRResponse Response;
 	Response.Type = ResponseType::TEXT;
@@ -426,10 +517,10 @@ void SLKRMsgDispatcher::SetIndividualPose(sl_pb::SetIndividualPoseParams params)
 	KRWSClient->SendResponse(Response);
 }
 
-void SLKRMsgDispatcher::ApplyForceTo(sl_pb::ApplyForceToParams params)
+void SLKRMsgDispatcher::ApplyForceTo(const FSLKRCommand& Command)
 {
-	FString Id = UTF8_TO_TCHAR(params.id().c_str());
-	FVector Force = FVector(params.forcex(), params.forcey(), params.forcez());
+	const FString& Id = Command.Id;
+	const FVector& Force = Command.Vector;
 	bool bSuccess = ControlManager->ApplyForceTo(Id, Force);
 	FSLKRResponse Response;
 	Response.Type = ResponseType::TEXT;
@@ -446,6 +537,7 @@ void SLKRMsgDispatcher::ApplyForceTo(sl_pb::ApplyForceToParams params)
 	KRWSClient->SendResponse(Response);
 }
 
+#if SL_WITH_PROTO
 // Transform the maker type
 ESLVizPrimitiveMarkerType SLKRMsgDispatcher::GetMarkerType(sl_pb::MarkerType Marker)
 {
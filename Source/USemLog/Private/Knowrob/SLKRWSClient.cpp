@@ -3,19 +3,53 @@
 
 #include "Knowrob/SLKRWSClient.h"
 #include "WebSocketsModule.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Compression.h"
+#include "Misc/Crc.h"
+#include "Async/Async.h"
+#include "Async/AsyncWork.h"
+#include "HAL/PlatformProcess.h"
 #if SL_WITH_PROTO
 #include "Knowrob/Proto/SLProtoMsgType.h"
 #endif // SL_WITH_PROTO	
 
 
+/**
+ * Runs the file transfer preparation on the thread pool, deletes itself when done
+ */
+class FSLKRFileTransferAsyncTask : public FNonAbandonableTask
+{
+	friend class FAutoDeleteAsyncTask<FSLKRFileTransferAsyncTask>;
+
+	// Ctor
+	FSLKRFileTransferAsyncTask(TFunction<void()>&& InWork) : Work(MoveTemp(InWork)) {};
+
+	// Prepare the messages
+	void DoWork() { Work(); };
+
+	// Needed internally
+	FORCEINLINE TStatId GetStatId() const { RETURN_QUICK_DECLARE_CYCLE_STAT(FSLKRFileTransferAsyncTask, STATGROUP_ThreadPoolAsyncTasks); }
+
+	// Read, slice and serialize the file
+	TFunction<void()> Work;
+};
+
+// Max number of prepared messages waiting to be sent (bounds the memory of large files)
+static constexpr int32 SLKRMaxNumQueuedFrames = 32;
+
 // Ctor
-FSLKRWSClient::FSLKRWSClient()
+FSLKRWSClient::FSLKRWSClient() : OutgoingFrames(MakeShareable(new FSLKRWSOutgoingFrames()))
 {
+	bIsSendingFile = false;
+	FileChunkSize = 256 * 1024;
+	bCompressFileChunks = false;
 }
 
 // Dtor
 FSLKRWSClient::~FSLKRWSClient()
 {
+	// The running transfer stops on its own, its messages are dropped
+	OutgoingFrames->bIsAlive = false;
 }
 
 // Set websocket conection parameters
@@ -106,6 +140,9 @@ void FSLKRWSClient::Clear()
 		WebSocket.Reset();
 	}
 
+	// Drop the files waiting to be sent
+	PendingFileTransfers.Empty();
+
 	// Clear any remaining messages
 	ReceiveBuffer.Empty();
 	MessageQueue.Empty();
@@ -187,36 +224,175 @@ void FSLKRWSClient::SendResponse(const FSLKRResponse& Response)
 	}
 	else if (Response.Type == ResponseType::FILE)
 	{
-		// Notify knowrob to create a file
-		std::string FLNameStr(TCHAR_TO_UTF8(*Response.FileName));
-		sl_pb::KRAmevaResponse CreationResponse;
-		CreationResponse.set_type(sl_pb::KRAmevaResponse::FileCreation);
-		CreationResponse.set_filename(FLNameStr);
-		std::string ProtoStr = CreationResponse.SerializeAsString();
-		WebSocket->Send(ProtoStr.data(), ProtoStr.size(), true);
+		FSLKRFileTransfer Transfer;
+		Transfer.FileName = Response.FileName;
+		Transfer.FileData = Response.FileData;
+		PendingFileTransfers.Emplace(MoveTemp(Transfer));
+		StartNextFileTransfer();
+	}
+#endif // SL_WITH_PROTO	
+}
+
+// Set the file transfer parameters
+void FSLKRWSClient::SetFileTransferParams(int32 InChunkSize, bool bInCompressChunks)
+{
+	FileChunkSize = FMath::Max(InChunkSize, 1024);
+	bCompressFileChunks = bInCompressChunks;
+}
 
-		// Slice the file data into frames and send them to knowrob
-		const int DefaultFrameSize = 64;
-		for (int Offset = 0; Offset < Response.FileData.Num(); Offset += DefaultFrameSize)
+// Read and send the file in chunks from a worker thread
+void FSLKRWSClient::SendFileAsync(const FString& FileName, const FString& FilePath)
+{
+	FSLKRFileTransfer Transfer;
+	Transfer.FileName = FileName;
+	Transfer.FilePath = FilePath;
+	PendingFileTransfers.Emplace(MoveTemp(Transfer));
+	StartNextFileTransfer();
+}
+
+// Start sending the next file if none is being sent (game thread)
+void FSLKRWSClient::StartNextFileTransfer()
+{
+	if (bIsSendingFile || PendingFileTransfers.Num() == 0)
+	{
+		return;
+	}
+	bIsSendingFile = true;
+
+	FSLKRFileTransfer Transfer = MoveTemp(PendingFileTransfers[0]);
+	PendingFileTransfers.RemoveAt(0, 1, false);
+
+	const int32 ChunkSize = FileChunkSize;
+	const bool bCompress = bCompressFileChunks;
+	TSharedRef<FSLKRWSOutgoingFrames, ESPMode::ThreadSafe> Outgoing = OutgoingFrames;
+	(new FAutoDeleteAsyncTask<FSLKRFileTransferAsyncTask>([this, Transfer, ChunkSize, bCompress, Outgoing]() mutable
+	{
+		// The messages are sent from the game thread as soon as they are ready
+		PrepareFileFrames(Transfer, ChunkSize, bCompress, Outgoing, [this, Outgoing]()
 		{
-			sl_pb::KRAmevaResponse DataResponse;
-			DataResponse.set_type(sl_pb::KRAmevaResponse::FileData);
-			int32 FrameSize = Response.FileData.Num() - Offset < DefaultFrameSize ? Response.FileData.Num() - Offset : DefaultFrameSize;
-			const uint8* FileData = Response.FileData.GetData();
-			uint8 DataFrame[DefaultFrameSize];
-			memcpy(DataFrame, FileData + Offset, FrameSize);
-			DataResponse.set_datalength(FrameSize);
-			DataResponse.set_filedata((char*)DataFrame);
-			ProtoStr = DataResponse.SerializeAsString();
-			WebSocket->Send(ProtoStr.data(), ProtoStr.size(), true);
+			AsyncTask(ENamedThreads::GameThread, [this, Outgoing]()
+			{
+				if (Outgoing->bIsAlive)
+				{
+					SendQueuedFrames();
+				}
+			});
+		});
+
+		AsyncTask(ENamedThreads::GameThread, [this, Outgoing]()
+		{
+			if (Outgoing->bIsAlive)
+			{
+				SendQueuedFrames();
+				bIsSendingFile = false;
+				StartNextFileTransfer();
+			}
+		});
+	}))->StartBackgroundTask();
+}
+
+// Read, slice, compress and serialize the file (worker thread)
+void FSLKRWSClient::PrepareFileFrames(FSLKRFileTransfer& Transfer, int32 ChunkSize, bool bCompress,
+	TSharedRef<FSLKRWSOutgoingFrames, ESPMode::ThreadSafe> Outgoing, TFunctionRef<void()> OnFrameQueued)
+{
+#if SL_WITH_PROTO
+	const double ExecBegin = FPlatformTime::Seconds();
+
+	auto QueueFrame = [&Outgoing, &OnFrameQueued](const sl_pb::KRAmevaResponse& Msg)
+	{
+		Outgoing->Frames.Enqueue(Msg.SerializeAsString());
+		Outgoing->NumQueued.Increment();
+		OnFrameQueued();
+	};
+
+	if (!Transfer.FilePath.IsEmpty() && !FFileHelper::LoadFileToArray(Transfer.FileData, *Transfer.FilePath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not read %s.."), *FString(__FUNCTION__), __LINE__, *Transfer.FilePath);
+		sl_pb::KRAmevaResponse ErrorResponse;
+		ErrorResponse.set_type(sl_pb::KRAmevaResponse::Text);
+		ErrorResponse.set_text("Error: Could not read file");
+		QueueFrame(ErrorResponse);
+		return;
+	}
+	const TArray<uint8>& FileData = Transfer.FileData;
+	const std::string FileNameStr(TCHAR_TO_UTF8(*Transfer.FileName));
+
+	// Notify knowrob to create a file
+	sl_pb::KRAmevaResponse CreationResponse;
+	CreationResponse.set_type(sl_pb::KRAmevaResponse::FileCreation);
+	CreationResponse.set_filename(FileNameStr);
+	CreationResponse.set_datalength(FileData.Num());
+	if (bCompress)
+	{
+		CreationResponse.set_text("zlib");
+	}
+	QueueFrame(CreationResponse);
+
+	// Slice the file data into chunks, compressed chunks are only sent if they are smaller
+	TArray<uint8> CompressedChunk;
+	int64 NumSentBytes = 0;
+	int32 NumChunks = 0;
+	for (int32 Offset = 0; Offset < FileData.Num(); Offset += ChunkSize)
+	{
+		// Wait for the game thread to send the queued messages
+		while (Outgoing->NumQueued.GetValue() >= SLKRMaxNumQueuedFrames && Outgoing->bIsAlive)
+		{
+			FPlatformProcess::Sleep(0.001f);
+		}
+		if (!Outgoing->bIsAlive)
+		{
+			return;
 		}
 
-		// Notify that all the data is sent
-		sl_pb::KRAmevaResponse FinishResponse;
-		FinishResponse.set_type(sl_pb::KRAmevaResponse::FileFinish);
-		FinishResponse.set_filename(FLNameStr);
-		ProtoStr = FinishResponse.SerializeAsString();
-		WebSocket->Send(ProtoStr.data(), ProtoStr.size(), true);
+		const int32 CurrChunkSize = FMath::Min(ChunkSize, FileData.Num() - Offset);
+		const uint8* ChunkData = FileData.GetData() + Offset;
+		int32 ChunkDataSize = CurrChunkSize;
+		if (bCompress)
+		{
+			int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Zlib, CurrChunkSize);
+			CompressedChunk.SetNumUninitialized(CompressedSize, false);
+			if (FCompression::CompressMemory(NAME_Zlib, CompressedChunk.GetData(), CompressedSize, ChunkData, CurrChunkSize)
+				&& CompressedSize < CurrChunkSize)
+			{
+				ChunkData = CompressedChunk.GetData();
+				ChunkDataSize = CompressedSize;
+			}
+		}
+
+		sl_pb::KRAmevaResponse DataResponse;
+		DataResponse.set_type(sl_pb::KRAmevaResponse::FileData);
+		DataResponse.set_datalength(CurrChunkSize);
+		DataResponse.set_filedata(ChunkData, ChunkDataSize);
+		QueueFrame(DataResponse);
+		NumSentBytes += ChunkDataSize;
+		NumChunks++;
 	}
+
+	// Notify that all the data is sent, knowrob can verify the size and checksum
+	sl_pb::KRAmevaResponse FinishResponse;
+	FinishResponse.set_type(sl_pb::KRAmevaResponse::FileFinish);
+	FinishResponse.set_filename(FileNameStr);
+	FinishResponse.set_datalength(FileData.Num());
+	FinishResponse.set_text(TCHAR_TO_UTF8(*FString::Printf(TEXT("crc32:%08x"), FCrc::MemCrc32(FileData.GetData(), FileData.Num()))));
+	QueueFrame(FinishResponse);
+
+	const double Duration = FPlatformTime::Seconds() - ExecBegin;
+	UE_LOG(LogTemp, Log, TEXT("%s::%d Prepared %s: %.2f MB in %d chunks (%.2f MB sent) in [%f] seconds (%.2f MB/s)..;"),
+		*FString(__FUNCTION__), __LINE__, *Transfer.FileName, FileData.Num() / (1024.f * 1024.f), NumChunks,
+		NumSentBytes / (1024.f * 1024.f), Duration, Duration > 0.0 ? FileData.Num() / (1024.f * 1024.f) / Duration : 0.0);
 #endif // SL_WITH_PROTO	
-}
\ No newline at end of file
+}
+
+// Send the messages prepared by the workers (game thread)
+void FSLKRWSClient::SendQueuedFrames()
+{
+	std::string ProtoStr;
+	while (OutgoingFrames->Frames.Dequeue(ProtoStr))
+	{
+		OutgoingFrames->NumQueued.Decrement();
+		if (WebSocket.IsValid() && WebSocket->IsConnected())
+		{
+			WebSocket->Send(ProtoStr.data(), ProtoStr.size(), true);
+		}
+	}
+}
@@ -29,6 +29,7 @@ ASLKnowrobManager::ASLKnowrobManager()
 	bIsInit = false;
 	bIsStarted = false;
 	bIsFinished = false;
+	bKRCommandsScheduled = false;
 
 #if WITH_EDITORONLY_DATA
 	// Make manager sprite smaller (used to easily find the actor in the world)
@@ -203,6 +204,7 @@ void ASLKnowrobManager::Init()
 	{
 		KRWSClient = MakeShareable<FSLKRWSClient>(new FSLKRWSClient());
 		KRWSClient->Init(KRServerIP, KRServerPort, KRWSProtocol);
+		KRWSClient->SetFileTransferParams(KRFileChunkSizeKB * 1024, bKRCompressFileChunks);
 	}
 
 	// Get and connect the mongo query manager
@@ -319,6 +321,11 @@ void ASLKnowrobManager::Start()
 		return;
 	}
 	
+	// Decode the received messages on a worker thread
+	KRMsgDecoder = MakeShareable(new FSLKRMsgDecoder());
+	KRMsgDecoder->OnNewCommands.BindUObject(this, &ASLKnowrobManager::OnKRCommands);
+	KRMsgDecoder->Start();
+
 	if (KRWSClient.IsValid())
 	{
 		// Bind delegates of the knowrob websocket client
@@ -373,6 +380,13 @@ void ASLKnowrobManager::Finish(bool bForced)
 		KRWSClient.Reset();
 	}
 
+	if (KRMsgDecoder.IsValid())
+	{
+		KRMsgDecoder->OnNewCommands.Unbind();
+		KRMsgDecoder->Close();
+		KRMsgDecoder.Reset();
+	}
+
 	bIsStarted = false;
 	bIsInit = false;
 	bIsFinished = true;
@@ -477,14 +491,53 @@ void ASLKnowrobManager::OnKRConnection(bool bConnectionValue)
 // Called when a new message is received from knowrob
 void ASLKnowrobManager::OnKRMsg()
 {
+	// The messages are moved to the decoder, parsing happens on its thread
 	std::string ProtoMsgBinary;
 	while (KRWSClient->MessageQueue.Dequeue(ProtoMsgBinary))
 	{
-#if SL_WITH_PROTO
-		UE_LOG(LogTemp, Log, TEXT("%s::%d Processing message.."), *FString(__FUNCTION__), __LINE__);
-		KRMsgDispatcher->ProcessProtobuf(ProtoMsgBinary);
-#endif // SL_WITH_PROTO	
+		if (KRMsgDecoder.IsValid() && KRMsgDecoder->IsRunning())
+		{
+			KRMsgDecoder->Enqueue(MoveTemp(ProtoMsgBinary));
+		}
+		else
+		{
+			KRMsgDispatcher->ProcessProtobuf(ProtoMsgBinary);
+		}
+	}
+}
+
+// Called when new commands are decoded, executes them within the frame time budget
+void ASLKnowrobManager::OnKRCommands()
+{
+	bKRCommandsScheduled = false;
+	if (!KRMsgDecoder.IsValid() || !KRMsgDispatcher.IsValid())
+	{
+		return;
+	}
+
+	const double ExecBegin = FPlatformTime::Seconds();
+	const double Budget = KRCommandBudgetMs / 1000.0;
+	int32 NumExecuted = 0;
+	FSLKRCommand Command;
+	while (KRMsgDecoder->Dequeue(Command))
+	{
+		KRMsgDispatcher->ExecuteCommand(Command);
+		NumExecuted++;
+
+		// Continue with the remaining commands in the next frame
+		if (Budget > 0.0 && FPlatformTime::Seconds() - ExecBegin > Budget)
+		{
+			if (!bKRCommandsScheduled)
+			{
+				bKRCommandsScheduled = true;
+				GetWorld()->GetTimerManager().SetTimerForNextTick(this, &ASLKnowrobManager::OnKRCommands);
+			}
+			break;
+		}
 	}
+
+	UE_LOG(LogTemp, Verbose, TEXT("%s::%d Executed %d commands in [%f] seconds (%d invalid messages so far).."),
+		*FString(__FUNCTION__), __LINE__, NumExecuted, FPlatformTime::Seconds() - ExecBegin, KRMsgDecoder->GetNumInvalid());
 }
 
 // Get the mongo query manager from the world (or spawn a new one)
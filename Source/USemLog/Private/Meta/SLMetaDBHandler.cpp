@@ -25,9 +25,6 @@ bool FSLMetaDBHandler::Connect(const FString& DBName, const FString& ServerIp, u
 	const FString ScansCollName = DBName + ".scans";
 
 #if SL_WITH_LIBMONGO_C
-	// Required to initialize libmongoc's internals	
-	mongoc_init();
-
 	// Stores any error that might appear during the connection
 	bson_error_t error;
 
@@ -170,7 +167,6 @@ void FSLMetaDBHandler::Disconnect() const
 	//{
 	//	bson_destroy(scan_entry_doc);
 	//}
-	mongoc_cleanup();
 #endif //SL_WITH_LIBMONGO_C
 }
 
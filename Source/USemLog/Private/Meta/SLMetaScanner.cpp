@@ -138,6 +138,9 @@ void USLMetaScanner::Init(const FString& InTaskId, FSLMetaScannerParams ScanPara
 		// Bind the screenshot callback
 		ViewportClient->OnScreenshotCaptured().AddUObject(this, &USLMetaScanner::ScreenshotCB);
 
+		// Compress and save the images in the background
+		ImageWriter.Init(ScanParams.ImageCodec);
+
 		bIsInit = true;
 	}
 }
@@ -175,6 +178,9 @@ void USLMetaScanner::Finish()
 {
 	if (!bIsFinished && (bIsInit || bIsStarted))
 	{
+		// Wait for the images in flight and log the timings
+		ImageWriter.Finish(TEXT("Meta scanner"));
+
 		bIsStarted = false;
 		bIsInit = false;
 		bIsFinished = true;
@@ -219,19 +225,23 @@ void USLMetaScanner::ScreenshotCB(int32 SizeX, int32 SizeY, const TArray<FColor>
 	//// Remove const-ness from array
 	//TArray<FColor>& BitmapRef = const_cast<TArray<FColor>&>(Bitmap)
 
-	// Compress image
-	TArray<uint8> CompressedBitmap;
-	FImageUtils::CompressImageArray(SizeX, SizeY, Bitmap, CompressedBitmap);
-
-	// Add image current scan data
-	ScanPoseData.Images.Emplace(GetViewModeName(ViewModes[CurrViewModeIdx]), CompressedBitmap);
-
-	// Save the png locally
+	// Check if the image should be saved locally as well
+	TArray<FString> Paths;
 	if (!SaveLocallyFolderName.IsEmpty())
 	{
-		SaveImageLocally(CompressedBitmap);
+		Paths.Emplace(GetLocalImagePath());
 	}
 
+	// Reserve the image entry of the current scan data, the writer compresses and saves a copy of the bitmap in the background
+	const int32 ImageIdx = ScanPoseData.Images.Emplace(GetViewModeName(ViewModes[CurrViewModeIdx]), TArray<uint8>());
+	ImageWriter.Enqueue(TArray<FColor>(Bitmap), SizeX, SizeY, MoveTemp(Paths), [this, ImageIdx](TArray<uint8>&& CompressedBitmap)
+	{
+		if (ScanPoseData.Images.IsValidIndex(ImageIdx))
+		{
+			ScanPoseData.Images[ImageIdx].Value = MoveTemp(CompressedBitmap);
+		}
+	});
+
 	// Item and camera in position, check for other view modes
 	if (SetupNextViewMode())
 	{
@@ -248,6 +258,8 @@ void USLMetaScanner::ScreenshotCB(int32 SizeX, int32 SizeY, const TArray<FColor>
 		// Check for next camera poses
 		if (GotoNextScanPose())
 		{
+			// Wait for the images of the scan pose to be compressed
+			ImageWriter.Flush();
 			//MetadataLoggerParent->AddScanPoseEntry(ScanPoseData);
 			ScanPoseData.Images.Empty();
 			ScanPoseData.CameraPose = CameraPoseActor->GetActorTransform(); //ScanPoses[CurrPoseIdx];
@@ -256,6 +268,8 @@ void USLMetaScanner::ScreenshotCB(int32 SizeX, int32 SizeY, const TArray<FColor>
 		}
 		else
 		{
+			// Wait for the images of the scan pose to be compressed
+			ImageWriter.Flush();
 			//MetadataLoggerParent->AddScanPoseEntry(ScanPoseData);
 			ScanPoseData.Images.Empty();
 			//MetadataLoggerParent->FinishScanEntry();
@@ -903,13 +917,13 @@ void USLMetaScanner::QuitEditor()
 #endif // WITH_EDITOR
 }
 
-// Save the compressed screenshot image locally
-void USLMetaScanner::SaveImageLocally(const TArray<uint8>& CompressedBitmap)
+// Get the path where to save the compressed screenshot image locally
+FString USLMetaScanner::GetLocalImagePath() const
 {
 	FString ItemClassFolder = ScanItems[CurrItemIdx].Value + "_" + ViewModeString + "/";
-	FString Path = FPaths::ProjectDir() + SaveLocallyFolderName + ItemClassFolder + CurrScanName + ".png";
+	FString Path = FPaths::ProjectDir() + SaveLocallyFolderName + ItemClassFolder + CurrScanName + ImageWriter.GetFileExtension();
 	FPaths::RemoveDuplicateSlashes(Path);
-	FFileHelper::SaveArrayToFile(CompressedBitmap, *Path);
+	return Path;
 }
 
 // Output progress to terminal
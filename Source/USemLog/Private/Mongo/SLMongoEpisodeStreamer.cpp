@@ -0,0 +1,156 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "Mongo/SLMongoEpisodeStreamer.h"
+#include "Mongo/SLMongoQueryDBHandler.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/PlatformProcess.h"
+
+// Ctor
+FSLMongoEpisodeStreamer::FSLMongoEpisodeStreamer()
+{
+	Thread = nullptr;
+	bStopRequested = false;
+	bReadFinished = false;
+	ServerPort = 0;
+	StartTs = -1.f;
+	EndTs = -1.f;
+	MaxNumQueuedFrames = 512;
+}
+
+// Dtor
+FSLMongoEpisodeStreamer::~FSLMongoEpisodeStreamer()
+{
+	Shutdown();
+}
+
+// Start streaming the frames between the timestamps, the first frame holds the full world state at the start time
+bool FSLMongoEpisodeStreamer::Start(const FString& InServerIp, uint16 InServerPort, const FString& InDBName, const FString& InCollName,
+	float InStartTs, float InEndTs, int32 InMaxNumQueuedFrames)
+{
+	if (Thread)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d Streamer is already running, restart it instead.."), *FString(__FUNCTION__), __LINE__);
+		return false;
+	}
+
+	ServerIp = InServerIp;
+	ServerPort = InServerPort;
+	DBName = InDBName;
+	CollName = InCollName;
+	StartTs = InStartTs;
+	EndTs = InEndTs;
+	MaxNumQueuedFrames = FMath::Max(InMaxNumQueuedFrames, 2);
+
+	bStopRequested = false;
+	bReadFinished = false;
+	Thread = FRunnableThread::Create(this, TEXT("SLMongoEpisodeStreamer"), 0, TPri_BelowNormal);
+	if (!Thread)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not create the streaming thread.."), *FString(__FUNCTION__), __LINE__);
+		return false;
+	}
+	return true;
+}
+
+// Restart streaming from the start time with the same parameters (used for looping)
+bool FSLMongoEpisodeStreamer::Restart()
+{
+	Shutdown();
+	return Start(ServerIp, ServerPort, DBName, CollName, StartTs, EndTs, MaxNumQueuedFrames);
+}
+
+// Stop the worker and clear the queued frames
+void FSLMongoEpisodeStreamer::Shutdown()
+{
+	if (Thread)
+	{
+		Stop();
+		Thread->WaitForCompletion();
+		delete Thread;
+		Thread = nullptr;
+	}
+	Frames.Empty();
+	NumQueuedFrames.Reset();
+}
+
+// Get the next frame (game thread), false if no frame is available yet
+bool FSLMongoEpisodeStreamer::Dequeue(TPair<float, TMap<FString, FTransform>>& OutFrame)
+{
+	if (Frames.Dequeue(OutFrame))
+	{
+		NumQueuedFrames.Decrement();
+		return true;
+	}
+	return false;
+}
+
+// Read the frames in windows until the end of the timeline or a stop request
+uint32 FSLMongoEpisodeStreamer::Run()
+{
+	const double ExecBegin = FPlatformTime::Seconds();
+
+	FSLMongoQueryDBHandler DBHandler;
+	if (!DBHandler.Connect(ServerIp, ServerPort) || !DBHandler.SetDatabase(DBName) || !DBHandler.SetCollection(CollName))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not connect to %s.%s, streaming aborted.."),
+			*FString(__FUNCTION__), __LINE__, *DBName, *CollName);
+		bReadFinished = true;
+		return 1;
+	}
+
+	// The following frames only hold the changes, the first one is the full world state at the start time
+	double LastTs = StartTs;
+	int32 NumReadFrames = 0;
+	TMap<FString, FTransform> StartFrame = DBHandler.GetFrameData(StartTs);
+	if (StartFrame.Num() > 0)
+	{
+		Frames.Enqueue(TPair<float, TMap<FString, FTransform>>(StartTs, MoveTemp(StartFrame)));
+		NumQueuedFrames.Increment();
+		NumReadFrames++;
+	}
+	double FirstFrameDuration = FPlatformTime::Seconds() - ExecBegin;
+
+	// Query a new window only if a larger part of the queue was consumed (avoids many small queries)
+	const int32 MinWindowSize = FMath::Max(MaxNumQueuedFrames / 4, 1);
+	TArray<TPair<float, TMap<FString, FTransform>>> Window;
+	Window.Reserve(MaxNumQueuedFrames);
+	bool bEndReached = false;
+	while (!bStopRequested && !bEndReached)
+	{
+		const int32 NumFreeSlots = MaxNumQueuedFrames - NumQueuedFrames.GetValue();
+		if (NumFreeSlots < MinWindowSize)
+		{
+			FPlatformProcess::Sleep(0.005f);
+			continue;
+		}
+
+		Window.Reset();
+		if (!DBHandler.GetEpisodeDataWindow(LastTs, NumFreeSlots, Window) || Window.Num() == 0)
+		{
+			break;
+		}
+		for (auto& Frame : Window)
+		{
+			if (EndTs > 0.f && Frame.Key > EndTs)
+			{
+				bEndReached = true;
+				break;
+			}
+			Frames.Enqueue(MoveTemp(Frame));
+			NumQueuedFrames.Increment();
+			NumReadFrames++;
+		}
+	}
+	bReadFinished = true;
+
+	UE_LOG(LogTemp, Log, TEXT("%s::%d Durations: first frame=[%f], streamed frames(num=%d) total=[%f] seconds..;"),
+		*FString(__func__), __LINE__, FirstFrameDuration, NumReadFrames, FPlatformTime::Seconds() - ExecBegin);
+	return 0;
+}
+
+// Request the worker to stop
+void FSLMongoEpisodeStreamer::Stop()
+{
+	bStopRequested = true;
+}
@@ -2,17 +2,45 @@
 // Author: Andrei Haidu (http://haidu.eu)
 
 #include "Mongo/SLMongoQueryDBHandler.h"
+#include "Mongo/SLMongoEpisodeStreamer.h"
+#include "Algo/BinarySearch.h"
+#include "Utils/SLPoseCodec.h"
 
 #if SL_WITH_ROS_CONVERSIONS
 #include "Conversions.h"
 #endif // SL_WITH_ROS_CONVERSIONS
 
+#if SL_WITH_LIBMONGO_C
+// Guards the shared client pools
+static FCriticalSection ClientPoolsLock;
+
+// Shared client pools, one per server uri
+static TMap<FString, mongoc_client_pool_t*> ClientPools;
+#endif // SL_WITH_LIBMONGO_C
+
 // Ctor
 FSLMongoQueryDBHandler::FSLMongoQueryDBHandler()
 {
 	bConnected = false;
 	bDatabaseSet = false;
 	bCollectionSet = false;
+	bCompactPoses = false;
+	PositionResolution = 0.0001f;
+	bSparseBones = false;
+	bLocalBones = false;
+	ConnServerPort = 0;
+	bPoseCacheEnabled = false;
+	PoseCacheWindowSize = 10.f;
+	PoseCacheMaxNumFrames = 8192;
+	bPoseCacheValid = false;
+#if SL_WITH_LIBMONGO_C
+	pool = nullptr;
+	client = nullptr;
+	database = nullptr;
+	collection = nullptr;
+	trj_collection = nullptr;
+	meta_collection = nullptr;
+#endif // SL_WITH_LIBMONGO_C
 }
 
 // Dtor
@@ -34,25 +62,20 @@ bool FSLMongoQueryDBHandler::Connect(const FString& ServerIp, uint16 ServerPort)
 	const bool bCheckConnection = true;
 
 #if SL_WITH_LIBMONGO_C
-	// Required to initialize libmongoc's internals
-	mongoc_init();
-
 	// Stores any error that might appear during the connection
 	bson_error_t error;
 
-	// Create a MongoDB URI object from the given string
+	// Get the shared pool of the server (libmongoc is initialized once by the module)
 	FString Uri = TEXT("mongodb://") + ServerIp + TEXT(":") + FString::FromInt(ServerPort);
-	const char* uri_string = TCHAR_TO_UTF8(*Uri);
-	uri = mongoc_uri_new_with_error(uri_string, &error);
-	if (!uri)
+	pool = GetClientPool(Uri);
+	if (!pool)
 	{
-		UE_LOG(LogTemp, Error, TEXT("%s::%d Err.:%s"),
-			*FString(__func__), __LINE__, *FString(error.message));
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not create the client pool of %s.."), *FString(__FUNCTION__), __LINE__, *Uri);
 		return false;
 	}
 
-	// Create a new client instance
-	client = mongoc_client_new_from_uri(uri);
+	// Pop a client from the pool, a client is used by a single thread at a time
+	client = mongoc_client_pool_pop(pool);
 	if (!client)
 	{
 		bConnected = false;
@@ -60,9 +83,6 @@ bool FSLMongoQueryDBHandler::Connect(const FString& ServerIp, uint16 ServerPort)
 		return false;
 	}
 
-	// Register the application name so we can track it in the profile logs on the server
-	mongoc_client_set_appname(client, "MongoQA");
-
 	if (bCheckConnection)
 	{
 		// Check server. Ping the "admin" database
@@ -73,6 +93,8 @@ bool FSLMongoQueryDBHandler::Connect(const FString& ServerIp, uint16 ServerPort)
 			UE_LOG(LogTemp, Error, TEXT("%s::%d Check server err.: %s"),
 				*FString(__func__), __LINE__, *FString(error.message));
 			bson_destroy(server_ping_cmd);
+			mongoc_client_pool_push(pool, client);
+			client = nullptr;
 			bConnected = false;
 			return false;
 		}
@@ -80,6 +102,8 @@ bool FSLMongoQueryDBHandler::Connect(const FString& ServerIp, uint16 ServerPort)
 	}
 
 	//UE_LOG(LogTemp, Log, TEXT("%s::%d Succesfully connected to: %s"), *FString(__func__), __LINE__, *Uri);		
+	ConnServerIp = ServerIp;
+	ConnServerPort = ServerPort;
 	bConnected = true;
 	return true;
 #else
@@ -150,6 +174,8 @@ bool FSLMongoQueryDBHandler::SetDatabase(const FString& InDBName)
 	}
 	meta_collection = mongoc_database_get_collection(database, TCHAR_TO_UTF8(*(InDBName + ".meta")));
 
+	ConnDBName = InDBName;
+	ClearPoseCache();
 	bDatabaseSet = true;
 	return true;
 #else
@@ -187,6 +213,33 @@ bool FSLMongoQueryDBHandler::SetCollection(const FString& InCollName)
 
 	// Set collection
 	collection = mongoc_database_get_collection(database, TCHAR_TO_UTF8(*InCollName));
+	ClearPoseCache();
+
+	// Use the trajectory buckets for the individual queries if the episode has them
+	if (trj_collection)
+	{
+		mongoc_collection_destroy(trj_collection);
+		trj_collection = nullptr;
+	}
+	bson_error_t trj_error;
+	if (mongoc_database_has_collection(database, TCHAR_TO_UTF8(*(InCollName + ".trj")), &trj_error))
+	{
+		trj_collection = mongoc_database_get_collection(database, TCHAR_TO_UTF8(*(InCollName + ".trj")));
+	}
+
+	// Compact encoded collections reference the individuals by their id table index
+	IdToIdx.Empty();
+	SkelIdToIdx.Empty();
+	bCompactPoses = ReadIdTable(collection, IdTable, SkelIdTable, PositionResolution, bSparseBones, bLocalBones);
+	for (int32 Idx = 0; Idx < IdTable.Num(); ++Idx)
+	{
+		IdToIdx.Add(IdTable[Idx], Idx);
+	}
+	for (int32 Idx = 0; Idx < SkelIdTable.Num(); ++Idx)
+	{
+		SkelIdToIdx.Add(SkelIdTable[Idx], Idx);
+	}
+	ConnCollName = InCollName;
 	bCollectionSet = true;
 	return true;
 #else
@@ -202,33 +255,95 @@ void FSLMongoQueryDBHandler::Disconnect()
 	bConnected = false;
 	bDatabaseSet = false;
 	bCollectionSet = false;
+	bCompactPoses = false;
+	bSparseBones = false;
+	bLocalBones = false;
+	IdTable.Empty();
+	SkelIdTable.Empty();
+	IdToIdx.Empty();
+	SkelIdToIdx.Empty();
+	ClearPoseCache();
 
 #if SL_WITH_LIBMONGO_C
-	// Release handles and clean up libmongoc
+	// Release handles
 	if (meta_collection)
 	{
 		mongoc_collection_destroy(meta_collection);
+		meta_collection = nullptr;
 	}
 	if (collection)
 	{
 		mongoc_collection_destroy(collection);
+		collection = nullptr;
 	}
-	if (database)
+	if (trj_collection)
 	{
-		mongoc_database_destroy(database);
+		mongoc_collection_destroy(trj_collection);
+		trj_collection = nullptr;
 	}
-	if (uri)
+	if (database)
 	{
-		mongoc_uri_destroy(uri);
+		mongoc_database_destroy(database);
+		database = nullptr;
 	}
 	if (client)
 	{
-		mongoc_client_destroy(client);
+		// Give the client back to the pool
+		mongoc_client_pool_push(pool, client);
+		client = nullptr;
 	}
-	mongoc_cleanup();
+	pool = nullptr;
 #endif //SL_WITH_LIBMONGO_C
 }
 
+#if SL_WITH_LIBMONGO_C
+// Get the shared (thread safe) client pool of the server uri, created on first use
+mongoc_client_pool_t* FSLMongoQueryDBHandler::GetClientPool(const FString& InUri)
+{
+	FScopeLock Lock(&ClientPoolsLock);
+	if (mongoc_client_pool_t** PoolPtr = ClientPools.Find(InUri))
+	{
+		return *PoolPtr;
+	}
+
+	// Create a MongoDB URI object from the given string
+	bson_error_t error;
+	mongoc_uri_t* pool_uri = mongoc_uri_new_with_error(TCHAR_TO_UTF8(*InUri), &error);
+	if (!pool_uri)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Err.:%s"),
+			*FString(__func__), __LINE__, *FString(error.message));
+		return nullptr;
+	}
+
+	// The pool keeps its own copy of the uri
+	mongoc_client_pool_t* new_pool = mongoc_client_pool_new(pool_uri);
+	mongoc_uri_destroy(pool_uri);
+	if (!new_pool)
+	{
+		return nullptr;
+	}
+
+	// Register the application name so we can track it in the profile logs on the server
+	mongoc_client_pool_set_appname(new_pool, "MongoQA");
+	ClientPools.Add(InUri, new_pool);
+	return new_pool;
+}
+#endif // SL_WITH_LIBMONGO_C
+
+// Destroy the shared client pools
+void FSLMongoQueryDBHandler::DestroyClientPools()
+{
+#if SL_WITH_LIBMONGO_C
+	FScopeLock Lock(&ClientPoolsLock);
+	for (auto& Pair : ClientPools)
+	{
+		mongoc_client_pool_destroy(Pair.Value);
+	}
+	ClientPools.Empty();
+#endif // SL_WITH_LIBMONGO_C
+}
+
 /* Queries */
 // Get the pose of the individual at the given time
 FTransform FSLMongoQueryDBHandler::GetIndividualPoseAt(const FString& Id, float Ts) const
@@ -240,22 +355,52 @@ FTransform FSLMongoQueryDBHandler::GetIndividualPoseAt(const FString& Id, float
 		return Pose;
 	}
 
+	// Nearby timestamps are answered from the cached window
+	if (bPoseCacheEnabled && GetCachedPoseAt(Id, Ts, Pose))
+	{
+		return Pose;
+	}
+	return QueryIndividualPoseAt(Id, Ts);
+}
+
+// Query the pose of the individual at the given time from the database
+FTransform FSLMongoQueryDBHandler::QueryIndividualPoseAt(const FString& Id, float Ts) const
+{
+	FTransform Pose;
 #if SL_WITH_LIBMONGO_C	
 	double ExecBegin = FPlatformTime::Seconds();
 
+	// Single indexed bucket lookup instead of unwinding the frames
+	if (trj_collection && GetBucketPoseAt(Id, Ts, Pose))
+	{
+		UE_LOG(LogTemp, Log, TEXT("%s::%d Durations: bucket=[%f] seconds..;"),
+			*FString(__func__), __LINE__, FPlatformTime::Seconds() - ExecBegin);
+		return Pose;
+	}
+
 	bson_error_t error;
 	const bson_t *doc;
 	mongoc_cursor_t *cursor;
 	bson_t *pipeline;
 
+	// Match by id, or by the id table index if the poses are compact
+	bson_t id_filter;
+	if (!CreateIdFilter(Id, "individuals", &id_filter))
+	{
+		bson_destroy(&id_filter);
+		return Pose;
+	}
+
 	pipeline = BCON_NEW("pipeline", "[",
 		"{",
 			"$match",
 			"{",
 				"timestamp", "{", "$lte", BCON_DOUBLE(Ts), "}",
-				"individuals.id", BCON_UTF8(TCHAR_TO_ANSI(*Id)),		// yields faster results if we match against the id from the start
 			"}",
 		"}",
+		"{",
+			"$match", BCON_DOCUMENT(&id_filter),					// yields faster results if we match against the id from the start (merged with the previous stage)
+		"}",
 		"{",
 			"$sort",
 			"{",
@@ -269,10 +414,7 @@ FTransform FSLMongoQueryDBHandler::GetIndividualPoseAt(const FString& Id, float
 			"$unwind", BCON_UTF8("$individuals"),
 		"}",
 		"{",
-			"$match",
-			"{",
-				"individuals.id", BCON_UTF8(TCHAR_TO_ANSI(*Id)),		// match against the searched id in the unwinded array (has all individuals from the doc)
-			"}",
+			"$match", BCON_DOCUMENT(&id_filter),					// match against the searched id in the unwinded array (has all individuals from the doc)
 		"}",
 		"{",
 			"$project",
@@ -282,6 +424,7 @@ FTransform FSLMongoQueryDBHandler::GetIndividualPoseAt(const FString& Id, float
 				"loc", BCON_UTF8("$individuals.loc"),
 				"quat", BCON_UTF8("$individuals.quat"),
 				"pose", BCON_UTF8("$individuals.pose"),
+				"p", BCON_UTF8("$individuals.p"),							// compact binary pose
 			"}",
 		"}",
 		"]");
@@ -307,6 +450,7 @@ FTransform FSLMongoQueryDBHandler::GetIndividualPoseAt(const FString& Id, float
 
 	mongoc_cursor_destroy(cursor);
 	bson_destroy(pipeline);
+	bson_destroy(&id_filter);
 	UE_LOG(LogTemp, Log, TEXT("%s::%d Durations: query=[%f], cursor=[%f], total=[%f] seconds..;"),
 		*FString(__func__), __LINE__, QueryDuration, CursorReadDuration, FPlatformTime::Seconds() - ExecBegin);
 #endif
@@ -323,67 +467,93 @@ TArray<FTransform> FSLMongoQueryDBHandler::GetIndividualTrajectory(const FString
 		return Trajectory;
 	}
 
+	// Short trajectories are answered from the cached window
+	if (bPoseCacheEnabled && GetCachedTrajectory(Id, StartTs, EndTs, DeltaT, Trajectory))
+	{
+		if (Trajectory.Num() == 0)
+		{
+			Trajectory.Add(GetIndividualPoseAt(Id, StartTs));
+		}
+		return Trajectory;
+	}
+
 #if SL_WITH_LIBMONGO_C
 	double ExecBegin = FPlatformTime::Seconds();
 
+	// Read the packed samples of the overlapping buckets instead of unwinding the frames
+	if (trj_collection && GetBucketTrajectory(Id, StartTs, EndTs, DeltaT, Trajectory))
+	{
+		UE_LOG(LogTemp, Log, TEXT("%s::%d Durations: bucket=[%f] seconds, Num=[%d]..;"),
+			*FString(__func__), __LINE__, FPlatformTime::Seconds() - ExecBegin, Trajectory.Num());
+		return Trajectory;
+	}
+
 	bson_error_t error;
 	const bson_t *doc;
 	mongoc_cursor_t *cursor;
 	bson_t *pipeline;
 
-	pipeline = BCON_NEW("pipeline", "[",
-		"{",
-			"$match",
+	// Match by id, or by the id table index if the poses are compact
+	bson_t id_filter;
+	if (!CreateIdFilter(Id, "individuals", &id_filter))
+	{
+		bson_destroy(&id_filter);
+		return Trajectory;
+	}
+
+	// Time range, or the downsampled frames if a delta time is given
+	TArray<bson_t*> time_filters;
+	CreateTrajectoryTimeFilters(&id_filter, StartTs, EndTs, DeltaT, time_filters);
+	double QueryDuration = 0.0;
+
+	// The skipped frames are not read anymore, the delta time check is kept since it also skips duplicate timestamps
+	double PrevTs = -BIG_NUMBER;
+	for (bson_t* time_filter : time_filters)
+	{
+		const double BatchBegin = FPlatformTime::Seconds();
+		pipeline = BCON_NEW("pipeline", "[",
 			"{",
-				"timestamp", 
-				"{", 
-					"$gte", BCON_DOUBLE(StartTs),
-					"$lte", BCON_DOUBLE(EndTs),
+				"$match", BCON_DOCUMENT(time_filter),
+			"}",
+			"{",
+				"$match", BCON_DOCUMENT(&id_filter),					// yields faster results if we match against the id from the start (merged with the previous stage)
+			"}",
+			"{",
+				"$sort",
+				"{",
+					"timestamp", BCON_INT32(1),								// no time penalty if the collection is indexed
 				"}",
-				"individuals.id", BCON_UTF8(TCHAR_TO_ANSI(*Id)),		// yields faster results if we match against the id from the start
 			"}",
-		"}",
-		"{",
-			"$sort",
 			"{",
-				"timestamp", BCON_INT32(1),								// no time penalty if the collection is indexed
+				"$unwind", BCON_UTF8("$individuals"),
 			"}",
-		"}",
-		"{",
-			"$unwind", BCON_UTF8("$individuals"),
-		"}",
-		"{",
-			"$match",
 			"{",
-				"individuals.id", BCON_UTF8(TCHAR_TO_ANSI(*Id)),		// match against the searched id in the unwinded array (has all individuals from the doc)
+				"$match", BCON_DOCUMENT(&id_filter),					// match against the searched id in the unwinded array (has all individuals from the doc)
 			"}",
-		"}",
-		"{",
-			"$project",
 			"{",
-				"_id", BCON_INT32(0),
-				"timestamp", BCON_INT32(1),
-				"loc", BCON_UTF8("$individuals.loc"),
-				"quat", BCON_UTF8("$individuals.quat"),
-				"pose", BCON_UTF8("$individuals.pose"),
+				"$project",
+				"{",
+					"_id", BCON_INT32(0),
+					"timestamp", BCON_INT32(1),
+					"loc", BCON_UTF8("$individuals.loc"),
+					"quat", BCON_UTF8("$individuals.quat"),
+					"pose", BCON_UTF8("$individuals.pose"),
+					"p", BCON_UTF8("$individuals.p"),							// compact binary pose
+				"}",
 			"}",
-		"}",
-		"]");
+			"]");
 
-	cursor = mongoc_collection_aggregate(
-		collection, MONGOC_QUERY_NONE, pipeline, NULL, NULL);
-	double QueryDuration = FPlatformTime::Seconds() - ExecBegin;
+		cursor = mongoc_collection_aggregate(
+			collection, MONGOC_QUERY_NONE, pipeline, NULL, NULL);
+		QueryDuration += FPlatformTime::Seconds() - BatchBegin;
 
-	// Read cursor if no errors occured
-	if (!mongoc_cursor_error(cursor, &error))
-	{
-		if (DeltaT > 0.f)
+		// Read cursor if no errors occured
+		if (!mongoc_cursor_error(cursor, &error))
 		{
-			double PrevTs = -BIG_NUMBER;
 			while (mongoc_cursor_next(cursor, &doc))
 			{
 				double CurrTs = GetTs(doc);
-				if (CurrTs - PrevTs > DeltaT)
+				if (DeltaT <= 0.f || CurrTs - PrevTs > DeltaT)
 				{
 					Trajectory.Add(GetPose(doc));
 					PrevTs = CurrTs;
@@ -392,23 +562,17 @@ TArray<FTransform> FSLMongoQueryDBHandler::GetIndividualTrajectory(const FString
 		}
 		else
 		{
-			while (mongoc_cursor_next(cursor, &doc))
-			{
-				Trajectory.Add(GetPose(doc));
-			}
+			UE_LOG(LogTemp, Error, TEXT("%s::%d Err.:%s"),
+				*FString(__func__), __LINE__, *FString(error.message));
 		}
-	}
-	else
-	{
-		UE_LOG(LogTemp, Error, TEXT("%s::%d Err.:%s"),
-			*FString(__func__), __LINE__, *FString(error.message));
-	}
-	double CursorReadDuration = FPlatformTime::Seconds() - ExecBegin - QueryDuration;
 
-	mongoc_cursor_destroy(cursor);
-	bson_destroy(pipeline);
-	UE_LOG(LogTemp, Log, TEXT("%s::%d Durations: query=[%f], cursor=[%f], total=[%f] seconds, Num=[%d]..;"),
-		*FString(__func__), __LINE__, QueryDuration, CursorReadDuration, FPlatformTime::Seconds() - ExecBegin, Trajectory.Num());
+		mongoc_cursor_destroy(cursor);
+		bson_destroy(pipeline);
+		bson_destroy(time_filter);
+	}
+	bson_destroy(&id_filter);
+	UE_LOG(LogTemp, Log, TEXT("%s::%d Durations: query=[%f], total=[%f] seconds, Num=[%d], Batches=[%d]..;"),
+		*FString(__func__), __LINE__, QueryDuration, FPlatformTime::Seconds() - ExecBegin, Trajectory.Num(), time_filters.Num());
 #endif
 	if (Trajectory.Num() == 0)
 	{
@@ -427,6 +591,15 @@ TPair<FTransform, TMap<int32, FTransform>> FSLMongoQueryDBHandler::GetSkeletalIn
 		return SkeletalPosePair;
 	}
 
+	TMap<int32, FTransform> Bones;
+	QuerySkeletalIndividualPoseAt(Id, Ts, SkeletalPosePair.Key, Bones);
+	SkeletalPosePair.Value = GetWorldBonePoses(SkeletalPosePair.Key, Bones);
+	return SkeletalPosePair;
+}
+
+// Query the skeletal individual pose and its bones at the given time (sparse bones are carried forward, local bones are not converted)
+void FSLMongoQueryDBHandler::QuerySkeletalIndividualPoseAt(const FString& Id, float Ts, FTransform& OutPose, TMap<int32, FTransform>& OutBones) const
+{
 #if SL_WITH_LIBMONGO_C	
 	double ExecBegin = FPlatformTime::Seconds();
 
@@ -435,14 +608,25 @@ TPair<FTransform, TMap<int32, FTransform>> FSLMongoQueryDBHandler::GetSkeletalIn
 	mongoc_cursor_t *cursor;
 	bson_t *pipeline;
 
+	// Match by id, or by the id table index if the poses are compact
+	bson_t id_filter;
+	if (!CreateIdFilter(Id, "skel_individuals", &id_filter))
+	{
+		bson_destroy(&id_filter);
+		return;
+	}
+
+	// Sparse bones are carried forward from the previous entries, these are read back until the last key entry
 	pipeline = BCON_NEW("pipeline", "[",
 		"{",
 			"$match",
 			"{",
 				"timestamp", "{", "$lte", BCON_DOUBLE(Ts), "}",
-				"skel_individuals.id", BCON_UTF8(TCHAR_TO_ANSI(*Id)),		// yields faster results if we match against the id from the start
 			"}",
 		"}",
+		"{",
+			"$match", BCON_DOCUMENT(&id_filter),					// yields faster results if we match against the id from the start (merged with the previous stage)
+		"}",
 		"{",
 			"$sort",
 			"{",
@@ -450,16 +634,13 @@ TPair<FTransform, TMap<int32, FTransform>> FSLMongoQueryDBHandler::GetSkeletalIn
 			"}",
 		"}",
 		"{",
-			"$limit", BCON_INT32(1),
+			"$limit", BCON_INT32(bSparseBones ? MAX_int32 : 1),
 		"}",
 		"{",
 			"$unwind", BCON_UTF8("$skel_individuals"),
 		"}",
 		"{",
-			"$match",
-			"{",
-				"skel_individuals.id", BCON_UTF8(TCHAR_TO_ANSI(*Id)),		// match against the searched id in the unwinded array (has all individuals from the doc)
-			"}",
+			"$match", BCON_DOCUMENT(&id_filter),					// match against the searched id in the unwinded array (has all individuals from the doc)
 		"}",
 		"{",
 			"$project",
@@ -470,6 +651,8 @@ TPair<FTransform, TMap<int32, FTransform>> FSLMongoQueryDBHandler::GetSkeletalIn
 				"loc", BCON_UTF8("$skel_individuals.loc"),			// actor loc
 				"quat", BCON_UTF8("$skel_individuals.quat"),		// actor quat
 				"pose", BCON_UTF8("$skel_individuals.pose"),
+				"p", BCON_UTF8("$skel_individuals.p"),							// compact binary pose
+				"key", BCON_UTF8("$skel_individuals.key"),						// entry with all the bones (sparse bones)
 			"}",
 		"}",
 		"]");
@@ -482,28 +665,18 @@ TPair<FTransform, TMap<int32, FTransform>> FSLMongoQueryDBHandler::GetSkeletalIn
 	// Read cursor if no errors occured
 	if (!mongoc_cursor_error(cursor, &error))
 	{
-		if (mongoc_cursor_next(cursor, &doc))
+		// Newest entry first, the older entries only add the bones which are not set yet
+		bool bFirst = true;
+		while (mongoc_cursor_next(cursor, &doc))
 		{
-			SkeletalPosePair.Key = GetPose(doc);
-
-			// Get bones data
-			bson_iter_t bones;
-			if (bson_iter_init(&bones, doc) && bson_iter_find(&bones, "bones"))
+			if (bFirst)
 			{
-				bson_iter_t bone;
-				if (bson_iter_recurse(&bones, &bone))
-				{
-					int32 BoneIndex;
-					bson_iter_t value;
-					while (bson_iter_next(&bone))
-					{
-						if (bson_iter_recurse(&bone, &value) && bson_iter_find(&value, "idx"))
-						{
-							BoneIndex = bson_iter_int32(&value);							
-						}
-						SkeletalPosePair.Value.Emplace(BoneIndex, GetPose(&bone));
-					}
-				}
+				OutPose = GetPose(doc);
+				bFirst = false;
+			}
+			if (ReadSkeletalBones(doc, false, OutBones))
+			{
+				break;
 			}
 		}
 	}
@@ -516,14 +689,31 @@ TPair<FTransform, TMap<int32, FTransform>> FSLMongoQueryDBHandler::GetSkeletalIn
 
 	mongoc_cursor_destroy(cursor);
 	bson_destroy(pipeline);
+	bson_destroy(&id_filter);
 	UE_LOG(LogTemp, Log, TEXT("%s::%d Durations: query=[%f], cursor=[%f], total=[%f] seconds..;"),
 		*FString(__func__), __LINE__, QueryDuration, CursorReadDuration, FPlatformTime::Seconds() - ExecBegin);
 #endif
-	return SkeletalPosePair;
+}
+
+// Get the world poses of the bones (the local bone poses are relative to the skeletal individual)
+TMap<int32, FTransform> FSLMongoQueryDBHandler::GetWorldBonePoses(const FTransform& SkelPose, const TMap<int32, FTransform>& Bones) const
+{
+	if (!bLocalBones)
+	{
+		return Bones;
+	}
+
+	TMap<int32, FTransform> WorldBones;
+	WorldBones.Reserve(Bones.Num());
+	for (const auto& Pair : Bones)
+	{
+		WorldBones.Emplace(Pair.Key, Pair.Value * SkelPose);
+	}
+	return WorldBones;
 }
 
 // Get skeletal individual trajectory
-TArray<TPair<FTransform, TMap<int32, FTransform>>> FSLMongoQueryDBHandler::GetSkeletalIndividualTrajectory(const FString& Id, float StartTs, float EndTs, float DeltaT) const
+TArray<TPair<FTransform, TMap<int32, FTransform>>> FSLMongoQueryDBHandler::GetSkeletalIndividualTrajectory(const FString& Id, float StartTs, float EndTs, float DeltaT, const TArray<int32>& BoneIndexes) const
 {
 	TArray<TPair<FTransform, TMap<int32, FTransform>>> SkeletalTrajectoryPair;
 	if (!IsReady())
@@ -540,130 +730,153 @@ TArray<TPair<FTransform, TMap<int32, FTransform>>> FSLMongoQueryDBHandler::GetSk
 	mongoc_cursor_t *cursor;
 	bson_t *pipeline;
 
-	pipeline = BCON_NEW("pipeline", "[",
-		"{",
-			"$match",
+	// Match by id, or by the id table index if the poses are compact
+	bson_t id_filter;
+	if (!CreateIdFilter(Id, "skel_individuals", &id_filter))
+	{
+		bson_destroy(&id_filter);
+		return SkeletalTrajectoryPair;
+	}
+
+	// Only the required fields (and bones) are sent back
+	bson_t project;
+	bson_init(&project);
+	BSON_APPEND_INT32(&project, "_id", 0);
+	BSON_APPEND_INT32(&project, "timestamp", 1);
+	if (BoneIndexes.Num() == 0)
+	{
+		BSON_APPEND_UTF8(&project, "bones", "$skel_individuals.bones");		// bones data (index, loc, quat)
+	}
+	else
+	{
+		// { $filter: { input: "$skel_individuals.bones", as: "b", cond: { $in: ["$$b.idx", [BoneIndexes]] } } }
+		bson_t bones_expr, filter_expr, cond_expr, in_arr, idx_arr;
+		char idx_str[16];
+		const char* idx_key;
+		BSON_APPEND_DOCUMENT_BEGIN(&project, "bones", &bones_expr);
+			BSON_APPEND_DOCUMENT_BEGIN(&bones_expr, "$filter", &filter_expr);
+				BSON_APPEND_UTF8(&filter_expr, "input", "$skel_individuals.bones");
+				BSON_APPEND_UTF8(&filter_expr, "as", "b");
+				BSON_APPEND_DOCUMENT_BEGIN(&filter_expr, "cond", &cond_expr);
+					BSON_APPEND_ARRAY_BEGIN(&cond_expr, "$in", &in_arr);
+						BSON_APPEND_UTF8(&in_arr, "0", "$$b.idx");
+						BSON_APPEND_ARRAY_BEGIN(&in_arr, "1", &idx_arr);
+						for (int32 Idx = 0; Idx < BoneIndexes.Num(); ++Idx)
+						{
+							bson_uint32_to_string(Idx, &idx_key, idx_str, sizeof idx_str);
+							BSON_APPEND_INT32(&idx_arr, idx_key, BoneIndexes[Idx]);
+						}
+						bson_append_array_end(&in_arr, &idx_arr);
+					bson_append_array_end(&cond_expr, &in_arr);
+				bson_append_document_end(&filter_expr, &cond_expr);
+			bson_append_document_end(&bones_expr, &filter_expr);
+		bson_append_document_end(&project, &bones_expr);
+	}
+	BSON_APPEND_UTF8(&project, "loc", "$skel_individuals.loc");			// actor loc
+	BSON_APPEND_UTF8(&project, "quat", "$skel_individuals.quat");		// actor quat
+	BSON_APPEND_UTF8(&project, "pose", "$skel_individuals.pose");
+	BSON_APPEND_UTF8(&project, "p", "$skel_individuals.p");				// compact binary pose
+
+	// Sparse bones are carried forward from the bones at the start time, all the frames in the range are read (the delta time only selects the output)
+	TMap<int32, FTransform> Bones;
+	if (bSparseBones)
+	{
+		FTransform StartPose;
+		QuerySkeletalIndividualPoseAt(Id, StartTs, StartPose, Bones);
+		if (BoneIndexes.Num() > 0)
+		{
+			for (auto BoneItr = Bones.CreateIterator(); BoneItr; ++BoneItr)
+			{
+				if (!BoneIndexes.Contains(BoneItr.Key()))
+				{
+					BoneItr.RemoveCurrent();
+				}
+			}
+		}
+	}
+
+	// Time range, or the downsampled frames if a delta time is given
+	TArray<bson_t*> time_filters;
+	CreateTrajectoryTimeFilters(&id_filter, StartTs, EndTs, bSparseBones ? 0.f : DeltaT, time_filters);
+	double QueryDuration = 0.0;
+
+	// The skipped frames are not read anymore, the delta time check is kept since it also skips duplicate timestamps
+	double PrevTs = -BIG_NUMBER;
+	for (bson_t* time_filter : time_filters)
+	{
+		const double BatchBegin = FPlatformTime::Seconds();
+		pipeline = BCON_NEW("pipeline", "[",
 			"{",
-				"timestamp", 
-				"{", 
-					"$gte", BCON_DOUBLE(StartTs),
-					"$lte", BCON_DOUBLE(EndTs),
+				"$match", BCON_DOCUMENT(time_filter),
+			"}",
+			"{",
+				"$match", BCON_DOCUMENT(&id_filter),					// yields faster results if we match against the id from the start (merged with the previous stage)
+			"}",
+			"{",
+				"$sort",
+				"{",
+					"timestamp", BCON_INT32(1),								// if sort if right after match it barely adds any time penalty
 				"}",
-				"skel_individuals.id", BCON_UTF8(TCHAR_TO_ANSI(*Id)),		// yields faster results if we match against the id from the start
 			"}",
-		"}",
-		"{",
-			"$sort",
 			"{",
-				"timestamp", BCON_INT32(1),								// if sort if right after match it barely adds any time penalty
+				"$unwind", BCON_UTF8("$skel_individuals"),
 			"}",
-		"}",
-		"{",
-			"$unwind", BCON_UTF8("$skel_individuals"),
-		"}",
-		"{",
-			"$match",
 			"{",
-				"skel_individuals.id", BCON_UTF8(TCHAR_TO_ANSI(*Id)),		// match against the searched id in the unwinded array (has all individuals from the doc)
+				"$match", BCON_DOCUMENT(&id_filter),					// match against the searched id in the unwinded array (has all individuals from the doc)
 			"}",
-		"}",
-		"{",
-			"$project",
 			"{",
-				"_id", BCON_INT32(0),
-				"timestamp", BCON_INT32(1),
-				"bones", BCON_UTF8("$skel_individuals.bones"),		// bones data (index, loc, quat)
-				"loc", BCON_UTF8("$skel_individuals.loc"),			// actor loc
-				"quat", BCON_UTF8("$skel_individuals.quat"),		// actor quat
-				"pose", BCON_UTF8("$skel_individuals.pose"),
-
+				"$project", BCON_DOCUMENT(&project),
 			"}",
-		"}",
-		"]");
+			"]");
 
-	cursor = mongoc_collection_aggregate(
-		collection, MONGOC_QUERY_NONE, pipeline, NULL, NULL);
-	double QueryDuration = FPlatformTime::Seconds() - ExecBegin;
+		cursor = mongoc_collection_aggregate(
+			collection, MONGOC_QUERY_NONE, pipeline, NULL, NULL);
+		QueryDuration += FPlatformTime::Seconds() - BatchBegin;
 
-	// Read cursor if no errors occured
-	if (!mongoc_cursor_error(cursor, &error))
-	{
-		if (DeltaT > 0.f)
+		// Read cursor if no errors occured
+		if (!mongoc_cursor_error(cursor, &error))
 		{
-			double PrevTs = -BIG_NUMBER;
 			while (mongoc_cursor_next(cursor, &doc))
 			{
+				// Every sparse frame updates the bones, even if it is not part of the output
+				if (bSparseBones)
+				{
+					ReadSkeletalBones(doc, true, Bones);
+				}
+
 				double CurrTs = GetTs(doc);
-				if (CurrTs - PrevTs > DeltaT)
+				if (DeltaT <= 0.f || CurrTs - PrevTs > DeltaT)
 				{
 					TPair<FTransform, TMap<int32, FTransform>> SkeletalPosePair;
 					SkeletalPosePair.Key = GetPose(doc);
 
 					// Get bones data
-					bson_iter_t bones;
-					if (bson_iter_init(&bones, doc) && bson_iter_find(&bones, "bones"))
+					if (!bSparseBones)
 					{
-						bson_iter_t bone;
-						if (bson_iter_recurse(&bones, &bone))
-						{
-							int32 BoneIndex;
-							bson_iter_t value;
-							while (bson_iter_next(&bone))
-							{
-								if (bson_iter_recurse(&bone, &value) && bson_iter_find(&value, "idx"))
-								{
-									BoneIndex = bson_iter_int32(&value);
-								}
-								SkeletalPosePair.Value.Emplace(BoneIndex, GetPose(&bone));
-							}
-						}
+						Bones.Reset();
+						ReadSkeletalBones(doc, true, Bones);
 					}
-					SkeletalTrajectoryPair.Add(SkeletalPosePair);
+					SkeletalPosePair.Value = GetWorldBonePoses(SkeletalPosePair.Key, Bones);
+					SkeletalTrajectoryPair.Emplace(MoveTemp(SkeletalPosePair));
 					PrevTs = CurrTs;
 				}
 			}
 		}
 		else
 		{
-			while (mongoc_cursor_next(cursor, &doc))
-			{
-				TPair<FTransform, TMap<int32, FTransform>> SkeletalPosePair;
-				SkeletalPosePair.Key = GetPose(doc);
-
-				// Get bones data
-				bson_iter_t bones;
-				if (bson_iter_init(&bones, doc) && bson_iter_find(&bones, "bones"))
-				{
-					bson_iter_t bone;
-					if (bson_iter_recurse(&bones, &bone))
-					{
-						int32 BoneIndex;
-						bson_iter_t value;
-						while (bson_iter_next(&bone))
-						{
-							if (bson_iter_recurse(&bone, &value) && bson_iter_find(&value, "idx"))
-							{
-								BoneIndex = bson_iter_int32(&value);
-							}
-							SkeletalPosePair.Value.Emplace(BoneIndex, GetPose(&bone));
-						}
-					}
-				}
-				SkeletalTrajectoryPair.Add(SkeletalPosePair);
-			}
+			UE_LOG(LogTemp, Error, TEXT("%s::%d Err.:%s"),
+				*FString(__func__), __LINE__, *FString(error.message));
 		}
-	}
-	else
-	{
-		UE_LOG(LogTemp, Error, TEXT("%s::%d Err.:%s"),
-			*FString(__func__), __LINE__, *FString(error.message));
-	}
-	double CursorReadDuration = FPlatformTime::Seconds() - ExecBegin - QueryDuration;
 
-	mongoc_cursor_destroy(cursor);
-	bson_destroy(pipeline);
-	UE_LOG(LogTemp, Log, TEXT("%s::%d Durations: query=[%f], cursor=[%f], total=[%f] seconds, Num=[%d]..;"),
-		*FString(__func__), __LINE__, QueryDuration, CursorReadDuration, FPlatformTime::Seconds() - ExecBegin, SkeletalTrajectoryPair.Num());
+		mongoc_cursor_destroy(cursor);
+		bson_destroy(pipeline);
+		bson_destroy(time_filter);
+	}
+	bson_destroy(&project);
+	bson_destroy(&id_filter);
+	UE_LOG(LogTemp, Log, TEXT("%s::%d Durations: query=[%f], total=[%f] seconds, Num=[%d], Batches=[%d], Bones=[%d]..;"),
+		*FString(__func__), __LINE__, QueryDuration, FPlatformTime::Seconds() - ExecBegin, SkeletalTrajectoryPair.Num(),
+		time_filters.Num(), BoneIndexes.Num());
 #endif
 	if (SkeletalTrajectoryPair.Num() == 0)
 	{
@@ -732,33 +945,10 @@ TArray<TPair<float, TMap<FString, FTransform>>> FSLMongoQueryDBHandler::GetEpiso
 		while (mongoc_cursor_next(cursor, &doc))
 		{
 			if (FrameIdx++ % 250 == 0) { UE_LOG(LogTemp, Log, TEXT(" mongo processing frame %d .."), FrameIdx++); }
-			bson_iter_t frame_iter;
-			if (bson_iter_init(&frame_iter, doc))
-			{
-				TMap<FString, FTransform> CurrIndividualsData;
-				float CurrTs;
-				
-				if (bson_iter_find(&frame_iter, "timestamp"))
-				{
-					CurrTs = bson_iter_double(&frame_iter);
-				}
-
-				bson_iter_t individuals_iter;
-				if (bson_iter_find(&frame_iter, "individuals") && bson_iter_recurse(&frame_iter, &individuals_iter))
-				{
-					while (bson_iter_next(&individuals_iter))
-					{
-						FString Id;
-						bson_iter_t individual_val_iter;
-						if (bson_iter_recurse(&individuals_iter, &individual_val_iter) && bson_iter_find(&individual_val_iter, "id"))
-						{
-							Id = FString(bson_iter_utf8(&individual_val_iter, NULL));
-						}
-						CurrIndividualsData.Emplace(Id, GetPose(&individuals_iter));
-					}
-				}
-				EpisodeData.Emplace(CurrTs, CurrIndividualsData);
-			}
+			double CurrTs = 0.;
+			TMap<FString, FTransform> CurrIndividualsData;
+			ReadFrame(doc, CurrTs, CurrIndividualsData);
+			EpisodeData.Emplace(CurrTs, MoveTemp(CurrIndividualsData));
 		}
 	}
 	else
@@ -776,18 +966,525 @@ TArray<TPair<float, TMap<FString, FTransform>>> FSLMongoQueryDBHandler::GetEpiso
 	return EpisodeData;
 }
 
-// Get the whole episode data in an async thread
-TArray<TPair<float, TMap<FString, FTransform>>> FSLMongoQueryDBHandler::GetEpisodeDataAsync() const
+// Stream the episode data between the given timestamps in an async thread (uses its own connection, nullptr if the handler is not ready)
+TSharedPtr<FSLMongoEpisodeStreamer> FSLMongoQueryDBHandler::GetEpisodeDataAsync(float StartTs, float EndTs, int32 MaxNumQueuedFrames) const
+{
+	if (!IsReady())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d DB handler is not ready, make sure the server, database, and collection is set.."), *FString(__FUNCTION__), __LINE__);
+		return nullptr;
+	}
+
+	// The mongo clients are not thread safe, the streamer connects with the same parameters
+	TSharedPtr<FSLMongoEpisodeStreamer> Streamer = MakeShareable(new FSLMongoEpisodeStreamer());
+	if (!Streamer->Start(ConnServerIp, ConnServerPort, ConnDBName, ConnCollName, StartTs, EndTs, MaxNumQueuedFrames))
+	{
+		return nullptr;
+	}
+	return Streamer;
+}
+
+// Get the frames after the given timestamp (at most MaxNumFrames), the timestamp is set to the last read one (false on errors)
+bool FSLMongoQueryDBHandler::GetEpisodeDataWindow(double& InOutTs, int32 MaxNumFrames, TArray<TPair<float, TMap<FString, FTransform>>>& OutFrames) const
+{
+	if (!IsReady())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d DB handler is not ready, make sure the server, database, and collection is set.."), *FString(__FUNCTION__), __LINE__);
+		return false;
+	}
+
+#if SL_WITH_LIBMONGO_C
+	bson_error_t error;
+	const bson_t *doc;
+	mongoc_cursor_t *cursor;
+	bson_t *filter;
+	bson_t *opts;
+
+	// The timestamp is compared as double, otherwise the last frame of the window could be read again
+	filter = BCON_NEW(
+		"timestamp",
+		"{",
+			"$gt", BCON_DOUBLE(InOutTs),
+		"}");
+
+	opts = BCON_NEW(
+		"sort",
+		"{",
+			"timestamp", BCON_INT32(1),
+		"}",
+		"limit", BCON_INT64(MaxNumFrames),
+		"batchSize", BCON_INT32(MaxNumFrames),
+		"projection",
+		"{",
+			"_id", BCON_INT32(0),
+			"timestamp", BCON_INT32(1),
+			"individuals", BCON_INT32(1),
+		"}");
+
+	cursor = mongoc_collection_find_with_opts(collection, filter, opts, NULL);
+	while (mongoc_cursor_next(cursor, &doc))
+	{
+		double CurrTs = InOutTs;
+		TMap<FString, FTransform> CurrIndividualsData;
+		ReadFrame(doc, CurrTs, CurrIndividualsData);
+		OutFrames.Emplace(CurrTs, MoveTemp(CurrIndividualsData));
+		InOutTs = CurrTs;
+	}
+
+	bool bSuccess = true;
+	if (mongoc_cursor_error(cursor, &error))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Err.:%s"),
+			*FString(__func__), __LINE__, *FString(error.message));
+		bSuccess = false;
+	}
+
+	mongoc_cursor_destroy(cursor);
+	bson_destroy(filter);
+	bson_destroy(opts);
+	return bSuccess;
+#else
+	return false;
+#endif // SL_WITH_LIBMONGO_C
+}
+
+// Get the full world state at the given timestamp (latest pose of every individual at or before the timestamp)
+TMap<FString, FTransform> FSLMongoQueryDBHandler::GetFrameData(float Ts) const
+{
+	TMap<FString, FTransform> FrameData;
+	if (!IsReady())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d DB handler is not ready, make sure the server, database, and collection is set.."), *FString(__FUNCTION__), __LINE__);
+		return FrameData;
+	}
+
+#if SL_WITH_LIBMONGO_C
+	bson_error_t error;
+	bson_t opts;
+	const bson_t *doc;
+	mongoc_cursor_t *cursor;
+	bson_t *pipeline;
+
+	// The frames only store the individuals that moved, the newest entry of every individual is taken
+	const char* group_id = bCompactPoses ? "$individuals.idx" : "$individuals.id";
+	pipeline = BCON_NEW("pipeline", "[",
+		"{",
+			"$match",
+			"{",
+				"timestamp",
+				"{",
+					"$lte", BCON_DOUBLE(Ts),
+				"}",
+			"}",
+		"}",
+		"{",
+			"$sort",
+			"{",
+				"timestamp", BCON_INT32(-1),
+			"}",
+		"}",
+		"{",
+			"$unwind", BCON_UTF8("$individuals"),
+		"}",
+		"{",
+			"$group",
+			"{",
+				"_id", BCON_UTF8(group_id),
+				"individual",
+				"{",
+					"$first", BCON_UTF8("$individuals"),
+				"}",
+			"}",
+		"}",
+		"]");
+
+	bson_init(&opts);
+	BSON_APPEND_BOOL(&opts, "allowDiskUse", true);
+	cursor = mongoc_collection_aggregate(
+		collection, MONGOC_QUERY_NONE, pipeline, &opts, NULL);
+
+	while (mongoc_cursor_next(cursor, &doc))
+	{
+		bson_iter_t iter;
+		if (bson_iter_init(&iter, doc) && bson_iter_find(&iter, "individual"))
+		{
+			FrameData.Emplace(GetId(&iter), GetPose(&iter));
+		}
+	}
+
+	if (mongoc_cursor_error(cursor, &error))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Err.:%s"),
+			*FString(__func__), __LINE__, *FString(error.message));
+	}
+
+	mongoc_cursor_destroy(cursor);
+	bson_destroy(pipeline);
+	bson_destroy(&opts);
+#endif // SL_WITH_LIBMONGO_C
+	return FrameData;
+}
+
+// Get the number of documents and the last timestamp of the collection (used to detect changes of the episode)
+bool FSLMongoQueryDBHandler::GetCollectionFingerprint(int64& OutNumDocs, double& OutLastTs) const
+{
+	OutNumDocs = 0;
+	OutLastTs = -1.0;
+	if (!IsReady())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d DB handler is not ready, make sure the server, database, and collection is set.."), *FString(__FUNCTION__), __LINE__);
+		return false;
+	}
+
+#if SL_WITH_LIBMONGO_C
+	bson_error_t error;
+	const bson_t *doc;
+	bson_t* filter = bson_new();
+	const int64_t count = mongoc_collection_count_documents(collection, filter, NULL, NULL, NULL, &error);
+	if (count < 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Err.:%s"),
+			*FString(__func__), __LINE__, *FString(error.message));
+		bson_destroy(filter);
+		return false;
+	}
+	OutNumDocs = count;
+
+	// Last world state timestamp (no time penalty if the collection is indexed)
+	bson_t* opts = BCON_NEW(
+		"sort", "{", "timestamp", BCON_INT32(-1), "}",
+		"limit", BCON_INT64(1),
+		"projection", "{", "_id", BCON_INT32(0), "timestamp", BCON_INT32(1), "}");
+	mongoc_cursor_t* cursor = mongoc_collection_find_with_opts(collection, filter, opts, NULL);
+	if (mongoc_cursor_next(cursor, &doc))
+	{
+		OutLastTs = GetTs(doc);
+	}
+
+	bool bSuccess = true;
+	if (mongoc_cursor_error(cursor, &error))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Err.:%s"),
+			*FString(__func__), __LINE__, *FString(error.message));
+		bSuccess = false;
+	}
+
+	mongoc_cursor_destroy(cursor);
+	bson_destroy(filter);
+	bson_destroy(opts);
+	return bSuccess;
+#else
+	return false;
+#endif // SL_WITH_LIBMONGO_C
+}
+
+/* Pose cache */
+// Answer the pose and short trajectory queries from a cached time window of frames
+void FSLMongoQueryDBHandler::SetPoseCache(bool bEnable, float InWindowSize, int32 InMaxNumFrames)
+{
+	bPoseCacheEnabled = bEnable;
+	PoseCacheWindowSize = FMath::Max(InWindowSize, 0.1f);
+	PoseCacheMaxNumFrames = FMath::Max(InMaxNumFrames, 1);
+	ClearPoseCache();
+}
+
+// Drop the cached frames (and the statistics)
+void FSLMongoQueryDBHandler::ClearPoseCache(bool bResetStats)
+{
+	if (bResetStats)
+	{
+		PoseCacheStats = FSLMongoPoseCacheStats();
+	}
+	PoseCacheTracks.Empty();
+	PoseCacheStats.NumFrames = 0;
+	PoseCacheStats.NumTracks = 0;
+	bPoseCacheValid = false;
+}
+
+// Get the pose from the cache, loads the window around the timestamp if needed
+bool FSLMongoQueryDBHandler::GetCachedPoseAt(const FString& Id, float Ts, FTransform& OutPose) const
+{
+	const int32 NumWindowLoads = PoseCacheStats.NumWindowLoads;
+	if (!LoadPoseCacheWindowAt(Ts))
+	{
+		PoseCacheStats.NumMisses++;
+		return false;
+	}
+	bool bHit = NumWindowLoads == PoseCacheStats.NumWindowLoads;
+
+	// Last pose of the individual at or before the timestamp
+	FSLMongoPoseTrack& Track = PoseCacheTracks.FindOrAdd(Id);
+	const int32 Idx = Algo::UpperBound(Track.Timestamps, static_cast<double>(Ts)) - 1;
+	if (Track.Timestamps.IsValidIndex(Idx))
+	{
+		OutPose = Track.Poses[Idx];
+	}
+	else
+	{
+		// The individual did not move in the window before the timestamp, use its pose before the window
+		if (!Track.bHasLastKnownPose)
+		{
+			Track.LastKnownPose = QueryIndividualPoseAt(Id, PoseCacheStats.WindowStart);
+			Track.bHasLastKnownPose = true;
+			bHit = false;
+		}
+		OutPose = Track.LastKnownPose;
+	}
+
+	if (bHit)
+	{
+		PoseCacheStats.NumHits++;
+	}
+	else
+	{
+		PoseCacheStats.NumMisses++;
+	}
+	return true;
+}
+
+// Get the poses between the timestamps from the cache
+bool FSLMongoQueryDBHandler::GetCachedTrajectory(const FString& Id, float StartTs, float EndTs, float DeltaT, TArray<FTransform>& OutTrajectory) const
+{
+	// Long trajectories are read from the database
+	if (EndTs < StartTs || EndTs - StartTs > PoseCacheWindowSize)
+	{
+		return false;
+	}
+
+	const int32 NumWindowLoads = PoseCacheStats.NumWindowLoads;
+	if (!IsInPoseCacheWindow(StartTs, EndTs) &&
+		(!LoadPoseCacheWindowAt((StartTs + EndTs) * 0.5f) || !IsInPoseCacheWindow(StartTs, EndTs)))
+	{
+		PoseCacheStats.NumMisses++;
+		return false;
+	}
+	if (NumWindowLoads == PoseCacheStats.NumWindowLoads)
+	{
+		PoseCacheStats.NumHits++;
+	}
+	else
+	{
+		PoseCacheStats.NumMisses++;
+	}
+
+	// Same samples as the database query (frames in which the individual moved)
+	const FSLMongoPoseTrack* Track = PoseCacheTracks.Find(Id);
+	if (!Track)
+	{
+		return true;
+	}
+	const int32 FirstIdx = Algo::LowerBound(Track->Timestamps, static_cast<double>(StartTs));
+	const int32 LastIdx = Algo::UpperBound(Track->Timestamps, static_cast<double>(EndTs));
+	double PrevTs = -BIG_NUMBER;
+	for (int32 Idx = FirstIdx; Idx < LastIdx; ++Idx)
+	{
+		if (DeltaT <= 0.f || Track->Timestamps[Idx] - PrevTs > DeltaT)
+		{
+			OutTrajectory.Add(Track->Poses[Idx]);
+			PrevTs = Track->Timestamps[Idx];
+		}
+	}
+	return true;
+}
+
+// Load the window of frames around the timestamp if it is not already cached
+bool FSLMongoQueryDBHandler::LoadPoseCacheWindowAt(float Ts) const
+{
+	if (IsInPoseCacheWindow(Ts, Ts))
+	{
+		return true;
+	}
+
+#if SL_WITH_LIBMONGO_C
+	const double ExecBegin = FPlatformTime::Seconds();
+
+	// Centered on the timestamp, the nearby queries go in both directions
+	double WindowStart = Ts - PoseCacheWindowSize * 0.5;
+	const double WindowEnd = Ts + PoseCacheWindowSize * 0.5;
+
+	// Read the frames of the window into the tracks, false on errors
+	int32 NumFrames = 0;
+	double LastTs = WindowStart;
+	auto ReadWindow = [&]() -> bool
+	{
+		PoseCacheTracks.Reset();
+		bPoseCacheValid = false;
+		NumFrames = 0;
+		LastTs = WindowStart;
+
+		bson_error_t error;
+		const bson_t *doc;
+		mongoc_cursor_t *cursor;
+		bson_t *filter;
+		bson_t *opts;
+
+		filter = BCON_NEW(
+			"timestamp",
+			"{",
+				"$gte", BCON_DOUBLE(WindowStart),
+				"$lte", BCON_DOUBLE(WindowEnd),
+			"}");
+
+		opts = BCON_NEW(
+			"sort",
+			"{",
+				"timestamp", BCON_INT32(1),
+			"}",
+			"limit", BCON_INT64(PoseCacheMaxNumFrames),
+			"projection",
+			"{",
+				"_id", BCON_INT32(0),
+				"timestamp", BCON_INT32(1),
+				"individuals", BCON_INT32(1),
+			"}");
+
+		TMap<FString, FTransform> FramePoses;
+		cursor = mongoc_collection_find_with_opts(collection, filter, opts, NULL);
+		while (mongoc_cursor_next(cursor, &doc))
+		{
+			FramePoses.Reset();
+			ReadFrame(doc, LastTs, FramePoses);
+			for (auto& Pair : FramePoses)
+			{
+				FSLMongoPoseTrack& Track = PoseCacheTracks.FindOrAdd(Pair.Key);
+				Track.Timestamps.Add(LastTs);
+				Track.Poses.Add(Pair.Value);
+			}
+			NumFrames++;
+		}
+
+		const bool bSuccess = !mongoc_cursor_error(cursor, &error);
+		if (!bSuccess)
+		{
+			UE_LOG(LogTemp, Error, TEXT("%s::%d Err.:%s"),
+				*FString(__func__), __LINE__, *FString(error.message));
+			PoseCacheTracks.Empty();
+		}
+		mongoc_cursor_destroy(cursor);
+		bson_destroy(filter);
+		bson_destroy(opts);
+		return bSuccess;
+	};
+
+	if (!ReadWindow())
+	{
+		return false;
+	}
+
+	// The frame limit truncated the window before the timestamp, start the window at the timestamp instead
+	// (otherwise every query at this timestamp would reload the same window and fall back to the database)
+	if (NumFrames >= PoseCacheMaxNumFrames && LastTs < Ts)
+	{
+		WindowStart = Ts;
+		if (!ReadWindow())
+		{
+			return false;
+		}
+	}
+
+	// If the frame limit is reached the window ends at the last read frame
+	PoseCacheStats.WindowStart = WindowStart;
+	PoseCacheStats.WindowEnd = NumFrames < PoseCacheMaxNumFrames ? WindowEnd : LastTs;
+	PoseCacheStats.NumFrames = NumFrames;
+	PoseCacheStats.NumTracks = PoseCacheTracks.Num();
+	PoseCacheStats.NumWindowLoads++;
+	bPoseCacheValid = true;
+	if (NumFrames >= PoseCacheMaxNumFrames)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d Window reached the max number of frames (%d), consider a smaller window size.."),
+			*FString(__func__), __LINE__, PoseCacheMaxNumFrames);
+	}
+	UE_LOG(LogTemp, Log, TEXT("%s::%d Loaded window in [%f] seconds; %s"),
+		*FString(__func__), __LINE__, FPlatformTime::Seconds() - ExecBegin, *PoseCacheStats.ToString());
+	return IsInPoseCacheWindow(Ts, Ts);
+#else
+	return false;
+#endif // SL_WITH_LIBMONGO_C
+}
+
+#if SL_WITH_LIBMONGO_C
+// Read the id table document of the world state collection, false if the collection has none or its poses are not compact encoded
+bool FSLMongoQueryDBHandler::ReadIdTable(mongoc_collection_t* coll, TArray<FString>& OutIds, TArray<FString>& OutSkelIds, float& OutPositionResolution,
+	bool& bOutSparseBones, bool& bOutLocalBones)
 {
-	// TODO
-	return TArray<TPair<float, TMap<FString, FTransform>>>();
+	OutIds.Empty();
+	OutSkelIds.Empty();
+	bOutSparseBones = false;
+	bOutLocalBones = false;
+
+	// Read the values of the given string array
+	auto ReadIds = [](const bson_t* doc, const char* Key, TArray<FString>& OutArr)
+	{
+		bson_iter_t iter;
+		bson_iter_t arr_iter;
+		if (bson_iter_init_find(&iter, doc, Key) && BSON_ITER_HOLDS_ARRAY(&iter) && bson_iter_recurse(&iter, &arr_iter))
+		{
+			while (bson_iter_next(&arr_iter))
+			{
+				OutArr.Emplace(UTF8_TO_TCHAR(bson_iter_utf8(&arr_iter, NULL)));
+			}
+		}
+	};
+
+	bool bCompact = false;
+	const bson_t* doc;
+	bson_t* filter = BCON_NEW("id_table", BCON_BOOL(true));
+	bson_t* opts = BCON_NEW("limit", BCON_INT64(1));
+	mongoc_cursor_t* cursor = mongoc_collection_find_with_opts(coll, filter, opts, NULL);
+	if (mongoc_cursor_next(cursor, &doc))
+	{
+		bson_iter_t iter;
+		if (bson_iter_init_find(&iter, doc, "pos_res") && BSON_ITER_HOLDS_DOUBLE(&iter))
+		{
+			OutPositionResolution = bson_iter_double(&iter);
+		}
+		if (bson_iter_init_find(&iter, doc, "sparse_bones") && BSON_ITER_HOLDS_BOOL(&iter))
+		{
+			bOutSparseBones = bson_iter_bool(&iter);
+		}
+		if (bson_iter_init_find(&iter, doc, "local_bones") && BSON_ITER_HOLDS_BOOL(&iter))
+		{
+			bOutLocalBones = bson_iter_bool(&iter);
+		}
+		ReadIds(doc, "ids", OutIds);
+		ReadIds(doc, "skel_ids", OutSkelIds);
+
+		// The id table is also written for the bone formats of the default encoding
+		bCompact = !(bson_iter_init_find(&iter, doc, "encoding") && BSON_ITER_HOLDS_UTF8(&iter)
+			&& FCStringAnsi::Strcmp(bson_iter_utf8(&iter, NULL), "default") == 0);
+	}
+	mongoc_cursor_destroy(cursor);
+	bson_destroy(filter);
+	bson_destroy(opts);
+	return bCompact;
 }
 
-// Get the episode data at the given timestamp (frame)
-TMap<FString, FTransform> FSLMongoQueryDBHandler::GetFrameData(float Ts)
+// Decode a binary pose (with the ROS conversion if enabled), false if the encoding is unknown
+bool FSLMongoQueryDBHandler::DecodePose(const bson_iter_t* p_iter, float InPositionResolution, FTransform& OutPose)
 {
-	return TMap<FString, FTransform>();
+	if (!BSON_ITER_HOLDS_BINARY(p_iter))
+	{
+		return false;
+	}
+	bson_subtype_t subtype;
+	uint32_t len = 0;
+	const uint8_t* data = nullptr;
+	bson_iter_binary(p_iter, &subtype, &len, &data);
+
+	FVector Loc;
+	FQuat Quat;
+	if (!FSLPoseCodec::Decode(data, len, InPositionResolution, Loc, Quat))
+	{
+		return false;
+	}
+#if SL_WITH_ROS_CONVERSIONS
+	OutPose = FConversions::ROSToU(FTransform(Quat, Loc));
+#else
+	OutPose = FTransform(Quat, Loc);
+#endif // SL_WITH_ROS_CONVERSIONS
+	return true;
 }
+#endif // SL_WITH_LIBMONGO_C
 
 /* Helpers */
 #if SL_WITH_LIBMONGO_C
@@ -800,6 +1497,13 @@ FTransform FSLMongoQueryDBHandler::GetPose(const bson_t* doc) const
 	bson_iter_t iter;
 	bson_iter_t value;
 
+	// Compact binary pose
+	FTransform CompactPose;
+	if (bCompactPoses && bson_iter_init_find(&iter, doc, "p") && DecodePose(&iter, PositionResolution, CompactPose))
+	{
+		return CompactPose;
+	}
+
 	if (bson_iter_init(&iter, doc) && bson_iter_find_descendant(&iter, "loc.x", &value)/* && BSON_ITER_HOLDS_DOUBLE(&value)*/)
 	{
 		Loc.X = bson_iter_double(&value);
@@ -867,6 +1571,12 @@ FTransform FSLMongoQueryDBHandler::GetPose(const bson_t* doc) const
 
 // Get the pose data from iterator
 FTransform FSLMongoQueryDBHandler::GetPose(const bson_iter_t* iter) const
+{
+	return GetPose(iter, bCompactPoses, PositionResolution);
+}
+
+// Get the pose of the array element, the binary pose if the poses are compact, or the loc/quat sub documents
+FTransform FSLMongoQueryDBHandler::GetPose(const bson_iter_t* iter, bool bInCompactPoses, float InPositionResolution)
 {
 	FVector Loc;
 	FQuat Quat;
@@ -874,6 +1584,13 @@ FTransform FSLMongoQueryDBHandler::GetPose(const bson_iter_t* iter) const
 	bson_iter_t value;
 	bson_iter_t sub_value;
 
+	// Compact binary pose
+	FTransform CompactPose;
+	if (bInCompactPoses && bson_iter_recurse(iter, &value) && bson_iter_find(&value, "p") && DecodePose(&value, InPositionResolution, CompactPose))
+	{
+		return CompactPose;
+	}
+
 	if (bson_iter_recurse(iter, &value) && bson_iter_find_descendant(&value, "loc.x", &sub_value))
 	{
 		Loc.X = bson_iter_double(&sub_value);
@@ -949,4 +1666,361 @@ double FSLMongoQueryDBHandler::GetTs(const bson_t* doc) const
 	}
 	return -1.f;
 }
+
+// Get the individual id of the array element (resolved through the id table if the poses are compact)
+FString FSLMongoQueryDBHandler::GetId(const bson_iter_t* iter) const
+{
+	bson_iter_t value;
+	if (bCompactPoses)
+	{
+		if (bson_iter_recurse(iter, &value) && bson_iter_find(&value, "idx") && BSON_ITER_HOLDS_INT32(&value))
+		{
+			const int32 Idx = bson_iter_int32(&value);
+			if (IdTable.IsValidIndex(Idx))
+			{
+				return IdTable[Idx];
+			}
+		}
+		return FString();
+	}
+
+	if (bson_iter_recurse(iter, &value) && bson_iter_find(&value, "id"))
+	{
+		return FString(bson_iter_utf8(&value, NULL));
+	}
+	return FString();
+}
+
+// Create the filter matching the individual in the given array (false if the id is not in the id table)
+bool FSLMongoQueryDBHandler::CreateIdFilter(const FString& Id, const char* ArrayName, bson_t* out_filter) const
+{
+	bson_init(out_filter);
+	const FString Key = FString(ArrayName) + (bCompactPoses ? TEXT(".idx") : TEXT(".id"));
+	if (!bCompactPoses)
+	{
+		BSON_APPEND_UTF8(out_filter, TCHAR_TO_UTF8(*Key), TCHAR_TO_UTF8(*Id));
+		return true;
+	}
+
+	const TMap<FString, int32>& Table = FCStringAnsi::Strcmp(ArrayName, "skel_individuals") == 0 ? SkelIdToIdx : IdToIdx;
+	if (const int32* Idx = Table.Find(Id))
+	{
+		BSON_APPEND_INT32(out_filter, TCHAR_TO_UTF8(*Key), *Idx);
+		return true;
+	}
+	UE_LOG(LogTemp, Warning, TEXT("%s::%d %s is not in the id table of the collection.."), *FString(__func__), __LINE__, *Id);
+	return false;
+}
+
+// Create the timestamp filters of a trajectory query (with a delta time only the selected frames are matched)
+void FSLMongoQueryDBHandler::CreateTrajectoryTimeFilters(const bson_t* id_filter, float StartTs, float EndTs, float DeltaT, TArray<bson_t*>& OutFilters) const
+{
+	// Max number of timestamps matched by a single query
+	static constexpr int32 MaxNumTsPerFilter = 2048;
+
+	if (DeltaT > 0.f)
+	{
+		const double ExecBegin = FPlatformTime::Seconds();
+		bson_error_t error;
+		const bson_t *doc;
+		mongoc_cursor_t *cursor;
+		bson_t *filter;
+		bson_t *opts;
+
+		// Only the timestamps of the matching frames are read, the frames are selected with the same delta time check as the poses
+		filter = BCON_NEW(
+			"timestamp",
+			"{",
+				"$gte", BCON_DOUBLE(StartTs),
+				"$lte", BCON_DOUBLE(EndTs),
+			"}");
+		bson_concat(filter, id_filter);
+
+		opts = BCON_NEW(
+			"sort",
+			"{",
+				"timestamp", BCON_INT32(1),
+			"}",
+			"projection",
+			"{",
+				"_id", BCON_INT32(0),
+				"timestamp", BCON_INT32(1),
+			"}");
+
+		TArray<double> SelectedTs;
+		int32 NumMatched = 0;
+		double PrevTs = -BIG_NUMBER;
+		cursor = mongoc_collection_find_with_opts(collection, filter, opts, NULL);
+		while (mongoc_cursor_next(cursor, &doc))
+		{
+			const double CurrTs = GetTs(doc);
+			if (CurrTs - PrevTs > DeltaT)
+			{
+				SelectedTs.Add(CurrTs);
+				PrevTs = CurrTs;
+			}
+			NumMatched++;
+		}
+		const bool bSuccess = !mongoc_cursor_error(cursor, &error);
+		if (!bSuccess)
+		{
+			UE_LOG(LogTemp, Error, TEXT("%s::%d Err.:%s"),
+				*FString(__func__), __LINE__, *FString(error.message));
+		}
+		mongoc_cursor_destroy(cursor);
+		bson_destroy(filter);
+		bson_destroy(opts);
+
+		if (bSuccess)
+		{
+			UE_LOG(LogTemp, Log, TEXT("%s::%d Downsampled %d frames to %d in [%f] seconds..;"),
+				*FString(__func__), __LINE__, NumMatched, SelectedTs.Num(), FPlatformTime::Seconds() - ExecBegin);
+
+			// Nothing to read
+			if (NumMatched == 0)
+			{
+				return;
+			}
+
+			// Match the selected timestamps (in batches to keep the queries small)
+			if (SelectedTs.Num() < NumMatched)
+			{
+				char idx_str[16];
+				const char* idx_key;
+				for (int32 Offset = 0; Offset < SelectedTs.Num(); Offset += MaxNumTsPerFilter)
+				{
+					bson_t* ts_filter = bson_new();
+					bson_t ts_doc;
+					bson_t ts_arr;
+					BSON_APPEND_DOCUMENT_BEGIN(ts_filter, "timestamp", &ts_doc);
+					BSON_APPEND_ARRAY_BEGIN(&ts_doc, "$in", &ts_arr);
+					const int32 Num = FMath::Min(MaxNumTsPerFilter, SelectedTs.Num() - Offset);
+					for (int32 Idx = 0; Idx < Num; ++Idx)
+					{
+						bson_uint32_to_string(Idx, &idx_key, idx_str, sizeof idx_str);
+						BSON_APPEND_DOUBLE(&ts_arr, idx_key, SelectedTs[Offset + Idx]);
+					}
+					bson_append_array_end(&ts_doc, &ts_arr);
+					bson_append_document_end(ts_filter, &ts_doc);
+					OutFilters.Add(ts_filter);
+				}
+				return;
+			}
+		}
+	}
+
+	// The whole time range
+	OutFilters.Add(BCON_NEW(
+		"timestamp",
+		"{",
+			"$gte", BCON_DOUBLE(StartTs),
+			"$lte", BCON_DOUBLE(EndTs),
+		"}"));
+}
+
+// Read the bones of a skeletal individual entry, returns true if the entry has all the bones (older values are not needed)
+bool FSLMongoQueryDBHandler::ReadSkeletalBones(const bson_t* doc, bool bOverwrite, TMap<int32, FTransform>& InOutBones) const
+{
+	bson_iter_t bones;
+	if (bson_iter_init(&bones, doc) && bson_iter_find(&bones, "bones"))
+	{
+		bson_iter_t bone;
+		if (bson_iter_recurse(&bones, &bone))
+		{
+			bson_iter_t value;
+			while (bson_iter_next(&bone))
+			{
+				if (bson_iter_recurse(&bone, &value) && bson_iter_find(&value, "idx"))
+				{
+					const int32 BoneIndex = bson_iter_int32(&value);
+					if (bOverwrite || !InOutBones.Contains(BoneIndex))
+					{
+						InOutBones.Emplace(BoneIndex, GetPose(&bone));
+					}
+				}
+			}
+		}
+	}
+
+	// Without sparse bones every entry has all the bones
+	bson_iter_t key;
+	return !bSparseBones || (bson_iter_init_find(&key, doc, "key") && BSON_ITER_HOLDS_BOOL(&key) && bson_iter_bool(&key));
+}
+
+// Read the timestamp and the individual poses of a world state document
+void FSLMongoQueryDBHandler::ReadFrame(const bson_t* doc, double& OutTs, TMap<FString, FTransform>& OutIndividualPoses) const
+{
+	bson_iter_t frame_iter;
+	if (bson_iter_init(&frame_iter, doc))
+	{
+		if (bson_iter_find(&frame_iter, "timestamp"))
+		{
+			OutTs = bson_iter_double(&frame_iter);
+		}
+
+		bson_iter_t individuals_iter;
+		if (bson_iter_find(&frame_iter, "individuals") && bson_iter_recurse(&frame_iter, &individuals_iter))
+		{
+			while (bson_iter_next(&individuals_iter))
+			{
+				OutIndividualPoses.Emplace(GetId(&individuals_iter), GetPose(&individuals_iter));
+			}
+		}
+	}
+}
+
+/* Trajectory buckets */
+// Get the pose at the given time from the trajectory buckets (false if there is no sample)
+bool FSLMongoQueryDBHandler::GetBucketPoseAt(const FString& Id, float Ts, FTransform& OutPose) const
+{
+	bson_error_t error;
+	const bson_t *doc;
+	mongoc_cursor_t *cursor;
+	bson_t *filter;
+	bson_t *opts;
+
+	// Last bucket starting before the given time (uses the {id, start} index)
+	filter = BCON_NEW(
+		"id", BCON_UTF8(TCHAR_TO_UTF8(*Id)),
+		"start", "{", "$lte", BCON_DOUBLE(Ts), "}");
+	opts = BCON_NEW(
+		"sort", "{", "start", BCON_INT32(-1), "}",
+		"limit", BCON_INT64(1));
+
+	bool bFound = false;
+	cursor = mongoc_collection_find_with_opts(trj_collection, filter, opts, NULL);
+	if (mongoc_cursor_next(cursor, &doc))
+	{
+		TArray<float> Timestamps;
+		TArray<FTransform> Poses;
+		if (ReadTrajectoryBucket(doc, Timestamps, Poses))
+		{
+			// Last sample not newer than the given time
+			const int32 Idx = Algo::UpperBound(Timestamps, Ts) - 1;
+			if (Idx >= 0)
+			{
+				OutPose = Poses[Idx];
+				bFound = true;
+			}
+		}
+	}
+	if (mongoc_cursor_error(cursor, &error))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Err.:%s"),
+			*FString(__func__), __LINE__, *FString(error.message));
+	}
+
+	mongoc_cursor_destroy(cursor);
+	bson_destroy(filter);
+	bson_destroy(opts);
+	return bFound;
+}
+
+// Get the poses between the given timestamps from the trajectory buckets (false if there is no sample)
+bool FSLMongoQueryDBHandler::GetBucketTrajectory(const FString& Id, float StartTs, float EndTs, float DeltaT, TArray<FTransform>& OutTrajectory) const
+{
+	bson_error_t error;
+	const bson_t *doc;
+	mongoc_cursor_t *cursor;
+	bson_t *filter;
+	bson_t *opts;
+
+	// Buckets overlapping the given interval
+	filter = BCON_NEW(
+		"id", BCON_UTF8(TCHAR_TO_UTF8(*Id)),
+		"start", "{", "$lte", BCON_DOUBLE(EndTs), "}",
+		"end", "{", "$gte", BCON_DOUBLE(StartTs), "}");
+	opts = BCON_NEW(
+		"sort", "{", "start", BCON_INT32(1), "}");
+
+	cursor = mongoc_collection_find_with_opts(trj_collection, filter, opts, NULL);
+	TArray<float> Timestamps;
+	TArray<FTransform> Poses;
+	double PrevTs = -BIG_NUMBER;
+	while (mongoc_cursor_next(cursor, &doc))
+	{
+		if (!ReadTrajectoryBucket(doc, Timestamps, Poses))
+		{
+			continue;
+		}
+		for (int32 Idx = Algo::LowerBound(Timestamps, StartTs); Idx < Timestamps.Num() && Timestamps[Idx] <= EndTs; ++Idx)
+		{
+			if (DeltaT <= 0.f || Timestamps[Idx] - PrevTs > DeltaT)
+			{
+				OutTrajectory.Add(Poses[Idx]);
+				PrevTs = Timestamps[Idx];
+			}
+		}
+	}
+	if (mongoc_cursor_error(cursor, &error))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Err.:%s"),
+			*FString(__func__), __LINE__, *FString(error.message));
+	}
+
+	mongoc_cursor_destroy(cursor);
+	bson_destroy(filter);
+	bson_destroy(opts);
+	return OutTrajectory.Num() > 0;
+}
+
+// Decode the packed timestamps and poses of a trajectory bucket document
+bool FSLMongoQueryDBHandler::ReadTrajectoryBucket(const bson_t* doc, TArray<float>& OutTimestamps, TArray<FTransform>& OutPoses) const
+{
+	OutTimestamps.Reset();
+	OutPoses.Reset();
+
+	// Get the packed float32 array of the given field
+	auto GetPacked = [doc](const char* Field, uint32_t ExpectedNum, const float*& OutData) -> bool
+	{
+		bson_iter_t iter;
+		bson_subtype_t subtype;
+		uint32_t len = 0;
+		const uint8_t* data = nullptr;
+		if (!bson_iter_init_find(&iter, doc, Field) || !BSON_ITER_HOLDS_BINARY(&iter))
+		{
+			return false;
+		}
+		bson_iter_binary(&iter, &subtype, &len, &data);
+		OutData = reinterpret_cast<const float*>(data);
+		return len == ExpectedNum * sizeof(float);
+	};
+
+	bson_iter_t iter;
+	if (!bson_iter_init_find(&iter, doc, "num") || !BSON_ITER_HOLDS_INT32(&iter))
+	{
+		return false;
+	}
+	const int32 Num = bson_iter_int32(&iter);
+
+	const float* ts_data = nullptr;
+	const float* loc_data = nullptr;
+	const float* quat_data = nullptr;
+	if (Num <= 0 || !GetPacked("ts", Num, ts_data) || !GetPacked("loc", Num * 3, loc_data) || !GetPacked("quat", Num * 4, quat_data))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d Invalid trajectory bucket, skipping.."), *FString(__func__), __LINE__);
+		return false;
+	}
+
+	// Binary data is not guaranteed to be aligned, copy it
+	OutTimestamps.SetNumUninitialized(Num);
+	FMemory::Memcpy(OutTimestamps.GetData(), ts_data, Num * sizeof(float));
+	OutPoses.Reserve(Num);
+	for (int32 Idx = 0; Idx < Num; ++Idx)
+	{
+		float L[3];
+		float Q[4];
+		FMemory::Memcpy(L, loc_data + Idx * 3, sizeof(L));
+		FMemory::Memcpy(Q, quat_data + Idx * 4, sizeof(Q));
+		FQuat Quat(Q[0], Q[1], Q[2], Q[3]);
+		Quat.Normalize();
+#if SL_WITH_ROS_CONVERSIONS
+		OutPoses.Add(FConversions::ROSToU(FTransform(Quat, FVector(L[0], L[1], L[2]))));
+#else
+		OutPoses.Add(FTransform(Quat, FVector(L[0], L[1], L[2])));
+#endif // SL_WITH_ROS_CONVERSIONS
+	}
+	return true;
+}
+
 #endif // SL_WITH_LIBMONGO_C
\ No newline at end of file
@@ -138,6 +138,7 @@ bool ASLMongoQueryManager::Connect(const FString& ServerIp, uint16 ServerPort)
 	}
 	if (DBHandler.Connect(ServerIp, ServerPort))
 	{
+		DBHandler.SetPoseCache(bUsePoseCache, PoseCacheWindowSize, PoseCacheMaxNumFrames);
 		bConnected = true;
 	}
 	else
@@ -323,11 +324,11 @@ TPair<FTransform, TMap<int32, FTransform>> ASLMongoQueryManager::GetSkeletalIndi
 }
 
 // Get skeletal individual trajectory with task and episode init
-TArray<TPair<FTransform, TMap<int32, FTransform>>> ASLMongoQueryManager::GetSkeletalIndividualTrajectory(const FString& InTaskId, const FString& InEpisodeId, const FString& IndividualId, float StartTs, float EndTs, float DeltaT)
+TArray<TPair<FTransform, TMap<int32, FTransform>>> ASLMongoQueryManager::GetSkeletalIndividualTrajectory(const FString& InTaskId, const FString& InEpisodeId, const FString& IndividualId, float StartTs, float EndTs, float DeltaT, const TArray<int32>& BoneIndexes)
 {
 	if (SetTask(InTaskId))
 	{
-		return GetSkeletalIndividualTrajectory(InEpisodeId, IndividualId, StartTs, EndTs, DeltaT);
+		return GetSkeletalIndividualTrajectory(InEpisodeId, IndividualId, StartTs, EndTs, DeltaT, BoneIndexes);
 	}
 	else
 	{
@@ -338,11 +339,11 @@ TArray<TPair<FTransform, TMap<int32, FTransform>>> ASLMongoQueryManager::GetSkel
 }
 
 // Get skeletal individual trajectoru with episode init
-TArray<TPair<FTransform, TMap<int32, FTransform>>> ASLMongoQueryManager::GetSkeletalIndividualTrajectory(const FString& InEpisodeId, const FString& IndividualId, float StartTs, float EndTs, float DeltaT)
+TArray<TPair<FTransform, TMap<int32, FTransform>>> ASLMongoQueryManager::GetSkeletalIndividualTrajectory(const FString& InEpisodeId, const FString& IndividualId, float StartTs, float EndTs, float DeltaT, const TArray<int32>& BoneIndexes)
 {
 	if (SetEpisode(InEpisodeId))
 	{
-		return GetSkeletalIndividualTrajectory(IndividualId, StartTs, EndTs, DeltaT);
+		return GetSkeletalIndividualTrajectory(IndividualId, StartTs, EndTs, DeltaT, BoneIndexes);
 	}
 	else
 	{
@@ -352,9 +353,9 @@ TArray<TPair<FTransform, TMap<int32, FTransform>>> ASLMongoQueryManager::GetSkel
 }
 
 // Get skeletal individual trajectory
-TArray<TPair<FTransform, TMap<int32, FTransform>>> ASLMongoQueryManager::GetSkeletalIndividualTrajectory(const FString& IndividualId, float StartTs, float EndTs, float DeltaT) const
+TArray<TPair<FTransform, TMap<int32, FTransform>>> ASLMongoQueryManager::GetSkeletalIndividualTrajectory(const FString& IndividualId, float StartTs, float EndTs, float DeltaT, const TArray<int32>& BoneIndexes) const
 {
-	return DBHandler.GetSkeletalIndividualTrajectory(IndividualId, StartTs, EndTs, DeltaT);
+	return DBHandler.GetSkeletalIndividualTrajectory(IndividualId, StartTs, EndTs, DeltaT, BoneIndexes);
 }
 
 // Get the episode data with task and episode init
@@ -391,6 +392,40 @@ TArray<TPair<float, TMap<FString, FTransform>>> ASLMongoQueryManager::GetEpisode
 	return DBHandler.GetEpisodeData();
 }
 
+// Get the number of documents and the last timestamp of the episode (used to detect changes of the episode)
+bool ASLMongoQueryManager::GetEpisodeFingerprint(const FString& InTaskId, const FString& InEpisodeId, int64& OutNumDocs, double& OutLastTs)
+{
+	if (SetTask(InTaskId) && SetEpisode(InEpisodeId))
+	{
+		return DBHandler.GetCollectionFingerprint(OutNumDocs, OutLastTs);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not set task/episode: %s/%s .."), *FString(__FUNCTION__), __LINE__, *InTaskId, *InEpisodeId);
+		return false;
+	}
+}
+
+// Stream the episode data in an async thread with task and episode init
+TSharedPtr<FSLMongoEpisodeStreamer> ASLMongoQueryManager::GetEpisodeDataAsync(const FString& InTaskId, const FString& InEpisodeId, float StartTs, float EndTs)
+{
+	if (SetTask(InTaskId) && SetEpisode(InEpisodeId))
+	{
+		return GetEpisodeDataAsync(StartTs, EndTs);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not set task/episode: %s/%s .."), *FString(__FUNCTION__), __LINE__, *InTaskId, *InEpisodeId);
+		return nullptr;
+	}
+}
+
+// Stream the episode data in an async thread
+TSharedPtr<FSLMongoEpisodeStreamer> ASLMongoQueryManager::GetEpisodeDataAsync(float StartTs, float EndTs) const
+{
+	return DBHandler.GetEpisodeDataAsync(StartTs, EndTs);
+}
+
 // Spawn or get manager from the world
 ASLMongoQueryManager* ASLMongoQueryManager::GetExistingOrSpawnNew(UWorld* World)
 {
@@ -7,7 +7,7 @@
 #include "Engine/StaticMeshActor.h"
 #include "Animation/SkeletalMeshActor.h"
 #include "Components/SkeletalMeshComponent.h"
-#include "TimerManager.h"
+#include "Monitors/SLMonitorScheduler.h"
 
 // Ctor
 USLBoneContactMonitor::USLBoneContactMonitor()
@@ -24,6 +24,7 @@ USLBoneContactMonitor::USLBoneContactMonitor()
 	bIsGraspDetectionPaused = false;
 	bDetectGrasps = false;
 	bDetectContacts = false;
+	MonitorScheduler = nullptr;
 
 	bLogContactDebug = false;
 	bLogGraspDebug = false;
@@ -51,6 +52,14 @@ void USLBoneContactMonitor::Init(bool bGrasp, bool bContact)
 		bDetectGrasps = bGrasp;
 		bDetectContacts = bContact;
 
+		// Owns the delayed end event calls
+		MonitorScheduler = USLMonitorScheduler::Get(GetWorld());
+		if (!MonitorScheduler)
+		{
+			UE_LOG(LogTemp, Error, TEXT("%s::%d Could not get the monitor scheduler of the world.."), *FString(__FUNCTION__), __LINE__);
+			return;
+		}
+
 		// Remove any unset references in the array
 		IgnoreList.Remove(nullptr);
 
@@ -204,6 +213,12 @@ void USLBoneContactMonitor::Finish(bool bForced)
 		}
 		RecentlyEndedContactOverlapEvents.Empty();
 
+		if (MonitorScheduler)
+		{
+			MonitorScheduler->ClearDelayedCall(GraspDelayTimerHandle);
+			MonitorScheduler->ClearDelayedCall(ContactDelayTimerHandle);
+		}
+
 		SetGenerateOverlapEvents(false);
 		
 		// Mark as finished
@@ -501,10 +516,10 @@ void USLBoneContactMonitor::OnGraspOverlapEnd(UPrimitiveComponent* OverlappedCom
 			OtherIndividual, GetWorld()->GetTimeSeconds()));
 			
 		// Delay publishing for a while, in case the new event is of the same type and should be concatenated
-		if(!GetWorld()->GetTimerManager().IsTimerActive(GraspDelayTimerHandle))
+		if(!MonitorScheduler->IsDelayedCallActive(GraspDelayTimerHandle))
 		{
-			GetWorld()->GetTimerManager().SetTimer(GraspDelayTimerHandle, this, 
-				&USLBoneContactMonitor::DelayedGraspOverlapEndEventCallback, ConcatenateIfSmaller*1.1f, false);
+			MonitorScheduler->SetDelayedCall(GraspDelayTimerHandle, this, 
+				&USLBoneContactMonitor::DelayedGraspOverlapEndEventCallback, ConcatenateIfSmaller*1.1f);
 		}
 	}
 	else
@@ -552,8 +567,8 @@ void USLBoneContactMonitor::DelayedGraspOverlapEndEventCallback()
 	if(RecentlyEndedGraspOverlapEvents.Num() > 0)
 	{
 		const float DelayValue = ConcatenateIfSmaller + ConcatenateIfSmallerDelay;
-		GetWorld()->GetTimerManager().SetTimer(GraspDelayTimerHandle,
-			this, &USLBoneContactMonitor::DelayedGraspOverlapEndEventCallback, DelayValue, false);
+		MonitorScheduler->SetDelayedCall(GraspDelayTimerHandle,
+			this, &USLBoneContactMonitor::DelayedGraspOverlapEndEventCallback, DelayValue);
 	}
 }
 
@@ -573,7 +588,7 @@ bool USLBoneContactMonitor::IsAJitterGrasp(USLBaseIndividual* OtherIndividual, f
 				// Check if it was the last event, if so, pause the delay publisher
 				if(RecentlyEndedGraspOverlapEvents.Num() == 0)
 				{
-					GetWorld()->GetTimerManager().ClearTimer(GraspDelayTimerHandle);
+					MonitorScheduler->ClearDelayedCall(GraspDelayTimerHandle);
 				}
 				return true;
 			}
@@ -736,11 +751,11 @@ void USLBoneContactMonitor::OnContactOverlapEnd(UPrimitiveComponent* OverlappedC
 		OtherIndividual, GetWorld()->GetTimeSeconds()));
 		
 	// Delay publishing for a while, in case the new event is of the same type and should be concatenated
-	if(!GetWorld()->GetTimerManager().IsTimerActive(ContactDelayTimerHandle))
+	if(!MonitorScheduler->IsDelayedCallActive(ContactDelayTimerHandle))
 	{
 		const float DelayValue = ConcatenateIfSmaller + ConcatenateIfSmallerDelay;
-		GetWorld()->GetTimerManager().SetTimer(ContactDelayTimerHandle, 
-			this, &USLBoneContactMonitor::DelayContactEndCallback, DelayValue, false);
+		MonitorScheduler->SetDelayedCall(ContactDelayTimerHandle, 
+			this, &USLBoneContactMonitor::DelayContactEndCallback, DelayValue);
 	}
 
 }
@@ -775,8 +790,8 @@ void USLBoneContactMonitor::DelayContactEndCallback()
 	if(RecentlyEndedContactOverlapEvents.Num() > 0)
 	{
 		const float DelayValue = ConcatenateIfSmaller + ConcatenateIfSmallerDelay;
-		GetWorld()->GetTimerManager().SetTimer(ContactDelayTimerHandle,
-			this, &USLBoneContactMonitor::DelayContactEndCallback, DelayValue, false);
+		MonitorScheduler->SetDelayedCall(ContactDelayTimerHandle,
+			this, &USLBoneContactMonitor::DelayContactEndCallback, DelayValue);
 	}
 }
 
@@ -797,7 +812,7 @@ bool USLBoneContactMonitor::IsAJitterContact(USLBaseIndividual* OtherIndividual,
 				// Check if it was the last event, if so, pause the delay publisher
 				if(RecentlyEndedContactOverlapEvents.Num() == 0)
 				{
-					GetWorld()->GetTimerManager().ClearTimer(ContactDelayTimerHandle);
+					MonitorScheduler->ClearDelayedCall(ContactDelayTimerHandle);
 				}
 				return true;
 			}
@@ -27,6 +27,7 @@ USLContactMonitorBox::USLContactMonitorBox()
 	bLogSupportedByEvents = true;
 
 	OwnerIndividualComponent = nullptr;
+	MonitorScheduler = nullptr;
 
 #if WITH_EDITORONLY_DATA
 	// Box extent scale
@@ -130,11 +131,6 @@ void USLContactMonitorBox::Start()
 {
 	if (!bIsStarted && bIsInit)
 	{
-		if(bLogSupportedByEvents)
-		{
-			StartSupportedByUpdateCheck();
-		}
-		
 		// Enable overlap events
 		SetGenerateOverlapEvents(true);
 
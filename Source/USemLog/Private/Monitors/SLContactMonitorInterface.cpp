@@ -17,6 +17,11 @@ void ISLContactMonitorInterface::Finish(bool bForced)
 			PublishDelayedOverlapEndEvent(Ev);
 		}
 		RecentlyEndedOverlapEvents.Empty();
+		if (MonitorScheduler)
+		{
+			MonitorScheduler->ClearDelayedCall(DelayTimerHandle);
+			MonitorScheduler->RemoveSupportedByCandidates(this);
+		}
 		
 		// Disable overlap events
 		ShapeComponent->SetGenerateOverlapEvents(false);
@@ -35,6 +40,12 @@ bool ISLContactMonitorInterface::InitContactMonitorInterface(UShapeComponent* In
 	{
 		World = InWorld;
 		ShapeComponent = InShapeComponent;
+		MonitorScheduler = USLMonitorScheduler::Get(InWorld);
+		if (!MonitorScheduler)
+		{
+			UE_LOG(LogTemp, Error, TEXT("%s::%d Could not get the monitor scheduler of the world.."), *FString(__FUNCTION__), __LINE__);
+			return false;
+		}
 		DelayTimerDelegate.BindRaw(this, &ISLContactMonitorInterface::DelayedOverlapEndEventCallback);
 		return true;
 	}
@@ -56,88 +67,46 @@ void ISLContactMonitorInterface::TriggerInitialOverlaps()
 	}
 }
 
-// Start checking for supported by events
-void ISLContactMonitorInterface::StartSupportedByUpdateCheck()
+// Broadcast the supported by event of the (vertically stable) candidate, called by the scheduler
+void ISLContactMonitorInterface::BeginSupportedByEvent(const FSLContactResult& Candidate, float Time)
 {
-	if(World)
+	if (Candidate.bIsOtherASemanticOverlapArea)
 	{
-		// Start updating the timer, will be paused if there are no candidates
-		SupportedByTimerDelegate.BindRaw(this, &ISLContactMonitorInterface::SupportedByUpdateCheckBegin);
-		World->GetTimerManager().SetTimer(SupportedByTimerHandle, SupportedByTimerDelegate, SupportedByUpdateRate, true);
-	}
-}
-
-// Supported by update
-// TODO is a supported by end update look required?
-void ISLContactMonitorInterface::SupportedByUpdateCheckBegin()
-{
-	// Check if candidates are in a supported by event
-	for (auto CandidateItr(SupportedByCandidates.CreateIterator()); CandidateItr; ++CandidateItr)
-	{
-		// Get relative vertical speed
-		const float RelVertSpeed = FMath::Abs(CandidateItr->SelfMeshComponent->GetComponentVelocity().Z -
-			CandidateItr->OtherMeshComponent->GetComponentVelocity().Z);
-		
-		// Check that the relative speed on Z between the two objects is smaller than the threshold
-		if (RelVertSpeed < SupportedByMaxVertSpeed)
+		// Check which is supporting and which is supported
+		// TODO simple height comparison for now
+		if (Candidate.SelfMeshComponent->GetComponentLocation().Z >
+			Candidate.OtherMeshComponent->GetComponentLocation().Z)
 		{
-			if (CandidateItr->bIsOtherASemanticOverlapArea)
-			{
-				// Check which is supporting and which is supported
-				// TODO simple height comparison for now
-				if (CandidateItr->SelfMeshComponent->GetComponentLocation().Z >
-					CandidateItr->OtherMeshComponent->GetComponentLocation().Z)
-				{
-					USLBaseIndividual* Supported = CandidateItr->Self;
-					USLBaseIndividual* Supporting = CandidateItr->Other;
-					const uint64 PairId = FSLUuid::PairEncodeCantor(Supported->GetUniqueID(), Supporting->GetUniqueID());
-					OnBeginSLSupportedBy.Broadcast(Supported, Supporting, World->GetTimeSeconds(), PairId);
-					IsSupportedByPariIds.Add(PairId);
-				}
-				else
-				{
-					USLBaseIndividual* Supported = CandidateItr->Other;
-					USLBaseIndividual* Supporting = CandidateItr->Self;
-					const uint64 PairId = FSLUuid::PairEncodeCantor(Supported->GetUniqueID(), Supporting->GetUniqueID());
-					OnBeginSLSupportedBy.Broadcast(Supported, Supporting, World->GetTimeSeconds(), PairId);
-					// Self item is supporting another, to not add it to the supportedby events id
-				}
-			}
-			else 
-			{
-				// Other can only support, self can only be supported
-				USLBaseIndividual* Supported = CandidateItr->Self;
-				USLBaseIndividual* Supporting = CandidateItr->Other;
-				const uint64 PairId = FSLUuid::PairEncodeCantor(Supported->GetUniqueID(), Supporting->GetUniqueID());
-				OnBeginSLSupportedBy.Broadcast(Supported, Supporting, World->GetTimeSeconds(), PairId);
-				IsSupportedByPariIds.Add(PairId);
-			}
-			// Remove candidate, it is now part of a started event
-			CandidateItr.RemoveCurrent();
+			USLBaseIndividual* Supported = Candidate.Self;
+			USLBaseIndividual* Supporting = Candidate.Other;
+			const uint64 PairId = FSLUuid::PairEncodeCantor(Supported->GetUniqueID(), Supporting->GetUniqueID());
+			OnBeginSLSupportedBy.Broadcast(Supported, Supporting, Time, PairId);
+			IsSupportedByPariIds.Add(PairId);
+		}
+		else
+		{
+			USLBaseIndividual* Supported = Candidate.Other;
+			USLBaseIndividual* Supporting = Candidate.Self;
+			const uint64 PairId = FSLUuid::PairEncodeCantor(Supported->GetUniqueID(), Supporting->GetUniqueID());
+			OnBeginSLSupportedBy.Broadcast(Supported, Supporting, Time, PairId);
+			// Self item is supporting another, to not add it to the supportedby events id
 		}
 	}
-	
-	// PauseGraspDetection timer
-	if (SupportedByCandidates.Num() == 0)
+	else 
 	{
-		World->GetTimerManager().PauseTimer(SupportedByTimerHandle);
+		// Other can only support, self can only be supported
+		USLBaseIndividual* Supported = Candidate.Self;
+		USLBaseIndividual* Supporting = Candidate.Other;
+		const uint64 PairId = FSLUuid::PairEncodeCantor(Supported->GetUniqueID(), Supporting->GetUniqueID());
+		OnBeginSLSupportedBy.Broadcast(Supported, Supporting, Time, PairId);
+		IsSupportedByPariIds.Add(PairId);
 	}
 }
 
 // Remove candidate from array
 bool ISLContactMonitorInterface::CheckAndRemoveIfJustCandidate(USLBaseIndividual* InOther)
 {
-	// Use iterator to be able to remove the entry from the array
-	for (auto CandidateItr(SupportedByCandidates.CreateIterator()); CandidateItr; ++CandidateItr)
-	{
-		if ((*CandidateItr).Other == InOther)
-		{
-			// Remove candidate from the list
-			CandidateItr.RemoveCurrent();
-			return true; // Found
-		}
-	}
-	return false; // Not in list
+	return MonitorScheduler->RemoveSupportedByCandidate(this, InOther);
 }
 
 // Called on overlap begin events
@@ -185,12 +154,8 @@ void ISLContactMonitorInterface::OnOverlapBegin(UPrimitiveComponent* OverlappedC
 
 		if(bLogSupportedByEvents)
 		{
-			// Add candidate and re-start (if paused) timer cb
-			SupportedByCandidates.Emplace(SemanticOverlapResult);
-			if(World->GetTimerManager().IsTimerPaused(SupportedByTimerHandle))
-			{
-				World->GetTimerManager().UnPauseTimer(SupportedByTimerHandle);
-			}
+			// Checked by the scheduler until the pair is vertically stable
+			MonitorScheduler->AddSupportedByCandidate(this, SemanticOverlapResult);
 		}
 	}
 	else if (ISLContactMonitorInterface* OtherContactTrigger = Cast<ISLContactMonitorInterface>(OtherComp))
@@ -211,12 +176,8 @@ void ISLContactMonitorInterface::OnOverlapBegin(UPrimitiveComponent* OverlappedC
 			
 			if(bLogSupportedByEvents)
 			{
-				// Add candidate and re-start (if paused) timer cb
-				SupportedByCandidates.Emplace(SemanticOverlapResult);
-				if(World->GetTimerManager().IsTimerPaused(SupportedByTimerHandle))
-				{
-					World->GetTimerManager().UnPauseTimer(SupportedByTimerHandle);
-				}
+				// Checked by the scheduler until the pair is vertically stable
+				MonitorScheduler->AddSupportedByCandidate(this, SemanticOverlapResult);
 			}
 		}
 	}
@@ -249,10 +210,10 @@ void ISLContactMonitorInterface::OnOverlapEnd(UPrimitiveComponent* OverlappedCom
 	RecentlyEndedOverlapEvents.Emplace(FSLOverlapEndEvent(OtherComp, OtherIndividual, World->GetTimeSeconds()));
 
 	// Delay publishing for a while, in case the new event is of the same type and should be concatenated
-	if(!World->GetTimerManager().IsTimerActive(DelayTimerHandle))
+	if(!MonitorScheduler->IsDelayedCallActive(DelayTimerHandle))
 	{
 		const float DelayValue = ConcatenateIfSmaller + ConcatenateIfSmallerDelay;
-		World->GetTimerManager().SetTimer(DelayTimerHandle, DelayTimerDelegate, DelayValue, false);
+		MonitorScheduler->SetDelayedCall(DelayTimerHandle, DelayTimerDelegate, DelayValue);
 	}
 }
 
@@ -275,7 +236,7 @@ void ISLContactMonitorInterface::DelayedOverlapEndEventCallback()
 	if(RecentlyEndedOverlapEvents.Num() > 0)
 	{
 		const float DelayValue = ConcatenateIfSmaller + ConcatenateIfSmallerDelay;
-		World->GetTimerManager().SetTimer(DelayTimerHandle, DelayTimerDelegate, DelayValue, false);
+		MonitorScheduler->SetDelayedCall(DelayTimerHandle, DelayTimerDelegate, DelayValue);
 	}
 }
 
@@ -345,7 +306,7 @@ bool ISLContactMonitorInterface::SkipOverlapEndEventBroadcast(USLBaseIndividual*
 				// Check if it was the last event, if so, pause the delay publisher
 				if(RecentlyEndedOverlapEvents.Num() == 0)
 				{
-					World->GetTimerManager().ClearTimer(DelayTimerHandle);
+					MonitorScheduler->ClearDelayedCall(DelayTimerHandle);
 				}
 				
 				return true;
@@ -26,6 +26,7 @@ USLContactMonitorSphere::USLContactMonitorSphere()
 	bLogSupportedByEvents = true;
 	
 	OwnerIndividualComponent = nullptr;
+	MonitorScheduler = nullptr;
 
 #if WITH_EDITORONLY_DATA
 	// Box extent scale
@@ -130,11 +131,6 @@ void USLContactMonitorSphere::Start()
 {
 	if (!bIsStarted && bIsInit)
 	{
-		if(bLogSupportedByEvents)
-		{
-			StartSupportedByUpdateCheck();
-		}
-		
 		// Enable overlap events
 		SetGenerateOverlapEvents(true);
 
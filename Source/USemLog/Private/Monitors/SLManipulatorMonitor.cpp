@@ -10,6 +10,7 @@
 #include "Engine/StaticMeshActor.h"
 #include "GameFramework/PlayerController.h"
 #include "Components/InputComponent.h"
+#include "Monitors/SLMonitorScheduler.h"
 #include "PhysicsEngine/PhysicsConstraintComponent.h" // AdHoc grasp helper
 #include "Components/StaticMeshComponent.h" // AdHoc grasp helper
 #include "Components/SkeletalMeshComponent.h" // AdHoc grasp helper
@@ -32,6 +33,7 @@ USLManipulatorMonitor::USLManipulatorMonitor()
 	bIsStarted = false;
 	bIsFinished = false;
 	bIsGraspDetectionPaused = false;
+	MonitorScheduler = nullptr;
 	InputAxisName = "LeftGrasp";
 	bIsNotSkeletal = false;
 	InputAxisTriggerThresholdValue = 0.3f;
@@ -82,6 +84,14 @@ void USLManipulatorMonitor::Init(bool bInDetectGrasps, bool bInDetectContacts)
 	bDetectGrasps = bInDetectGrasps;
 	bDetectContacts = bInDetectContacts;
 
+	// Owns the delayed end event calls
+	MonitorScheduler = USLMonitorScheduler::Get(GetWorld());
+	if (!MonitorScheduler)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not get the monitor scheduler of the world.."), *FString(__FUNCTION__), __LINE__);
+		return;
+	}
+
 	// Make sure the owner is semantically annotated
 	if (UActorComponent* AC = GetOwner()->GetComponentByClass(USLIndividualComponent::StaticClass()))
 	{
@@ -273,6 +283,12 @@ void USLManipulatorMonitor::Finish(bool bForced)
 		}
 		RecentlyEndedContactEvents.Empty();
 
+		if (MonitorScheduler)
+		{
+			MonitorScheduler->ClearDelayedCall(GraspDelayTimerHandle);
+			MonitorScheduler->ClearDelayedCall(ContactDelayTimerHandle);
+		}
+
 		// Mark as finished
 		bIsStarted = false;
 		bIsInit = false;
@@ -874,11 +890,11 @@ void USLManipulatorMonitor::GraspEnded(USLBaseIndividual* OtherIndividual)
 		RecentlyEndedGraspEvents.Emplace(FSLGraspEndEvent(OtherIndividual, GetWorld()->GetTimeSeconds()));
 		
 		// Delay publishing for a while, in case the new event is of the same type and should be concatenated
-		if(!GetWorld()->GetTimerManager().IsTimerActive(GraspDelayTimerHandle))
+		if(!MonitorScheduler->IsDelayedCallActive(GraspDelayTimerHandle))
 		{
 			const float DelayValue = GraspConcatenateIfSmaller + ConcatenateIfSmallerDelay;
-			GetWorld()->GetTimerManager().SetTimer(GraspDelayTimerHandle, this,
-				&USLManipulatorMonitor::DelayedGraspEndCallback, DelayValue, false);
+			MonitorScheduler->SetDelayedCall(GraspDelayTimerHandle, this,
+				&USLManipulatorMonitor::DelayedGraspEndCallback, DelayValue);
 		}
 	}
 	else
@@ -924,8 +940,8 @@ void USLManipulatorMonitor::DelayedGraspEndCallback()
 	if(RecentlyEndedGraspEvents.Num() > 0)
 	{
 		const float DelayValue = GraspConcatenateIfSmaller + ConcatenateIfSmallerDelay;
-		GetWorld()->GetTimerManager().SetTimer(GraspDelayTimerHandle, this,
-			&USLManipulatorMonitor::DelayedGraspEndCallback, DelayValue, false);
+		MonitorScheduler->SetDelayedCall(GraspDelayTimerHandle, this,
+			&USLManipulatorMonitor::DelayedGraspEndCallback, DelayValue);
 	}
 }
 
@@ -945,7 +961,7 @@ bool USLManipulatorMonitor::IsAJitterGrasp(USLBaseIndividual* OtherIndividual, f
 				// Check if it was the last event, if so, pause the delay publisher
 				if(RecentlyEndedGraspEvents.Num() == 0)
 				{
-					GetWorld()->GetTimerManager().ClearTimer(GraspDelayTimerHandle);
+					MonitorScheduler->ClearDelayedCall(GraspDelayTimerHandle);
 				}
 				return true;
 			}
@@ -1021,11 +1037,11 @@ void USLManipulatorMonitor::OnBoneContactEnd(USLBaseIndividual* OtherIndividual,
 			RecentlyEndedContactEvents.Emplace(FSLContactEndEvent(OtherIndividual, GetWorld()->GetTimeSeconds()));
 				
 			// Delay publishing for a while, in case the new event is of the same type and should be concatenated
-			if(!GetWorld()->GetTimerManager().IsTimerActive(ContactDelayTimerHandle))
+			if(!MonitorScheduler->IsDelayedCallActive(ContactDelayTimerHandle))
 			{
 				const float DelayValue = ContactConcatenateIfSmaller + ConcatenateIfSmallerDelay;
-				GetWorld()->GetTimerManager().SetTimer(ContactDelayTimerHandle, this,
-					&USLManipulatorMonitor::DelayedContactEndCallback,	DelayValue, false);
+				MonitorScheduler->SetDelayedCall(ContactDelayTimerHandle, this,
+					&USLManipulatorMonitor::DelayedContactEndCallback,	DelayValue);
 			}
 		}
 	}
@@ -1101,8 +1117,8 @@ void USLManipulatorMonitor::DelayedContactEndCallback()
 	if(RecentlyEndedContactEvents.Num() > 0)
 	{
 		const float DelayValue = ContactConcatenateIfSmaller + ConcatenateIfSmallerDelay;
-		GetWorld()->GetTimerManager().SetTimer(ContactDelayTimerHandle, this,
-			&USLManipulatorMonitor::DelayedContactEndCallback, DelayValue, false);
+		MonitorScheduler->SetDelayedCall(ContactDelayTimerHandle, this,
+			&USLManipulatorMonitor::DelayedContactEndCallback, DelayValue);
 	}
 }
 
@@ -1124,7 +1140,7 @@ bool USLManipulatorMonitor::IsAJitterContact(USLBaseIndividual* InOther, float S
 				// Check if it was the last event, if so, pause the delay publisher
 				if(RecentlyEndedContactEvents.Num() == 0)
 				{
-					GetWorld()->GetTimerManager().ClearTimer(ContactDelayTimerHandle);
+					MonitorScheduler->ClearDelayedCall(ContactDelayTimerHandle);
 				}
 				return true;
 			}
@@ -0,0 +1,243 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "Monitors/SLMonitorScheduler.h"
+#include "Monitors/SLContactMonitorInterface.h"
+#include "Components/MeshComponent.h"
+#include "Engine/World.h"
+
+DECLARE_CYCLE_STAT(TEXT("SL Monitor Scheduler Tick"), STAT_SLMonitorSchedulerTick, STATGROUP_Game);
+
+// Get the scheduler of the world
+USLMonitorScheduler* USLMonitorScheduler::Get(UWorld* World)
+{
+	return World ? World->GetSubsystem<USLMonitorScheduler>() : nullptr;
+}
+
+// Init the containers
+void USLMonitorScheduler::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	NextSupportedByUpdateTime = 0.f;
+	LastWheelTick = -1;
+	NextCallId = 1;
+	NumTicks = 0;
+	TotalTickTime = 0.0;
+	MaxTickTime = 0.0;
+	MaxNumCandidates = 0;
+	MaxNumDelayedCalls = 0;
+}
+
+// Log the tick cost and clear the pending calls
+void USLMonitorScheduler::Deinitialize()
+{
+	if (NumTicks > 0)
+	{
+		UE_LOG(LogTemp, Log, TEXT("%s::%d Monitor scheduler: %lld ticks, avg=%.4fms, max=%.4fms, peak candidates=%d, peak delayed calls=%d;"),
+			*FString(__FUNCTION__), __LINE__, NumTicks, TotalTickTime * 1000.0 / NumTicks, MaxTickTime * 1000.0,
+			MaxNumCandidates, MaxNumDelayedCalls);
+	}
+
+	SupportedByCandidates.Empty();
+	for (auto& Slot : WheelSlots)
+	{
+		Slot.Empty();
+	}
+	ActiveCallIds.Empty();
+	Super::Deinitialize();
+}
+
+// Update the supported by candidates and the delayed calls
+void USLMonitorScheduler::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_SLMonitorSchedulerTick);
+	const double ExecBegin = FPlatformTime::Seconds();
+
+	const float CurrTime = GetWorld()->GetTimeSeconds();
+	UpdateDelayedCalls(CurrTime);
+	if (SupportedByCandidates.Num() > 0 && CurrTime >= NextSupportedByUpdateTime)
+	{
+		UpdateSupportedByCandidates(CurrTime);
+		NextSupportedByUpdateTime = CurrTime + SupportedByUpdateRate;
+	}
+
+	const double ExecTime = FPlatformTime::Seconds() - ExecBegin;
+	TotalTickTime += ExecTime;
+	MaxTickTime = FMath::Max(MaxTickTime, ExecTime);
+	NumTicks++;
+}
+
+// Only the world instances tick, and only if there is something to update
+bool USLMonitorScheduler::IsTickable() const
+{
+	return !HasAnyFlags(RF_ClassDefaultObject)
+		&& (SupportedByCandidates.Num() > 0 || ActiveCallIds.Num() > 0);
+}
+
+// Stat id of the tick
+TStatId USLMonitorScheduler::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USLMonitorScheduler, STATGROUP_Tickables);
+}
+
+// Add a supported by candidate, the monitor is called back once the pair is vertically stable
+void USLMonitorScheduler::AddSupportedByCandidate(ISLContactMonitorInterface* Monitor, const FSLContactResult& Candidate)
+{
+	if (SupportedByCandidates.Num() == 0)
+	{
+		// Give the new candidate a full update period (same as a newly started timer)
+		NextSupportedByUpdateTime = GetWorld()->GetTimeSeconds() + SupportedByUpdateRate;
+	}
+	SupportedByCandidates.Add(FSupportedByCandidate{ Monitor, Candidate });
+	MaxNumCandidates = FMath::Max(MaxNumCandidates, SupportedByCandidates.Num());
+}
+
+// Remove the candidate of the monitor with the other individual, false if it was not a candidate
+bool USLMonitorScheduler::RemoveSupportedByCandidate(ISLContactMonitorInterface* Monitor, USLBaseIndividual* Other)
+{
+	for (int32 Idx = 0; Idx < SupportedByCandidates.Num(); ++Idx)
+	{
+		const FSupportedByCandidate& Candidate = SupportedByCandidates[Idx];
+		if (Candidate.Monitor == Monitor && Candidate.Result.Other == Other)
+		{
+			SupportedByCandidates.RemoveAtSwap(Idx, 1, false);
+			return true;
+		}
+	}
+	return false;
+}
+
+// Remove all the candidates of the monitor
+void USLMonitorScheduler::RemoveSupportedByCandidates(ISLContactMonitorInterface* Monitor)
+{
+	SupportedByCandidates.RemoveAllSwap([Monitor](const FSupportedByCandidate& Candidate)
+	{
+		return Candidate.Monitor == Monitor;
+	}, false);
+}
+
+// Call the delegate after the delay (a pending call of the handle is replaced)
+void USLMonitorScheduler::SetDelayedCall(FSLDelayedCallHandle& InOutHandle, const FTimerDelegate& Delegate, float Delay)
+{
+	ClearDelayedCall(InOutHandle);
+
+	const float CurrTime = GetWorld()->GetTimeSeconds();
+	if (LastWheelTick < 0)
+	{
+		// Nothing processed yet, start from the previous slot
+		LastWheelTick = GetWheelTick(CurrTime) - 1;
+	}
+
+	FDelayedCall Call;
+	Call.Id = NextCallId++;
+	Call.DueTime = CurrTime + Delay;
+	Call.Delegate = Delegate;
+
+	// Slots up to the last processed one are not visited again
+	const int64 DueTick = FMath::Max(GetWheelTick(Call.DueTime), LastWheelTick + 1);
+	WheelSlots[DueTick % NumWheelSlots].Add(MoveTemp(Call));
+
+	InOutHandle.Id = NextCallId - 1;
+	ActiveCallIds.Add(InOutHandle.Id);
+	MaxNumDelayedCalls = FMath::Max(MaxNumDelayedCalls, ActiveCallIds.Num());
+}
+
+// Cancel the pending call of the handle
+void USLMonitorScheduler::ClearDelayedCall(FSLDelayedCallHandle& InOutHandle)
+{
+	if (InOutHandle.IsValid())
+	{
+		// The entry is dropped when its slot is processed
+		ActiveCallIds.Remove(InOutHandle.Id);
+		InOutHandle.Invalidate();
+	}
+}
+
+// Check the candidates and start the supported by events of the stable ones
+void USLMonitorScheduler::UpdateSupportedByCandidates(float CurrTime)
+{
+	// The same components are usually part of several candidates, read their velocity once per batch
+	TMap<const UMeshComponent*, float> VertSpeeds;
+	VertSpeeds.Reserve(SupportedByCandidates.Num() * 2);
+	auto GetVertSpeed = [&VertSpeeds](const UMeshComponent* MeshComp) -> float
+	{
+		if (const float* Speed = VertSpeeds.Find(MeshComp))
+		{
+			return *Speed;
+		}
+		return VertSpeeds.Add(MeshComp, MeshComp->GetComponentVelocity().Z);
+	};
+
+	// Collect the stable candidates first, the monitor callbacks can add or remove candidates
+	TArray<FSupportedByCandidate> StableCandidates;
+	for (int32 Idx = SupportedByCandidates.Num() - 1; Idx >= 0; --Idx)
+	{
+		const FSupportedByCandidate& Candidate = SupportedByCandidates[Idx];
+		const UMeshComponent* SelfMeshComp = Candidate.Result.SelfMeshComponent.Get();
+		const UMeshComponent* OtherMeshComp = Candidate.Result.OtherMeshComponent.Get();
+		if (!SelfMeshComp || !OtherMeshComp)
+		{
+			// Component was destroyed, drop the candidate
+			SupportedByCandidates.RemoveAtSwap(Idx, 1, false);
+			continue;
+		}
+
+		// Check that the relative speed on Z between the two objects is smaller than the threshold
+		const float RelVertSpeed = FMath::Abs(GetVertSpeed(SelfMeshComp) - GetVertSpeed(OtherMeshComp));
+		if (RelVertSpeed < SupportedByMaxVertSpeed)
+		{
+			// Remove candidate, it is now part of a started event
+			StableCandidates.Add(Candidate);
+			SupportedByCandidates.RemoveAtSwap(Idx, 1, false);
+		}
+	}
+
+	for (const auto& Candidate : StableCandidates)
+	{
+		Candidate.Monitor->BeginSupportedByEvent(Candidate.Result, CurrTime);
+	}
+}
+
+// Execute the delayed calls which are due
+void USLMonitorScheduler::UpdateDelayedCalls(float CurrTime)
+{
+	const int64 CurrTick = GetWheelTick(CurrTime);
+	if (LastWheelTick < 0)
+	{
+		LastWheelTick = CurrTick - 1;
+	}
+
+	// After a long hitch visiting every slot once is enough
+	const int64 FirstTick = FMath::Max(LastWheelTick + 1, CurrTick - NumWheelSlots + 1);
+	TArray<FDelayedCall> DueCalls;
+	for (int64 Tick = FirstTick; Tick <= CurrTick; ++Tick)
+	{
+		TArray<FDelayedCall>& Slot = WheelSlots[Tick % NumWheelSlots];
+		for (int32 Idx = Slot.Num() - 1; Idx >= 0; --Idx)
+		{
+			if (!ActiveCallIds.Contains(Slot[Idx].Id))
+			{
+				// Cleared call
+				Slot.RemoveAtSwap(Idx, 1, false);
+			}
+			else if (Slot[Idx].DueTime <= CurrTime)
+			{
+				DueCalls.Add(MoveTemp(Slot[Idx]));
+				Slot.RemoveAtSwap(Idx, 1, false);
+			}
+			// else due in a later revolution of the wheel
+		}
+	}
+	// Keep the current slot open, calls added later in this frame can still be due within it
+	LastWheelTick = CurrTick - 1;
+
+	// Execute in the scheduled order, a call can set or clear other calls
+	DueCalls.Sort([](const FDelayedCall& A, const FDelayedCall& B) { return A.Id < B.Id; });
+	for (auto& Call : DueCalls)
+	{
+		if (ActiveCallIds.Remove(Call.Id) > 0)
+		{
+			Call.Delegate.ExecuteIfBound();
+		}
+	}
+}
@@ -115,7 +115,7 @@ void FSLOwlExperimentStatics::WriteToFile(TSharedPtr<FSLOwlExperiment> Experimen
 		FPaths::RemoveDuplicateSlashes(FullFilePath);
 		if (!FPaths::FileExists(FullFilePath) || bOverwrite)
 		{
-			FFileHelper::SaveStringToFile(Experiment->ToString(), *FullFilePath);
+			FSLOwlWriter::WriteToFile(*Experiment, FullFilePath);
 		}
 	}
 }
@@ -88,7 +88,7 @@ bool FSLOwlOntologyDocUtils::PrintDoc(const FSLOwlDoc& InDoc, const FString& Pat
         return false;
     }
 
-    return FFileHelper::SaveStringToFile(InDoc.ToString(), *FullPath);
+    return FSLOwlWriter::WriteToFile(InDoc, FullPath);
 }
 
 // Create a semantic map document template
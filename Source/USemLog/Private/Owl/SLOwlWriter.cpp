@@ -0,0 +1,253 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "Owl/SLOwlWriter.h"
+#include "Owl/SLOwlDoc.h"
+#include "HAL/FileManager.h"
+
+// Append the output to the string
+FSLOwlWriter::FSLOwlWriter(FString& InOutString, const FString& InIndent) :
+	Indent(InIndent),
+	OutString(&InOutString),
+	OutArchive(nullptr),
+	BlockSize(0),
+	NumWritten(0)
+{
+}
+
+// Stream the output as utf-8 to the archive
+FSLOwlWriter::FSLOwlWriter(FArchive& InOutArchive, int32 InBlockSize) :
+	OutString(nullptr),
+	OutArchive(&InOutArchive),
+	BlockSize(FMath::Max(InBlockSize, 1024)),
+	NumWritten(0)
+{
+	Buffer.Reserve(BlockSize + 1024);
+}
+
+// Dtor
+FSLOwlWriter::~FSLOwlWriter()
+{
+	Flush();
+}
+
+// Write the document, same output as the root node holding all the doc nodes, without copying them into it
+void FSLOwlWriter::WriteDoc(const FSLOwlDoc& Doc)
+{
+	WriteDocBegin(Doc);
+	WriteDocEnd();
+}
+
+// Write the document up to and including its individuals
+void FSLOwlWriter::WriteDocBegin(const FSLOwlDoc& Doc)
+{
+	Write(TEXT("<?xml version=\"1.0\" encoding=\"utf-8\"?>\n\n"));
+	Write(Doc.EntityDefinitions.ToString());
+
+	// The root always has children (the ontology imports node)
+	WriteStartTag(FSLOwlPrefixName("rdf", "RDF"), Doc.Namespaces);
+	Write(TEXT(">\n"));
+	Indent += INDENT_STEP;
+	WriteNode(Doc.OntologyImports);
+	for (const auto& Node : Doc.PropertyDefinitions)
+	{
+		WriteNode(Node);
+	}
+	for (const auto& Node : Doc.DatatypeDefinitions)
+	{
+		WriteNode(Node);
+	}
+	for (const auto& Node : Doc.ClassDefinitions)
+	{
+		WriteNode(Node);
+	}
+	for (const auto& Node : Doc.Individuals)
+	{
+		WriteNode(Node);
+	}
+}
+
+// Close the document root
+void FSLOwlWriter::WriteDocEnd()
+{
+	Indent.RemoveFromEnd(INDENT_STEP);
+	Write(Indent);
+	Write(TEXT("</rdf:RDF>\n"));
+}
+
+// Write the node and its children
+void FSLOwlWriter::WriteNode(const FSLOwlNode& Node)
+{
+	// Add comment
+	if (!Node.Comment.IsEmpty())
+	{
+		Write(TEXT("\n"));
+		Write(Indent);
+		Write(TEXT("<!-- "));
+		Write(Node.Comment);
+		Write(TEXT(" -->\n"));
+	}
+
+	// Comment only OR empty node
+	if (Node.Name.IsEmpty())
+	{
+		return;
+	}
+
+	WriteStartTag(Node.Name, Node.Attributes);
+
+	// Node cannot have value and children
+	if (Node.ChildNodes.Num() == 0 && Node.Value.IsEmpty())
+	{
+		Write(TEXT("/>\n"));
+	}
+	else if (!Node.Value.IsEmpty())
+	{
+		Write(TEXT(">"));
+		Write(Node.Value);
+		Write(TEXT("</"));
+		WritePrefixName(Node.Name);
+		Write(TEXT(">\n"));
+	}
+	else
+	{
+		Write(TEXT(">\n"));
+		Indent += INDENT_STEP;
+		for (const auto& ChildNode : Node.ChildNodes)
+		{
+			WriteNode(ChildNode);
+		}
+		Indent.RemoveFromEnd(INDENT_STEP);
+		Write(Indent);
+		Write(TEXT("</"));
+		WritePrefixName(Node.Name);
+		Write(TEXT(">\n"));
+	}
+}
+
+// Write the buffered data to the archive
+void FSLOwlWriter::Flush()
+{
+	if (OutArchive && Buffer.Num() > 0)
+	{
+		OutArchive->Serialize(Buffer.GetData(), Buffer.Num());
+		NumWritten += Buffer.Num();
+		Buffer.Reset();
+	}
+}
+
+// Stream the document to the file as utf-8
+bool FSLOwlWriter::WriteToFile(const FSLOwlDoc& Doc, const FString& Path)
+{
+	const double ExecBegin = FPlatformTime::Seconds();
+	TUniquePtr<FArchive> Ar(IFileManager::Get().CreateFileWriter(*Path));
+	if (!Ar)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not create %s.."), *FString(__FUNCTION__), __LINE__, *Path);
+		return false;
+	}
+
+	int64 NumBytes = 0;
+	{
+		FSLOwlWriter Writer(*Ar);
+		Writer.WriteDoc(Doc);
+		Writer.Flush();
+		NumBytes = Writer.GetNumWritten();
+	}
+	const bool bWritten = !Ar->IsError() && Ar->Close();
+	if (!bWritten)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not write %s.."), *FString(__FUNCTION__), __LINE__, *Path);
+		return false;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("%s::%d Wrote %s (%d individuals, %.2f MB) in [%f] seconds..;"),
+		*FString(__FUNCTION__), __LINE__, *Path, Doc.Individuals.Num(),
+		NumBytes / (1024.f * 1024.f), FPlatformTime::Seconds() - ExecBegin);
+	return true;
+}
+
+// Write the tag name and its attributes (without closing the tag)
+void FSLOwlWriter::WriteStartTag(const FSLOwlPrefixName& Name, const TArray<FSLOwlAttribute>& Attributes)
+{
+	Write(Indent);
+	Write(TEXT("<"));
+	WritePrefixName(Name);
+	for (int32 Idx = 0; Idx < Attributes.Num(); ++Idx)
+	{
+		Write(TEXT(" "));
+		WriteAttribute(Attributes[Idx]);
+
+		// Multiple attributes are written on separate lines, last attribute does not have new line
+		if (Idx < Attributes.Num() - 1)
+		{
+			Write(TEXT("\n"));
+			Write(Indent);
+			Write(INDENT_STEP);
+		}
+	}
+}
+
+// Write prefixed name (e.g. "rdf:about")
+void FSLOwlWriter::WritePrefixName(const FSLOwlPrefixName& Name)
+{
+	Write(Name.Prefix);
+	if (!Name.LocalName.IsEmpty())
+	{
+		Write(TEXT(":"));
+		Write(Name.LocalName);
+	}
+}
+
+// Write attribute (e.g. rdf:about="&log;abc")
+void FSLOwlWriter::WriteAttribute(const FSLOwlAttribute& Attribute)
+{
+	WritePrefixName(Attribute.Key);
+	if (Attribute.Value.Ns.IsEmpty())
+	{
+		Write(TEXT("=\""));
+	}
+	else
+	{
+		Write(TEXT("=\"&"));
+		Write(Attribute.Value.Ns);
+		Write(TEXT(";"));
+	}
+	Write(Attribute.Value.LocalValue);
+	Write(TEXT("\""));
+}
+
+// Write the chars
+void FSLOwlWriter::Write(const TCHAR* Chars, int32 Len)
+{
+	if (Len <= 0)
+	{
+		return;
+	}
+
+	if (OutString)
+	{
+		OutString->AppendChars(Chars, Len);
+		NumWritten += Len;
+		return;
+	}
+
+	// Ascii chars are copied directly, the rest of the string is converted if any other char is found
+	const int32 Start = Buffer.AddUninitialized(Len);
+	for (int32 Idx = 0; Idx < Len; ++Idx)
+	{
+		if (Chars[Idx] >= 0x80)
+		{
+			Buffer.SetNum(Start + Idx, false);
+			FTCHARToUTF8 Utf8Chars(Chars + Idx, Len - Idx);
+			Buffer.Append(reinterpret_cast<const ANSICHAR*>(Utf8Chars.Get()), Utf8Chars.Length());
+			break;
+		}
+		Buffer[Start + Idx] = static_cast<ANSICHAR>(Chars[Idx]);
+	}
+
+	if (Buffer.Num() >= BlockSize)
+	{
+		Flush();
+	}
+}
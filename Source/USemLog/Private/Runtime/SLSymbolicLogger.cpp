@@ -22,6 +22,7 @@
 #include "Events/SLReachAndPreGraspEventHandler.h"
 #include "Events/SLPickAndPlaceEventsHandler.h"
 #include "Events/SLContainerEventHandler.h"
+#include "Events/SLOfflineEventDetector.h"
 
 #include "Monitors/SLContactMonitorInterface.h"
 #include "Monitors/SLManipulatorMonitor.h"
@@ -30,6 +31,8 @@
 #include "Monitors/SLContainerMonitor.h"
 
 #include "Owl/SLOwlExperimentStatics.h"
+#include "Owl/SLOwlWriter.h"
+#include "HAL/FileManager.h"
 
 #if SL_WITH_MC_GRASP
 #include "Events/SLFixationGraspEventHandler.h"
@@ -202,8 +205,25 @@ void ASLSymbolicLogger::InitImpl()
 	// Create the document template
 	ExperimentDoc = CreateEventsDocTemplate(ESLOwlExperimentTemplate::Default, LocationParameters.EpisodeId);
 
-	// Setup monitors
-	if (LoggerParameters.EventsSelection.bSelectAll)
+	// Finished events are appended to the journal instead of being kept in memory
+	if (LoggerParameters.bJournalEvents)
+	{
+		const FString JournalPath = FPaths::ProjectDir() + "/SL/Tasks/" + LocationParameters.TaskId + "/" + LocationParameters.EpisodeId + TEXT("_ED.journal");
+		EventJournal = MakeShareable(new FSLEventJournal());
+		if (!EventJournal->Open(JournalPath, LoggerParameters.JournalFlushInterval))
+		{
+			UE_LOG(LogTemp, Error, TEXT("%s::%d Could not open the events journal, the events will be kept in memory.."),
+				*FString(__FUNCTION__), __LINE__);
+			EventJournal.Reset();
+		}
+	}
+
+	// Setup monitors, or replay the logged world state instead
+	if (LoggerParameters.OfflineParams.bDetectFromWorldState)
+	{
+		InitOfflineEventDetector();
+	}
+	else if (LoggerParameters.EventsSelection.bSelectAll)
 	{
 		InitContactMonitors();
 		InitReachAndPreGraspMonitors();
@@ -329,6 +349,13 @@ void ASLSymbolicLogger::StartImpl()
 	EpisodeStartTime = GetWorld()->GetTimeSeconds();
 
 	bIsStarted = true;
+
+	// Replay the logged world state (the events are published through the handlers)
+	if (OfflineDetector.IsValid())
+	{
+		GetWorld()->GetTimerManager().SetTimerForNextTick(this, &ASLSymbolicLogger::ReplayOfflineFrames);
+	}
+
 	UE_LOG(LogTemp, Warning, TEXT("%s::%d Symbolic logger (%s) succesfully started at %.2f.."),
 		*FString(__FUNCTION__), __LINE__, *GetName(), GetWorld()->GetTimeSeconds());
 }
@@ -360,12 +387,20 @@ void ASLSymbolicLogger::FinishImpl(bool bForced)
 		return;
 	}
 
+	// The episode times of the replay are the ones of the logged frames
+	if (OfflineDetector.IsValid() && OfflineDetector->GetLastFrameTime() >= 0.f)
+	{
+		EpisodeStartTime = OfflineDetector->GetFirstFrameTime();
+		EpisodeEndTime = OfflineDetector->GetLastFrameTime();
+	}
+
 	// Finish handlers pending events
 	for (auto& EvHandler : EventHandlers)
 	{
 		EvHandler->Finish(EpisodeEndTime, bForced);
 	}
 	EventHandlers.Empty();
+	OfflineDetector.Reset();
 
 	// Finish semantic overlap events publishing
 	for (auto& SLContactMonitor : ContactMonitors)
@@ -402,8 +437,13 @@ void ASLSymbolicLogger::FinishImpl(bool bForced)
 	//}
 	//ContainerMonitors.Empty();
 
+	// Write the remaining journaled events, the experiment owl doc is created while streaming the journal
+	if (EventJournal.IsValid())
+	{
+		EventJournal->Close();
+	}
 	// Create the experiment owl doc	
-	if (ExperimentDoc.IsValid())
+	else if (ExperimentDoc.IsValid())
 	{
 		TArray<FString> SubActionIds;		
 		for (const auto& Ev : FinishedEvents)
@@ -473,7 +513,34 @@ void ASLSymbolicLogger::SemanticEventFinishedCallback(TSharedPtr<ISLEvent> Event
 {
 	//GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Yellow, FString::Printf(TEXT("%s::%d %s"), *FString(__func__), __LINE__, *Event->ToString()));
 	//UE_LOG(LogTemp, Error, TEXT(">> %s::%d %s"), *FString(__func__), __LINE__, *Event->ToString());
-	FinishedEvents.Add(Event);
+	if (EventJournal.IsValid() && ExperimentDoc.IsValid())
+	{
+		// Register the event timepoints and objects in the doc, and take out its owl individuals
+		const int32 NumIndividuals = ExperimentDoc->Individuals.Num();
+		Event->AddToOwlDoc(ExperimentDoc.Get());
+		TArray<FSLOwlNode> OwlNodes;
+		for (int32 Idx = NumIndividuals; Idx < ExperimentDoc->Individuals.Num(); ++Idx)
+		{
+			OwlNodes.Emplace(MoveTemp(ExperimentDoc->Individuals[Idx]));
+		}
+		ExperimentDoc->Individuals.SetNum(NumIndividuals, false);
+
+		FSLEventJournalRecord Record;
+		Record.Id = Event->Id;
+		Record.StartTime = Event->StartTime;
+		Record.EndTime = Event->EndTime;
+		if (LoggerParameters.bWriteTimelines && FSLGoogleCharts::ShouldEventBeWritten(Event, LoggerParameters.TimelineEventsSelection))
+		{
+			Record.bInTimeline = true;
+			Record.Context = Event->Context();
+			Record.Tooltip = Event->Tooltip();
+		}
+		EventJournal->Append(MoveTemp(Record), MoveTemp(OwlNodes));
+	}
+	else
+	{
+		FinishedEvents.Add(Event);
+	}
 
 #if SL_WITH_ROSBRIDGE
 	if (LoggerParameters.bPublishToROS)
@@ -488,6 +555,12 @@ void ASLSymbolicLogger::WriteToFile()
 {
 	const FString DirPath = FPaths::ProjectDir() + "/SL/Tasks/" + LocationParameters.TaskId /*+ TEXT("/Episodes/")*/ + "/";
 
+	if (EventJournal.IsValid())
+	{
+		WriteToFileFromJournal(DirPath);
+		return;
+	}
+
 	// Write events timelines to file
 	if (LoggerParameters.bWriteTimelines)
 	{
@@ -519,6 +592,99 @@ void ASLSymbolicLogger::WriteToFile()
 	//}
 }
 
+// Write the owl and timeline outputs by streaming the events journal
+void ASLSymbolicLogger::WriteToFileFromJournal(const FString& DirPath)
+{
+	const double ExecBegin = FPlatformTime::Seconds();
+	const FString JournalPath = EventJournal->GetPath();
+
+	// Write events timelines to file
+	if (LoggerParameters.bWriteTimelines)
+	{
+		FSLGoogleChartsParameters Params;
+		Params.bTooltips = true;
+		Params.StartTime = EpisodeStartTime;
+		Params.EndTime = EpisodeEndTime;
+		Params.TaskId = LocationParameters.TaskId;
+		Params.EpisodeId = LocationParameters.EpisodeId;
+
+		FString FullFilePath = DirPath + LocationParameters.EpisodeId + TEXT("_TL.html");
+		FPaths::RemoveDuplicateSlashes(FullFilePath);
+		if (!FPaths::FileExists(FullFilePath) || LocationParameters.bOverwrite)
+		{
+			if (TUniquePtr<FArchive> Ar = TUniquePtr<FArchive>(IFileManager::Get().CreateFileWriter(*FullFilePath)))
+			{
+				FString TimelineStr = FSLGoogleCharts::GetTimelineHeader(Params);
+				FSLEventJournal::ForEachRecord(JournalPath, [&](FSLEventJournalRecord& Record)
+				{
+					if (Record.bInTimeline)
+					{
+						TimelineStr.Append(FSLGoogleCharts::GetTimelineRow(Record.Context, Record.Id,
+							Record.StartTime, Record.EndTime, Record.Tooltip, Params));
+					}
+
+					// Write in blocks
+					if (TimelineStr.Len() > 1024 * 1024)
+					{
+						FTCHARToUTF8 Utf8Str(*TimelineStr, TimelineStr.Len());
+						Ar->Serialize(const_cast<ANSICHAR*>(Utf8Str.Get()), Utf8Str.Length());
+						TimelineStr.Reset();
+					}
+				});
+				TimelineStr.Append(FSLGoogleCharts::GetTimelineFooter(Params));
+				FTCHARToUTF8 Utf8Str(*TimelineStr, TimelineStr.Len());
+				Ar->Serialize(const_cast<ANSICHAR*>(Utf8Str.Get()), Utf8Str.Length());
+				Ar->Close();
+			}
+		}
+	}
+
+	// Write experiment owl to file, the event individuals are streamed from the journal
+	bool bOwlWritten = false;
+	if (ExperimentDoc.IsValid())
+	{
+		FString FullFilePath = DirPath + "/" + ExperimentDoc->Id + TEXT("_ED.owl");
+		FPaths::RemoveDuplicateSlashes(FullFilePath);
+		if (!FPaths::FileExists(FullFilePath) || LocationParameters.bOverwrite)
+		{
+			if (TUniquePtr<FArchive> Ar = TUniquePtr<FArchive>(IFileManager::Get().CreateFileWriter(*FullFilePath)))
+			{
+				FSLOwlWriter Writer(*Ar);
+				Writer.WriteDocBegin(*ExperimentDoc);
+
+				TArray<FString> SubActionIds;
+				FSLEventJournal::ForEachRecord(JournalPath, [&](FSLEventJournalRecord& Record)
+				{
+					Writer.WriteRaw(Record.OwlStr);
+					SubActionIds.Add(Record.Id);
+				});
+
+				// Add stored unique timepoints and the experiment individual (metadata) after the events
+				const int32 NumIndividuals = ExperimentDoc->Individuals.Num();
+				ExperimentDoc->AddTimepointIndividuals();
+				ExperimentDoc->AddExperimentIndividual(SubActionIds, LocationParameters.SemanticMapId, LocationParameters.TaskId);
+				for (int32 Idx = NumIndividuals; Idx < ExperimentDoc->Individuals.Num(); ++Idx)
+				{
+					Writer.WriteNode(ExperimentDoc->Individuals[Idx]);
+				}
+				Writer.WriteDocEnd();
+				Writer.Flush();
+				bOwlWritten = !Ar->IsError() && Ar->Close();
+			}
+		}
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("%s::%d Wrote %d journaled events in [%f] seconds..;"),
+		*FString(__FUNCTION__), __LINE__, EventJournal->Num(), FPlatformTime::Seconds() - ExecBegin);
+
+	// The journal is only needed to recover the events if the outputs could not be written
+	if (bOwlWritten)
+	{
+		IFileManager::Get().Delete(*JournalPath);
+	}
+	EventJournal.Reset();
+}
+
 // Create events doc template
 TSharedPtr<FSLOwlExperiment> ASLSymbolicLogger::CreateEventsDocTemplate(ESLOwlExperimentTemplate TemplateType, const FString& InDocId)
 {
@@ -829,6 +995,66 @@ void ASLSymbolicLogger::InitSlicingMonitors()
 #endif // SL_WITH_SLICING
 }
 
+// Init the detector replaying the logged world state instead of the live monitors
+void ASLSymbolicLogger::InitOfflineEventDetector()
+{
+	// The task and episode ids point to the logged world state
+	if (!LocationParameters.bUseCustomTaskId || !LocationParameters.bUseCustomEpisodeId)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Offline detection requires the custom task and episode ids of the logged world state.."),
+			*FString(__FUNCTION__), __LINE__);
+		return;
+	}
+
+	if (!LoggerParameters.EventsSelection.bSelectAll && !LoggerParameters.EventsSelection.bContact)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d Offline detection only supports contact and supported by events, none selected.."),
+			*FString(__FUNCTION__), __LINE__);
+		return;
+	}
+
+	// The manipulator (contact, grasp, reach), pick-and-place and container events are not re-detected offline
+	const FLSymbolicEventsSelection& Selection = LoggerParameters.EventsSelection;
+	if (Selection.bSelectAll || Selection.bManipulatorContact || Selection.bGrasp || Selection.bReachAndPreGrasp || Selection.bPickAndPlace)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d Offline detection only re-detects the contact and supported by events, the selected manipulator, reach, grasp, pick-and-place and container events will not be logged.."),
+			*FString(__FUNCTION__), __LINE__);
+	}
+
+	const bool bDetectSupportedBy = LoggerParameters.EventsSelection.bSelectAll || LoggerParameters.EventsSelection.bSupportedBy;
+	OfflineDetector = MakeShareable(new FSLOfflineEventDetector(LoggerParameters.OfflineParams, bDetectSupportedBy));
+	OfflineDetector->TaskId = LocationParameters.TaskId;
+	OfflineDetector->EpisodeId = LocationParameters.EpisodeId;
+	OfflineDetector->Init(IndividualManager);
+	if (OfflineDetector->IsInit())
+	{
+		EventHandlers.Emplace(OfflineDetector);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Offline event detector could not be init.."), *FString(__FUNCTION__), __LINE__);
+		OfflineDetector.Reset();
+	}
+}
+
+// Replay the streamed world state frames, finishes the logger at the end of the episode
+void ASLSymbolicLogger::ReplayOfflineFrames()
+{
+	if (!bIsStarted || !OfflineDetector.IsValid())
+	{
+		return;
+	}
+
+	if (OfflineDetector->ReplayQueuedFrames(LoggerParameters.OfflineParams.FrameBudgetMs))
+	{
+		GetWorld()->GetTimerManager().SetTimerForNextTick(this, &ASLSymbolicLogger::ReplayOfflineFrames);
+	}
+	else
+	{
+		FinishImpl();
+	}
+}
+
 // Publish data through ROS
 void ASLSymbolicLogger::InitROSPublisher()
 {
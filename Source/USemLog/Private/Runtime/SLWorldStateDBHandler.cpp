@@ -9,6 +9,9 @@
 #include "Individuals/Type/SLBoneIndividual.h"
 #include "Individuals/Type/SLVirtualBoneIndividual.h"
 #include "Individuals/Type/SLRobotIndividual.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "Utils/SLPoseCodec.h"
 
 // UUtils
 #if SL_WITH_ROS_CONVERSIONS
@@ -16,19 +19,128 @@
 #endif // SL_WITH_ROS_CONVERSIONS
 
 /* DB Write Async Task */
+// Ctor
+FSLWorldStateDBWriterAsyncTask::FSLWorldStateDBWriterAsyncTask()
+{
+	IndividualManager = nullptr;
+	Layout = nullptr;
+	FrameQueue = nullptr;
+	BatchSize = 1;
+	BatchMaxDelay = 0.0;
+	BatchStartTime = 0.0;
+	NumFlushes = 0;
+	NumFlushedDocs = 0;
+	TotalFlushSeconds = 0.0;
+	MaxFlushSeconds = 0.0;
+#if SL_WITH_LIBMONGO_C
+	mongo_collection = nullptr;
+	write_opts = nullptr;
+	bulk_opts = nullptr;
+	trj_collection = nullptr;
+#endif //SL_WITH_LIBMONGO_C
+	TrajectoryBucketDuration = 10.f;
+	PoseEncoding = ESLWorldStatePoseEncoding::Default;
+	PositionResolution = 0.0001f;
+	bWriteSparseBones = false;
+	bWriteLocalBonePoses = false;
+	BoneKeyFrameInterval = 1.f;
+	PoseTolerance = 0.1f;
+}
+
+// Dtor
+FSLWorldStateDBWriterAsyncTask::~FSLWorldStateDBWriterAsyncTask()
+{
+#if SL_WITH_LIBMONGO_C
+	if (batch_docs.Num() > 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d %d batched world state documents were not uploaded.."),
+			*FString(__FUNCTION__), __LINE__, batch_docs.Num());
+		for (bson_t* doc : batch_docs)
+		{
+			bson_destroy(doc);
+		}
+		batch_docs.Empty();
+	}
+	if (write_opts)
+	{
+		bson_destroy(write_opts);
+		write_opts = nullptr;
+	}
+	if (bulk_opts)
+	{
+		bson_destroy(bulk_opts);
+		bulk_opts = nullptr;
+	}
+#endif //SL_WITH_LIBMONGO_C
+}
+
 // Init task
 #if SL_WITH_LIBMONGO_C
-bool FSLWorldStateDBWriterAsyncTask::Init(mongoc_collection_t* in_collection, ASLIndividualManager* Manager, float PoseTolerance, bool bInWriteSparse)
+bool FSLWorldStateDBWriterAsyncTask::Init(mongoc_collection_t* in_collection, mongoc_collection_t* in_trj_collection, ASLIndividualManager* Manager,
+	const FSLWorldStateLayout* InLayout, FSLWorldStateFrameQueue* InFrameQueue,
+	const FSLWorldStateLoggerParams& InLoggerParameters)
 {
 	IndividualManager = Manager;
+	Layout = InLayout;
 	mongo_collection = in_collection;
-	MinPoseDiff = PoseTolerance;
-	bWriteSparse = bInWriteSparse;
+	trj_collection = in_trj_collection;
+	TrajectoryBucketDuration = InLoggerParameters.TrajectoryBucketDuration;
+	PoseEncoding = InLoggerParameters.PoseEncoding;
+	PositionResolution = InLoggerParameters.PositionResolution;
+	if (trj_collection)
+	{
+		TrajectoryBuckets.SetNum(Layout->IndividualIds.Num());
+	}
 
-	// Set the write function pointer (first write is without optimization, write all individuals)
-	WriteFunctionPtr = &FSLWorldStateDBWriterAsyncTask::FirstWrite;
+	// Sparse bones are only written in the sparse mode, the first frame of every skeletal individual is a key frame
+	bWriteSparseBones = InLoggerParameters.bWriteSparse && InLoggerParameters.bWriteSparseBones;
+	bWriteLocalBonePoses = InLoggerParameters.bWriteLocalBonePoses;
+	BoneKeyFrameInterval = InLoggerParameters.BoneKeyFrameInterval;
+	PoseTolerance = InLoggerParameters.PoseTolerance;
+	LastSkelPoses.Init(FTransform::Identity, Layout->SkelIds.Num());
+	LastBoneKeyFrameTimes.Init(-1.f, Layout->SkelIds.Num());
+	LastLocalBonePoses.Init(FTransform::Identity, Layout->BoneIndexes.Num());
+	FrameQueue = InFrameQueue;
+	BatchSize = FMath::Max(InLoggerParameters.BatchSize, 1);
+	BatchMaxDelay = InLoggerParameters.BatchMaxDelay;
+	batch_docs.Reserve(BatchSize);
+
+	// Insert options with the requested acknowledgment, bulk inserts are unordered
+	mongoc_write_concern_t* write_concern = mongoc_write_concern_new();
+	if (InLoggerParameters.WriteConcern == ESLWorldStateWriteConcern::Unacknowledged)
+	{
+		mongoc_write_concern_set_w(write_concern, MONGOC_WRITE_CONCERN_W_UNACKNOWLEDGED);
+	}
+	else if (InLoggerParameters.WriteConcern == ESLWorldStateWriteConcern::Acknowledged)
+	{
+		mongoc_write_concern_set_w(write_concern, 1);
+	}
+	else if (InLoggerParameters.WriteConcern == ESLWorldStateWriteConcern::Journaled)
+	{
+		mongoc_write_concern_set_w(write_concern, 1);
+		mongoc_write_concern_set_journal(write_concern, true);
+	}
 
-	return true;
+	if (write_opts)
+	{
+		bson_destroy(write_opts);
+	}
+	if (bulk_opts)
+	{
+		bson_destroy(bulk_opts);
+	}
+	write_opts = bson_new();
+	bulk_opts = bson_new();
+	BSON_APPEND_BOOL(bulk_opts, "ordered", false);
+	const bool bRetVal = mongoc_write_concern_append(write_concern, write_opts)
+		&& mongoc_write_concern_append(write_concern, bulk_opts);
+	mongoc_write_concern_destroy(write_concern);
+	if (!bRetVal)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not set the world state write concern.."),
+			*FString(__FUNCTION__), __LINE__);
+	}
+	return bRetVal;
 }
 #endif //SL_WITH_LIBMONGO_C	
 
@@ -37,16 +149,45 @@ void FSLWorldStateDBWriterAsyncTask::DoWork()
 {
 	const double StartTime = FPlatformTime::Seconds();
 
-	// Call the write function pointer
-	int32 NumEntries = (this->*WriteFunctionPtr)();
+	int32 NumFrames = 0;
+	while (true)
+	{
+		// Write the queued frames in order
+		while (const FSLWorldStateFrame* Frame = FrameQueue->Peek())
+		{
+			WriteFrame(*Frame);
+			FrameQueue->Pop();
+			FrameQueue->CountWritten();
+			NumFrames++;
+		}
+
+		// Frames newer than the queued ones might have been spilled to disk
+		FString SpillFilePath;
+		if (FrameQueue->TakeSpill(SpillFilePath))
+		{
+			NumFrames += WriteSpilledFrames(SpillFilePath);
+		}
+		else
+		{
+			break;
+		}
+	}
+
+#if SL_WITH_LIBMONGO_C
+	// Do not keep documents waiting for longer than the max delay
+	if (IsBatchExpired())
+	{
+		FlushBatch();
+	}
+#endif //SL_WITH_LIBMONGO_C
 
 	//double Duration = FPlatformTime::Seconds() - StartTime;
-	//UE_LOG(LogTemp, Warning, TEXT("%s::%d \t\t\t Async work (written %ld entries) duration:\t%f (s)"),
-	//	*FString(__FUNCTION__), __LINE__, NumEntries, Duration);
+	//UE_LOG(LogTemp, Warning, TEXT("%s::%d \t\t\t Async work (written %ld frames) duration:\t%f (s)"),
+	//	*FString(__FUNCTION__), __LINE__, NumFrames, Duration);
 }
 
-// First write where all the individuals are written irregardresly of their previous position
-int32 FSLWorldStateDBWriterAsyncTask::FirstWrite()
+// Write the frame as a world state document
+int32 FSLWorldStateDBWriterAsyncTask::WriteFrame(const FSLWorldStateFrame& Frame)
 {
 	// Count the number of entries written to the document (if 0, skip upload)
 	int32 Num = 0;
@@ -55,15 +196,27 @@ int32 FSLWorldStateDBWriterAsyncTask::FirstWrite()
 	bson_t* ws_doc;
 	ws_doc = bson_new();
 
-	AddTimestamp(ws_doc);
+	AddTimestamp(Frame.Timestamp, ws_doc);
 
-	Num += AddAllIndividuals(ws_doc);
-	Num += AddSkeletalIndividals(ws_doc);
+	Num += AddIndividuals(Frame, ws_doc);
+	Num += AddSkeletalIndividals(Frame, ws_doc);
 	//Num += AddRobotIndividuals(ws_doc);
 
+	// Per individual trajectories
+	if (trj_collection)
+	{
+		AddToTrajectoryBuckets(Frame);
+	}
+
 	// Write only if there are any entries in the document
 	if (Num > 0)
 	{
+		if (BatchSize > 1)
+		{
+			// The batch takes ownership of the document
+			AddToBatch(ws_doc);
+			return Num;
+		}
 		UploadDoc(ws_doc);
 	}
 
@@ -71,99 +224,144 @@ int32 FSLWorldStateDBWriterAsyncTask::FirstWrite()
 	bson_destroy(ws_doc);
 #endif //SL_WITH_LIBMONGO_C	
 
-	// Change the write function pointer to write only individuals that are moving
-	if (bWriteSparse)
+	return Num;
+}
+
+// Upload the batched documents
+int32 FSLWorldStateDBWriterAsyncTask::FlushBatch()
+{
+#if SL_WITH_LIBMONGO_C
+	const int32 NumDocs = batch_docs.Num();
+	if (NumDocs == 0)
 	{
-		WriteFunctionPtr = &FSLWorldStateDBWriterAsyncTask::WriteSparse;
+		return 0;
 	}
-	else
+
+	const double FlushStartTime = FPlatformTime::Seconds();
+	bson_error_t error;
+	mongoc_bulk_operation_t* bulk = mongoc_collection_create_bulk_operation_with_opts(mongo_collection, bulk_opts);
+	for (bson_t* doc : batch_docs)
 	{
-		WriteFunctionPtr = &FSLWorldStateDBWriterAsyncTask::WriteAll;
+		mongoc_bulk_operation_insert(bulk, doc);
 	}
+	
+	int32 NumUploaded = NumDocs;
+	if (!mongoc_bulk_operation_execute(bulk, NULL, &error))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Bulk insert of %d documents err.: %s"),
+			*FString(__func__), __LINE__, NumDocs, *FString(error.message));
+		NumUploaded = 0;
+	}
+	mongoc_bulk_operation_destroy(bulk);
 
-	return Num;
+	for (bson_t* doc : batch_docs)
+	{
+		bson_destroy(doc);
+	}
+	batch_docs.Reset();
+
+	const double FlushDuration = FPlatformTime::Seconds() - FlushStartTime;
+	NumFlushes++;
+	NumFlushedDocs += NumUploaded;
+	TotalFlushSeconds += FlushDuration;
+	MaxFlushSeconds = FMath::Max(MaxFlushSeconds, FlushDuration);
+	UE_LOG(LogTemp, Verbose, TEXT("%s::%d Flushed %d world state documents in %f (s) (%.1f docs/s).."),
+		*FString(__FUNCTION__), __LINE__, NumUploaded, FlushDuration, FlushDuration > 0.0 ? NumUploaded / FlushDuration : 0.0);
+	return NumUploaded;
+#else
+	return 0;
+#endif //SL_WITH_LIBMONGO_C
 }
 
-// Write only the indviduals that changed pose
-int32 FSLWorldStateDBWriterAsyncTask::WriteSparse()
+// Upload all the non-empty trajectory buckets
+void FSLWorldStateDBWriterAsyncTask::FlushTrajectoryBuckets()
 {
-	// Count the number of entries written to the document (if 0, skip upload)
-	int32 Num = 0;
-
 #if SL_WITH_LIBMONGO_C
-	bson_t* ws_doc;
-	ws_doc = bson_new();
-
-	AddTimestamp(ws_doc);
-
-	Num += AddIndividualsThatMoved(ws_doc);
-	Num += AddSkeletalIndividals(ws_doc);
-	//Num += AddRobotIndividuals(ws_doc);
-
-	// Write only if there are any entries in the document
-	if (Num > 0)
+	if (trj_collection)
 	{
-		UploadDoc(ws_doc);
+		for (int32 Idx = 0; Idx < TrajectoryBuckets.Num(); ++Idx)
+		{
+			if (TrajectoryBuckets[Idx].Num() > 0)
+			{
+				UploadTrajectoryBucket(Idx);
+			}
+		}
 	}
-
-	// Clean up
-	bson_destroy(ws_doc);
 #endif //SL_WITH_LIBMONGO_C
-
-	return Num;
 }
 
-// Write all individuals
-int32 FSLWorldStateDBWriterAsyncTask::WriteAll()
+// True if batched documents waited longer than the max delay (only call while the task is idle)
+bool FSLWorldStateDBWriterAsyncTask::IsBatchExpired() const
 {
-	// Count the number of entries written to the document (if 0, skip upload)
-	int32 Num = 0;
-
 #if SL_WITH_LIBMONGO_C
-	bson_t* ws_doc;
-	ws_doc = bson_new();
-
-	AddTimestamp(ws_doc);
+	return batch_docs.Num() > 0 && FPlatformTime::Seconds() - BatchStartTime >= BatchMaxDelay;
+#else
+	return false;
+#endif //SL_WITH_LIBMONGO_C
+}
 
-	Num += AddAllIndividuals(ws_doc);
-	Num += AddSkeletalIndividals(ws_doc);
-	//Num += AddRobotIndividuals(ws_doc);
+// Log the upload statistics
+void FSLWorldStateDBWriterAsyncTask::LogStats(const FString& Prefix) const
+{
+	if (NumFlushes > 0)
+	{
+		UE_LOG(LogTemp, Log, TEXT("%s flushes=%d; docs=%d; avg latency=%f (s); max latency=%f (s); throughput=%.1f docs/s;"),
+			*Prefix, NumFlushes, NumFlushedDocs, TotalFlushSeconds / NumFlushes, MaxFlushSeconds,
+			TotalFlushSeconds > 0.0 ? NumFlushedDocs / TotalFlushSeconds : 0.0);
+	}
+}
 
-	// Write only if there are any entries in the document
-	if (Num > 0)
+// Write the frames spilled to the given file, remove the file afterwards
+int32 FSLWorldStateDBWriterAsyncTask::WriteSpilledFrames(const FString& FilePath)
+{
+	int32 NumFrames = 0;
+	FArchive* Reader = IFileManager::Get().CreateFileReader(*FilePath);
+	if (Reader == nullptr)
 	{
-		UploadDoc(ws_doc);
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not read the spill file %s.."),
+			*FString(__FUNCTION__), __LINE__, *FilePath);
+		return 0;
 	}
 
-	// Clean up
-	bson_destroy(ws_doc);
-#endif //SL_WITH_LIBMONGO_C
+	FSLWorldStateFrame Frame;
+	while (!Reader->AtEnd() && !Reader->IsError())
+	{
+		*Reader << Frame;
+		if (Reader->IsError())
+		{
+			// Truncated or corrupt frame, the rest of the file cannot be trusted
+			UE_LOG(LogTemp, Error, TEXT("%s::%d Could not read frame %d of the spill file %s, the remaining frames are dropped.."),
+				*FString(__FUNCTION__), __LINE__, NumFrames, *FilePath);
+			break;
+		}
+		WriteFrame(Frame);
+		FrameQueue->CountWritten();
+		NumFrames++;
+	}
+	Reader->Close();
+	delete Reader;
 
-	return Num;
+	IFileManager::Get().Delete(*FilePath);
+	return NumFrames;
 }
 
 #if SL_WITH_LIBMONGO_C
 // Add timestamp to the bson doc
-void FSLWorldStateDBWriterAsyncTask::AddTimestamp(bson_t* doc)
+void FSLWorldStateDBWriterAsyncTask::AddTimestamp(float Timestamp, bson_t* doc)
 {
 	BSON_APPEND_DOUBLE(doc, "timestamp", Timestamp);
 }
 
-// Add all individuals (return the number of individuals added)
-int32 FSLWorldStateDBWriterAsyncTask::AddAllIndividuals(bson_t* doc)
+// Add the individuals of the frame (return the number of individuals added)
+int32 FSLWorldStateDBWriterAsyncTask::AddIndividuals(const FSLWorldStateFrame& Frame, bson_t* doc)
 {
 	int32 Num = 0;
 	bson_t arr_obj;
 	uint32_t arr_idx = 0;
 
 	BSON_APPEND_ARRAY_BEGIN(doc, "individuals", &arr_obj);
-	for (const auto& Individual : IndividualManager->GetIndividuals())
+	for (int32 FrameIdx = 0; FrameIdx < Frame.IndividualIndexes.Num(); ++FrameIdx)
 	{
-		Individual->UpdateCachedPose(0.0);
-
-		//// TODO workaround
-		//Individual->SetHasMovedFlag(true);
-
 		bson_t individual_obj;
 		char idx_str[16];
 		const char* idx_key;
@@ -171,9 +369,9 @@ int32 FSLWorldStateDBWriterAsyncTask::AddAllIndividuals(bson_t* doc)
 		bson_uint32_to_string(arr_idx, &idx_key, idx_str, sizeof idx_str);
 		BSON_APPEND_DOCUMENT_BEGIN(&arr_obj, idx_key, &individual_obj);
 			// Id
-			BSON_APPEND_UTF8(&individual_obj, "id", TCHAR_TO_UTF8(*Individual->GetIdValue()));			
+			AddIndividualRef(Layout->GetIndividualId(Frame.IndividualIndexes[FrameIdx]), Frame.IndividualIndexes[FrameIdx], &individual_obj);
 			// Pose
-			AddPose(Individual->GetCachedPose(), &individual_obj);
+			AddPose(Frame.IndividualLocations[FrameIdx], Frame.IndividualRotations[FrameIdx], &individual_obj);
 		bson_append_document_end(&arr_obj, &individual_obj);
 
 		arr_idx++;
@@ -183,87 +381,88 @@ int32 FSLWorldStateDBWriterAsyncTask::AddAllIndividuals(bson_t* doc)
 	return Num;
 }
 
-// Add only the individuals that moved (return the number of individuals added)
-int32 FSLWorldStateDBWriterAsyncTask::AddIndividualsThatMoved(bson_t* doc)
+// Add skeletal individuals of the frame (return the number of individuals added)
+int32 FSLWorldStateDBWriterAsyncTask::AddSkeletalIndividals(const FSLWorldStateFrame& Frame, bson_t* doc)
 {
 	int32 Num = 0;
-
-	bson_t individuals_arr;
+	bson_t arr_obj;
 	uint32_t arr_idx = 0;
 
-	BSON_APPEND_ARRAY_BEGIN(doc, "individuals", &individuals_arr);
-	for (const auto& Individual : IndividualManager->GetIndividuals())
-	{
-		if (Individual->UpdateCachedPose(MinPoseDiff))
-		{
-			//// TODO workaround
-			//Individual->SetHasMovedFlag(true);
+	// Offset of the current skeletal individual in the flattened bones array
+	int32 BoneOffset = 0;
 
-			bson_t individual_obj;
-			char idx_str[16];
-			const char* idx_key;
-
-			bson_uint32_to_string(arr_idx, &idx_key, idx_str, sizeof idx_str);
-			BSON_APPEND_DOCUMENT_BEGIN(&individuals_arr, idx_key, &individual_obj);
-				// Id
-				BSON_APPEND_UTF8(&individual_obj, "id", TCHAR_TO_UTF8(*Individual->GetIdValue()));
-				// Pose
-				AddPose(Individual->GetCachedPose(), &individual_obj);
-			bson_append_document_end(&individuals_arr, &individual_obj);
+	BSON_APPEND_ARRAY_BEGIN(doc, "skel_individuals", &arr_obj);
+	for (int32 SkelIdx = 0; SkelIdx < Frame.SkelLocations.Num(); ++SkelIdx)
+	{
+		const int32 BoneNum = Layout->SkelBoneNums[SkelIdx];
+		const FTransform SkelPose(Frame.SkelRotations[SkelIdx], Frame.SkelLocations[SkelIdx]);
 
-			arr_idx++;
-			Num++;
+		// All the bones are written in the dense mode and at the key frames
+		bool bKeyFrame = true;
+		if (bWriteSparseBones)
+		{
+			bKeyFrame = LastBoneKeyFrameTimes[SkelIdx] < 0.f
+				|| Frame.Timestamp - LastBoneKeyFrameTimes[SkelIdx] >= BoneKeyFrameInterval;
 		}
-	}
-	bson_append_array_end(doc, &individuals_arr);
-	return Num;
-}
 
-// Add skeletal individuals (return the number of individuals added)
-int32 FSLWorldStateDBWriterAsyncTask::AddSkeletalIndividals(bson_t* doc)
-{
-	int32 Num = 0;
-	bson_t arr_obj;
-	uint32_t arr_idx = 0;
+		// Select the bones to write, the local poses are compared with their last written value
+		BoneIdxsToWrite.Reset();
+		for (int32 BoneIdx = BoneOffset; BoneIdx < BoneOffset + BoneNum; ++BoneIdx)
+		{
+			if (bWriteLocalBonePoses)
+			{
+				const FTransform LocalPose = FTransform(Frame.BoneRotations[BoneIdx], Frame.BoneLocations[BoneIdx]).GetRelativeTransform(SkelPose);
+				if (bKeyFrame || !LastLocalBonePoses[BoneIdx].Equals(LocalPose, PoseTolerance))
+				{
+					LastLocalBonePoses[BoneIdx] = LocalPose;
+					BoneIdxsToWrite.Add(BoneIdx);
+				}
+			}
+			else if (bKeyFrame || Frame.MovedBones[BoneIdx])
+			{
+				BoneIdxsToWrite.Add(BoneIdx);
+			}
+		}
+		BoneOffset += BoneNum;
 
-	BSON_APPEND_ARRAY_BEGIN(doc, "skel_individuals", &arr_obj);
-	for (const auto& SkelIndividual : IndividualManager->GetSkeletalIndividuals())
-	{
-		//// Check if it was marked as "moved" by the previous iterator function
-		//if (SkelIndividual->HasMovedFlagSet())
-		//{
-		//	SkelIndividual->SetHasMovedFlag(false);
+		// Skip the idle skeletal individuals, their previous entry is still valid
+		if (!bKeyFrame && BoneIdxsToWrite.Num() == 0 && LastSkelPoses[SkelIdx].Equals(SkelPose, PoseTolerance))
+		{
+			continue;
+		}
+		LastSkelPoses[SkelIdx] = SkelPose;
 
-			bson_t individual_obj;
-			char idx_str[16];
-			const char* idx_key;
+		bson_t individual_obj;
+		char idx_str[16];
+		const char* idx_key;
 
-			bson_uint32_to_string(arr_idx, &idx_key, idx_str, sizeof idx_str);
-			BSON_APPEND_DOCUMENT_BEGIN(&arr_obj, idx_key, &individual_obj);
-				// Id
-				BSON_APPEND_UTF8(&individual_obj, "id", TCHAR_TO_UTF8(*SkelIndividual->GetIdValue()));
-				// Pose
-				AddPose(SkelIndividual->GetCachedPose(), &individual_obj);
-				// Bones
-				AddSkeletalBoneIndividuals(SkelIndividual->GetBoneIndividuals(), SkelIndividual->GetVirtualBoneIndividuals(),
-					&individual_obj);
-				// Constraints
-				//AddSkeletalConstraintIndividuals(SkelIndividual->GetBoneConstraintIndividuals(), &individual_obj);
-			bson_append_document_end(&arr_obj, &individual_obj);
+		bson_uint32_to_string(arr_idx, &idx_key, idx_str, sizeof idx_str);
+		BSON_APPEND_DOCUMENT_BEGIN(&arr_obj, idx_key, &individual_obj);
+			// Id
+			AddIndividualRef(Layout->GetSkelId(SkelIdx), SkelIdx, &individual_obj);
+			// Pose
+			AddPose(Frame.SkelLocations[SkelIdx], Frame.SkelRotations[SkelIdx], &individual_obj);
+			// All the bones are written, the readers stop carrying forward older values here
+			if (bWriteSparseBones && bKeyFrame)
+			{
+				BSON_APPEND_BOOL(&individual_obj, "key", true);
+				LastBoneKeyFrameTimes[SkelIdx] = Frame.Timestamp;
+			}
+			// Bones
+			AddSkeletalBoneIndividuals(Frame, BoneIdxsToWrite, &individual_obj);
+			// Constraints
+			//AddSkeletalConstraintIndividuals(SkelIndividual->GetBoneConstraintIndividuals(), &individual_obj);
+		bson_append_document_end(&arr_obj, &individual_obj);
 
-			arr_idx++;
-			Num++;
-		//}
+		arr_idx++;
+		Num++;
 	}
 	bson_append_array_end(doc, &arr_obj);
 	return Num;
 }
 
-// Add skeletal bones to the document
-void FSLWorldStateDBWriterAsyncTask::AddSkeletalBoneIndividuals(
-	const TArray<USLBoneIndividual*>& BoneIndividuals,
-	const TArray<USLVirtualBoneIndividual*>& VirtualBoneIndividuals,
-	bson_t* doc)
+// Add the given skeletal bones to the document (flattened layout indexes)
+void FSLWorldStateDBWriterAsyncTask::AddSkeletalBoneIndividuals(const FSLWorldStateFrame& Frame, const TArray<int32>& BoneIdxs, bson_t* doc)
 {
 	bson_t bones_arr;
 	bson_t arr_obj;
@@ -273,31 +472,25 @@ void FSLWorldStateDBWriterAsyncTask::AddSkeletalBoneIndividuals(
 
 	BSON_APPEND_ARRAY_BEGIN(doc, "bones", &bones_arr);
 
-	for (const auto& BI : BoneIndividuals)
-	{
-		bson_uint32_to_string(arr_idx, &idx_key, idx_str, sizeof idx_str);
-		BSON_APPEND_DOCUMENT_BEGIN(&bones_arr, idx_key, &arr_obj);
-			// Bone index
-			BSON_APPEND_INT32(&arr_obj, "idx", BI->GetBoneIndex());
-			// Bone world pose
-			AddPose(BI->GetCachedPose(), &arr_obj);
-		bson_append_document_end(&bones_arr, &arr_obj);
-		arr_idx++;
-	}
-
-	for (const auto& VBI : VirtualBoneIndividuals)
+	for (const int32 BoneIdx : BoneIdxs)
 	{
 		bson_uint32_to_string(arr_idx, &idx_key, idx_str, sizeof idx_str);
 		BSON_APPEND_DOCUMENT_BEGIN(&bones_arr, idx_key, &arr_obj);
 			// Bone index
-			BSON_APPEND_INT32(&arr_obj, "idx", VBI->GetBoneIndex());
-			// Bone world pose
-			AddPose(VBI->GetCachedPose(), &arr_obj);
+			BSON_APPEND_INT32(&arr_obj, "idx", Layout->BoneIndexes[BoneIdx]);
+			// Bone pose relative to the skeletal individual, or the world pose
+			if (bWriteLocalBonePoses)
+			{
+				AddPose(LastLocalBonePoses[BoneIdx].GetLocation(), LastLocalBonePoses[BoneIdx].GetRotation(), &arr_obj);
+			}
+			else
+			{
+				AddPose(Frame.BoneLocations[BoneIdx], Frame.BoneRotations[BoneIdx], &arr_obj);
+			}
 		bson_append_document_end(&bones_arr, &arr_obj);
 		arr_idx++;
 	}
 
-
 	bson_append_array_end(doc, &bones_arr);
 }
 
@@ -401,11 +594,44 @@ void FSLWorldStateDBWriterAsyncTask::AddPose(FTransform Pose, bson_t* doc)
 	bson_append_array_end(doc, &child_pose);
 }
 
+// Add pose document from the frame buffer values (binary pose if a compact encoding is used)
+void FSLWorldStateDBWriterAsyncTask::AddPose(const FVector& Location, const FQuat& Rotation, bson_t* doc)
+{
+	if (PoseEncoding == ESLWorldStatePoseEncoding::Default)
+	{
+		AddPose(FTransform(Rotation, Location), doc);
+		return;
+	}
+
+	FTransform Pose(Rotation, Location);
+#if SL_WITH_ROS_CONVERSIONS
+	FConversions::UToROS(Pose);
+#endif // SL_WITH_ROS_CONVERSIONS
+
+	uint8 Data[FSLPoseCodec::MaxSize];
+	const int32 Size = FSLPoseCodec::Encode(Pose.GetLocation(), Pose.GetRotation(),
+		PoseEncoding == ESLWorldStatePoseEncoding::Quantized, PositionResolution, Data);
+	BSON_APPEND_BINARY(doc, "p", BSON_SUBTYPE_BINARY, Data, Size);
+}
+
+// Add the individual reference, the id or the id table index if a compact encoding is used
+void FSLWorldStateDBWriterAsyncTask::AddIndividualRef(const char* Id, int32 Idx, bson_t* doc)
+{
+	if (PoseEncoding == ESLWorldStatePoseEncoding::Default)
+	{
+		BSON_APPEND_UTF8(doc, "id", Id);
+	}
+	else
+	{
+		BSON_APPEND_INT32(doc, "idx", Idx);
+	}
+}
+
 // Write the bson doc to the meta_coll
 bool FSLWorldStateDBWriterAsyncTask::UploadDoc(bson_t* doc)
 {
 	bson_error_t error;
-	if (!mongoc_collection_insert_one(mongo_collection, doc, NULL, NULL, &error))
+	if (!mongoc_collection_insert_one(mongo_collection, doc, write_opts, NULL, &error))
 	{
 		UE_LOG(LogTemp, Error, TEXT("%s::%d Err.: %s"),
 			*FString(__func__), __LINE__, *FString(error.message));
@@ -413,6 +639,77 @@ bool FSLWorldStateDBWriterAsyncTask::UploadDoc(bson_t* doc)
 	}
 	return true;
 }
+
+// Append the frame poses to the trajectory buckets, upload the buckets which are full
+void FSLWorldStateDBWriterAsyncTask::AddToTrajectoryBuckets(const FSLWorldStateFrame& Frame)
+{
+	for (int32 FrameIdx = 0; FrameIdx < Frame.IndividualIndexes.Num(); ++FrameIdx)
+	{
+		const int32 IndividualIdx = Frame.IndividualIndexes[FrameIdx];
+		FSLWorldStateTrajectoryBucket& Bucket = TrajectoryBuckets[IndividualIdx];
+		if (Bucket.Num() > 0 && (Bucket.Num() >= FSLWorldStateTrajectoryBucket::MaxSamples
+			|| Frame.Timestamp - Bucket.Timestamps[0] >= TrajectoryBucketDuration))
+		{
+			UploadTrajectoryBucket(IndividualIdx);
+		}
+
+		FTransform Pose(Frame.IndividualRotations[FrameIdx], Frame.IndividualLocations[FrameIdx]);
+#if SL_WITH_ROS_CONVERSIONS
+		FConversions::UToROS(Pose);
+#endif // SL_WITH_ROS_CONVERSIONS
+		const FVector Loc = Pose.GetLocation();
+		const FQuat Quat = Pose.GetRotation();
+		Bucket.Timestamps.Add(Frame.Timestamp);
+		Bucket.Locations.Append({ (float)Loc.X, (float)Loc.Y, (float)Loc.Z });
+		Bucket.Rotations.Append({ (float)Quat.X, (float)Quat.Y, (float)Quat.Z, (float)Quat.W });
+	}
+}
+
+// Upload the trajectory bucket of the individual and clear it
+bool FSLWorldStateDBWriterAsyncTask::UploadTrajectoryBucket(int32 IndividualIdx)
+{
+	FSLWorldStateTrajectoryBucket& Bucket = TrajectoryBuckets[IndividualIdx];
+
+	bson_t* bucket_doc;
+	bucket_doc = bson_new();
+	BSON_APPEND_UTF8(bucket_doc, "id", Layout->GetIndividualId(IndividualIdx));
+	BSON_APPEND_DOUBLE(bucket_doc, "start", Bucket.Timestamps[0]);
+	BSON_APPEND_DOUBLE(bucket_doc, "end", Bucket.Timestamps.Last());
+	BSON_APPEND_INT32(bucket_doc, "num", Bucket.Num());
+	BSON_APPEND_BINARY(bucket_doc, "ts", BSON_SUBTYPE_BINARY,
+		reinterpret_cast<const uint8_t*>(Bucket.Timestamps.GetData()), Bucket.Timestamps.Num() * sizeof(float));
+	BSON_APPEND_BINARY(bucket_doc, "loc", BSON_SUBTYPE_BINARY,
+		reinterpret_cast<const uint8_t*>(Bucket.Locations.GetData()), Bucket.Locations.Num() * sizeof(float));
+	BSON_APPEND_BINARY(bucket_doc, "quat", BSON_SUBTYPE_BINARY,
+		reinterpret_cast<const uint8_t*>(Bucket.Rotations.GetData()), Bucket.Rotations.Num() * sizeof(float));
+
+	bool bRetVal = true;
+	bson_error_t error;
+	if (!mongoc_collection_insert_one(trj_collection, bucket_doc, write_opts, NULL, &error))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Err.: %s"),
+			*FString(__func__), __LINE__, *FString(error.message));
+		bRetVal = false;
+	}
+
+	bson_destroy(bucket_doc);
+	Bucket.Reset();
+	return bRetVal;
+}
+
+// Add the bson doc to the batch (takes ownership), flush if the batch is full
+void FSLWorldStateDBWriterAsyncTask::AddToBatch(bson_t* doc)
+{
+	if (batch_docs.Num() == 0)
+	{
+		BatchStartTime = FPlatformTime::Seconds();
+	}
+	batch_docs.Add(doc);
+	if (batch_docs.Num() >= BatchSize || FPlatformTime::Seconds() - BatchStartTime >= BatchMaxDelay)
+	{
+		FlushBatch();
+	}
+}
 #endif //SL_WITH_LIBMONGO_C	
 
 
@@ -424,6 +721,13 @@ FSLWorldStateDBHandler::FSLWorldStateDBHandler()
 	bIsFinished = false;
 	bIsInit = false;
 	DBWriterTask = nullptr;
+	IndividualManager = nullptr;
+#if SL_WITH_LIBMONGO_C
+	trj_collection = nullptr;
+#endif //SL_WITH_LIBMONGO_C
+	MinPoseDiff = 0.1f;
+	bWriteSparse = true;
+	PoseEncoding = ESLWorldStatePoseEncoding::Default;
 }
 
 // Dtor
@@ -436,7 +740,7 @@ FSLWorldStateDBHandler::~FSLWorldStateDBHandler()
 }
 
 // Connect to the db and set up the async writer
-bool FSLWorldStateDBHandler::Init(ASLIndividualManager* IndividualManager,
+bool FSLWorldStateDBHandler::Init(ASLIndividualManager* InIndividualManager,
 	const FSLWorldStateLoggerParams& InLoggerParameters,
 	const FSLLoggerLocationParams& InLocationParameters,
 	const FSLLoggerDBServerParams& InDBServerParameters)
@@ -450,12 +754,51 @@ bool FSLWorldStateDBHandler::Init(ASLIndividualManager* IndividualManager,
 		return false;
 	}
 
+	// Per individual trajectory buckets
+	if (InLoggerParameters.bWriteTrajectoryBuckets)
+	{
+		if (!CreateTrajectoryCollection(InLocationParameters.TaskId, InLocationParameters.EpisodeId, InLocationParameters.bOverwrite))
+		{
+			UE_LOG(LogTemp, Error, TEXT("%s::%d World state trajectory buckets will not be written.."), *FString(__FUNCTION__), __LINE__);
+		}
+	}
+
 	// Write metadata if needed
 	if (InLoggerParameters.bIncludeMetadata)
 	{
-		WriteMetadata(IndividualManager, InLocationParameters.TaskId + ".meta", InLoggerParameters.bOverwriteMetadata);
+		WriteMetadata(InIndividualManager, InLocationParameters.TaskId + ".meta", InLoggerParameters.bOverwriteMetadata);
+	}
+
+	IndividualManager = InIndividualManager;
+	MinPoseDiff = InLoggerParameters.PoseTolerance;
+	bWriteSparse = InLoggerParameters.bWriteSparse;
+	PoseEncoding = InLoggerParameters.PoseEncoding;
+
+	// Cache the individuals on the game thread, the writer only reads the frame buffers and the layout
+	if (!PoseSnapshot.Init(IndividualManager))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d World state snapshot could not be initialized.."),
+			*FString(__FUNCTION__), __LINE__);
+		Disconnect();
+		return false;
+	}
+
+	// The compact encodings reference the individuals by their index in the id table, the readers find the bone format in it as well
+	const bool bSparseBones = bWriteSparse && InLoggerParameters.bWriteSparseBones;
+	if ((PoseEncoding != ESLWorldStatePoseEncoding::Default || bSparseBones || InLoggerParameters.bWriteLocalBonePoses)
+		&& !WriteIdTable(PoseEncoding, InLoggerParameters.PositionResolution, bSparseBones, InLoggerParameters.bWriteLocalBonePoses))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d World state id table could not be written.."),
+			*FString(__FUNCTION__), __LINE__);
+		Disconnect();
+		return false;
 	}
 
+	// Pre-allocate the frame buffers
+	FString SpillFilePath = FPaths::ProjectDir() + "/SL/" + InLocationParameters.TaskId + "/Spill/" + InLocationParameters.EpisodeId + ".ws";
+	FPaths::RemoveDuplicateSlashes(SpillFilePath);
+	FrameQueue.Init(InLoggerParameters.FrameBufferSize, InLoggerParameters.OverflowPolicy, SpillFilePath);
+
 	// Create the async worker
 	if (DBWriterTask == nullptr)
 	{
@@ -469,7 +812,7 @@ bool FSLWorldStateDBHandler::Init(ASLIndividualManager* IndividualManager,
 
 #if SL_WITH_LIBMONGO_C
 	// Set worker parameters
-	if (!DBWriterTask->GetTask().Init(collection, IndividualManager, InLoggerParameters.PoseTolerance, InLoggerParameters.bWriteSparse))
+	if (!DBWriterTask->GetTask().Init(collection, trj_collection, IndividualManager, &PoseSnapshot.GetLayout(), &FrameQueue, InLoggerParameters))
 	{
 		UE_LOG(LogTemp, Error, TEXT("%s::%d World state async writer could not be initialized.."),
 			*FString(__FUNCTION__), __LINE__);
@@ -490,11 +833,12 @@ bool FSLWorldStateDBHandler::Init(ASLIndividualManager* IndividualManager,
 void FSLWorldStateDBHandler::FirstWrite(float Timestamp)
 {
 	PrevWriteCallTime = FPlatformTime::Seconds();
-	DBWriterTask->GetTask().SetTimestamp(Timestamp);
-	DBWriterTask->StartBackgroundTask();
+
+	// First write is without optimization, write all individuals
+	EnqueueFrame(Timestamp, true);
 }
 
-// Delegate job to the async task (true if the previous job was done)
+// Queue the current world state and delegate the job to the async task (false if the frame was dropped)
 bool FSLWorldStateDBHandler::Write(float Timestamp)
 {
 	//double CurrentTime = FPlatformTime::Seconds();
@@ -503,17 +847,7 @@ bool FSLWorldStateDBHandler::Write(float Timestamp)
 	//UE_LOG(LogTemp, Warning, TEXT("%s::%d \t\t Duration since previous call:\t%f (s)"),
 	//	*FString(__func__), __LINE__, DurationSincePrevCall);
 
-	if (DBWriterTask->IsDone())
-	{
-		DBWriterTask->GetTask().SetTimestamp(Timestamp);
-		DBWriterTask->StartBackgroundTask();
-		return true;
-	}
-	else
-	{
-		UE_LOG(LogTemp, Warning, TEXT("%s::%d [%f] Current db write async task is not finished yet, trying again next update call.."), *FString(__func__), __LINE__, Timestamp);
-		return false;
-	}
+	return EnqueueFrame(Timestamp, !bWriteSparse);
 }
 
 // Disconnect from db, clear task
@@ -525,28 +859,23 @@ void FSLWorldStateDBHandler::Finish()
 		return;
 	}
 	
-	// Wait for writer to finish
+	// Wait for writer to finish, and write any frames that are still queued
 	if (DBWriterTask != nullptr)
 	{
-		if (DBWriterTask->IsDone())
+		if (!DBWriterTask->IsDone())
 		{
-			delete DBWriterTask;
-			DBWriterTask = nullptr;
+			DBWriterTask->EnsureCompletion();
 		}
-		else
+		if (bIsInit && !FrameQueue.IsEmpty())
 		{
-			if (DBWriterTask->WaitCompletionWithTimeout(0.5f))
-			{
-				delete DBWriterTask;
-				DBWriterTask = nullptr;
-			}
-			else
-			{
-				UE_LOG(LogTemp, Error, TEXT("%s::%d Task not completed, and writer was killed.."), *FString(__FUNCTION__), __LINE__);
-				delete DBWriterTask;
-				DBWriterTask = nullptr;
-			}
+			DBWriterTask->StartSynchronousTask();
 		}
+		DBWriterTask->GetTask().FlushBatch();
+		DBWriterTask->GetTask().FlushTrajectoryBuckets();
+		FrameQueue.LogStats(FString::Printf(TEXT("%s::%d World state writer frames:"), *FString(__FUNCTION__), __LINE__));
+		DBWriterTask->GetTask().LogStats(FString::Printf(TEXT("%s::%d World state writer uploads:"), *FString(__FUNCTION__), __LINE__));
+		delete DBWriterTask;
+		DBWriterTask = nullptr;
 	}
 
 	// Finish up handler
@@ -557,14 +886,78 @@ void FSLWorldStateDBHandler::Finish()
 	bIsFinished = true;
 }
 
+// Snapshot the poses into a frame buffer (game thread) and apply the overflow policy if needed
+bool FSLWorldStateDBHandler::EnqueueFrame(float Timestamp, bool bWriteAllIndividuals)
+{
+	const float Tolerance = bWriteAllIndividuals ? 0.f : MinPoseDiff;
+	bool bRetVal = true;
+	if (FSLWorldStateFrame* Frame = FrameQueue.BeginWrite())
+	{
+		PoseSnapshot.Snapshot(*Frame, Timestamp, Tolerance, bWriteAllIndividuals);
+		if (!Frame->IsEmpty())
+		{
+			FrameQueue.EndWrite();
+		}
+	}
+	else if (FrameQueue.IsSpilling())
+	{
+		// Keep the order, new frames follow the already spilled ones
+		PoseSnapshot.Snapshot(OverflowFrame, Timestamp, Tolerance, bWriteAllIndividuals);
+		bRetVal = OverflowFrame.IsEmpty() || FrameQueue.Spill(OverflowFrame);
+	}
+	else if (FrameQueue.GetOverflowPolicy() == ESLWorldStateOverflowPolicy::Block)
+	{
+		// Wait for the writer to release a buffer
+		const double BlockStartTime = FPlatformTime::Seconds();
+		while ((Frame = FrameQueue.BeginWrite()) == nullptr)
+		{
+			StartWriter();
+			FPlatformProcess::Sleep(0.001f);
+		}
+		FrameQueue.CountBlocked(FPlatformTime::Seconds() - BlockStartTime);
+		PoseSnapshot.Snapshot(*Frame, Timestamp, Tolerance, bWriteAllIndividuals);
+		if (!Frame->IsEmpty())
+		{
+			FrameQueue.EndWrite();
+		}
+	}
+	else if (FrameQueue.GetOverflowPolicy() == ESLWorldStateOverflowPolicy::Coalesce)
+	{
+		// Poses of the newest queued frame are overwritten, no moved individual is lost
+		PoseSnapshot.Snapshot(OverflowFrame, Timestamp, Tolerance, bWriteAllIndividuals);
+		if (!OverflowFrame.IsEmpty() && !FrameQueue.CoalesceIntoLast(OverflowFrame))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("%s::%d [%f] Could not coalesce the frame, it is dropped.."),
+				*FString(__func__), __LINE__, Timestamp);
+			FrameQueue.CountDropped();
+			bRetVal = false;
+		}
+	}
+	else if (FrameQueue.GetOverflowPolicy() == ESLWorldStateOverflowPolicy::SpillToDisk)
+	{
+		PoseSnapshot.Snapshot(OverflowFrame, Timestamp, Tolerance, bWriteAllIndividuals);
+		bRetVal = OverflowFrame.IsEmpty() || FrameQueue.Spill(OverflowFrame);
+	}
+
+	StartWriter();
+	return bRetVal;
+}
+
+// Start the async writer if it is idle and there are queued frames or expired batched documents
+void FSLWorldStateDBHandler::StartWriter()
+{
+	// Idle (sparse) episodes do not queue frames, the partial batch is flushed once it is older than the max delay
+	if (DBWriterTask->IsDone() && (!FrameQueue.IsEmpty() || DBWriterTask->GetTask().IsBatchExpired()))
+	{
+		DBWriterTask->StartBackgroundTask();
+	}
+}
+
 // Connect to the db
 bool FSLWorldStateDBHandler::Connect(const FString& DBName, const FString& CollName, const FString& ServerIp,
 		uint16 ServerPort, bool bOverwrite)
 {
 #if SL_WITH_LIBMONGO_C
-	// Required to initialize libmongoc's internals	
-	mongoc_init();
-
 	// Stores any error that might appear during the connection
 	bson_error_t error;
 
@@ -640,8 +1033,93 @@ bool FSLWorldStateDBHandler::Connect(const FString& DBName, const FString& CollN
 #endif //SL_WITH_LIBMONGO_C
 }
 
+// Create the trajectory buckets collection (<episode>.trj)
+bool FSLWorldStateDBHandler::CreateTrajectoryCollection(const FString& DBName, const FString& CollName, bool bOverwrite)
+{
+#if SL_WITH_LIBMONGO_C
+	bson_error_t error;
+	const FString TrjCollName = CollName + ".trj";
+	if (mongoc_database_has_collection(database, TCHAR_TO_UTF8(*TrjCollName), &error))
+	{
+		if (!bOverwrite)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("%s::%d Trajectory collection %s already exists and should not be overwritten.."),
+				*FString(__func__), __LINE__, *TrjCollName);
+			return false;
+		}
+		mongoc_collection_t* prev_coll = mongoc_database_get_collection(database, TCHAR_TO_UTF8(*TrjCollName));
+		const bool bDropped = mongoc_collection_drop(prev_coll, &error);
+		mongoc_collection_destroy(prev_coll);
+		if (!bDropped)
+		{
+			UE_LOG(LogTemp, Error, TEXT("%s::%d Could not drop collection, err.:%s;"),
+				*FString(__func__), __LINE__, *FString(error.message));
+			return false;
+		}
+	}
+	trj_collection = mongoc_client_get_collection(client, TCHAR_TO_UTF8(*DBName), TCHAR_TO_UTF8(*TrjCollName));
+	return true;
+#else
+	return false;
+#endif //SL_WITH_LIBMONGO_C
+}
+
+// Write the id table document used by the compact pose encodings and the sparse or local bone poses
+bool FSLWorldStateDBHandler::WriteIdTable(ESLWorldStatePoseEncoding Encoding, float PositionResolution, bool bSparseBones, bool bLocalBonePoses)
+{
+#if SL_WITH_LIBMONGO_C
+	const FSLWorldStateLayout& Layout = PoseSnapshot.GetLayout();
+
+	// Add the ids as an array (the array index is the one used in the frames)
+	auto AddIds = [](const TArray<TArray<ANSICHAR>>& Ids, const char* Key, bson_t* doc)
+	{
+		bson_t arr_obj;
+		char idx_str[16];
+		const char* idx_key;
+		BSON_APPEND_ARRAY_BEGIN(doc, Key, &arr_obj);
+		for (int32 Idx = 0; Idx < Ids.Num(); ++Idx)
+		{
+			bson_uint32_to_string(Idx, &idx_key, idx_str, sizeof idx_str);
+			BSON_APPEND_UTF8(&arr_obj, idx_key, Ids[Idx].GetData());
+		}
+		bson_append_array_end(doc, &arr_obj);
+	};
+
+	// Document without a timestamp, ignored by the frame queries
+	bson_t* id_table_doc;
+	id_table_doc = bson_new();
+	BSON_APPEND_BOOL(id_table_doc, "id_table", true);
+	if (Encoding == ESLWorldStatePoseEncoding::Default)
+	{
+		BSON_APPEND_UTF8(id_table_doc, "encoding", "default");
+	}
+	else
+	{
+		BSON_APPEND_UTF8(id_table_doc, "encoding", Encoding == ESLWorldStatePoseEncoding::Quantized ? "quantized" : "float32");
+	}
+	BSON_APPEND_DOUBLE(id_table_doc, "pos_res", PositionResolution);
+	BSON_APPEND_BOOL(id_table_doc, "sparse_bones", bSparseBones);
+	BSON_APPEND_BOOL(id_table_doc, "local_bones", bLocalBonePoses);
+	AddIds(Layout.IndividualIds, "ids", id_table_doc);
+	AddIds(Layout.SkelIds, "skel_ids", id_table_doc);
+
+	bool bRetVal = true;
+	bson_error_t error;
+	if (!mongoc_collection_insert_one(collection, id_table_doc, NULL, NULL, &error))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Err.: %s"),
+			*FString(__func__), __LINE__, *FString(error.message));
+		bRetVal = false;
+	}
+	bson_destroy(id_table_doc);
+	return bRetVal;
+#else
+	return false;
+#endif //SL_WITH_LIBMONGO_C
+}
+
 // Write metadata (collname + .meta)
-bool FSLWorldStateDBHandler::WriteMetadata(ASLIndividualManager* IndividualManager, const FString& MetaCollName, bool bOverwrite)
+bool FSLWorldStateDBHandler::WriteMetadata(ASLIndividualManager* InIndividualManager, const FString& MetaCollName, bool bOverwrite)
 {
 #if SL_WITH_LIBMONGO_C
 	bson_error_t error;
@@ -690,7 +1168,7 @@ bool FSLWorldStateDBHandler::WriteMetadata(ASLIndividualManager* IndividualManag
 	BSON_APPEND_UTF8(meta_doc, "type_id", "individuals");
 
 	// Add individuals data
-	int32 Num = AddIndividualsMetadata(IndividualManager, meta_doc);
+	int32 Num = AddIndividualsMetadata(InIndividualManager, meta_doc);
 
 	bool RetVal = true;
 	if(Num > 0)
@@ -723,14 +1201,14 @@ bool FSLWorldStateDBHandler::WriteMetadata(ASLIndividualManager* IndividualManag
 }
 
 #if SL_WITH_LIBMONGO_C
-int32 FSLWorldStateDBHandler::AddIndividualsMetadata(ASLIndividualManager* IndividualManager, bson_t* doc)
+int32 FSLWorldStateDBHandler::AddIndividualsMetadata(ASLIndividualManager* InIndividualManager, bson_t* doc)
 {
 	int32 Num = 0;
 	bson_t arr_obj;
 	uint32_t arr_idx = 0;
 
 	BSON_APPEND_ARRAY_BEGIN(doc, "individuals", &arr_obj);
-	for (const auto& Individual : IndividualManager->GetIndividuals())
+	for (const auto& Individual : InIndividualManager->GetIndividuals())
 	{
 		bson_t individual_obj;
 		char idx_str[16];
@@ -774,7 +1252,10 @@ void FSLWorldStateDBHandler::Disconnect() const
 	{
 		mongoc_collection_destroy(collection);
 	}
-	mongoc_cleanup();
+	if (trj_collection)
+	{
+		mongoc_collection_destroy(trj_collection);
+	}
 #endif //SL_WITH_LIBMONGO_C
 }
 
@@ -798,12 +1279,12 @@ bool FSLWorldStateDBHandler::CreateIndexes() const
 
 	bson_t idx_individuals_id;
 	bson_init(&idx_individuals_id);
-	BSON_APPEND_INT32(&idx_individuals_id, "individuals.id", 1);
+	BSON_APPEND_INT32(&idx_individuals_id, PoseEncoding == ESLWorldStatePoseEncoding::Default ? "individuals.id" : "individuals.idx", 1);
 	char* idx_individuals_id_chr = mongoc_collection_keys_to_index_string(&idx_individuals_id);
 
 	bson_t idx_skel_individuals_id;
 	bson_init(&idx_skel_individuals_id);
-	BSON_APPEND_INT32(&idx_skel_individuals_id, "skel_individuals.id", 1);
+	BSON_APPEND_INT32(&idx_skel_individuals_id, PoseEncoding == ESLWorldStatePoseEncoding::Default ? "skel_individuals.id" : "skel_individuals.idx", 1);
 	char* idx_skel_individuals_id_chr = mongoc_collection_keys_to_index_string(&idx_skel_individuals_id);
 
 	index_command = BCON_NEW("createIndexes",
@@ -835,6 +1316,35 @@ bool FSLWorldStateDBHandler::CreateIndexes() const
 		bRetVal = false;
 	}
 
+	// Trajectory buckets are searched by id and time
+	if (trj_collection)
+	{
+		bson_t idx_trj;
+		bson_init(&idx_trj);
+		BSON_APPEND_INT32(&idx_trj, "id", 1);
+		BSON_APPEND_INT32(&idx_trj, "start", 1);
+		char* idx_trj_chr = mongoc_collection_keys_to_index_string(&idx_trj);
+
+		bson_t* trj_index_command = BCON_NEW("createIndexes",
+			BCON_UTF8(mongoc_collection_get_name(trj_collection)),
+			"indexes",
+			"[",
+				"{",
+					"key", BCON_DOCUMENT(&idx_trj),
+					"name", BCON_UTF8(idx_trj_chr),
+				"}",
+			"]");
+
+		if (!mongoc_collection_write_command_with_opts(trj_collection, trj_index_command, NULL/*opts*/, NULL/*reply*/, &error))
+		{
+			UE_LOG(LogTemp, Error, TEXT("%s::%d Create trajectory indexes err.: %s"),
+				*FString(__func__), __LINE__, *FString(error.message));
+			bRetVal = false;
+		}
+		bson_destroy(trj_index_command);
+		bson_free(idx_trj_chr);
+	}
+
 	// Clean up
 	bson_destroy(index_command);
 	bson_free(idx_ts_chr);
@@ -0,0 +1,236 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "Runtime/SLWorldStateFrameQueue.h"
+#include "HAL/FileManager.h"
+#include "Misc/ScopeLock.h"
+
+/* Frame */
+// Clear the data but keep the allocations
+void FSLWorldStateFrame::Reset()
+{
+	Timestamp = 0.f;
+	IndividualIndexes.Reset();
+	IndividualLocations.Reset();
+	IndividualRotations.Reset();
+	SkelLocations.Reset();
+	SkelRotations.Reset();
+	BoneLocations.Reset();
+	BoneRotations.Reset();
+	MovedBones.Reset();
+}
+
+// Merge a newer frame into this one (newer poses and timestamp overwrite the current ones)
+void FSLWorldStateFrame::Coalesce(const FSLWorldStateFrame& Newer)
+{
+	Timestamp = Newer.Timestamp;
+
+	// Individuals are unique in a frame, overwrite the existing ones and append the new ones
+	TMap<int32, int32> IndexToPos;
+	IndexToPos.Reserve(IndividualIndexes.Num());
+	for (int32 Pos = 0; Pos < IndividualIndexes.Num(); ++Pos)
+	{
+		IndexToPos.Add(IndividualIndexes[Pos], Pos);
+	}
+	for (int32 NewerPos = 0; NewerPos < Newer.IndividualIndexes.Num(); ++NewerPos)
+	{
+		if (int32* Pos = IndexToPos.Find(Newer.IndividualIndexes[NewerPos]))
+		{
+			IndividualLocations[*Pos] = Newer.IndividualLocations[NewerPos];
+			IndividualRotations[*Pos] = Newer.IndividualRotations[NewerPos];
+		}
+		else
+		{
+			IndividualIndexes.Add(Newer.IndividualIndexes[NewerPos]);
+			IndividualLocations.Add(Newer.IndividualLocations[NewerPos]);
+			IndividualRotations.Add(Newer.IndividualRotations[NewerPos]);
+		}
+	}
+
+	// Every frame holds all the skeletal poses (the writer selects the bones to write), the newer data replaces the current one
+	SkelLocations = Newer.SkelLocations;
+	SkelRotations = Newer.SkelRotations;
+	BoneLocations = Newer.BoneLocations;
+	BoneRotations = Newer.BoneRotations;
+
+	// A bone moved if it moved in any of the merged frames
+	if (MovedBones.Num() == Newer.MovedBones.Num())
+	{
+		for (TConstSetBitIterator<> BitItr(Newer.MovedBones); BitItr; ++BitItr)
+		{
+			MovedBones[BitItr.GetIndex()] = true;
+		}
+	}
+	else
+	{
+		MovedBones = Newer.MovedBones;
+	}
+}
+
+// Serialization (used for spilling to disk)
+FArchive& operator<<(FArchive& Ar, FSLWorldStateFrame& Frame)
+{
+	Ar << Frame.Timestamp;
+	Ar << Frame.IndividualIndexes;
+	Ar << Frame.IndividualLocations;
+	Ar << Frame.IndividualRotations;
+	Ar << Frame.SkelLocations;
+	Ar << Frame.SkelRotations;
+	Ar << Frame.BoneLocations;
+	Ar << Frame.BoneRotations;
+	Ar << Frame.MovedBones;
+	return Ar;
+}
+
+
+/* Queue */
+// Ctor
+FSLWorldStateFrameQueue::FSLWorldStateFrameQueue()
+{
+	Capacity = 0;
+	OverflowPolicy = ESLWorldStateOverflowPolicy::Block;
+	SpillWriter = nullptr;
+	SpillTakeIdx = 0;
+	bSpilling = false;
+	ClaimedIdx = INDEX_NONE;
+	MaxNum = 0;
+	BlockedSeconds = 0.0;
+}
+
+// Dtor
+FSLWorldStateFrameQueue::~FSLWorldStateFrameQueue()
+{
+	FScopeLock Lock(&SpillLock);
+	if (SpillWriter)
+	{
+		SpillWriter->Close();
+		delete SpillWriter;
+		SpillWriter = nullptr;
+	}
+}
+
+// Allocate the frame buffers
+void FSLWorldStateFrameQueue::Init(int32 InCapacity, ESLWorldStateOverflowPolicy InPolicy, const FString& InSpillFilePath)
+{
+	// The newest frame must not be the one read by the consumer when the queue is full (see CoalesceIntoLast)
+	Capacity = FMath::Max(InCapacity, 2);
+	OverflowPolicy = InPolicy;
+	SpillFilePath = InSpillFilePath;
+	Frames.SetNum(Capacity);
+	Head.Reset();
+	Tail.Reset();
+	ClaimedIdx = INDEX_NONE;
+}
+
+// Get the next free frame buffer (nullptr if full, or if frames are being spilled)
+FSLWorldStateFrame* FSLWorldStateFrameQueue::BeginWrite()
+{
+	if (IsFull() || bSpilling)
+	{
+		return nullptr;
+	}
+	FSLWorldStateFrame* Frame = &Frames[Tail.GetValue() % Capacity];
+	Frame->Reset();
+	return Frame;
+}
+
+// Publish the frame returned by BeginWrite
+void FSLWorldStateFrameQueue::EndWrite()
+{
+	Tail.Increment();
+	NumEnqueued.Increment();
+	MaxNum = FMath::Max(MaxNum, Num());
+}
+
+// Merge the frame into the newest queued frame (false if there is no safe frame to merge into)
+bool FSLWorldStateFrameQueue::CoalesceIntoLast(const FSLWorldStateFrame& Frame)
+{
+	// The consumer cannot claim a new frame while merging, the claimed one is not touched
+	FScopeLock Lock(&ClaimLock);
+	const int32 LastIdx = Tail.GetValue() - 1;
+	if (Num() == 0 || LastIdx == ClaimedIdx)
+	{
+		return false;
+	}
+	Frames[LastIdx % Capacity].Coalesce(Frame);
+	NumCoalesced.Increment();
+	return true;
+}
+
+// Append the frame to the spill file (false if the frame had to be dropped)
+bool FSLWorldStateFrameQueue::Spill(FSLWorldStateFrame& Frame)
+{
+	FScopeLock Lock(&SpillLock);
+	if (SpillWriter == nullptr)
+	{
+		SpillWriter = IFileManager::Get().CreateFileWriter(*SpillFilePath);
+		if (SpillWriter == nullptr)
+		{
+			UE_LOG(LogTemp, Error, TEXT("%s::%d Could not create the spill file %s, frame [%f] is dropped.."),
+				*FString(__FUNCTION__), __LINE__, *SpillFilePath, Frame.Timestamp);
+			NumDropped.Increment();
+			return false;
+		}
+	}
+	*SpillWriter << Frame;
+	bSpilling = true;
+	NumSpilled.Increment();
+	NumPendingSpill.Increment();
+	return true;
+}
+
+// Get the oldest queued frame and claim it until it is popped (nullptr if empty)
+const FSLWorldStateFrame* FSLWorldStateFrameQueue::Peek() const
+{
+	FScopeLock Lock(&ClaimLock);
+	if (Num() == 0)
+	{
+		return nullptr;
+	}
+	ClaimedIdx = Head.GetValue();
+	return &Frames[ClaimedIdx % Capacity];
+}
+
+// Release the frame returned by Peek
+void FSLWorldStateFrameQueue::Pop()
+{
+	FScopeLock Lock(&ClaimLock);
+	Head.Increment();
+	ClaimedIdx = INDEX_NONE;
+}
+
+// Move the spilled frames into a file ready to be read (false if nothing is spilled)
+bool FSLWorldStateFrameQueue::TakeSpill(FString& OutFilePath)
+{
+	FScopeLock Lock(&SpillLock);
+	if (SpillWriter == nullptr)
+	{
+		// Nothing left on disk, new frames can use the buffers again
+		bSpilling = false;
+		return false;
+	}
+
+	SpillWriter->Close();
+	delete SpillWriter;
+	SpillWriter = nullptr;
+
+	OutFilePath = SpillFilePath + TEXT(".") + FString::FromInt(SpillTakeIdx++);
+	if (!IFileManager::Get().Move(*OutFilePath, *SpillFilePath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not move the spill file %s to %s, %d frames are dropped.."),
+			*FString(__FUNCTION__), __LINE__, *SpillFilePath, *OutFilePath, NumPendingSpill.GetValue());
+		NumDropped.Add(NumPendingSpill.GetValue());
+		NumPendingSpill.Reset();
+		return false;
+	}
+	NumPendingSpill.Reset();
+	return true;
+}
+
+// Log the drop accounting counters
+void FSLWorldStateFrameQueue::LogStats(const FString& Prefix) const
+{
+	UE_LOG(LogTemp, Log, TEXT("%s enqueued=%d; written=%d; coalesced=%d; spilled=%d; dropped=%d; blocked=%d (%.3f s); max queued=%d/%d;"),
+		*Prefix, NumEnqueued.GetValue(), NumWritten.GetValue(), NumCoalesced.GetValue(), NumSpilled.GetValue(),
+		NumDropped.GetValue(), NumBlocked.GetValue(), BlockedSeconds, MaxNum, Capacity);
+}
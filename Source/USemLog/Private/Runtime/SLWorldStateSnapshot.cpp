@@ -0,0 +1,163 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "Runtime/SLWorldStateSnapshot.h"
+#include "Individuals/SLIndividualManager.h"
+#include "Individuals/Type/SLBaseIndividual.h"
+#include "Individuals/Type/SLSkeletalIndividual.h"
+#include "Individuals/Type/SLBoneIndividual.h"
+#include "Individuals/Type/SLVirtualBoneIndividual.h"
+
+/* Layout */
+// Clear the data
+void FSLWorldStateLayout::Reset()
+{
+	IndividualIds.Empty();
+	SkelIds.Empty();
+	SkelBoneNums.Empty();
+	BoneIndexes.Empty();
+}
+
+
+/* Snapshot */
+// Ctor
+FSLWorldStateSnapshot::FSLWorldStateSnapshot()
+{
+}
+
+// Cache the individuals and build the layout
+bool FSLWorldStateSnapshot::Init(ASLIndividualManager* IndividualManager)
+{
+	Layout.Reset();
+	Individuals.Empty();
+	SkelSlots.Empty();
+	BoneSlots.Empty();
+	SkelIndividuals.Empty();
+
+	if (IndividualManager == nullptr || !IndividualManager->ThreadSafeToRead())
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Individual manager is not valid or its containers are being modified.."),
+			*FString(__FUNCTION__), __LINE__);
+		return false;
+	}
+
+	// Individuals
+	Individuals = IndividualManager->GetIndividuals();
+	TMap<USLBaseIndividual*, int32> IndividualToIdx;
+	IndividualToIdx.Reserve(Individuals.Num());
+	Layout.IndividualIds.SetNum(Individuals.Num());
+	for (int32 Idx = 0; Idx < Individuals.Num(); ++Idx)
+	{
+		IndividualToIdx.Add(Individuals[Idx], Idx);
+		ToUTF8(Individuals[Idx]->GetIdValue(), Layout.IndividualIds[Idx]);
+	}
+	SkelSlots.Init(INDEX_NONE, Individuals.Num());
+	BoneSlots.Init(INDEX_NONE, Individuals.Num());
+
+	// Skeletal individuals and their bones
+	SkelIndividuals = IndividualManager->GetSkeletalIndividuals();
+	Layout.SkelIds.SetNum(SkelIndividuals.Num());
+	for (int32 SkelIdx = 0; SkelIdx < SkelIndividuals.Num(); ++SkelIdx)
+	{
+		USLSkeletalIndividual* SkelIndividual = SkelIndividuals[SkelIdx];
+		ToUTF8(SkelIndividual->GetIdValue(), Layout.SkelIds[SkelIdx]);
+		if (int32* Idx = IndividualToIdx.Find(SkelIndividual))
+		{
+			SkelSlots[*Idx] = SkelIdx;
+		}
+		else
+		{
+			UE_LOG(LogTemp, Warning, TEXT("%s::%d %s is not part of the individuals array, its pose will not be updated.."),
+				*FString(__FUNCTION__), __LINE__, *SkelIndividual->GetFullName());
+		}
+
+		// Bones are written in the skeletal individual order, first the visible then the virtual ones
+		auto AddBone = [&](USLBaseIndividual* Bone, int32 BoneIndex)
+		{
+			const int32 BoneSlot = Layout.BoneIndexes.Add(BoneIndex);
+			if (int32* Idx = IndividualToIdx.Find(Bone))
+			{
+				BoneSlots[*Idx] = BoneSlot;
+			}
+		};
+		for (const auto& BI : SkelIndividual->GetBoneIndividuals())
+		{
+			AddBone(BI, BI->GetBoneIndex());
+		}
+		for (const auto& VBI : SkelIndividual->GetVirtualBoneIndividuals())
+		{
+			AddBone(VBI, VBI->GetBoneIndex());
+		}
+		Layout.SkelBoneNums.Add(SkelIndividual->GetBoneIndividuals().Num() + SkelIndividual->GetVirtualBoneIndividuals().Num());
+	}
+	return true;
+}
+
+// Copy the poses of the moved (or all) individuals and the poses of all skeletal bones (with their moved flags) into the frame
+void FSLWorldStateSnapshot::Snapshot(FSLWorldStateFrame& Frame, float Timestamp, float Tolerance, bool bWriteAllIndividuals)
+{
+	Frame.Reset();
+	Frame.Timestamp = Timestamp;
+	Frame.SkelLocations.SetNumUninitialized(Layout.SkelIds.Num());
+	Frame.SkelRotations.SetNumUninitialized(Layout.SkelIds.Num());
+	Frame.BoneLocations.SetNumUninitialized(Layout.BoneIndexes.Num());
+	Frame.BoneRotations.SetNumUninitialized(Layout.BoneIndexes.Num());
+
+	// Bone poses are updated per skeleton (one read of the component space transforms), in the flattened layout order
+	int32 BoneSlot = 0;
+	for (int32 SkelIdx = 0; SkelIdx < SkelIndividuals.Num(); ++SkelIdx)
+	{
+		SkelIndividuals[SkelIdx]->UpdateCachedBonePoses(Tolerance, Frame.MovedBones);
+		auto CopyBonePose = [&](const USLBaseIndividual* Bone)
+		{
+			const FTransform& Pose = Bone->GetCachedPose();
+			Frame.BoneLocations[BoneSlot] = Pose.GetLocation();
+			Frame.BoneRotations[BoneSlot] = Pose.GetRotation();
+			BoneSlot++;
+		};
+		for (const auto& BI : SkelIndividuals[SkelIdx]->GetBoneIndividuals())
+		{
+			CopyBonePose(BI);
+		}
+		for (const auto& VBI : SkelIndividuals[SkelIdx]->GetVirtualBoneIndividuals())
+		{
+			CopyBonePose(VBI);
+		}
+	}
+
+	// Single pass over the individuals, skeletal poses are copied into their slots, bones are already up to date
+	for (int32 Idx = 0; Idx < Individuals.Num(); ++Idx)
+	{
+		USLBaseIndividual* Individual = Individuals[Idx];
+		bool bMoved;
+		if (BoneSlots[Idx] != INDEX_NONE)
+		{
+			bMoved = Frame.MovedBones[BoneSlots[Idx]];
+		}
+		else
+		{
+			bMoved = Individual->UpdateCachedPose(Tolerance);
+		}
+		const FTransform& Pose = Individual->GetCachedPose();
+		if (bMoved || bWriteAllIndividuals)
+		{
+			Frame.IndividualIndexes.Add(Idx);
+			Frame.IndividualLocations.Add(Pose.GetLocation());
+			Frame.IndividualRotations.Add(Pose.GetRotation());
+		}
+		if (SkelSlots[Idx] != INDEX_NONE)
+		{
+			Frame.SkelLocations[SkelSlots[Idx]] = Pose.GetLocation();
+			Frame.SkelRotations[SkelSlots[Idx]] = Pose.GetRotation();
+		}
+	}
+}
+
+// Convert the id to a null terminated utf8 buffer
+void FSLWorldStateSnapshot::ToUTF8(const FString& Id, TArray<ANSICHAR>& OutBuffer)
+{
+	FTCHARToUTF8 Converted(*Id);
+	OutBuffer.Reset(Converted.Length() + 1);
+	OutBuffer.Append(reinterpret_cast<const ANSICHAR*>(Converted.Get()), Converted.Length());
+	OutBuffer.Add('\0');
+}
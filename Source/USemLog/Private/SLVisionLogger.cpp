@@ -52,6 +52,9 @@ void USLVisionLogger::Init(const FString& InTaskId, const FString& InEpisodeId,
 	{
 		Resolution = Params.Resolution;
 
+		// Compress and save the images in the background
+		ImageWriter.Init(Params.ImageCodec);
+
 		// Save the folder name if the images are going to be stored locally as well
 		if(Params.bIncludeLocally)
 		{
@@ -170,6 +173,9 @@ void USLVisionLogger::Finish(bool bForced)
 {
 	if (!bIsFinished && (bIsInit || bIsStarted))
 	{
+		// Hand over the images in flight and log the timings
+		ImageWriter.Finish(TEXT("Vision logger"));
+
 		// Index the entries in the db
 		DBHandler.CreateIndexes();
 
@@ -291,32 +297,20 @@ void USLVisionLogger::ScreenshotCB(int32 SizeX, int32 SizeY, const TArray<FColor
 	// Terminal output with the log progress
 	PrintProgress();
 
-	// Compress image
-	TArray<uint8> CompressedBitmap;
+	// The bitmap is owned by the screenshot broadcaster, the writer takes over a copy of it
+	TArray<FColor> Image = Bitmap;
 
 	// If mask mode is currently active, restore the colors and get the entity data
 	if (ViewModes[CurrViewModeIdx] == ESLVisionViewMode::Mask)
 	{
-		// Remove const-ness from image (needed for restore the image masks from the rendered values to the original ones)
-		TArray<FColor>& BitmapRef = const_cast<TArray<FColor>&>(Bitmap);
-
 		// Get information from the mask image and restore any rendering artefacts to the original mask colors
-		MaskImgHandler.GetDataAndRestoreImage(BitmapRef, SizeX, SizeY, CurrViewData);
+		MaskImgHandler.GetDataAndRestoreImage(Image, SizeX, SizeY, CurrViewData);
 
-		// Compress the restored bitmap image
-		FImageUtils::CompressImageArray(SizeX, SizeY, BitmapRef, CompressedBitmap);
+		// Compress and save the restored bitmap image in the background
+		EnqueueImage(MoveTemp(Image), SizeX, SizeY);
 	
 		if (OverlapCalc)
 		{
-			// Check if the image should be saved locally as well
-			if (!SaveLocallyFolderName.IsEmpty())
-			{
-				SaveImageLocally(CompressedBitmap);
-			}
-
-			// Cache the image binary
-			CurrViewData.Images.Emplace(FSLVisionImageData(GetViewModeName(ViewModes[CurrViewModeIdx]), CompressedBitmap));
-
 			// Bind the screenshot callback for calculating overlaps
 			OverlapCalc->Start(&CurrViewData, CurrTimestamp, Episode.GetCurrIndex());
 
@@ -326,19 +320,10 @@ void USLVisionLogger::ScreenshotCB(int32 SizeX, int32 SizeY, const TArray<FColor
 	}
 	else
 	{
-		// Compress the original bitmap image
-		FImageUtils::CompressImageArray(SizeX, SizeY, Bitmap, CompressedBitmap);
-	}
-
-	// Check if the image should be saved locally as well
-	if(!SaveLocallyFolderName.IsEmpty())
-	{
-		SaveImageLocally(CompressedBitmap);
+		// Compress and save the original bitmap image in the background
+		EnqueueImage(MoveTemp(Image), SizeX, SizeY);
 	}
 
-	// Cache the image binary
-	CurrViewData.Images.Emplace(FSLVisionImageData(GetViewModeName(ViewModes[CurrViewModeIdx]), CompressedBitmap));
-
 	// Go to next frame/camera/view mode
 	if (NextStep())
 	{
@@ -403,7 +388,8 @@ bool USLVisionLogger::NextStep()
 		}
 		else
 		{
-			// Write vision frame data to the database
+			// Write vision frame data to the database (wait for the images of the frame to be compressed)
+			ImageWriter.Flush();
 			DBHandler.WriteFrame(CurrFrameData);
 
 			if (SetupNextEpisodeFrame())
@@ -934,13 +920,36 @@ void USLVisionLogger::QuitEditor()
 #endif // WITH_EDITOR
 }
 
-// Save the compressed screenshot image locally
-void USLVisionLogger::SaveImageLocally(const TArray<uint8>& CompressedBitmap)
+// Hand the image over to the writer, the compressed data is added to the current view when ready
+void USLVisionLogger::EnqueueImage(TArray<FColor>&& Bitmap, int32 SizeX, int32 SizeY)
+{
+	// Check if the image should be saved locally as well
+	TArray<FString> Paths;
+	if (!SaveLocallyFolderName.IsEmpty())
+	{
+		Paths.Emplace(GetLocalImagePath());
+	}
+
+	// Reserve the image entry, by the time the image is compressed the view might already be cached in the frame data
+	const int32 ViewIdx = CurrFrameData.Views.Num();
+	const int32 ImageIdx = CurrViewData.Images.Emplace(FSLVisionImageData(GetViewModeName(ViewModes[CurrViewModeIdx]), TArray<uint8>()));
+	ImageWriter.Enqueue(MoveTemp(Bitmap), SizeX, SizeY, MoveTemp(Paths), [this, ViewIdx, ImageIdx](TArray<uint8>&& CompressedBitmap)
+	{
+		FSLVisionViewData& View = CurrFrameData.Views.IsValidIndex(ViewIdx) ? CurrFrameData.Views[ViewIdx] : CurrViewData;
+		if (View.Images.IsValidIndex(ImageIdx))
+		{
+			View.Images[ImageIdx].Data = MoveTemp(CompressedBitmap);
+		}
+	});
+}
+
+// Get the path where to save the compressed screenshot image locally
+FString USLVisionLogger::GetLocalImagePath() const
 {
 	const FString FolderName = VirtualCameras[CurrVirtualCameraIdx]->GetClassName() + "_" + CurrViewModePostfix;
-	FString Path = FPaths::ProjectDir() + "/SemLog/" + SaveLocallyFolderName + "/" + FolderName + "/" + CurrImageFilename + ".png";
+	FString Path = FPaths::ProjectDir() + "/SemLog/" + SaveLocallyFolderName + "/" + FolderName + "/" + CurrImageFilename + ImageWriter.GetFileExtension();
 	FPaths::RemoveDuplicateSlashes(Path);
-	FFileHelper::SaveArrayToFile(CompressedBitmap, *Path);
+	return Path;
 }
 
 // Output progress to terminal
@@ -0,0 +1,186 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "Owl/SLOwlWriter.h"
+#include "Owl/SLOwlDoc.h"
+#include "Misc/AutomationTest.h"
+#include "Serialization/MemoryWriter.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSLOwlWriterEquivalenceTest, "USemLog.Owl.Writer.Equivalence",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+// Reference node conversion, the recursive per-node string implementation the writer replaced
+static FString SLOwlLegacyNodeToString(const FSLOwlNode& Node, FString& Indent)
+{
+	FString NodeStr;
+	// Add comment
+	if (!Node.Comment.IsEmpty())
+	{
+		NodeStr += TEXT("\n") + Indent + TEXT("<!-- ") + Node.Comment + TEXT(" -->\n");
+	}
+
+	// Comment only OR empty node
+	if (Node.Name.ToString().IsEmpty())
+	{
+		return NodeStr;
+	}
+
+	// Add node name
+	NodeStr += Indent + TEXT("<") + Node.Name.ToString();
+
+	// Add attributes to tag
+	for (int32 i = 0; i < Node.Attributes.Num(); ++i)
+	{
+		if (Node.Attributes.Num() == 1)
+		{
+			NodeStr += TEXT(" ") + Node.Attributes[i].ToString();
+		}
+		else
+		{
+			if (i < (Node.Attributes.Num() - 1))
+			{
+				NodeStr += TEXT(" ") + Node.Attributes[i].ToString() + TEXT("\n") + Indent + INDENT_STEP;
+			}
+			else
+			{
+				// Last attribute does not have new line
+				NodeStr += TEXT(" ") + Node.Attributes[i].ToString();
+			}
+		}
+	}
+
+	// Check node data (children/value)
+	bool bHasChildren = Node.ChildNodes.Num() != 0;
+	bool bHasValue = !Node.Value.IsEmpty();
+
+	// Node cannot have value and children
+	if (!bHasChildren && !bHasValue)
+	{
+		NodeStr += TEXT("/>\n");
+	}
+	else if (bHasValue)
+	{
+		NodeStr += TEXT(">") + Node.Value + TEXT("</") + Node.Name.ToString() + TEXT(">\n");
+	}
+	else if (bHasChildren)
+	{
+		NodeStr += TEXT(">\n");
+		Indent += INDENT_STEP;
+		for (auto& ChildItr : Node.ChildNodes)
+		{
+			NodeStr += SLOwlLegacyNodeToString(ChildItr, Indent);
+		}
+		Indent.RemoveFromEnd(INDENT_STEP);
+		NodeStr += Indent + Node.Value + TEXT("</") + Node.Name.ToString() + TEXT(">\n");
+	}
+	return NodeStr;
+}
+
+// Reference document conversion, copies the nodes into a root node and converts it
+static FString SLOwlLegacyDocToString(const FSLOwlDoc& Doc)
+{
+	FString Indent = "";
+	FString DocStr = TEXT("<?xml version=\"1.0\" encoding=\"utf-8\"?>\n\n");
+	DocStr += Doc.EntityDefinitions.ToString();
+	FSLOwlNode Root(FSLOwlPrefixName("rdf", "RDF"), Doc.Namespaces);
+	Root.AddChildNode(Doc.OntologyImports);
+	Root.AddChildNodes(Doc.PropertyDefinitions);
+	Root.AddChildNodes(Doc.DatatypeDefinitions);
+	Root.AddChildNodes(Doc.ClassDefinitions);
+	Root.AddChildNodes(Doc.Individuals);
+	DocStr += SLOwlLegacyNodeToString(Root, Indent);
+	return DocStr;
+}
+
+// Create a document with every node layout (comments, comment only, multiple attributes, values, nesting)
+static void SLOwlMakeTestDoc(FSLOwlDoc& OutDoc, const FString& ValueSuffix)
+{
+	OutDoc = FSLOwlDoc(TEXT("log"), TEXT("UE-Experiment"), TEXT("TestDocId"));
+	OutDoc.AddEntityDefintion(TEXT("rdf"), TEXT("http://www.w3.org/1999/02/22-rdf-syntax-ns#"));
+	OutDoc.AddEntityDefintion(TEXT("owl"), TEXT("http://www.w3.org/2002/07/owl#"));
+	OutDoc.AddEntityDefintion(TEXT("log"), TEXT("http://knowrob.org/kb/UE-Experiment.owl#"));
+	OutDoc.AddNamespaceDeclaration(TEXT("xmlns"), FString(), TEXT("http://knowrob.org/kb/UE-Experiment.owl#"));
+	OutDoc.AddNamespaceDeclaration(TEXT("xmlns"), TEXT("rdf"), TEXT("http://www.w3.org/1999/02/22-rdf-syntax-ns#"));
+	OutDoc.AddNamespaceDeclaration(TEXT("xmlns"), TEXT("owl"), TEXT("http://www.w3.org/2002/07/owl#"));
+	OutDoc.CreateOntologyNode();
+	OutDoc.AddOntologyImport(TEXT("package://knowrob_common/owl/knowrob.owl"));
+	OutDoc.AddPropertyDefinition(TEXT("knowrob"), TEXT("startTime"));
+	OutDoc.AddDatatypeDefinition(TEXT("knowrob"), TEXT("quaternion"));
+	OutDoc.AddClassDefinition(TEXT("knowrob"), TEXT("TouchingSituation"));
+
+	const FSLOwlPrefixName RdfAbout("rdf", "about");
+	const FSLOwlPrefixName RdfType("rdf", "type");
+	const FSLOwlPrefixName RdfResource("rdf", "resource");
+	const FSLOwlPrefixName RdfDatatype("rdf", "datatype");
+	const FSLOwlPrefixName OwlNI("owl", "NamedIndividual");
+	const FSLOwlPrefixName KbQuat("knowrob", "quaternion");
+	const FSLOwlPrefixName KbTime("knowrob", "startTime");
+
+	for (int32 Idx = 0; Idx < 200; ++Idx)
+	{
+		const FString Id = FString::Printf(TEXT("Id%03d"), Idx);
+		FSLOwlNode Individual(OwlNI, FSLOwlAttribute(RdfAbout, FSLOwlAttributeValue(TEXT("log"), Id)));
+		Individual.SetComment(TEXT("Individual ") + Id);
+		Individual.AddChildNode(FSLOwlNode(RdfType, FSLOwlAttribute(RdfResource, FSLOwlAttributeValue(TEXT("knowrob"), TEXT("Cup")))));
+
+		TArray<FSLOwlAttribute> Attributes;
+		Attributes.Add(FSLOwlAttribute(RdfDatatype, FSLOwlAttributeValue(TEXT("xsd"), TEXT("string"))));
+		Attributes.Add(FSLOwlAttribute(RdfResource, FSLOwlAttributeValue(TEXT("Unprefixed"))));
+		Attributes.Add(FSLOwlAttribute(FSLOwlPrefixName(TEXT("id")), FSLOwlAttributeValue(Id)));
+		Individual.AddChildNode(FSLOwlNode(KbQuat, Attributes, FString::Printf(TEXT("0.%d 0 0 1"), Idx) + ValueSuffix));
+
+		// Nested nodes, an empty node, and a comment only node
+		FSLOwlNode Nested(KbTime);
+		Nested.AddChildNode(FSLOwlNode(KbTime, FSLOwlAttribute(RdfResource, FSLOwlAttributeValue(TEXT("log"), TEXT("Time_") + Id))));
+		Nested.AddChildNode(FSLOwlNode(FSLOwlPrefixName(TEXT("empty"))));
+		FSLOwlNode CommentOnly;
+		CommentOnly.SetComment(TEXT("Comment only"));
+		Nested.AddChildNode(CommentOnly);
+		Individual.AddChildNode(Nested);
+
+		OutDoc.AddIndividual(Individual);
+	}
+}
+
+// Compare the writer with the recursive string conversion, the documents need to be byte-for-byte identical
+bool FSLOwlWriterEquivalenceTest::RunTest(const FString& Parameters)
+{
+	// Ascii values, and values with non-ascii chars (written as utf-8 by the archive output)
+	const FString ValueSuffixes[] = { FString(), FString(TEXT("\u00E4\u00DF\u20AC")) };
+	for (const FString& ValueSuffix : ValueSuffixes)
+	{
+		FSLOwlDoc Doc;
+		SLOwlMakeTestDoc(Doc, ValueSuffix);
+		const FString Ctx = ValueSuffix.IsEmpty() ? TEXT("ascii") : TEXT("non-ascii");
+
+		// String output
+		const FString LegacyStr = SLOwlLegacyDocToString(Doc);
+		TestTrue(Ctx + TEXT(" doc string"), Doc.ToString().Equals(LegacyStr, ESearchCase::CaseSensitive));
+
+		// Node string output with a non empty start indentation
+		FString LegacyIndent = INDENT_STEP;
+		FString NodeIndent = INDENT_STEP;
+		TestTrue(Ctx + TEXT(" node string"), Doc.Individuals[0].ToString(NodeIndent).Equals(
+			SLOwlLegacyNodeToString(Doc.Individuals[0], LegacyIndent), ESearchCase::CaseSensitive));
+		TestTrue(Ctx + TEXT(" node indent restored"), NodeIndent.Equals(LegacyIndent, ESearchCase::CaseSensitive));
+
+		// Archive output with the smallest block size (several flushes), compared against the utf-8 legacy string
+		TArray<uint8> Bytes;
+		{
+			FMemoryWriter MemWriter(Bytes);
+			FSLOwlWriter Writer(MemWriter, 1024);
+			Writer.WriteDoc(Doc);
+			Writer.Flush();
+			TestEqual(Ctx + TEXT(" num written"), Writer.GetNumWritten(), (int64)Bytes.Num());
+		}
+		FTCHARToUTF8 LegacyUtf8(*LegacyStr, LegacyStr.Len());
+		TestEqual(Ctx + TEXT(" archive size"), Bytes.Num(), LegacyUtf8.Length());
+		TestTrue(Ctx + TEXT(" archive bytes"), Bytes.Num() == LegacyUtf8.Length()
+			&& FMemory::Memcmp(Bytes.GetData(), LegacyUtf8.Get(), Bytes.Num()) == 0);
+	}
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,254 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "Vision/SLVisionMaskImageHandler.h"
+#include "Misc/AutomationTest.h"
+#include "Math/RandomStream.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSLVisionMaskImageHandlerEquivalenceTest, "USemLog.Vision.MaskImageHandler.Equivalence",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+// Reference restore, the per pixel sequential implementation the stripe decoder replaced
+static void SLMaskLegacyGetDataAndRestoreImage(const TMap<FColor, FSLVisionMaskEntityInfo>& RenderedColorToEntityInfo,
+	const TMap<FColor, FSLVisionMaskSkelInfo>& RenderedColorToSkelInfo,
+	TArray<FColor>& MaskBitmapToRestore, int32 ImgWidth, int32 ImgHeight, FSLVisionViewData& OutViewData)
+{
+	// Used to calculate the percentage of an entity in the image
+	const int64 ImgTotalPixels = ImgWidth * ImgHeight;
+
+	// Index position of the image matrix in rows and columns (used for storing the bounding box of the entities)
+	int32 RowIdx = 0;
+	int32 ColIdx = 0;
+
+	// Store the occurance of every color in the image to its data
+	TMap<FColor, FSLVisionImageColorInfo> TempRenderedColorsData;
+
+	// Restore image colors and create a mapping of all the rendered pixel colors to its data
+	for (auto& PixelColor : MaskBitmapToRestore)
+	{
+		// Ignore color black (represents semantically unknown areas, normally there should not be any
+		if (PixelColor != FColor::Black)
+		{
+			// Check if the color is new
+			if (FSLVisionImageColorInfo* ColorData = TempRenderedColorsData.Find(PixelColor))
+			{
+				// Color already stored, update its data
+				(*ColorData).Num++;
+
+				// Update the bounding box in the image
+				if (RowIdx < (*ColorData).MinBB.Y)
+				{
+					(*ColorData).MinBB.Y = RowIdx;
+				}
+				if (RowIdx > (*ColorData).MaxBB.Y)
+				{
+					(*ColorData).MaxBB.Y = RowIdx;
+				}
+				if (ColIdx < (*ColorData).MinBB.X)
+				{
+					(*ColorData).MinBB.X = ColIdx;
+				}
+				if (ColIdx > (*ColorData).MaxBB.X)
+				{
+					(*ColorData).MaxBB.X = ColIdx;
+				}
+
+				// Fix image by changing the rendered color to the original value
+				PixelColor = (*ColorData).OriginalMaskColor;
+			}
+			else
+			{
+				// Cache rendered color, since the pixel color will be restored to the original mask (if found)
+				const FColor RenderedColor = PixelColor;
+
+				// New color, cache its info
+				FSLVisionImageColorInfo ColorInfo(1, FIntPoint(ImgWidth, ImgHeight), FIntPoint(0, 0));
+
+				// Get the original mask color value
+				if (const FSLVisionMaskEntityInfo* EntityInfo = RenderedColorToEntityInfo.Find(RenderedColor))
+				{
+					ColorInfo.OriginalMaskColor = FColor::FromHex((*EntityInfo).OrigMaskColor);
+					TempRenderedColorsData.Emplace(RenderedColor, ColorInfo);
+					PixelColor = ColorInfo.OriginalMaskColor;
+				}
+				else if (const FSLVisionMaskSkelInfo* SkelInfo = RenderedColorToSkelInfo.Find(RenderedColor))
+				{
+					ColorInfo.OriginalMaskColor = FColor::FromHex((*SkelInfo).OrigMaskColor);
+					TempRenderedColorsData.Emplace(RenderedColor, ColorInfo);
+					PixelColor = ColorInfo.OriginalMaskColor;
+				}
+			}
+		}
+
+		// Update current pixel index position
+		ColIdx++;
+
+		// Check for row change
+		if (ColIdx > ImgWidth - 1)
+		{
+			ColIdx = 0;
+			RowIdx++;
+		}
+	}
+
+	// Store skeletal related data in a temp map, this will need an extra processing to calculcate the data as a whole skeleton (from bones)
+	TMap<FString, FSLVisionViewSkelData> TempIdToSkelData;
+
+	// Iterate the collected data from the image
+	for (const auto& Pair : TempRenderedColorsData)
+	{
+		if (const FSLVisionMaskEntityInfo* EntityInfo = RenderedColorToEntityInfo.Find(Pair.Key))
+		{
+			FSLVisionViewEntityData EntityData(EntityInfo->Id, EntityInfo->Class, Pair.Value.MinBB, Pair.Value.MaxBB);
+			EntityData.ImagePercentage = (float) Pair.Value.Num / ImgTotalPixels;
+			OutViewData.Entities.Emplace(EntityData);
+		}
+		else if (const FSLVisionMaskSkelInfo* SkelInfo = RenderedColorToSkelInfo.Find(Pair.Key))
+		{
+			FSLVisionViewSkelBoneData BoneData(SkelInfo->BoneClass, Pair.Value.MinBB, Pair.Value.MaxBB);
+			BoneData.ImagePercentage = (float) Pair.Value.Num / ImgTotalPixels;
+			if (FSLVisionViewSkelData* SkelData = TempIdToSkelData.Find(SkelInfo->Id))
+			{
+				SkelData->Bones.Emplace(BoneData);
+			}
+			else
+			{
+				FSLVisionViewSkelData NewSkelData(SkelInfo->Id, SkelInfo->Class);
+				NewSkelData.Bones.Emplace(BoneData);
+				TempIdToSkelData.Emplace(SkelInfo->Id, NewSkelData);
+			}
+		}
+	}
+
+	// Add the skeletal data from the bones
+	for (auto& Pair : TempIdToSkelData)
+	{
+		Pair.Value.CalculateParamsFromBones();
+		OutViewData.SkelEntities.Emplace(Pair.Value);
+	}
+}
+
+// Fill the image with overlapping rectangles and scattered pixels of the given colors (black included)
+static void SLMaskMakeTestImage(const TArray<FColor>& Colors, int32 ImgWidth, int32 ImgHeight, int32 Seed, TArray<FColor>& OutBitmap)
+{
+	FRandomStream Rand(Seed);
+	OutBitmap.Init(FColor::Black, ImgWidth * ImgHeight);
+
+	const int32 NumRects = 4 + ImgWidth * ImgHeight / 2000;
+	for (int32 RectIdx = 0; RectIdx < NumRects; ++RectIdx)
+	{
+		const FColor& Color = Colors[Rand.RandRange(0, Colors.Num() - 1)];
+		const int32 X0 = Rand.RandRange(0, ImgWidth - 1);
+		const int32 Y0 = Rand.RandRange(0, ImgHeight - 1);
+		const int32 X1 = FMath::Min(ImgWidth - 1, X0 + Rand.RandRange(0, ImgWidth / 3));
+		const int32 Y1 = FMath::Min(ImgHeight - 1, Y0 + Rand.RandRange(0, ImgHeight / 3));
+		for (int32 Y = Y0; Y <= Y1; ++Y)
+		{
+			for (int32 X = X0; X <= X1; ++X)
+			{
+				OutBitmap[Y * ImgWidth + X] = Color;
+			}
+		}
+	}
+
+	const int32 NumScattered = ImgWidth * ImgHeight / 50;
+	for (int32 PixelIdx = 0; PixelIdx < NumScattered; ++PixelIdx)
+	{
+		OutBitmap[Rand.RandRange(0, OutBitmap.Num() - 1)] = Colors[Rand.RandRange(0, Colors.Num() - 1)];
+	}
+}
+
+// Compare the stripe decoder with the sequential restore, the restored masks need to be bit-identical
+bool FSLVisionMaskImageHandlerEquivalenceTest::RunTest(const FString& Parameters)
+{
+	FSLVisionMaskImageHandler Handler;
+
+	// Rendered colors are offseted from the original mask colors, as in the screenshots
+	TArray<FColor> Colors;
+	Colors.Add(FColor::Black);
+	for (int32 Idx = 0; Idx < 16; ++Idx)
+	{
+		const FColor OrigColor((uint8)(16 + Idx * 14), (uint8)(200 - Idx * 9), (uint8)(40 + Idx * 11));
+		const FColor RenderedColor((uint8)(OrigColor.R + 2), (uint8)(OrigColor.G - 1), (uint8)(OrigColor.B + 3));
+		Handler.RenderedColorToEntityInfo.Emplace(RenderedColor,
+			FSLVisionMaskEntityInfo(TEXT("TestClass") + FString::FromInt(Idx), TEXT("TestId") + FString::FromInt(Idx), OrigColor.ToHex()));
+		Colors.Add(RenderedColor);
+	}
+	for (int32 Idx = 0; Idx < 8; ++Idx)
+	{
+		const FColor OrigColor((uint8)(240 - Idx * 13), (uint8)(30 + Idx * 17), (uint8)(220 - Idx * 5));
+		const FColor RenderedColor((uint8)(OrigColor.R - 3), (uint8)(OrigColor.G + 1), (uint8)(OrigColor.B - 2));
+		Handler.RenderedColorToSkelInfo.Emplace(RenderedColor,
+			FSLVisionMaskSkelInfo(TEXT("TestSkel"), TEXT("TestSkelId") + FString::FromInt(Idx % 2), TEXT("TestBone") + FString::FromInt(Idx), OrigColor.ToHex()));
+		Colors.Add(RenderedColor);
+	}
+	// Rendered color without any mapping, left as it is by both paths
+	Colors.Add(FColor(1, 2, 3));
+	Handler.bIsInit = true;
+
+	// Single stripe, multiple stripes, and stripes with a remainder
+	const FIntPoint Resolutions[] = { FIntPoint(17, 9), FIntPoint(640, 480), FIntPoint(1023, 257), FIntPoint(1, 300) };
+	int32 Seed = 0;
+	for (const FIntPoint& Res : Resolutions)
+	{
+		TArray<FColor> LegacyBitmap;
+		SLMaskMakeTestImage(Colors, Res.X, Res.Y, ++Seed, LegacyBitmap);
+
+		// A color present only as the last pixel keeps its initial bounding box
+		LegacyBitmap.Last() = Colors[1];
+		TArray<FColor> StripeBitmap = LegacyBitmap;
+
+		FSLVisionViewData LegacyData;
+		SLMaskLegacyGetDataAndRestoreImage(Handler.RenderedColorToEntityInfo, Handler.RenderedColorToSkelInfo,
+			LegacyBitmap, Res.X, Res.Y, LegacyData);
+		FSLVisionViewData StripeData;
+		Handler.GetDataAndRestoreImage(StripeBitmap, Res.X, Res.Y, StripeData);
+
+		const FString Ctx = FString::Printf(TEXT("%dx%d"), Res.X, Res.Y);
+		TestTrue(Ctx + TEXT(" restored mask"), FMemory::Memcmp(LegacyBitmap.GetData(), StripeBitmap.GetData(), LegacyBitmap.Num() * sizeof(FColor)) == 0);
+
+		TestEqual(Ctx + TEXT(" num entities"), StripeData.Entities.Num(), LegacyData.Entities.Num());
+		if (StripeData.Entities.Num() == LegacyData.Entities.Num())
+		{
+			for (int32 Idx = 0; Idx < LegacyData.Entities.Num(); ++Idx)
+			{
+				const FSLVisionViewEntityData& L = LegacyData.Entities[Idx];
+				const FSLVisionViewEntityData& S = StripeData.Entities[Idx];
+				TestEqual(Ctx + TEXT(" entity id"), S.Id, L.Id);
+				TestTrue(Ctx + TEXT(" entity min bb"), S.MinBB == L.MinBB);
+				TestTrue(Ctx + TEXT(" entity max bb"), S.MaxBB == L.MaxBB);
+				TestEqual(Ctx + TEXT(" entity percentage"), S.ImagePercentage, L.ImagePercentage, 0.f);
+			}
+		}
+
+		TestEqual(Ctx + TEXT(" num skel entities"), StripeData.SkelEntities.Num(), LegacyData.SkelEntities.Num());
+		if (StripeData.SkelEntities.Num() == LegacyData.SkelEntities.Num())
+		{
+			for (int32 Idx = 0; Idx < LegacyData.SkelEntities.Num(); ++Idx)
+			{
+				const FSLVisionViewSkelData& L = LegacyData.SkelEntities[Idx];
+				const FSLVisionViewSkelData& S = StripeData.SkelEntities[Idx];
+				TestEqual(Ctx + TEXT(" skel id"), S.Id, L.Id);
+				TestTrue(Ctx + TEXT(" skel min bb"), S.MinBB == L.MinBB);
+				TestTrue(Ctx + TEXT(" skel max bb"), S.MaxBB == L.MaxBB);
+				TestEqual(Ctx + TEXT(" skel percentage"), S.ImagePercentage, L.ImagePercentage, 0.f);
+				TestEqual(Ctx + TEXT(" num bones"), S.Bones.Num(), L.Bones.Num());
+				if (S.Bones.Num() == L.Bones.Num())
+				{
+					for (int32 BoneIdx = 0; BoneIdx < L.Bones.Num(); ++BoneIdx)
+					{
+						TestEqual(Ctx + TEXT(" bone class"), S.Bones[BoneIdx].Class, L.Bones[BoneIdx].Class);
+						TestTrue(Ctx + TEXT(" bone min bb"), S.Bones[BoneIdx].MinBB == L.Bones[BoneIdx].MinBB);
+						TestTrue(Ctx + TEXT(" bone max bb"), S.Bones[BoneIdx].MaxBB == L.Bones[BoneIdx].MaxBB);
+						TestEqual(Ctx + TEXT(" bone percentage"), S.Bones[BoneIdx].ImagePercentage, L.Bones[BoneIdx].ImagePercentage, 0.f);
+					}
+				}
+			}
+		}
+	}
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
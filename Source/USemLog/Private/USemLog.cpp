@@ -2,6 +2,7 @@
 // Author: Andrei Haidu (http://haidu.eu)
 
 #include "USemLog.h"
+#include "Mongo/SLMongoQueryDBHandler.h"
 
 // Define logging types
 DEFINE_LOG_CATEGORY(LogSL);
@@ -11,12 +12,20 @@ DEFINE_LOG_CATEGORY(LogSL);
 void FUSemLog::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
+#if SL_WITH_LIBMONGO_C
+	// Initialize libmongoc's internals once for all the db handlers (not thread safe, must not run per handler)
+	mongoc_init();
+#endif //SL_WITH_LIBMONGO_C
 }
 
 void FUSemLog::ShutdownModule()
 {
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
+#if SL_WITH_LIBMONGO_C
+	FSLMongoQueryDBHandler::DestroyClientPools();
+	mongoc_cleanup();
+#endif //SL_WITH_LIBMONGO_C
 }
 
 #undef LOCTEXT_NAMESPACE
@@ -0,0 +1,210 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "Utils/SLImageWriter.h"
+#include "IImageWrapper.h"
+#include "IImageWrapperModule.h"
+#include "Modules/ModuleManager.h"
+#include "Misc/FileHelper.h"
+
+// Ctor
+FSLImageEncodeAsyncTask::FSLImageEncodeAsyncTask(IImageWrapperModule* InImageWrapperModule, ESLImageCodec InCodec, int32 InQuality,
+	TArray<FColor>&& InBitmap, int32 InSizeX, int32 InSizeY, TArray<FString>&& InPaths) :
+	EncodeSeconds(0.0),
+	IOSeconds(0.0),
+	ImageWrapperModule(InImageWrapperModule),
+	Codec(InCodec),
+	Quality(InQuality),
+	Bitmap(MoveTemp(InBitmap)),
+	SizeX(InSizeX),
+	SizeY(InSizeY),
+	Paths(MoveTemp(InPaths))
+{
+}
+
+// Compress and write the image
+void FSLImageEncodeAsyncTask::DoWork()
+{
+	const double EncodeStart = FPlatformTime::Seconds();
+	if (Bitmap.Num() != SizeX * SizeY)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Bitmap size (%d) does not match the resolution %dx%d, skipping.."),
+			*FString(__func__), __LINE__, Bitmap.Num(), SizeX, SizeY);
+		return;
+	}
+
+	const EImageFormat Format = Codec == ESLImageCodec::JPEG ? EImageFormat::JPEG : EImageFormat::PNG;
+	TSharedPtr<IImageWrapper> ImageWrapper = ImageWrapperModule->CreateImageWrapper(Format);
+	if (!ImageWrapper.IsValid())
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not create the image compressor, skipping.."), *FString(__func__), __LINE__);
+		return;
+	}
+
+	// FColor is stored as BGRA, the jpeg compressor expects RGBA
+	ERGBFormat RawFormat = ERGBFormat::BGRA;
+	if (Codec == ESLImageCodec::JPEG)
+	{
+		for (FColor& C : Bitmap)
+		{
+			Swap(C.R, C.B);
+		}
+		RawFormat = ERGBFormat::RGBA;
+	}
+
+	if (ImageWrapper->SetRaw(Bitmap.GetData(), Bitmap.Num() * sizeof(FColor), SizeX, SizeY, RawFormat, 8))
+	{
+		CompressedData = TArray<uint8>(ImageWrapper->GetCompressed(Quality));
+	}
+
+	// Release the raw image before writing (bounds the memory of the images waiting to be handed over)
+	Bitmap.Empty();
+	EncodeSeconds = FPlatformTime::Seconds() - EncodeStart;
+
+	const double IOStart = FPlatformTime::Seconds();
+	for (const FString& Path : Paths)
+	{
+		if (!FFileHelper::SaveArrayToFile(CompressedData, *Path))
+		{
+			UE_LOG(LogTemp, Error, TEXT("%s::%d Could not write %s.."), *FString(__func__), __LINE__, *Path);
+		}
+	}
+	IOSeconds = FPlatformTime::Seconds() - IOStart;
+}
+
+
+// Ctor
+FSLImageWriter::FSLImageWriter()
+{
+	bIsInit = false;
+	ImageWrapperModule = nullptr;
+	Codec = ESLImageCodec::PNG;
+	Quality = 90;
+	MaxNumInFlight = 4;
+	LastEnqueueTime = -1.0;
+	NumImages = 0;
+	TotalRenderSeconds = 0.0;
+	TotalEncodeSeconds = 0.0;
+	TotalIOSeconds = 0.0;
+	TotalWaitSeconds = 0.0;
+}
+
+// Dtor
+FSLImageWriter::~FSLImageWriter()
+{
+	// Wait for the tasks, the callbacks might reference destroyed owners, skip them
+	for (FSLImageWriterJob& Job : Jobs)
+	{
+		Job.Task->EnsureCompletion(false);
+		delete Job.Task;
+	}
+	Jobs.Empty();
+}
+
+// Load the compressors and set the format (game thread)
+bool FSLImageWriter::Init(ESLImageCodec InCodec, int32 InMaxNumInFlight, int32 InQuality)
+{
+	// The module can only be loaded from the game thread, the tasks use the cached pointer
+	ImageWrapperModule = &FModuleManager::LoadModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
+	Codec = InCodec;
+	Quality = FMath::Clamp(InQuality, 1, 100);
+	MaxNumInFlight = FMath::Max(InMaxNumInFlight, 1);
+	LastEnqueueTime = -1.0;
+	bIsInit = ImageWrapperModule != nullptr;
+	return bIsInit;
+}
+
+// Compress and write the bitmap asynchronously (takes ownership), OnCompressed is called on the game thread
+void FSLImageWriter::Enqueue(TArray<FColor>&& Bitmap, int32 SizeX, int32 SizeY, TArray<FString>&& Paths,
+	TFunction<void(TArray<uint8>&&)> OnCompressed)
+{
+	if (!bIsInit)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Image writer is not initialized, skipping image.."), *FString(__func__), __LINE__);
+		return;
+	}
+
+	const double EnqueueStart = FPlatformTime::Seconds();
+	if (LastEnqueueTime > 0.0)
+	{
+		TotalRenderSeconds += EnqueueStart - LastEnqueueTime;
+	}
+
+	// Hand over what is already done, wait for the oldest if there are too many images in flight
+	ProcessCompleted();
+	while (Jobs.Num() >= MaxNumInFlight)
+	{
+		CompleteOldest();
+	}
+
+	FSLImageWriterJob Job;
+	Job.Task = new FAsyncTask<FSLImageEncodeAsyncTask>(ImageWrapperModule, Codec, Quality,
+		MoveTemp(Bitmap), SizeX, SizeY, MoveTemp(Paths));
+	Job.OnCompressed = MoveTemp(OnCompressed);
+	Job.Task->StartBackgroundTask();
+	Jobs.Emplace(MoveTemp(Job));
+
+	LastEnqueueTime = FPlatformTime::Seconds();
+	TotalWaitSeconds += LastEnqueueTime - EnqueueStart;
+}
+
+// Hand over the finished images in order (stops at the first unfinished one)
+int32 FSLImageWriter::ProcessCompleted()
+{
+	int32 NumProcessed = 0;
+	while (Jobs.Num() > 0 && Jobs[0].Task->IsDone())
+	{
+		CompleteOldest();
+		NumProcessed++;
+	}
+	return NumProcessed;
+}
+
+// Wait for all the images in flight and hand them over
+void FSLImageWriter::Flush()
+{
+	const double FlushStart = FPlatformTime::Seconds();
+	while (Jobs.Num() > 0)
+	{
+		CompleteOldest();
+	}
+	TotalWaitSeconds += FPlatformTime::Seconds() - FlushStart;
+}
+
+// Flush and log the stats
+void FSLImageWriter::Finish(const FString& Prefix)
+{
+	Flush();
+	if (NumImages > 0)
+	{
+		UE_LOG(LogTemp, Log, TEXT("%s::%d %s images=%d; avg render=[%f], encode=[%f], io=[%f], game thread wait=[%f] seconds..;"),
+			*FString(__func__), __LINE__, *Prefix, NumImages,
+			TotalRenderSeconds / NumImages, TotalEncodeSeconds / NumImages,
+			TotalIOSeconds / NumImages, TotalWaitSeconds / NumImages);
+	}
+	LastEnqueueTime = -1.0;
+}
+
+// File extension of the compressed images (including the dot)
+FString FSLImageWriter::GetFileExtension() const
+{
+	return Codec == ESLImageCodec::JPEG ? TEXT(".jpg") : TEXT(".png");
+}
+
+// Remove the oldest image from the queue and call its callback
+void FSLImageWriter::CompleteOldest()
+{
+	FSLImageWriterJob Job = MoveTemp(Jobs[0]);
+	Jobs.RemoveAt(0, 1, false);
+
+	Job.Task->EnsureCompletion();
+	FSLImageEncodeAsyncTask& Task = Job.Task->GetTask();
+	TotalEncodeSeconds += Task.EncodeSeconds;
+	TotalIOSeconds += Task.IOSeconds;
+	NumImages++;
+	if (Job.OnCompressed)
+	{
+		Job.OnCompressed(MoveTemp(Task.CompressedData));
+	}
+	delete Job.Task;
+}
@@ -0,0 +1,119 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "Utils/SLPoseCodec.h"
+
+// Range of the smallest three quaternion components is [-1/sqrt(2), 1/sqrt(2)]
+static constexpr float SLSqrt2 = 1.41421356237f;
+static constexpr float SLInvSqrt2 = 0.70710678118f;
+
+// Encode the pose into the buffer (at least MaxSize bytes), returns the number of written bytes
+int32 FSLPoseCodec::Encode(const FVector& Location, const FQuat& Rotation, bool bQuantized, float PositionResolution, uint8* OutData)
+{
+	if (bQuantized)
+	{
+		const double InvRes = 1.0 / FMath::Max(PositionResolution, KINDA_SMALL_NUMBER);
+		const int32 Loc[3] = {
+			(int32)FMath::Clamp<double>(FMath::RoundHalfFromZero(Location.X * InvRes), MIN_int32, MAX_int32),
+			(int32)FMath::Clamp<double>(FMath::RoundHalfFromZero(Location.Y * InvRes), MIN_int32, MAX_int32),
+			(int32)FMath::Clamp<double>(FMath::RoundHalfFromZero(Location.Z * InvRes), MIN_int32, MAX_int32) };
+		const uint32 Quat = (uint32)PackQuat(Rotation, 10);
+		FMemory::Memcpy(OutData, Loc, sizeof(Loc));
+		FMemory::Memcpy(OutData + sizeof(Loc), &Quat, sizeof(Quat));
+		return QuantizedSize;
+	}
+	else
+	{
+		const float Loc[3] = { (float)Location.X, (float)Location.Y, (float)Location.Z };
+		const uint64 Quat = PackQuat(Rotation, 20);
+		FMemory::Memcpy(OutData, Loc, sizeof(Loc));
+		FMemory::Memcpy(OutData + sizeof(Loc), &Quat, sizeof(Quat));
+		return Float32Size;
+	}
+}
+
+// Decode the pose, the encoding is deduced from the size (false if the size is not known)
+bool FSLPoseCodec::Decode(const uint8* Data, uint32 Size, float PositionResolution, FVector& OutLocation, FQuat& OutRotation)
+{
+	if (Size == QuantizedSize)
+	{
+		int32 Loc[3];
+		uint32 Quat;
+		FMemory::Memcpy(Loc, Data, sizeof(Loc));
+		FMemory::Memcpy(&Quat, Data + sizeof(Loc), sizeof(Quat));
+		OutLocation = FVector(Loc[0] * PositionResolution, Loc[1] * PositionResolution, Loc[2] * PositionResolution);
+		OutRotation = UnpackQuat(Quat, 10);
+		return true;
+	}
+	else if (Size == Float32Size)
+	{
+		float Loc[3];
+		uint64 Quat;
+		FMemory::Memcpy(Loc, Data, sizeof(Loc));
+		FMemory::Memcpy(&Quat, Data + sizeof(Loc), sizeof(Quat));
+		OutLocation = FVector(Loc[0], Loc[1], Loc[2]);
+		OutRotation = UnpackQuat(Quat, 20);
+		return true;
+	}
+	return false;
+}
+
+// Pack the smallest three quaternion components using the given number of bits per component
+uint64 FSLPoseCodec::PackQuat(FQuat Rotation, int32 NumBits)
+{
+	Rotation.Normalize();
+	const float C[4] = { Rotation.X, Rotation.Y, Rotation.Z, Rotation.W };
+
+	// The largest component is dropped, q and -q are the same rotation so it is always made positive
+	int32 Largest = 0;
+	for (int32 Idx = 1; Idx < 4; ++Idx)
+	{
+		if (FMath::Abs(C[Idx]) > FMath::Abs(C[Largest]))
+		{
+			Largest = Idx;
+		}
+	}
+	const float Sign = C[Largest] < 0.f ? -1.f : 1.f;
+
+	// The remaining components are in [-1/sqrt(2), 1/sqrt(2)]
+	const uint64 MaxVal = (1ull << NumBits) - 1;
+	uint64 Packed = Largest;
+	for (int32 Idx = 0; Idx < 4; ++Idx)
+	{
+		if (Idx != Largest)
+		{
+			const float Normalized = FMath::Clamp((C[Idx] * Sign * SLSqrt2 + 1.f) * 0.5f, 0.f, 1.f);
+			Packed = (Packed << NumBits) | (uint64)FMath::RoundToInt(Normalized * MaxVal);
+		}
+	}
+	return Packed;
+}
+
+// Unpack the smallest three quaternion components
+FQuat FSLPoseCodec::UnpackQuat(uint64 Packed, int32 NumBits)
+{
+	const uint64 MaxVal = (1ull << NumBits) - 1;
+	float Smallest[3];
+	for (int32 Idx = 2; Idx >= 0; --Idx)
+	{
+		Smallest[Idx] = ((float)(Packed & MaxVal) / MaxVal * 2.f - 1.f) * SLInvSqrt2;
+		Packed >>= NumBits;
+	}
+	const int32 Largest = (int32)(Packed & 3);
+
+	float C[4];
+	float SumSq = 0.f;
+	for (int32 Idx = 0, SmallIdx = 0; Idx < 4; ++Idx)
+	{
+		if (Idx != Largest)
+		{
+			C[Idx] = Smallest[SmallIdx++];
+			SumSq += C[Idx] * C[Idx];
+		}
+	}
+	C[Largest] = FMath::Sqrt(FMath::Max(0.f, 1.f - SumSq));
+
+	FQuat Rotation(C[0], C[1], C[2], C[3]);
+	Rotation.Normalize();
+	return Rotation;
+}
@@ -2,6 +2,11 @@
 // Author: Andrei Haidu (http://haidu.eu)
 
 #include "Vision/SLVisionDBHandler.h"
+#include "Vision/SLVisionPoseableMeshActor.h"
+#include "Components/PoseableMeshComponent.h"
+#include "Individuals/SLIndividualUtils.h"
+#include "Individuals/Type/SLBaseIndividual.h"
+#include "Mongo/SLMongoQueryDBHandler.h"
 
 // UUtils
 #if SL_WITH_ROS_CONVERSIONS
@@ -19,9 +24,6 @@ bool FSLVisionDBHandler::Connect(const FString& DBName, const FString& CollName,
 	const FString VisCollName = CollName + ".vis";
 
 #if SL_WITH_LIBMONGO_C
-	// Required to initialize libmongoc's internals	
-	mongoc_init();
-
 	// Stores any error that might appear during the connection
 	bson_error_t error;
 
@@ -58,6 +60,10 @@ bool FSLVisionDBHandler::Connect(const FString& DBName, const FString& CollName,
 	}
 	collection = mongoc_database_get_collection(database, TCHAR_TO_UTF8(*CollName));
 
+	// Compact encoded world states reference the entities by their id table index (sparse bones are merged by the frames)
+	bool bSparseBones;
+	bCompactPoses = FSLMongoQueryDBHandler::ReadIdTable(collection, IdTable, SkelIdTable, PositionResolution, bSparseBones, bLocalBones);
+
 	if (mongoc_database_has_collection(database, TCHAR_TO_UTF8(*VisCollName), &error))
 	{
 		if (bRemovePrevEntries)
@@ -149,7 +155,6 @@ void FSLVisionDBHandler::Disconnect() const
 	{
 		mongoc_collection_destroy(vis_collection);
 	}
-	mongoc_cleanup();
 #endif //SL_WITH_LIBMONGO_C
 }
 
@@ -329,8 +334,8 @@ bool FSLVisionDBHandler::GetEpisodeData(float UpdateRate, const TMap<ASkeletalMe
 			"{",
 				"_id", BCON_INT32(0),
 				"timestamp", BCON_INT32(1),
-				"entities", BCON_UTF8("$entities"),
-				"skel_entities", BCON_UTF8("$skel_entities"),
+				//"individuals", BCON_INT32(1),		// static mesh and camera actors are not resolved
+				"skel_individuals", BCON_INT32(1),
 			"}",
 		"}",
 	"]");
@@ -341,11 +346,23 @@ bool FSLVisionDBHandler::GetEpisodeData(float UpdateRate, const TMap<ASkeletalMe
 	cursor = mongoc_collection_aggregate(
 		collection, MONGOC_QUERY_NONE, pipeline, &opts, NULL);
 
-	while (mongoc_cursor_next(cursor, &doc))
+	// The skeletal individuals are referenced by their id, map them to their poseable mesh clones
+	TMap<FString, ASLVisionPoseableMeshActor*> IdToPoseableMap;
+	for (const auto& Pair : InSkelToPoseableMap)
 	{
-		// Store the changes from the previous frame until this one
-		FSLVisionFrame Frame;
+		if (USLBaseIndividual* SkelIndividual = FSLIndividualUtils::GetIndividualObject(Pair.Key))
+		{
+			IdToPoseableMap.Emplace(SkelIndividual->GetIdValue(), Pair.Value);
+		}
+	}
 
+	// Last local bone poses of the skeletal individuals (only used if the bones are local)
+	TMap<ASLVisionPoseableMeshActor*, TMap<FName, FTransform>> LocalBonePoses;
+
+	// Store the changes from the previous frame until this one (sparse bones are only part of the documents in which they moved)
+	FSLVisionFrame Frame;
+	while (mongoc_cursor_next(cursor, &doc))
+	{
 		bson_iter_t doc_iter;
 		if (bson_iter_init(&doc_iter, doc))
 		{
@@ -358,8 +375,9 @@ bool FSLVisionDBHandler::GetEpisodeData(float UpdateRate, const TMap<ASkeletalMe
 			// Accumulate entity changes in the frame until the desired update rate is reached
 			GetEntitiesData(&doc_iter, Frame.ActorPoses, Frame.VisionCameraPoses);
 
-			// Accumulate skeletal entity changes in the frame until the desired update rate is reached
-			GetSkeletalEntitiesData(&doc_iter, InSkelToPoseableMap, Frame.SkeletalPoses);
+			// Accumulate skeletal entity changes in the frame until the desired update rate is reached (search from the doc start)
+			bson_iter_init(&doc_iter, doc);
+			GetSkeletalEntitiesData(&doc_iter, IdToPoseableMap, LocalBonePoses, Frame.SkeletalPoses);
 
 			// Check if the desired update rate is reached
 			if (CurrTs - PrevTs >= UpdateRate)
@@ -624,76 +642,31 @@ void FSLVisionDBHandler::DropPreviousEntries(const FString& DBName, const FStrin
 }
 
 #if SL_WITH_LIBMONGO_C
-// Get the entities data out of the bson iterator
+// Get the individuals data out of the bson iterator
 bool FSLVisionDBHandler::GetEntitiesData(bson_iter_t* doc,
 	TMap<AStaticMeshActor*, FTransform>& OutEntityPoses,
 	TMap<ASLVirtualCameraView*, FTransform>& OutVirtualCameraPoses) const
 {
-	// Iterate entities
-	if (bson_iter_find(doc, "entities"))
+	// Iterate individuals (not projected by the episode query, the static mesh and virtual camera actors
+	// cannot be resolved from their ids without the entities manager, so they are not decoded)
+	if (bson_iter_find(doc, "individuals"))
 	{
-		bson_iter_t child_iter;				// entities,
-		bson_iter_t sub_child_iter;			// id, loc, rot
-		bson_iter_t sub_sub_child_iter;		// x,y,z,w (entity)
+		bson_iter_t child_iter;				// individuals
 
 		// Check if there are any entities
 		if (bson_iter_recurse(doc, &child_iter))
 		{
-			FString Id;
-			FVector Loc;
-			FQuat Quat;
-
 			while (bson_iter_next(&child_iter))
 			{
-				if (bson_iter_recurse(&child_iter, &sub_child_iter) && bson_iter_find(&sub_child_iter, "id"))
-				{
-					Id = FString(bson_iter_utf8(&sub_child_iter, NULL));
-				}
-				if (bson_iter_recurse(&child_iter, &sub_child_iter) && bson_iter_find_descendant(&sub_child_iter, "loc.x", &sub_sub_child_iter))
-				{
-					Loc.X = bson_iter_double(&sub_sub_child_iter);
-				}
-				if (bson_iter_recurse(&child_iter, &sub_child_iter) && bson_iter_find_descendant(&sub_child_iter, "loc.y", &sub_sub_child_iter))
-				{
-					Loc.Y = bson_iter_double(&sub_sub_child_iter);
-				}
-				if (bson_iter_recurse(&child_iter, &sub_child_iter) && bson_iter_find_descendant(&sub_child_iter, "loc.z", &sub_sub_child_iter))
-				{
-					Loc.Z = bson_iter_double(&sub_sub_child_iter);
-				}
-				if (bson_iter_recurse(&child_iter, &sub_child_iter) && bson_iter_find_descendant(&sub_child_iter, "rot.x", &sub_sub_child_iter))
-				{
-					Quat.X = bson_iter_double(&sub_sub_child_iter);
-				}
-				if (bson_iter_recurse(&child_iter, &sub_child_iter) && bson_iter_find_descendant(&sub_child_iter, "rot.y", &sub_sub_child_iter))
-				{
-					Quat.Y = bson_iter_double(&sub_sub_child_iter);
-				}
-				if (bson_iter_recurse(&child_iter, &sub_child_iter) && bson_iter_find_descendant(&sub_child_iter, "rot.z", &sub_sub_child_iter))
-				{
-					Quat.Z = bson_iter_double(&sub_sub_child_iter);
-				}
-				if (bson_iter_recurse(&child_iter, &sub_child_iter) && bson_iter_find_descendant(&sub_child_iter, "rot.w", &sub_sub_child_iter))
-				{
-					Quat.W = bson_iter_double(&sub_sub_child_iter);
-				}
-
-//				// Add entity
+//				// Add entity (the pose is only decoded for the resolved actors)
+//				const FString Id = GetId(&child_iter, IdTable);
 //				if (AStaticMeshActor* SMA = FSLEntitiesManager::GetInstance()->GetStaticMeshActor(Id))
 //				{
-//#if SL_WITH_ROS_CONVERSIONS
-//					OutEntityPoses.Emplace(SMA, FConversions::ROSToU(FTransform(Quat, Loc)));
-//#else
-//					OutEntityPoses.Emplace(SMA, FTransform(Quat, Loc));
-//#endif // SL_WITH_ROS_CONVERSIONS
+//					OutEntityPoses.Emplace(SMA, FSLMongoQueryDBHandler::GetPose(&child_iter, bCompactPoses, PositionResolution));
 //				}
 //				else if (ASLVirtualCameraView* VCA = FSLEntitiesManager::GetInstance()->GetVisionCameraActor(Id))
-//				{					
-//#if SL_WITH_ROS_CONVERSIONS
-//					OutVirtualCameraPoses.Emplace(VCA, FConversions::ROSToU(FTransform(Quat, Loc)));
-//#else
-//					OutVirtualCameraPoses.Emplace(VCA, FTransform(Quat, Loc));
-//#endif // SL_WITH_ROS_CONVERSIONS
+//				{
+//					OutVirtualCameraPoses.Emplace(VCA, FSLMongoQueryDBHandler::GetPose(&child_iter, bCompactPoses, PositionResolution));
 //				}
 			}
 		}
@@ -705,98 +678,67 @@ bool FSLVisionDBHandler::GetEntitiesData(bson_iter_t* doc,
 	}
 }
 
-// Get the entities data out of the bson iterator, returns false if there are no entities
-bool FSLVisionDBHandler::GetSkeletalEntitiesData(bson_iter_t* doc, 
-	const TMap<ASkeletalMeshActor*, ASLVisionPoseableMeshActor*>& InSkelToPoseableMap,
+// Get the skeletal individuals data out of the bson iterator, returns false if there are no entities
+bool FSLVisionDBHandler::GetSkeletalEntitiesData(bson_iter_t* doc,
+	const TMap<FString, ASLVisionPoseableMeshActor*>& InIdToPoseableMap,
+	TMap<ASLVisionPoseableMeshActor*, TMap<FName, FTransform>>& InOutLocalBonePoses,
 	TMap<ASLVisionPoseableMeshActor*, TMap<FName, FTransform>>& OutSkeletalPoses) const
 {
-	// Iterate skeletal entities
-	if (bson_iter_find(doc, "skel_entities"))
+	// Iterate skeletal individuals
+	if (bson_iter_find(doc, "skel_individuals"))
 	{
-		bson_iter_t child_iter;				// skel_entities
+		bson_iter_t child_iter;				// skel_individuals
 		bson_iter_t sub_child_iter;			// bones
-		bson_iter_t sub_sub_child_iter;		// bones (array)
 
 		if (bson_iter_recurse(doc, &child_iter))
 		{
-			FString Id;
-			TMap<FName, FTransform> BonesMap;
-
 			while (bson_iter_next(&child_iter))
 			{
-				if (bson_iter_recurse(&child_iter, &sub_child_iter) && bson_iter_find(&sub_child_iter, "id"))
+				// Skip the skeletal individuals without a poseable mesh clone
+				ASLVisionPoseableMeshActor* const* PMA = InIdToPoseableMap.Find(GetId(&child_iter, SkelIdTable));
+				if (!PMA)
 				{
-					Id = FString(bson_iter_utf8(&sub_child_iter, NULL));
+					continue;
 				}
+				UPoseableMeshComponent* PMC = (*PMA)->GetPoseableMeshComponent();
 
-				if (bson_iter_recurse(&child_iter, &sub_sub_child_iter) && bson_iter_find(&sub_sub_child_iter, "bones"))
-				{
-					bson_iter_t bones_child;			// array  obj
-					bson_iter_t bones_sub_child;		// name, loc, rot
-					bson_iter_t bones_sub_sub_child;	// x, y , z, w
+				// Only the written (moved) bones are part of the entry, the previous ones are kept by the frame,
+				// local bones are first gathered with the previous local poses
+				TMap<FName, FTransform>& BonesMap = bLocalBones ? InOutLocalBonePoses.FindOrAdd(*PMA) : OutSkeletalPoses.FindOrAdd(*PMA);
 
-					FName BoneName;
-					FVector Loc;
-					FQuat Quat;
+				if (bson_iter_recurse(&child_iter, &sub_child_iter) && bson_iter_find(&sub_child_iter, "bones"))
+				{
+					bson_iter_t bones_child;			// array obj
+					bson_iter_t bones_sub_child;		// idx, pose
 
-					if (bson_iter_recurse(&sub_sub_child_iter, &bones_child))
+					if (bson_iter_recurse(&sub_child_iter, &bones_child))
 					{
 						while (bson_iter_next(&bones_child))
 						{
-							if (bson_iter_recurse(&bones_child, &bones_sub_child) && bson_iter_find(&bones_sub_child, "name"))
-							{
-								BoneName = FName(bson_iter_utf8(&bones_sub_child, NULL));
-							}
-							if (bson_iter_recurse(&bones_child, &bones_sub_child) && bson_iter_find_descendant(&bones_sub_child, "loc.x", &bones_sub_sub_child))
-							{
-								Loc.X = bson_iter_double(&bones_sub_sub_child);
-							}
-							if (bson_iter_recurse(&bones_child, &bones_sub_child) && bson_iter_find_descendant(&bones_sub_child, "loc.y", &bones_sub_sub_child))
-							{
-								Loc.Y = bson_iter_double(&bones_sub_sub_child);
-							}
-							if (bson_iter_recurse(&bones_child, &bones_sub_child) && bson_iter_find_descendant(&bones_sub_child, "loc.z", &bones_sub_sub_child))
-							{
-								Loc.Z = bson_iter_double(&bones_sub_sub_child);
-							}
-							if (bson_iter_recurse(&bones_child, &bones_sub_child) && bson_iter_find_descendant(&bones_sub_child, "rot.x", &bones_sub_sub_child))
-							{
-								Quat.X = bson_iter_double(&bones_sub_sub_child);
-							}
-							if (bson_iter_recurse(&bones_child, &bones_sub_child) && bson_iter_find_descendant(&bones_sub_child, "rot.y", &bones_sub_sub_child))
-							{
-								Quat.Y = bson_iter_double(&bones_sub_sub_child);
-							}
-							if (bson_iter_recurse(&bones_child, &bones_sub_child) && bson_iter_find_descendant(&bones_sub_child, "rot.z", &bones_sub_sub_child))
-							{
-								Quat.Z = bson_iter_double(&bones_sub_sub_child);
-							}
-							if (bson_iter_recurse(&bones_child, &bones_sub_child) && bson_iter_find_descendant(&bones_sub_child, "rot.w", &bones_sub_sub_child))
+							// The bones are referenced by their skeletal mesh bone index
+							if (bson_iter_recurse(&bones_child, &bones_sub_child) && bson_iter_find(&bones_sub_child, "idx"))
 							{
-								Quat.W = bson_iter_double(&bones_sub_sub_child);
+								const FName BoneName = PMC->GetBoneName(bson_iter_int32(&bones_sub_child));
+								if (BoneName != NAME_None)
+								{
+									BonesMap.Emplace(BoneName, FSLMongoQueryDBHandler::GetPose(&bones_child, bCompactPoses, PositionResolution));
+								}
 							}
-#if SL_WITH_ROS_CONVERSIONS
-							BonesMap.Add(BoneName, FConversions::ROSToU(FTransform(Quat, Loc)));
-#else
-							BonesMap.Add(BoneName, FTransform(Quat, Loc));
-#endif // SL_WITH_ROS_CONVERSIONS
 						}
 					}
 				}
 
-				//// Add skeletal entity
-				//if (ASkeletalMeshActor* SkMA = FSLEntitiesManager::GetInstance()->GetSkeletalMeshActor((Id)))
-				//{
-				//	if (ASLVisionPoseableMeshActor* const* PMA = InSkelToPoseableMap.Find(SkMA))
-				//	{
-				//		OutSkeletalPoses.Emplace(*PMA, BonesMap);
-				//	}
-				//	else
-				//	{
-				//		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not find poseable mesh clone actor for %s, did you run the setup before?"),
-				//			*FString(__func__), __LINE__, *SkMA->GetName());
-				//	}
-				//}
+				// Local bone poses are relative to the skeletal individual pose of the same entry, the idle bones
+				// are not written but still move with the skeletal individual, so all of them are converted
+				if (bLocalBones)
+				{
+					const FTransform SkelPose = FSLMongoQueryDBHandler::GetPose(&child_iter, bCompactPoses, PositionResolution);
+					TMap<FName, FTransform>& WorldBonesMap = OutSkeletalPoses.FindOrAdd(*PMA);
+					for (const auto& Pair : BonesMap)
+					{
+						WorldBonesMap.Emplace(Pair.Key, Pair.Value * SkelPose);
+					}
+				}
 			}
 		}
 		return OutSkeletalPoses.Num() > 0;
@@ -804,6 +746,30 @@ bool FSLVisionDBHandler::GetSkeletalEntitiesData(bson_iter_t* doc,
 	return false;
 }
 
+// Get the id of the array element (resolved through the given id table if the poses are compact)
+FString FSLVisionDBHandler::GetId(const bson_iter_t* iter, const TArray<FString>& InIdTable) const
+{
+	bson_iter_t value;
+	if (bCompactPoses)
+	{
+		if (bson_iter_recurse(iter, &value) && bson_iter_find(&value, "idx") && BSON_ITER_HOLDS_INT32(&value))
+		{
+			const int32 Idx = bson_iter_int32(&value);
+			if (InIdTable.IsValidIndex(Idx))
+			{
+				return InIdTable[Idx];
+			}
+		}
+		return FString();
+	}
+
+	if (bson_iter_recurse(iter, &value) && bson_iter_find(&value, "id") && BSON_ITER_HOLDS_UTF8(&value))
+	{
+		return FString(UTF8_TO_TCHAR(bson_iter_utf8(&value, NULL)));
+	}
+	return FString();
+}
+
 // Save image to gridfs, get the file oid and return true if succeeded
 bool FSLVisionDBHandler::AddToGridFs(const TArray<uint8>& InData, bson_oid_t* out_oid) const
 {
@@ -2,6 +2,53 @@
 // Author: Andrei Haidu (http://haidu.eu)
 
 #include "Vision/SLVisionMaskImageHandler.h"
+#include "Async/ParallelFor.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SL_MASK_WITH_SSE2 1
+#include <emmintrin.h>
+#else
+#define SL_MASK_WITH_SSE2 0
+#endif
+
+// Min number of rows of an image stripe decoded in parallel
+static constexpr int32 SLMaskMinRowsPerStripe = 64;
+
+// Update the [MinX, MinY, -MaxX, -MaxY] bounds with the pixel run [X0, X1] of row Y
+FORCEINLINE static void SLMaskUpdateBounds(int32* Bounds, int32 X0, int32 X1, int32 Y)
+{
+#if SL_MASK_WITH_SSE2
+	const __m128i Curr = _mm_loadu_si128((const __m128i*)Bounds);
+	const __m128i Cand = _mm_set_epi32(-Y, -X1, Y, X0);
+	const __m128i LessMask = _mm_cmplt_epi32(Cand, Curr);
+	_mm_storeu_si128((__m128i*)Bounds, _mm_or_si128(_mm_and_si128(LessMask, Cand), _mm_andnot_si128(LessMask, Curr)));
+#else
+	Bounds[0] = FMath::Min(Bounds[0], X0);
+	Bounds[1] = FMath::Min(Bounds[1], Y);
+	Bounds[2] = FMath::Min(Bounds[2], -X1);
+	Bounds[3] = FMath::Min(Bounds[3], -Y);
+#endif // SL_MASK_WITH_SSE2
+}
+
+// Get the end of the run of pixels equal to the one at the given index
+FORCEINLINE static int32 SLMaskGetRunEnd(const uint32* Row, int32 X, int32 RowLength)
+{
+	const uint32 Key = Row[X];
+	int32 RunEnd = X + 1;
+#if SL_MASK_WITH_SSE2
+	const __m128i Ref = _mm_set1_epi32((int32)Key);
+	while (RunEnd + 4 <= RowLength
+		&& _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(Row + RunEnd)), Ref)) == 0xFFFF)
+	{
+		RunEnd += 4;
+	}
+#endif // SL_MASK_WITH_SSE2
+	while (RunEnd < RowLength && Row[RunEnd] == Key)
+	{
+		RunEnd++;
+	}
+	return RunEnd;
+}
 
 
 // Ctor
@@ -97,98 +144,60 @@ void FSLVisionMaskImageHandler::GetDataAndRestoreImage(TArray<FColor>& MaskBitma
 	// Used to calculate the percentage of an entity in the image
 	const int64 ImgTotalPixels = ImgWidth * ImgHeight;
 
-	// Index position of the image matrix in rows and columns (used for storing the bounding box of the entities)
-	int32 RowIdx = 0;
-	int32 ColIdx = 0;
-
 	// Store the occurance of every color in the image to its data
 	TMap<FColor, FSLVisionImageColorInfo> TempRenderedColorsData;
 
 	// Array of rendered colors without a semantic match (store in array to avoid smapping the logger everytime the color appears)
 	TSet<FColor> UnknownColors;
 
-	// Restore image colors and create a mapping of all the rendered pixel colors to its data
-	for (auto& PixelColor : MaskBitmapToRestore)
+	// Restore image colors and collect the rendered colors data in row stripes (in parallel)
+	const int32 NumPixels = MaskBitmapToRestore.Num();
+	const int32 NumRows = ImgWidth > 0 ? FMath::DivideAndRoundUp(NumPixels, ImgWidth) : 0;
+	const int32 NumStripes = FMath::Clamp(NumRows / SLMaskMinRowsPerStripe, 1, FPlatformMisc::NumberOfCoresIncludingHyperthreads());
+	const int32 RowsPerStripe = FMath::DivideAndRoundUp(FMath::Max(NumRows, 1), NumStripes);
+	TArray<FSLVisionMaskStripeData> StripesData;
+	StripesData.SetNum(NumStripes);
+	uint32* Pixels = (uint32*)MaskBitmapToRestore.GetData();
+	ParallelFor(NumStripes, [&](int32 StripeIdx)
+	{
+		const int32 FirstRow = StripeIdx * RowsPerStripe;
+		DecodeStripe(Pixels, NumPixels, ImgWidth, ImgHeight, FirstRow, FMath::Min(FirstRow + RowsPerStripe, NumRows), StripesData[StripeIdx]);
+	}, NumStripes == 1);
+
+	// Merge the stripes in row order, this keeps the colors in order of appearance and the first pixel 
+	// of every color out of its bounding box, as the sequential restore did
+	for (const auto& StripeData : StripesData)
 	{
-		// Ignore color black (represents semantically unknown areas, normally there should not be any
-		if (PixelColor != FColor::Black)
+		for (const auto& StripeColor : StripeData.Colors)
 		{
-			// Check if the color is new
-			if (FSLVisionImageColorInfo* ColorData = TempRenderedColorsData.Find(PixelColor))
+			const FColor RenderedColor(StripeColor.Key);
+			if (!StripeColor.bKnown)
 			{
-				// Color already stored, update its data
-				(*ColorData).Num++;
-
-				// Update the bounding box in the image
-				if (RowIdx < (*ColorData).MinBB.Y)
-				{
-					(*ColorData).MinBB.Y = RowIdx;
-				}
-				if (RowIdx > (*ColorData).MaxBB.Y)
-				{
-					(*ColorData).MaxBB.Y = RowIdx;
-				}
-				if (ColIdx < (*ColorData).MinBB.X)
-				{
-					(*ColorData).MinBB.X = ColIdx;
-				}
-				if (ColIdx > (*ColorData).MaxBB.X)
+				if (!UnknownColors.Contains(RenderedColor))
 				{
-					(*ColorData).MaxBB.X = ColIdx;
+					UnknownColors.Add(RenderedColor);
+					UE_LOG(LogTemp, Error, TEXT("%s::%d Rendered color %s - %s has no mapping to any entity.. this should not happen.."),
+						*FString(__func__), __LINE__, *RenderedColor.ToString(), *RenderedColor.ToHex());
 				}
+				continue;
+			}
 
-				// Fix image by changing the rendered color to the original value
-				PixelColor = (*ColorData).OriginalMaskColor;
+			const FIntPoint StripeMinBB(StripeColor.Bounds[0], StripeColor.Bounds[1]);
+			const FIntPoint StripeMaxBB(-StripeColor.Bounds[2], -StripeColor.Bounds[3]);
+			if (FSLVisionImageColorInfo* ColorData = TempRenderedColorsData.Find(RenderedColor))
+			{
+				(*ColorData).Num += StripeColor.Num;
+				(*ColorData).MinBB = (*ColorData).MinBB.ComponentMin(StripeMinBB).ComponentMin(StripeColor.FirstPixel);
+				(*ColorData).MaxBB = (*ColorData).MaxBB.ComponentMax(StripeMaxBB).ComponentMax(StripeColor.FirstPixel);
 			}
 			else
 			{
-				// Cache rendered color, since the pixel color will be restored to the original mask (if found)
-				const FColor RenderedColor = PixelColor;
-
-				// New color, cache its info
-				FSLVisionImageColorInfo ColorInfo(1, FIntPoint(ImgWidth, ImgHeight), FIntPoint(0, 0));
-
-				// Get the original mask color value
-				if (const FSLVisionMaskEntityInfo* EntityInfo = RenderedColorToEntityInfo.Find(RenderedColor))
-				{
-					// Color found as an entity visual mask
-					ColorInfo.OriginalMaskColor = FColor::FromHex((*EntityInfo).OrigMaskColor);
-
-					// Cache the color info in the local map
-					TempRenderedColorsData.Emplace(RenderedColor, ColorInfo);
-
-					// Fix image by changing the rendered color to the original value
-					PixelColor = ColorInfo.OriginalMaskColor;
-				}
-				else if (const FSLVisionMaskSkelInfo* SkelInfo = RenderedColorToSkelInfo.Find(RenderedColor))
-				{
-					// Color found as a skeletal visual mask
-					ColorInfo.OriginalMaskColor = FColor::FromHex((*SkelInfo).OrigMaskColor);
-
-					// Cache the color info in the local map
-					TempRenderedColorsData.Emplace(RenderedColor, ColorInfo);
-
-					// Fix image by changing the rendered color to the original value
-					PixelColor = ColorInfo.OriginalMaskColor;
-				}
-				else if(!UnknownColors.Contains(PixelColor))
-				{
-					UnknownColors.Add(PixelColor);
-					UE_LOG(LogTemp, Error, TEXT("%s::%d Rendered color %s - %s has no mapping to any entity.. this should not happen.."),
-						*FString(__func__), __LINE__, *RenderedColor.ToString(), *RenderedColor.ToHex());
-				}
+				FSLVisionImageColorInfo ColorInfo(0, StripeMinBB, StripeMaxBB);
+				ColorInfo.Num = StripeColor.Num;
+				ColorInfo.OriginalMaskColor = FColor(StripeColor.RestoredKey);
+				TempRenderedColorsData.Emplace(RenderedColor, ColorInfo);
 			}
 		}
-
-		// Update current pixel index position
-		ColIdx++;
-
-		// Check for row change
-		if (ColIdx > ImgWidth - 1)
-		{
-			ColIdx = 0;
-			RowIdx++;
-		}
 	}
 
 	// Store skeletal related data in a temp map, this will need an extra processing to calculcate the data as a whole skeleton (from bones)
@@ -254,6 +263,98 @@ void FSLVisionMaskImageHandler::GetDataAndRestoreImage(TArray<FColor>& MaskBitma
 	}
 }
 
+// Restore the pixels of the rows and collect the colors data of the stripe
+void FSLVisionMaskImageHandler::DecodeStripe(uint32* Pixels, int32 NumPixels, int32 ImgWidth, int32 ImgHeight,
+	int32 FirstRow, int32 EndRow, FSLVisionMaskStripeData& OutStripeData) const
+{
+	const uint32 BlackKey = FColor::Black.DWColor();
+
+	// Consecutive runs (and rows) often have the same color, skip the table lookup for them
+	int32 LastColorIdx = INDEX_NONE;
+
+	for (int32 RowIdx = FirstRow; RowIdx < EndRow; ++RowIdx)
+	{
+		uint32* Row = Pixels + (int64)RowIdx * ImgWidth;
+		const int32 RowLength = FMath::Min(ImgWidth, NumPixels - RowIdx * ImgWidth);
+
+		// Process the row as runs of identical colors
+		int32 RunStart = 0;
+		while (RunStart < RowLength)
+		{
+			const uint32 Key = Row[RunStart];
+			const int32 RunEnd = SLMaskGetRunEnd(Row, RunStart, RowLength);
+
+			// Ignore color black (represents semantically unknown areas, normally there should not be any
+			if (Key != BlackKey)
+			{
+				int32 ColorIdx = LastColorIdx != INDEX_NONE && OutStripeData.Colors[LastColorIdx].Key == Key
+					? LastColorIdx : OutStripeData.Slots.Num() > 0 ? OutStripeData.Find(Key) : INDEX_NONE;
+				int32 FirstCountedX = RunStart;
+				if (ColorIdx == INDEX_NONE)
+				{
+					// New color, the first pixel is kept out of the bounding box
+					FSLVisionMaskStripeColor NewColor;
+					NewColor.Key = Key;
+					NewColor.RestoredKey = Key;
+					FColor OriginalMaskColor;
+					if (GetOriginalMaskColor(FColor(Key), OriginalMaskColor))
+					{
+						NewColor.bKnown = true;
+						NewColor.RestoredKey = OriginalMaskColor.DWColor();
+					}
+					NewColor.Bounds[0] = ImgWidth;
+					NewColor.Bounds[1] = ImgHeight;
+					NewColor.Bounds[2] = 0;
+					NewColor.Bounds[3] = 0;
+					NewColor.FirstPixel = FIntPoint(RunStart, RowIdx);
+					ColorIdx = OutStripeData.Add(NewColor);
+					FirstCountedX = RunStart + 1;
+				}
+				LastColorIdx = ColorIdx;
+
+				FSLVisionMaskStripeColor& Color = OutStripeData.Colors[ColorIdx];
+				if (Color.bKnown)
+				{
+					Color.Num += RunEnd - RunStart;
+					if (FirstCountedX < RunEnd)
+					{
+						SLMaskUpdateBounds(Color.Bounds, FirstCountedX, RunEnd - 1, RowIdx);
+					}
+
+					// Fix image by changing the rendered color to the original value
+					if (Color.RestoredKey != Key)
+					{
+						const uint32 RestoredKey = Color.RestoredKey;
+						for (int32 ColIdx = RunStart; ColIdx < RunEnd; ++ColIdx)
+						{
+							Row[ColIdx] = RestoredKey;
+						}
+					}
+				}
+			}
+			RunStart = RunEnd;
+		}
+	}
+}
+
+// Get the original mask color of the rendered color (false if the color is not mapped to any entity)
+bool FSLVisionMaskImageHandler::GetOriginalMaskColor(const FColor& RenderedColor, FColor& OutOriginalMaskColor) const
+{
+	if (const FSLVisionMaskEntityInfo* EntityInfo = RenderedColorToEntityInfo.Find(RenderedColor))
+	{
+		// Color found as an entity visual mask
+		OutOriginalMaskColor = FColor::FromHex((*EntityInfo).OrigMaskColor);
+		return true;
+	}
+	else if (const FSLVisionMaskSkelInfo* SkelInfo = RenderedColorToSkelInfo.Find(RenderedColor))
+	{
+		// Color found as a skeletal visual mask
+		OutOriginalMaskColor = FColor::FromHex((*SkelInfo).OrigMaskColor);
+		return true;
+	}
+	return false;
+}
+
 // Restore the color of the pixel to its original mask value (offseted by screenshot rendering artifacts), returns true if restoration happened
 bool FSLVisionMaskImageHandler::RestoreColorValueFromArray(FColor& RenderedPixelColor, const TArray<FColor>& InOriginalMaskColors, uint8 Tolerance) const
 {
@@ -31,6 +31,10 @@ USLVisionOverlapCalc::USLVisionOverlapCalc() : bIsInit(false), bIsStarted(false)
 	CurrPMAClone = nullptr;
 	bSkelArrayActive = false;
 	bSkelBoneActive = false;
+	CurrFrameStartTime = 0.0;
+	NumCalculatedFrames = 0;
+	NumCalculatedScreenshots = 0;
+	TotalCalcSeconds = 0.0;
 }
 
 // Destructor
@@ -82,6 +86,7 @@ void USLVisionOverlapCalc::Start(FSLVisionViewData* CurrViewData, float Timestam
 		SkelEntities = &CurrViewData->SkelEntities;
 
 		CurrOverlapCalcIdx = 0;		
+		CurrFrameStartTime = FPlatformTime::Seconds();
 		int32 NumBones = 0;
 		for (const auto& SkE : *SkelEntities)
 		{
@@ -117,7 +122,6 @@ void USLVisionOverlapCalc::Finish()
 {
 	if (!bIsFinished && bIsStarted)
 	{
-		CurrOverlapCalcIdx = INDEX_NONE;
 		EntityIndex = INDEX_NONE;
 		SkelIndex = INDEX_NONE;
 		
@@ -129,6 +133,15 @@ void USLVisionOverlapCalc::Finish()
 		CurrSMAClone = nullptr;
 		CurrPMAClone = nullptr;
 
+		// Throughput in logged episode frames per second
+		NumCalculatedFrames++;
+		NumCalculatedScreenshots += CurrOverlapCalcIdx + 1;
+		TotalCalcSeconds += FPlatformTime::Seconds() - CurrFrameStartTime;
+		UE_LOG(LogTemp, Log, TEXT("%s::%d Overlap calc throughput: frames=%d; screenshots=%d; [%.3f] frames/s;"),
+			*FString(__func__), __LINE__, NumCalculatedFrames, NumCalculatedScreenshots,
+			TotalCalcSeconds > 0.0 ? NumCalculatedFrames / TotalCalcSeconds : 0.0);
+		CurrOverlapCalcIdx = INDEX_NONE;
+
 		// Switch callback functions, and re-start parent
 		ViewportClient->OnScreenshotCaptured().Remove(ScreenshotCallbackHandle);
 		Parent->Pause(false);
@@ -7,6 +7,91 @@
 #include "Components/SkeletalMeshComponent.h"
 #include "Materials/MaterialInstanceDynamic.h"
 
+// Get a visible component with the mesh and materials of the reference (reuse a hidden one if available)
+UPoseableMeshComponent* FSLVizPoseableMeshPool::Acquire(UObject* Outer, UPoseableMeshComponent* Reference)
+{
+	UPoseableMeshComponent* PMC = nullptr;
+	while (!PMC && FreeComponents.Num() > 0)
+	{
+		UPoseableMeshComponent* Candidate = FreeComponents.Pop(false);
+		if (Candidate && Candidate->IsValidLowLevel() && !Candidate->IsPendingKillOrUnreachable())
+		{
+			PMC = Candidate;
+		}
+	}
+
+	if (PMC)
+	{
+		PMC->SetSkeletalMesh(Reference->SkeletalMesh);
+		// Clear the bone poses of the previous usage
+		for (int32 BoneIdx = 0; BoneIdx < PMC->GetNumBones(); ++BoneIdx)
+		{
+			PMC->ResetBoneTransformByName(PMC->GetBoneName(BoneIdx));
+		}
+		NumReused++;
+	}
+	else
+	{
+		PMC = NewObject<UPoseableMeshComponent>(Outer);
+		PMC->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		PMC->bPerBoneMotionBlur = false;
+		PMC->bHasMotionBlurVelocityMeshes = false;
+		PMC->bSelectable = false;
+		PMC->SetSkeletalMesh(Reference->SkeletalMesh);
+		PMC->RegisterComponent();
+		NumCreated++;
+	}
+
+	// Use the same materials as the reference
+	PMC->EmptyOverrideMaterials();
+	for (int32 MatIdx = 0; MatIdx < Reference->GetNumMaterials(); ++MatIdx)
+	{
+		PMC->SetMaterial(MatIdx, Reference->GetMaterial(MatIdx));
+	}
+	PMC->SetVisibility(true);
+	return PMC;
+}
+
+// Hide the component and keep it for reuse (destroyed if the pool is full)
+void FSLVizPoseableMeshPool::Release(UPoseableMeshComponent* PMC)
+{
+	if (!PMC || !PMC->IsValidLowLevel() || PMC->IsPendingKillOrUnreachable())
+	{
+		return;
+	}
+
+	if (FreeComponents.Num() < MaxNumFree)
+	{
+		PMC->SetVisibility(false);
+		FreeComponents.Add(PMC);
+	}
+	else
+	{
+		PMC->DestroyComponent();
+	}
+}
+
+// Destroy the hidden components
+void FSLVizPoseableMeshPool::Empty()
+{
+	if (NumCreated > 0)
+	{
+		UE_LOG(LogTemp, Log, TEXT("%s::%d Poseable mesh pool created %d components, reused %d times, %d hidden left.."),
+			*FString(__FUNCTION__), __LINE__, NumCreated, NumReused, FreeComponents.Num());
+	}
+
+	for (const auto& PMC : FreeComponents)
+	{
+		if (PMC && PMC->IsValidLowLevel() && !PMC->IsPendingKillOrUnreachable())
+		{
+			PMC->DestroyComponent();
+		}
+	}
+	FreeComponents.Empty();
+	NumCreated = 0;
+	NumReused = 0;
+}
+
 // Constructor
 USLVizSkeletalMeshMarker::USLVizSkeletalMeshMarker()
 {
@@ -14,6 +99,9 @@ USLVizSkeletalMeshMarker::USLVizSkeletalMeshMarker()
 	PrimaryComponentTick.bStartWithTickEnabled = false;
 
 	PMCRef = nullptr;
+	MaxNumKeyPoses = INDEX_NONE;
+	KeyPoseTolerance = -1.f;
+	PMCPool = nullptr;
 }
 
 // Called every frame, used for timeline visualizations, activated and deactivated on request
@@ -163,7 +251,11 @@ void USLVizSkeletalMeshMarker::AddInstances(const TArray<TPair<FTransform, TMap<
 		return;
 	}
 
-	for (const auto& SkelPosePair : SkeletalPoses)
+	// Skip the poses which do not change the look of the trajectory
+	TArray<TPair<FTransform, TMap<int32, FTransform>>> KeyPoses;
+	const auto& Poses = GetKeyPoses(SkeletalPoses, KeyPoses) ? KeyPoses : SkeletalPoses;
+
+	for (const auto& SkelPosePair : Poses)
 	{
 		UPoseableMeshComponent* PMC = CreateNewPoseableMeshInstance();
 		PMC->SetWorldTransform(SkelPosePair.Key);
@@ -203,7 +295,7 @@ void USLVizSkeletalMeshMarker::AddInstances(const TArray<TPair<FTransform, TMap<
 		return;
 	}
 
-	// Set the timeline data
+	// Set the timeline data, the poses are revealed at a constant rate, so they are not reduced to the (non-uniform in time) key poses
 	TimelinePoses = SkeletalPoses;
 	TimelineDuration = TimelineParams.Duration;
 	TimelineMaxNumInstances = TimelineParams.MaxNumInstances;
@@ -218,6 +310,114 @@ void USLVizSkeletalMeshMarker::AddInstances(const TArray<TPair<FTransform, TMap<
 	SetComponentTickEnabled(true);
 }
 
+// Only keep the key poses of the added trajectories (max number of instances and/or max deviation in cm, negative values ignored)
+void USLVizSkeletalMeshMarker::SetKeyPoseParams(int32 InMaxNumKeyPoses, float InKeyPoseTolerance)
+{
+	MaxNumKeyPoses = InMaxNumKeyPoses;
+	KeyPoseTolerance = InKeyPoseTolerance;
+}
+
+// Max deviation (cm) of the pose from the interpolation of the segment key poses
+static float GetKeyPoseDeviation(const TPair<FTransform, TMap<int32, FTransform>>& First,
+	const TPair<FTransform, TMap<int32, FTransform>>& Last,
+	const TPair<FTransform, TMap<int32, FTransform>>& Pose, float Alpha)
+{
+	// Rotation errors are converted to the arc length at this distance (cm) from the root
+	static const float RotationRadius = 10.f;
+
+	const FVector Location = FMath::Lerp(First.Key.GetLocation(), Last.Key.GetLocation(), Alpha);
+	const FQuat Rotation = FQuat::Slerp(First.Key.GetRotation(), Last.Key.GetRotation(), Alpha);
+	float Deviation = FMath::Max(FVector::Dist(Location, Pose.Key.GetLocation()),
+		Rotation.AngularDistance(Pose.Key.GetRotation()) * RotationRadius);
+
+	for (const auto& BonePosePair : Pose.Value)
+	{
+		const FTransform* FirstBonePose = First.Value.Find(BonePosePair.Key);
+		const FTransform* LastBonePose = Last.Value.Find(BonePosePair.Key);
+		if (FirstBonePose && LastBonePose)
+		{
+			const FVector BoneLocation = FMath::Lerp(FirstBonePose->GetLocation(), LastBonePose->GetLocation(), Alpha);
+			Deviation = FMath::Max(Deviation, FVector::Dist(BoneLocation, BonePosePair.Value.GetLocation()));
+		}
+	}
+	return Deviation;
+}
+
+// Select the poses which deviate the most from the interpolation of their neighbouring key poses
+void USLVizSkeletalMeshMarker::SelectKeyPoses(const TArray<TPair<FTransform, TMap<int32, FTransform>>>& SkeletalPoses,
+	int32 MaxNumKeyPoses, float Tolerance, TArray<int32>& OutIndexes)
+{
+	const int32 NumPoses = SkeletalPoses.Num();
+	OutIndexes.Empty();
+	if (NumPoses <= 2 || (MaxNumKeyPoses <= 0 && Tolerance < 0.f))
+	{
+		for (int32 Idx = 0; Idx < NumPoses; ++Idx)
+		{
+			OutIndexes.Add(Idx);
+		}
+		return;
+	}
+
+	// Trajectory segment between two key poses, with the pose deviating the most from their interpolation
+	struct FSegment
+	{
+		int32 First;
+		int32 Last;
+		int32 SplitIdx;
+		float MaxDeviation;
+	};
+	auto SegmentPredicate = [](const FSegment& A, const FSegment& B) { return A.MaxDeviation > B.MaxDeviation; };
+
+	// Segments ordered by their max deviation
+	TArray<FSegment> SegmentHeap;
+	auto AddSegment = [&](int32 First, int32 Last)
+	{
+		if (Last - First < 2)
+		{
+			return;
+		}
+		FSegment Segment{ First, Last, INDEX_NONE, -1.f };
+		for (int32 Idx = First + 1; Idx < Last; ++Idx)
+		{
+			const float Alpha = float(Idx - First) / float(Last - First);
+			const float Deviation = GetKeyPoseDeviation(SkeletalPoses[First], SkeletalPoses[Last], SkeletalPoses[Idx], Alpha);
+			if (Deviation > Segment.MaxDeviation)
+			{
+				Segment.MaxDeviation = Deviation;
+				Segment.SplitIdx = Idx;
+			}
+		}
+		SegmentHeap.HeapPush(Segment, SegmentPredicate);
+	};
+
+	// Start with the first and last poses, split the worst segment until the budget or the tolerance is reached
+	TBitArray<> IsKeyPose(false, NumPoses);
+	IsKeyPose[0] = true;
+	IsKeyPose[NumPoses - 1] = true;
+	int32 NumKeyPoses = 2;
+	const int32 MaxNum = MaxNumKeyPoses > 0 ? FMath::Max(MaxNumKeyPoses, 2) : NumPoses;
+	AddSegment(0, NumPoses - 1);
+	while (NumKeyPoses < MaxNum && SegmentHeap.Num() > 0)
+	{
+		FSegment Segment;
+		SegmentHeap.HeapPop(Segment, SegmentPredicate, false);
+		if (Segment.MaxDeviation <= Tolerance)
+		{
+			break;
+		}
+		IsKeyPose[Segment.SplitIdx] = true;
+		NumKeyPoses++;
+		AddSegment(Segment.First, Segment.SplitIdx);
+		AddSegment(Segment.SplitIdx, Segment.Last);
+	}
+
+	OutIndexes.Reserve(NumKeyPoses);
+	for (TConstSetBitIterator<> It(IsKeyPose); It; ++It)
+	{
+		OutIndexes.Add(It.GetIndex());
+	}
+}
+
 // Unregister the component, remove it from its outer Actor's Components array and mark for pending kill
 void USLVizSkeletalMeshMarker::DestroyComponent(bool bPromoteChildren)
 {
@@ -225,9 +425,10 @@ void USLVizSkeletalMeshMarker::DestroyComponent(bool bPromoteChildren)
 	{
 		if (PMCInst && PMCInst->IsValidLowLevel() && !PMCInst->IsPendingKillOrUnreachable())
 		{
-			PMCInst->DestroyComponent();
+			ReleasePoseableMeshInstance(PMCInst);
 		}
 	}
+	PMCInstances.Empty();
 
 	if (PMCRef && PMCRef->IsValidLowLevel() && !PMCRef->IsPendingKillOrUnreachable())
 	{
@@ -264,7 +465,7 @@ void USLVizSkeletalMeshMarker::ResetPoses()
 	{
 		if (!PMC->IsPendingKillOrUnreachable())
 		{
-			PMC->DestroyComponent();
+			ReleasePoseableMeshInstance(PMC);
 		}
 	}
 	PMCInstances.Empty();
@@ -455,7 +656,7 @@ void USLVizSkeletalMeshMarker::UpdateTimelineWithMaxNumInstances(int32 NumNewIns
 		{
 			if (TimelineIndex < TimelineMaxNumInstances)
 			{
-				bInstancesAlreadyCreated ? PMCInstances[TimelineIndex]->SetVisibility(true) : AddInstance(TimelinePoses[TimelineIndex]);				bInstancesAlreadyCreated ? PMCInstances[TimelineIndex]->SetVisibility(true) : AddInstance(TimelinePoses[TimelineIndex]);
+				bInstancesAlreadyCreated ? PMCInstances[TimelineIndex]->SetVisibility(true) : AddInstance(TimelinePoses[TimelineIndex]);
 			}
 			else
 			{
@@ -505,10 +706,56 @@ void USLVizSkeletalMeshMarker::SetPoseableMeshComponentVisual(USkeletalMesh* Ske
 // Create poseable mesh component instance attached and registered to this marker
 UPoseableMeshComponent* USLVizSkeletalMeshMarker::CreateNewPoseableMeshInstance()
 {
+	// Reuse a hidden component from the shared pool (owned by the marker owner)
+	if (PMCPool)
+	{
+		UObject* PoolOuter = GetOwner() ? static_cast<UObject*>(GetOwner()) : static_cast<UObject*>(this);
+		return PMCPool->Acquire(PoolOuter, PMCRef);
+	}
+
 	UPoseableMeshComponent* NewPMC = DuplicateObject<UPoseableMeshComponent>(PMCRef, this);
 	NewPMC->SetVisibility(true);
 	//NewPMC->AttachToComponent(this, FAttachmentTransformRules::KeepWorldTransform);
 	NewPMC->RegisterComponent();
 	return NewPMC;
 }
+
+// Return the instance to the pool, or destroy it if there is no pool
+void USLVizSkeletalMeshMarker::ReleasePoseableMeshInstance(UPoseableMeshComponent* PMC)
+{
+	if (PMCPool)
+	{
+		PMCPool->Release(PMC);
+	}
+	else
+	{
+		PMC->DestroyComponent();
+	}
+}
+
+// Apply the key pose selection to the poses (returns false if all the poses are kept)
+bool USLVizSkeletalMeshMarker::GetKeyPoses(const TArray<TPair<FTransform, TMap<int32, FTransform>>>& SkeletalPoses,
+	TArray<TPair<FTransform, TMap<int32, FTransform>>>& OutKeyPoses) const
+{
+	if (MaxNumKeyPoses <= 0 && KeyPoseTolerance < 0.f)
+	{
+		return false;
+	}
+
+	TArray<int32> KeyIndexes;
+	SelectKeyPoses(SkeletalPoses, MaxNumKeyPoses, KeyPoseTolerance, KeyIndexes);
+	if (KeyIndexes.Num() == SkeletalPoses.Num())
+	{
+		return false;
+	}
+
+	OutKeyPoses.Empty(KeyIndexes.Num());
+	for (const int32 Idx : KeyIndexes)
+	{
+		OutKeyPoses.Add(SkeletalPoses[Idx]);
+	}
+	UE_LOG(LogTemp, Log, TEXT("%s::%d %s visualizes %d key poses out of %d.."),
+		*FString(__FUNCTION__), __LINE__, *GetName(), OutKeyPoses.Num(), SkeletalPoses.Num());
+	return true;
+}
 /* End VizMarker interface */
@@ -0,0 +1,271 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "Viz/SLVizEpisodeCache.h"
+#include "Viz/SLVizEpisodeUtils.h"
+#include "Viz/SLVizEpisodeFile.h"
+#include "Mongo/SLMongoQueryDBHandler.h"
+#include "Async/Async.h"
+#include "Async/AsyncWork.h"
+
+/**
+ * Runs the episode fetch on the thread pool, deletes itself when done
+ */
+class FSLVizEpisodeFetchAsyncTask : public FNonAbandonableTask
+{
+	friend class FAutoDeleteAsyncTask<FSLVizEpisodeFetchAsyncTask>;
+
+	// Ctor
+	FSLVizEpisodeFetchAsyncTask(TFunction<void()>&& InWork) : Work(MoveTemp(InWork)) {};
+
+	// Run the fetch
+	void DoWork() { Work(); };
+
+	// Needed internally
+	FORCEINLINE TStatId GetStatId() const { RETURN_QUICK_DECLARE_CYCLE_STAT(FSLVizEpisodeFetchAsyncTask, STATGROUP_ThreadPoolAsyncTasks); }
+
+	// Fetch and hand over
+	TFunction<void()> Work;
+};
+
+// Ctor
+FSLVizEpisodeCache::FSLVizEpisodeCache() : bIsAlive(MakeShareable(new FThreadSafeBool(true)))
+{
+	UsedBytes = 0;
+	BudgetBytes = SIZE_T(4096) * 1024 * 1024;
+	MaxNumConcurrentFetches = 4;
+	NumActiveFetches = 0;
+	FetchGeneration = 0;
+}
+
+// Dtor
+FSLVizEpisodeCache::~FSLVizEpisodeCache()
+{
+	// The running fetches finish on their own, their results are dropped
+	*bIsAlive = false;
+}
+
+// Set the memory budget (evicts episodes if needed) and the number of episodes fetched in parallel
+void FSLVizEpisodeCache::SetLimits(float InMemoryBudgetMB, int32 InMaxNumConcurrentFetches)
+{
+	BudgetBytes = static_cast<SIZE_T>(FMath::Max(InMemoryBudgetMB, 1.f) * 1024.f * 1024.f);
+	MaxNumConcurrentFetches = FMath::Max(InMaxNumConcurrentFetches, 1);
+	EvictToFit(0);
+	StartPendingFetches();
+}
+
+// Check if the episode is being fetched or waiting to be fetched
+bool FSLVizEpisodeCache::IsFetching(const FString& Id) const
+{
+	return ActiveFetchIds.Contains(Id)
+		|| PendingFetches.ContainsByPredicate([&Id](const FSLVizEpisodeFetch& Fetch) { return Fetch.EpisodeId.Equals(Id); });
+}
+
+// Add the episode (evicts the least recently used episodes if the budget is exceeded)
+void FSLVizEpisodeCache::Add(const FString& Id, FSLVizEpisodeData&& Data)
+{
+	if (Contains(Id))
+	{
+		return;
+	}
+
+	const SIZE_T Size = Data.GetAllocatedSize();
+	if (Size > BudgetBytes)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d Episode %s (%.2f MB) exceeds the cache budget (%.2f MB), it will be the only cached episode.."),
+			*FString(__FUNCTION__), __LINE__, *Id, Size / (1024.f * 1024.f), BudgetBytes / (1024.f * 1024.f));
+	}
+	EvictToFit(Size);
+
+	FSLVizEpisodeCacheEntry& Entry = Entries.Add(Id);
+	Entry.Data = MoveTemp(Data);
+	Entry.Size = Size;
+	UsageOrder.Add(Id);
+	UsedBytes += Size;
+
+	UE_LOG(LogTemp, Log, TEXT("%s::%d Cached episode %s (%.2f MB), cache usage %.2f / %.2f MB (%d episodes).."),
+		*FString(__FUNCTION__), __LINE__, *Id, Size / (1024.f * 1024.f),
+		UsedBytes / (1024.f * 1024.f), BudgetBytes / (1024.f * 1024.f), Entries.Num());
+}
+
+// Get the episode and mark it as the most recently used one (nullptr if not cached)
+const FSLVizEpisodeData* FSLVizEpisodeCache::Get(const FString& Id)
+{
+	if (FSLVizEpisodeCacheEntry* Entry = Entries.Find(Id))
+	{
+		UsageOrder.Remove(Id);
+		UsageOrder.Add(Id);
+		return &Entry->Data;
+	}
+	return nullptr;
+}
+
+// Fetch and convert the episodes in the background
+void FSLVizEpisodeCache::FetchAsync(const FString& ServerIp, uint16 ServerPort, const FString& TaskId, const TArray<FString>& EpisodeIds,
+	TSharedRef<const FSLVizEpisodeHandleTable, ESPMode::ThreadSafe> HandleTable,
+	FSLVizEpisodeCachedCallback OnCached)
+{
+	for (const auto& EpisodeId : EpisodeIds)
+	{
+		if (Contains(EpisodeId) || IsFetching(EpisodeId))
+		{
+			if (OnCached && Contains(EpisodeId))
+			{
+				OnCached(EpisodeId, true);
+			}
+			continue;
+		}
+
+		FSLVizEpisodeFetch Fetch;
+		Fetch.ServerIp = ServerIp;
+		Fetch.ServerPort = ServerPort;
+		Fetch.TaskId = TaskId;
+		Fetch.EpisodeId = EpisodeId;
+		Fetch.HandleTable = HandleTable;
+		Fetch.OnCached = OnCached;
+		Fetch.Generation = FetchGeneration;
+		PendingFetches.Emplace(MoveTemp(Fetch));
+	}
+	StartPendingFetches();
+}
+
+// Remove all cached episodes, drop the fetches waiting to be started and discard the results of the running ones
+void FSLVizEpisodeCache::Empty()
+{
+	Entries.Empty();
+	UsageOrder.Empty();
+	UsedBytes = 0;
+	PendingFetches.Empty();
+
+	// The running fetches cannot be interrupted, they still count towards the concurrency limit until they finish
+	ActiveFetchIds.Empty();
+	FetchGeneration++;
+}
+
+// Start fetches until the concurrency limit is reached
+void FSLVizEpisodeCache::StartPendingFetches()
+{
+	while (PendingFetches.Num() > 0 && NumActiveFetches < MaxNumConcurrentFetches)
+	{
+		FSLVizEpisodeFetch Fetch = MoveTemp(PendingFetches[0]);
+		PendingFetches.RemoveAt(0, 1, false);
+		ActiveFetchIds.Add(Fetch.EpisodeId);
+		NumActiveFetches++;
+
+		TSharedRef<FThreadSafeBool, ESPMode::ThreadSafe> bIsAliveRef = bIsAlive;
+		(new FAutoDeleteAsyncTask<FSLVizEpisodeFetchAsyncTask>([this, Fetch, bIsAliveRef]()
+		{
+			TSharedPtr<FSLVizEpisodeData, ESPMode::ThreadSafe> Data = MakeShareable(new FSLVizEpisodeData());
+			const bool bSuccess = FetchEpisode(Fetch, *Data);
+			AsyncTask(ENamedThreads::GameThread, [this, Fetch, Data, bSuccess, bIsAliveRef]()
+			{
+				if (*bIsAliveRef)
+				{
+					OnFetchFinished(Fetch, Data, bSuccess);
+				}
+			});
+		}))->StartBackgroundTask();
+	}
+}
+
+// Fetch and convert the episode (worker thread)
+bool FSLVizEpisodeCache::FetchEpisode(const FSLVizEpisodeFetch& Fetch, FSLVizEpisodeData& OutData)
+{
+	const double ExecBegin = FPlatformTime::Seconds();
+
+	// The mongo clients are not thread safe, every fetch uses its own connection
+	FSLMongoQueryDBHandler DBHandler;
+	if (!DBHandler.Connect(Fetch.ServerIp, Fetch.ServerPort) || !DBHandler.SetDatabase(Fetch.TaskId) || !DBHandler.SetCollection(Fetch.EpisodeId))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not connect to %s.%s.."),
+			*FString(__FUNCTION__), __LINE__, *Fetch.TaskId, *Fetch.EpisodeId);
+		return false;
+	}
+
+	// Use the local episode file if the collection did not change since it was written
+	FSLVizEpisodeFileFingerprint Fingerprint;
+	DBHandler.GetCollectionFingerprint(Fingerprint.NumDocs, Fingerprint.LastTs);
+	const FString FilePath = FSLVizEpisodeFile::GetPath(Fetch.TaskId, Fetch.EpisodeId);
+	OutData.Id = Fetch.EpisodeId;
+	if (Fingerprint.IsValid() && FSLVizEpisodeFile::Read(FilePath, Fingerprint, *Fetch.HandleTable, OutData))
+	{
+		DBHandler.Disconnect();
+		UE_LOG(LogTemp, Log, TEXT("%s::%d Durations: %s.%s loaded from %s in [%f] seconds..;"),
+			*FString(__FUNCTION__), __LINE__, *Fetch.TaskId, *Fetch.EpisodeId, *FilePath, FPlatformTime::Seconds() - ExecBegin);
+		return true;
+	}
+
+	TArray<TPair<float, TMap<FString, FTransform>>> MongoEpisodeData = DBHandler.GetEpisodeData();
+	DBHandler.Disconnect();
+	const double FetchDuration = FPlatformTime::Seconds() - ExecBegin;
+	if (MongoEpisodeData.Num() == 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d The episode %s.%s data is empty.."),
+			*FString(__FUNCTION__), __LINE__, *Fetch.TaskId, *Fetch.EpisodeId);
+		return false;
+	}
+
+	OutData = FSLVizEpisodeData(MongoEpisodeData.Num());
+	OutData.Id = Fetch.EpisodeId;
+	const bool bBuilt = FSLVizEpisodeUtils::BuildEpisodeData(*Fetch.HandleTable, MongoEpisodeData, OutData);
+	if (bBuilt && Fingerprint.IsValid())
+	{
+		FSLVizEpisodeFile::Write(FilePath, Fingerprint, MongoEpisodeData);
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("%s::%d Durations: %s.%s fetch=[%f], total=[%f] seconds..;"),
+		*FString(__FUNCTION__), __LINE__, *Fetch.TaskId, *Fetch.EpisodeId,
+		FetchDuration, FPlatformTime::Seconds() - ExecBegin);
+	return bBuilt;
+}
+
+// Cache the fetched episode and start the next fetch (game thread)
+void FSLVizEpisodeCache::OnFetchFinished(const FSLVizEpisodeFetch& Fetch, TSharedPtr<FSLVizEpisodeData, ESPMode::ThreadSafe> Data, bool bSuccess)
+{
+	NumActiveFetches--;
+
+	// The cache was emptied while fetching, drop the result
+	if (Fetch.Generation != FetchGeneration)
+	{
+		StartPendingFetches();
+		if (Fetch.OnCached)
+		{
+			Fetch.OnCached(Fetch.EpisodeId, false);
+		}
+		return;
+	}
+
+	ActiveFetchIds.Remove(Fetch.EpisodeId);
+	if (bSuccess)
+	{
+		Add(Fetch.EpisodeId, MoveTemp(*Data));
+	}
+	else
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not cache episode %s.%s.."),
+			*FString(__FUNCTION__), __LINE__, *Fetch.TaskId, *Fetch.EpisodeId);
+	}
+
+	StartPendingFetches();
+
+	if (Fetch.OnCached)
+	{
+		Fetch.OnCached(Fetch.EpisodeId, bSuccess);
+	}
+}
+
+// Evict the least recently used episodes until the given number of bytes fit in the budget
+void FSLVizEpisodeCache::EvictToFit(SIZE_T NumBytes)
+{
+	while (UsageOrder.Num() > 0 && UsedBytes + NumBytes > BudgetBytes)
+	{
+		const FString Id = UsageOrder[0];
+		UsageOrder.RemoveAt(0);
+		if (FSLVizEpisodeCacheEntry* Entry = Entries.Find(Id))
+		{
+			UsedBytes -= Entry->Size;
+			Entries.Remove(Id);
+			UE_LOG(LogTemp, Log, TEXT("%s::%d Evicted episode %s from the cache.."), *FString(__FUNCTION__), __LINE__, *Id);
+		}
+	}
+}
@@ -0,0 +1,361 @@
+// Copyright 2017-present, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "Viz/SLVizEpisodeFile.h"
+#include "Viz/SLVizEpisodeManager.h"
+#include "Viz/SLVizEpisodeUtils.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Async/MappedFileHandle.h"
+#include "Serialization/MemoryReader.h"
+#include "Misc/Paths.h"
+#include "Misc/Guid.h"
+
+// Size of the header in bytes (magic, version, fingerprint, counts, section offsets)
+static constexpr int64 SLEpisodeFileHeaderSize = 4 + 4 + 8 + 8 + 4 * 4 + 3 * 8;
+
+// Size of a packed pose in bytes (id index, location, quaternion)
+static constexpr int64 SLEpisodeFilePoseSize = 4 + 7 * 4;
+
+// Header fields of the episode file
+struct FSLVizEpisodeFileHeader
+{
+	uint32 Magic = 0;
+	uint32 Version = 0;
+	int64 NumDocs = 0;
+	double LastTs = -1.0;
+	int32 NumIds = 0;
+	int32 NumFrames = 0;
+	int32 NumChunks = 0;
+	int32 FramesPerChunk = 0;
+	int64 IdTableOffset = 0;
+	int64 TimestampsOffset = 0;
+	int64 ChunkTableOffset = 0;
+
+	// Read or write the fields
+	friend FArchive& operator<<(FArchive& Ar, FSLVizEpisodeFileHeader& H)
+	{
+		Ar << H.Magic << H.Version << H.NumDocs << H.LastTs << H.NumIds << H.NumFrames << H.NumChunks << H.FramesPerChunk
+			<< H.IdTableOffset << H.TimestampsOffset << H.ChunkTableOffset;
+		return Ar;
+	}
+};
+
+// Get the local file path of the episode
+FString FSLVizEpisodeFile::GetPath(const FString& TaskId, const FString& EpisodeId)
+{
+	FString Path = FPaths::ProjectSavedDir() + TEXT("/SemLog/EpisodeCache/") + TaskId + TEXT("/") + EpisodeId + TEXT(".slep");
+	FPaths::RemoveDuplicateSlashes(Path);
+	return Path;
+}
+
+// Write the mongo episode data to the file (written to a temporary file first, then renamed)
+bool FSLVizEpisodeFile::Write(const FString& Path, const FSLVizEpisodeFileFingerprint& Fingerprint,
+	const TArray<TPair<float, TMap<FString, FTransform>>>& InMongoEpisodeData)
+{
+	const double ExecBegin = FPlatformTime::Seconds();
+
+	// The poses reference the ids by their index
+	TMap<FString, int32> IdToIdx;
+	TArray<FString> Ids;
+	for (const auto& Frame : InMongoEpisodeData)
+	{
+		for (const auto& IndividualPosePair : Frame.Value)
+		{
+			if (!IdToIdx.Contains(IndividualPosePair.Key))
+			{
+				IdToIdx.Add(IndividualPosePair.Key, Ids.Add(IndividualPosePair.Key));
+			}
+		}
+	}
+
+	// Unique temporary file, the sync and the async caching of the same episode can write at the same time
+	const FString TempPath = Path + TEXT(".") + FGuid::NewGuid().ToString() + TEXT(".tmp");
+	TUniquePtr<FArchive> Ar(IFileManager::Get().CreateFileWriter(*TempPath));
+	if (!Ar)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not create %s.."), *FString(__FUNCTION__), __LINE__, *TempPath);
+		return false;
+	}
+
+	FSLVizEpisodeFileHeader Header;
+	Header.Magic = Magic;
+	Header.Version = Version;
+	Header.NumDocs = Fingerprint.NumDocs;
+	Header.LastTs = Fingerprint.LastTs;
+	Header.NumIds = Ids.Num();
+	Header.NumFrames = InMongoEpisodeData.Num();
+	Header.FramesPerChunk = FramesPerChunk;
+	Header.NumChunks = (Header.NumFrames + FramesPerChunk - 1) / FramesPerChunk;
+
+	// The offsets are filled in after the sections are written
+	*Ar << Header;
+
+	Header.IdTableOffset = Ar->Tell();
+	for (const auto& Id : Ids)
+	{
+		FTCHARToUTF8 Utf8Id(*Id);
+		int32 Length = Utf8Id.Length();
+		*Ar << Length;
+		Ar->Serialize(const_cast<ANSICHAR*>(Utf8Id.Get()), Length);
+	}
+
+	Header.TimestampsOffset = Ar->Tell();
+	for (const auto& Frame : InMongoEpisodeData)
+	{
+		float Ts = Frame.Key;
+		*Ar << Ts;
+	}
+
+	Header.ChunkTableOffset = Ar->Tell();
+	TArray<int64> ChunkTable;
+	ChunkTable.SetNumZeroed(Header.NumChunks * 2);
+	for (int64& Value : ChunkTable)
+	{
+		*Ar << Value;
+	}
+
+	for (int32 ChunkIdx = 0; ChunkIdx < Header.NumChunks; ++ChunkIdx)
+	{
+		ChunkTable[ChunkIdx * 2] = Ar->Tell();
+		const int32 LastFrameIdx = FMath::Min((ChunkIdx + 1) * FramesPerChunk, Header.NumFrames);
+		for (int32 FrameIdx = ChunkIdx * FramesPerChunk; FrameIdx < LastFrameIdx; ++FrameIdx)
+		{
+			int32 NumPoses = InMongoEpisodeData[FrameIdx].Value.Num();
+			*Ar << NumPoses;
+			for (const auto& IndividualPosePair : InMongoEpisodeData[FrameIdx].Value)
+			{
+				int32 IdIdx = IdToIdx[IndividualPosePair.Key];
+				const FVector Loc = IndividualPosePair.Value.GetLocation();
+				const FQuat Quat = IndividualPosePair.Value.GetRotation();
+				float Values[7] = { (float)Loc.X, (float)Loc.Y, (float)Loc.Z, (float)Quat.X, (float)Quat.Y, (float)Quat.Z, (float)Quat.W };
+				*Ar << IdIdx;
+				for (float& Value : Values)
+				{
+					*Ar << Value;
+				}
+			}
+		}
+		ChunkTable[ChunkIdx * 2 + 1] = Ar->Tell() - ChunkTable[ChunkIdx * 2];
+	}
+	const int64 FileSize = Ar->Tell();
+
+	// Fill in the offsets
+	Ar->Seek(0);
+	*Ar << Header;
+	Ar->Seek(Header.ChunkTableOffset);
+	for (int64& Value : ChunkTable)
+	{
+		*Ar << Value;
+	}
+
+	const bool bWritten = !Ar->IsError() && Ar->Close();
+	Ar.Reset();
+	if (!bWritten || !IFileManager::Get().Move(*Path, *TempPath, true))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not write %s.."), *FString(__FUNCTION__), __LINE__, *Path);
+		IFileManager::Get().Delete(*TempPath);
+		return false;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("%s::%d Wrote %s (frames=%d, ids=%d, %.2f MB) in [%f] seconds..;"),
+		*FString(__FUNCTION__), __LINE__, *Path, Header.NumFrames, Header.NumIds,
+		FileSize / (1024.f * 1024.f), FPlatformTime::Seconds() - ExecBegin);
+	return true;
+}
+
+// Build the replay episode data from the file if it exists and matches the fingerprint
+bool FSLVizEpisodeFile::Read(const FString& Path, const FSLVizEpisodeFileFingerprint& Fingerprint,
+	const FSLVizEpisodeHandleTable& ResolvedHandleTable, FSLVizEpisodeData& OutVizEpisodeData)
+{
+	const double ExecBegin = FPlatformTime::Seconds();
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	if (!PlatformFile.FileExists(*Path))
+	{
+		return false;
+	}
+
+	TUniquePtr<IFileHandle> File(PlatformFile.OpenRead(*Path));
+	if (!File)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d Could not open %s.."), *FString(__FUNCTION__), __LINE__, *Path);
+		return false;
+	}
+	const int64 FileSize = File->Size();
+
+	// Read a section of the file into the buffer (false if it is out of bounds)
+	auto ReadSection = [&File, FileSize](int64 Offset, int64 Size, uint8* OutData)
+	{
+		return Offset >= 0 && Size >= 0 && Offset + Size <= FileSize
+			&& File->Seek(Offset) && (Size == 0 || File->Read(OutData, Size));
+	};
+
+	TArray<uint8> Buffer;
+	Buffer.SetNumUninitialized(SLEpisodeFileHeaderSize);
+	if (!ReadSection(0, SLEpisodeFileHeaderSize, Buffer.GetData()))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d %s is too small, ignoring.."), *FString(__FUNCTION__), __LINE__, *Path);
+		return false;
+	}
+	FSLVizEpisodeFileHeader Header;
+	FMemoryReader HeaderReader(Buffer);
+	HeaderReader << Header;
+	if (Header.Magic != Magic || Header.Version != Version || Header.FramesPerChunk <= 0
+		|| Header.NumFrames <= 0 || Header.NumIds < 0 || Header.NumChunks != (Header.NumFrames + Header.FramesPerChunk - 1) / Header.FramesPerChunk)
+	{
+		UE_LOG(LogTemp, Log, TEXT("%s::%d %s has an unknown format or version, ignoring.."), *FString(__FUNCTION__), __LINE__, *Path);
+		return false;
+	}
+	if (!(FSLVizEpisodeFileFingerprint(Header.NumDocs, Header.LastTs) == Fingerprint))
+	{
+		UE_LOG(LogTemp, Log, TEXT("%s::%d %s is outdated (the episode collection changed), ignoring.."), *FString(__FUNCTION__), __LINE__, *Path);
+		return false;
+	}
+
+	// The sections are in order and within the file, and every id (at least its length) fits in the id table, checked before any allocation
+	if (Header.IdTableOffset < SLEpisodeFileHeaderSize
+		|| Header.TimestampsOffset < Header.IdTableOffset
+		|| Header.ChunkTableOffset < Header.TimestampsOffset + (int64)Header.NumFrames * (int64)sizeof(float)
+		|| Header.ChunkTableOffset + (int64)Header.NumChunks * 2 * (int64)sizeof(int64) > FileSize
+		|| (int64)Header.NumIds * 4 > Header.TimestampsOffset - Header.IdTableOffset)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d %s has invalid section offsets, ignoring.."), *FString(__FUNCTION__), __LINE__, *Path);
+		return false;
+	}
+
+	// Map the file ids to the replay handles
+	Buffer.SetNumUninitialized(Header.TimestampsOffset - Header.IdTableOffset);
+	if (!ReadSection(Header.IdTableOffset, Buffer.Num(), Buffer.GetData()))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d %s is corrupted, ignoring.."), *FString(__FUNCTION__), __LINE__, *Path);
+		return false;
+	}
+	TArray<int32> IdxToHandle;
+	IdxToHandle.Reserve(Header.NumIds);
+	int64 Pos = 0;
+	for (int32 IdIdx = 0; IdIdx < Header.NumIds; ++IdIdx)
+	{
+		int32 Length = 0;
+		if (Pos + 4 > Buffer.Num())
+		{
+			break;
+		}
+		FMemory::Memcpy(&Length, Buffer.GetData() + Pos, 4);
+		Pos += 4;
+		if (Length < 0 || Pos + Length > Buffer.Num())
+		{
+			break;
+		}
+		FUTF8ToTCHAR TCharId(reinterpret_cast<const ANSICHAR*>(Buffer.GetData() + Pos), Length);
+		const FString Id(TCharId.Length(), TCharId.Get());
+		Pos += Length;
+
+		const int32* Handle = ResolvedHandleTable.IdToHandle.Find(Id);
+		if (!Handle || *Handle == INDEX_NONE)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("%s::%d Could not find individual with id=%s, ignoring %s.."),
+				*FString(__FUNCTION__), __LINE__, *Id, *Path);
+			return false;
+		}
+		IdxToHandle.Add(*Handle);
+	}
+	if (IdxToHandle.Num() != Header.NumIds)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d %s is corrupted, ignoring.."), *FString(__FUNCTION__), __LINE__, *Path);
+		return false;
+	}
+
+	TArray<float> Timestamps;
+	Timestamps.SetNumUninitialized(Header.NumFrames);
+	TArray<int64> ChunkTable;
+	ChunkTable.SetNumUninitialized(Header.NumChunks * 2);
+	if (!ReadSection(Header.TimestampsOffset, Timestamps.Num() * sizeof(float), reinterpret_cast<uint8*>(Timestamps.GetData()))
+		|| !ReadSection(Header.ChunkTableOffset, ChunkTable.Num() * sizeof(int64), reinterpret_cast<uint8*>(ChunkTable.GetData())))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d %s is corrupted, ignoring.."), *FString(__FUNCTION__), __LINE__, *Path);
+		return false;
+	}
+
+	// The chunks are mapped one at a time, if the platform does not support mapping they are read into a buffer
+	TUniquePtr<IMappedFileHandle> MappedFile(PlatformFile.OpenMapped(*Path));
+	TUniquePtr<IMappedFileRegion> MappedChunk;
+	TArray<uint8> ChunkBuffer;
+	const uint8* ChunkData = nullptr;
+	const uint8* ChunkEnd = nullptr;
+	int32 CurrChunkIdx = INDEX_NONE;
+
+	const FString EpisodeId = OutVizEpisodeData.Id;
+	OutVizEpisodeData = FSLVizEpisodeData(Header.NumFrames);
+	OutVizEpisodeData.Id = EpisodeId;
+	const bool bBuilt = FSLVizEpisodeUtils::BuildEpisodeData(ResolvedHandleTable, Header.NumFrames,
+		[&](int32 FrameIndex, float& OutTs, TArray<TPair<int32, FTransform>>& OutHandlePoses)
+		{
+			const int32 ChunkIdx = FrameIndex / Header.FramesPerChunk;
+			if (ChunkIdx != CurrChunkIdx)
+			{
+				const int64 Offset = ChunkTable[ChunkIdx * 2];
+				const int64 Size = ChunkTable[ChunkIdx * 2 + 1];
+				if (Offset < 0 || Size <= 0 || Offset + Size > FileSize)
+				{
+					UE_LOG(LogTemp, Warning, TEXT("%s::%d %s chunk %d is out of bounds.."), *FString(__FUNCTION__), __LINE__, *Path, ChunkIdx);
+					return false;
+				}
+				MappedChunk.Reset();
+				if (MappedFile)
+				{
+					MappedChunk.Reset(MappedFile->MapRegion(Offset, Size));
+				}
+				if (MappedChunk)
+				{
+					ChunkData = MappedChunk->GetMappedPtr();
+				}
+				else
+				{
+					ChunkBuffer.SetNumUninitialized(Size);
+					if (!ReadSection(Offset, Size, ChunkBuffer.GetData()))
+					{
+						return false;
+					}
+					ChunkData = ChunkBuffer.GetData();
+				}
+				ChunkEnd = ChunkData + Size;
+				CurrChunkIdx = ChunkIdx;
+			}
+
+			int32 NumPoses = 0;
+			if (ChunkData + 4 > ChunkEnd)
+			{
+				return false;
+			}
+			FMemory::Memcpy(&NumPoses, ChunkData, 4);
+			ChunkData += 4;
+			if (NumPoses < 0 || ChunkData + NumPoses * SLEpisodeFilePoseSize > ChunkEnd)
+			{
+				UE_LOG(LogTemp, Warning, TEXT("%s::%d %s frame %d is corrupted.."), *FString(__FUNCTION__), __LINE__, *Path, FrameIndex);
+				return false;
+			}
+			for (int32 PoseIdx = 0; PoseIdx < NumPoses; ++PoseIdx)
+			{
+				int32 IdIdx;
+				float Values[7];
+				FMemory::Memcpy(&IdIdx, ChunkData, 4);
+				FMemory::Memcpy(Values, ChunkData + 4, sizeof(Values));
+				ChunkData += SLEpisodeFilePoseSize;
+				if (!IdxToHandle.IsValidIndex(IdIdx))
+				{
+					return false;
+				}
+				OutHandlePoses.Emplace(IdxToHandle[IdIdx],
+					FTransform(FQuat(Values[3], Values[4], Values[5], Values[6]), FVector(Values[0], Values[1], Values[2])));
+			}
+			OutTs = Timestamps[FrameIndex];
+			return true;
+		},
+		OutVizEpisodeData);
+
+	UE_LOG(LogTemp, Log, TEXT("%s::%d Read %s (frames=%d, ids=%d, mapped=%d) in [%f] seconds..;"),
+		*FString(__FUNCTION__), __LINE__, *Path, Header.NumFrames, Header.NumIds, MappedFile.IsValid(),
+		FPlatformTime::Seconds() - ExecBegin);
+	return bBuilt;
+}
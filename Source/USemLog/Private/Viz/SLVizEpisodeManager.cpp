@@ -3,6 +3,7 @@
 
 #include "Viz/SLVizEpisodeManager.h"
 #include "Viz/SLVizEpisodeUtils.h"
+#include "Mongo/SLMongoEpisodeStreamer.h"
 #include "Components/PoseableMeshComponent.h"
 
 // Sets default values
@@ -22,6 +23,8 @@ ASLVizEpisodeManager::ASLVizEpisodeManager()
 	ReplayFirstFrameIndex = INDEX_NONE;
 	ReplayLastFrameIndex = INDEX_NONE;
 	ReplayStepSize = 1;
+	StreamIndividualManager = nullptr;
+	NumStreamFramesWithUnknownIds = 0;
 
 #if WITH_EDITORONLY_DATA
 	// Make manager sprite smaller (used to easily find the actor in the world)
@@ -36,7 +39,11 @@ void ASLVizEpisodeManager::Tick(float DeltaTime)
 
 	if (!ApplyNextFrameChanges())
 	{
-		if (bLoopReplay)
+		if (bLoopReplay && EpisodeStreamer.IsValid())
+		{
+			EpisodeStreamer->Restart();
+		}
+		else if (bLoopReplay)
 		{
 			ActiveFrameIndex = ReplayFirstFrameIndex;
 			GotoFrame(ActiveFrameIndex);
@@ -129,14 +136,23 @@ bool ASLVizEpisodeManager::GotoFrame(int32 FrameIndex)
 		return false;
 	}
 
-	if(!EpisodeData.FullFrames.IsValidIndex(FrameIndex))
+	if(!EpisodeData.CompactFrames.IsValidIndex(FrameIndex))
 	{
 		UE_LOG(LogTemp, Warning, TEXT("%s::%d Frame index is not valid, this should not happen.."), *FString(__FUNCTION__), __LINE__);
 		return false;
 	}
 
+	// Seek to the nearest previous keyframe and roll forward the changes (applied at once)
+	const int32 KeyFrameIndex = EpisodeData.GetKeyFrameIndex(FrameIndex);
+	FSLVizEpisodeFrameData RollForwardChanges;
+	for (int32 Idx = KeyFrameIndex * EpisodeData.KeyFrameInterval + 1; Idx <= FrameIndex; ++Idx)
+	{
+		MergeFrameChanges(EpisodeData.CompactFrames[Idx], RollForwardChanges);
+	}
+
 	ActiveFrameIndex = FrameIndex;
-	ApplyPoses(EpisodeData.FullFrames[FrameIndex]);
+	ApplyPoses(EpisodeData.KeyFrames[KeyFrameIndex]);
+	ApplyPoses(RollForwardChanges);
 
 	//UE_LOG(LogTemp, Log, TEXT("%s::%d Applied poses from frame %d.."), *FString(__FUNCTION__), __LINE__, ActiveFrameIndex);
 	return true;
@@ -251,6 +267,38 @@ bool ASLVizEpisodeManager::PlayTimeline(float StartTime, float EndTime)
 	return PlayFrames(StartFrameIndex, EndFrameIndex);
 }
 
+// Play the frames from the episode streamer (the episode does not need to be loaded)
+bool ASLVizEpisodeManager::PlayStream(TSharedPtr<FSLMongoEpisodeStreamer> InEpisodeStreamer, ASLIndividualManager* InIndividualManager,
+	const FSLVizEpisodePlayParams& PlayParams)
+{
+	if (!bWorldSetAsVisualOnly)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d World is not set as visual only.."), *FString(__FUNCTION__), __LINE__);
+		return false;
+	}
+
+	if (!InEpisodeStreamer.IsValid() || !InIndividualManager)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d The episode streamer or the individual manager is not valid.."), *FString(__FUNCTION__), __LINE__);
+		return false;
+	}
+
+	// Stop any previous replays
+	StopReplay();
+
+	EpisodeStreamer = InEpisodeStreamer;
+	StreamIndividualManager = InIndividualManager;
+	NumStreamFramesWithUnknownIds = 0;
+	bLoopReplay = PlayParams.bLoop;
+
+	// Without cached timestamps the default update rate cannot be approximated, the frames are applied every tick
+	SetActorTickInterval(PlayParams.UpdateRate > 0.f ? PlayParams.UpdateRate : 0.f);
+
+	// Start playing the frames as they arrive
+	StartReplay();
+	return true;
+}
+
 // Set replay parameters
 void ASLVizEpisodeManager::SetReplayParams(bool bLoop, float UpdateRate, int32 StepSize)
 {
@@ -271,7 +319,13 @@ void ASLVizEpisodeManager::SetPauseReplay(bool bPause)
 // Stop replay, goto first frame
 void ASLVizEpisodeManager::StopReplay()
 {
-	if (bReplayRunning || IsActorTickEnabled())
+	if (EpisodeStreamer.IsValid())
+	{
+		SetActorTickEnabled(false);
+		bReplayRunning = false;
+		ClearStream();
+	}
+	else if (bReplayRunning || IsActorTickEnabled())
 	{
 		SetActorTickEnabled(false);
 		bReplayRunning = false;
@@ -474,28 +528,64 @@ void ASLVizEpisodeManager::StopReplay()
 // Apply the next frames changes
 bool ASLVizEpisodeManager::ApplyNextFrameChanges()
 {
+	if (EpisodeStreamer.IsValid())
+	{
+		return ApplyNextStreamedFrame();
+	}
+
 	if (ActiveFrameIndex < ReplayLastFrameIndex)
 	{
 		ActiveFrameIndex++;
-		//if (EpisodeData.CompactFrames.IsValidIndex(ActiveFrameIndex))
-		if (EpisodeData.FullFrames.IsValidIndex(ActiveFrameIndex))
+		if (EpisodeData.CompactFrames.IsValidIndex(ActiveFrameIndex))
 		{
-			//ApplyPoses(EpisodeData.CompactFrames[ActiveFrameIndex]);
-			ApplyPoses(EpisodeData.FullFrames[ActiveFrameIndex]);
+			// The world is in the previous frame state, only the changes need to be applied
+			ApplyPoses(EpisodeData.CompactFrames[ActiveFrameIndex]);
 			return true;
 		}
 		else
 		{
-			//UE_LOG(LogTemp, Warning, TEXT("%s::%d ActiveFrameIndex=%d (Num=%d) is not valid, this should not happen.."),
-			//	*FString(__FUNCTION__), __LINE__, ActiveFrameIndex, EpisodeData.CompactFrames.Num());
 			UE_LOG(LogTemp, Warning, TEXT("%s::%d ActiveFrameIndex=%d (Num=%d) is not valid, this should not happen.."),
-				*FString(__FUNCTION__), __LINE__, ActiveFrameIndex, EpisodeData.FullFrames.Num());
+				*FString(__FUNCTION__), __LINE__, ActiveFrameIndex, EpisodeData.CompactFrames.Num());
 			ActiveFrameIndex--;
 		}
 	}
 	return false;	
 }
 
+// Apply the next streamed frame (return false if there are no more frames)
+bool ASLVizEpisodeManager::ApplyNextStreamedFrame()
+{
+	TPair<float, TMap<FString, FTransform>> MongoFrame;
+	if (EpisodeStreamer->Dequeue(MongoFrame))
+	{
+		// The first streamed frame is the full world state, the rest only hold the changes
+		FSLVizEpisodeFrameData FrameData;
+		if (!FSLVizEpisodeUtils::BuildFrameData(StreamIndividualManager, StreamHandleTable, MongoFrame.Value, FrameData)
+			&& NumStreamFramesWithUnknownIds++ == 0)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("%s::%d Frame at %f has unknown individuals, they are ignored.."),
+				*FString(__FUNCTION__), __LINE__, MongoFrame.Key);
+		}
+		ApplyPoses(FrameData);
+		return true;
+	}
+
+	// Keep ticking if the worker did not prefetch the next frame yet
+	return !EpisodeStreamer->IsFinished();
+}
+
+// Stop the streamer and clear the streaming data
+void ASLVizEpisodeManager::ClearStream()
+{
+	if (EpisodeStreamer.IsValid())
+	{
+		EpisodeStreamer->Shutdown();
+		EpisodeStreamer.Reset();
+	}
+	StreamIndividualManager = nullptr;
+	StreamHandleTable.Empty();
+}
+
 // Start replay
 void ASLVizEpisodeManager::StartReplay()
 {
@@ -530,6 +620,23 @@ void ASLVizEpisodeManager::ApplyPoses(const FSLVizEpisodeFrameData& Frame)
 	}
 }
 
+// Merge the changes of the given frame into the accumulated changes
+void ASLVizEpisodeManager::MergeFrameChanges(const FSLVizEpisodeFrameData& Changes, FSLVizEpisodeFrameData& OutAccumulated)
+{
+	for (const auto& ActorPosePair : Changes.ActorPoses)
+	{
+		OutAccumulated.ActorPoses.Add(ActorPosePair.Key, ActorPosePair.Value);
+	}
+	for (const auto& PMCBonePosesPair : Changes.BonePoses)
+	{
+		TMap<int32, FTransform>& AccumulatedBonePoses = OutAccumulated.BonePoses.FindOrAdd(PMCBonePosesPair.Key);
+		for (const auto& BoneIndexPosePair : PMCBonePosesPair.Value)
+		{
+			AccumulatedBonePoses.Add(BoneIndexPosePair.Key, BoneIndexPosePair.Value);
+		}
+	}
+}
+
 // Calculate an approximation of the update rate value to coincide with realtime
 void ASLVizEpisodeManager::CalcRealtimeAproxUpdateRateValue(int32 MaxNumSteps)
 {
@@ -81,121 +81,203 @@ bool FSLVizEpisodeUtils::BuildEpisodeData(ASLIndividualManager* IndividualManage
 	const TArray<TPair<float, TMap<FString, FTransform>>>& InMongoEpisodeData,
 	FSLVizEpisodeData& OutVizEpisodeData)
 {
-	double ExecBegin = FPlatformTime::Seconds();
-	/* First frame (FullFrame -  contains all the data) */
-	// Process first frame (contains all individuals -- the rest of the frames contain only individuals that have moved)
-	FSLVizEpisodeFrameData FullFrameData;
+	// The individuals are resolved and classified once, the frames are processed using their dense handles
+	FSLVizEpisodeHandleTable HandleTable;
+	BuildHandleTable(IndividualManager, HandleTable);
+	return BuildEpisodeData(HandleTable,
+		[IndividualManager, &HandleTable](const FString& Id) { return GetOrAddHandle(IndividualManager, Id, HandleTable); },
+		InMongoEpisodeData, OutVizEpisodeData);
+}
+
+// Build the full replay episode data using already resolved handles (does not access the individuals, safe to call from worker threads)
+bool FSLVizEpisodeUtils::BuildEpisodeData(const FSLVizEpisodeHandleTable& ResolvedHandleTable,
+	const TArray<TPair<float, TMap<FString, FTransform>>>& InMongoEpisodeData,
+	FSLVizEpisodeData& OutVizEpisodeData)
+{
+	return BuildEpisodeData(ResolvedHandleTable,
+		[&ResolvedHandleTable](const FString& Id)
+		{
+			const int32* Handle = ResolvedHandleTable.IdToHandle.Find(Id);
+			return Handle ? *Handle : INDEX_NONE;
+		},
+		InMongoEpisodeData, OutVizEpisodeData);
+}
 
-	// Iterate individuals with their poses
-	for (const auto& IndividualPosePair : InMongoEpisodeData[0].Value)
+// Resolve the handles of all the individuals from the manager (game thread)
+void FSLVizEpisodeUtils::BuildHandleTable(ASLIndividualManager* IndividualManager, FSLVizEpisodeHandleTable& OutHandleTable)
+{
+	for (const auto& Individual : IndividualManager->GetIndividuals())
 	{
-		const FString IndividualId = IndividualPosePair.Key;
-		const FTransform IndividualPose = IndividualPosePair.Value;
+		GetOrAddHandle(IndividualManager, Individual->GetIdValue(), OutHandleTable);
+	}
+}
 
-		if (auto Individual = IndividualManager->GetIndividual(IndividualId))
+// Build the episode data, the handles are provided by the given function
+bool FSLVizEpisodeUtils::BuildEpisodeData(const FSLVizEpisodeHandleTable& HandleTable,
+	TFunctionRef<int32(const FString&)> GetHandle,
+	const TArray<TPair<float, TMap<FString, FTransform>>>& InMongoEpisodeData,
+	FSLVizEpisodeData& OutVizEpisodeData)
+{
+	return BuildEpisodeData(HandleTable, InMongoEpisodeData.Num(),
+		[&](int32 FrameIndex, float& OutTs, TArray<TPair<int32, FTransform>>& OutHandlePoses)
 		{
-			if (Individual->IsA(USLRigidIndividual::StaticClass())
-			|| Individual->IsA(USLSkeletalIndividual::StaticClass())
-			|| Individual->IsA(USLVirtualViewIndividual::StaticClass()))
-			{
-				FullFrameData.ActorPoses.Emplace(Individual->GetParentActor(), IndividualPose);
-			}
-			else if (auto BI = Cast<USLBoneIndividual>(Individual))
-			{
-				FullFrameData.BonePoses.FindOrAdd(BI->GetPoseableMeshComponent()).Add(BI->GetBoneIndex(), IndividualPose);
-			}
-			else if (auto VBI = Cast<USLVirtualBoneIndividual>(Individual))
+			for (const auto& IndividualPosePair : InMongoEpisodeData[FrameIndex].Value)
 			{
-				FullFrameData.BonePoses.FindOrAdd(VBI->GetPoseableMeshComponent()).Add(VBI->GetBoneIndex(), IndividualPose);
+				const int32 Handle = GetHandle(IndividualPosePair.Key);
+				if (Handle == INDEX_NONE)
+				{
+					UE_LOG(LogTemp, Warning, TEXT("%s::%d Could not find individual with id=%s, this should not happen, aborting.."),
+						*FString(__FUNCTION__), __LINE__, *IndividualPosePair.Key);
+					return false;
+				}
+				OutHandlePoses.Emplace(Handle, IndividualPosePair.Value);
 			}
-		}
-		else
-		{
-			UE_LOG(LogTemp, Warning, TEXT("%s::%d Could not find individual with id=%s, this should not happen, aborting.."),
-				*FString(__FUNCTION__), __LINE__, *IndividualPosePair.Key);
-			return false;
-		}
-	}
-	// Add the timestamp
-	//OutVizEpisodeData.Timestamps[0] = InMongoEpisodeData[0].Key;
-	OutVizEpisodeData.Timestamps.Emplace(InMongoEpisodeData[0].Key);
+			OutTs = InMongoEpisodeData[FrameIndex].Key;
+			return true;
+		},
+		OutVizEpisodeData);
+}
 
-	double FirstFrameDuration = FPlatformTime::Seconds() - ExecBegin;
+// Build the full replay episode data from frames of handle poses (GetFrame returns false on errors)
+bool FSLVizEpisodeUtils::BuildEpisodeData(const FSLVizEpisodeHandleTable& HandleTable, int32 NumFrames,
+	TFunctionRef<bool(int32, float&, TArray<TPair<int32, FTransform>>&)> GetFrame,
+	FSLVizEpisodeData& OutVizEpisodeData)
+{
+	double ExecBegin = FPlatformTime::Seconds();
 
-	// Add the individuals poses
-	//OutVizEpisodeData.Frames[0] = FullFrameData;
-	OutVizEpisodeData.FullFrames.Emplace(FullFrameData);
-	OutVizEpisodeData.CompactFrames.Emplace(FullFrameData);
+	// Latest pose of every handle (the first frame contains all individuals, the rest only the ones that moved)
+	TArray<FTransform> CurrentPoses;
+	CurrentPoses.SetNum(HandleTable.Num());
 
-	/* Process the following frames */
-	// Update full frame with the new transform values
-	// Create compact frame holding only the changes fromt he previous frame
-	for (int32 FrameIndex = 1; FrameIndex < InMongoEpisodeData.Num(); ++FrameIndex)
-	{
-		if (FrameIndex % 250 == 0) { UE_LOG(LogTemp, Log, TEXT(" processing frame %d / %d .."),  FrameIndex, InMongoEpisodeData.Num()); }
+	// Handles with a pose, the table can hold handles which are not part of any frame yet (these are not moved by the keyframes)
+	TBitArray<> HasPose(false, HandleTable.Num());
 
-		// TODO will emplace make a copy, or one needs to make one here ?
-		//FSLVizEpisodeFrameData PrevFrameCopy = FullFrameData;
-		FSLVizEpisodeFrameData CompactFrameData;
+	// Handles and poses of the individuals in the current frame
+	TArray<TPair<int32, FTransform>> FrameHandlePoses;
 
-		// Iterate individuals with their poses
-		for (const auto& IndividualPosePair : InMongoEpisodeData[FrameIndex].Value)
+	for (int32 FrameIndex = 0; FrameIndex < NumFrames; ++FrameIndex)
+	{
+		if (FrameIndex % 250 == 0) { UE_LOG(LogTemp, Log, TEXT(" processing frame %d / %d .."),  FrameIndex, NumFrames); }
+
+		// Update the latest poses with the frame values
+		float Timestamp = 0.f;
+		FrameHandlePoses.Reset();
+		if (!GetFrame(FrameIndex, Timestamp, FrameHandlePoses))
 		{
-			const FString IndividualId = IndividualPosePair.Key;
-			const FTransform IndividualPose = IndividualPosePair.Value;
-			if (auto Individual = IndividualManager->GetIndividual(IndividualId))
+			return false;
+		}
+		for (const auto& HandlePosePair : FrameHandlePoses)
+		{
+			// Handles added while building (lazily resolved individuals)
+			if (HandlePosePair.Key >= CurrentPoses.Num())
 			{
-				if (Individual->IsA(USLRigidIndividual::StaticClass())
-					|| Individual->IsA(USLSkeletalIndividual::StaticClass())
-					|| Individual->IsA(USLVirtualViewIndividual::StaticClass()))
-				{
-					// Update the full frame with the new value
-					//if (auto FoundActorPose = FullFrameData.ActorPoses.Find(RI->GetParentActor())){(*FoundActorPose) = IndividualPose;}
-					FullFrameData.ActorPoses.FindChecked(Individual->GetParentActor()) = IndividualPose;
-					// Add as new data to the compact frame
-					CompactFrameData.ActorPoses.Emplace(Individual->GetParentActor(), IndividualPose);
-
-					if (IndividualId.Equals("6HI1inL7OUKmqNXGXI81YA"))
-					{
-						UE_LOG(LogTemp, Log, TEXT("%s::%d Pose=%s;"), *FString(__FUNCTION__), __LINE__, *IndividualPose.ToString());
-					}
-				}
-				else if (auto BI = Cast<USLBoneIndividual>(Individual))
-				{
-					FullFrameData.BonePoses.FindOrAdd(BI->GetPoseableMeshComponent()).Add(BI->GetBoneIndex(), IndividualPose);
-					CompactFrameData.BonePoses.FindOrAdd(BI->GetPoseableMeshComponent()).Add(BI->GetBoneIndex(), IndividualPose);
-				}
-				else if (auto VBI = Cast<USLVirtualBoneIndividual>(Individual))
-				{
-					FullFrameData.BonePoses.FindOrAdd(VBI->GetPoseableMeshComponent()).Add(VBI->GetBoneIndex(), IndividualPose);
-					CompactFrameData.BonePoses.FindOrAdd(VBI->GetPoseableMeshComponent()).Add(VBI->GetBoneIndex(), IndividualPose);
-				}
+				CurrentPoses.SetNum(HandlePosePair.Key + 1);
+				HasPose.Add(false, HandlePosePair.Key + 1 - HasPose.Num());
 			}
-			else
+			CurrentPoses[HandlePosePair.Key] = HandlePosePair.Value;
+			HasPose[HandlePosePair.Key] = true;
+		}
+
+		// Compact frame holding only the changes from the previous frame
+		FSLVizEpisodeFrameData CompactFrameData;
+		for (const auto& HandlePosePair : FrameHandlePoses)
+		{
+			HandleTable.AddPose(HandlePosePair.Key, HandlePosePair.Value, CompactFrameData);
+		}
+
+		// Full frame stored only every keyframe interval (the first frame is a keyframe)
+		if (OutVizEpisodeData.IsKeyFrame(FrameIndex))
+		{
+			FSLVizEpisodeFrameData KeyFrameData;
+			for (TConstSetBitIterator<> HandleItr(HasPose); HandleItr; ++HandleItr)
 			{
-				UE_LOG(LogTemp, Warning, TEXT("%s::%d Could not find individual with id=%s, this should not happen, aborting.."),
-					*FString(__FUNCTION__), __LINE__, *IndividualId);
-				return false;
+				HandleTable.AddPose(HandleItr.GetIndex(), CurrentPoses[HandleItr.GetIndex()], KeyFrameData);
 			}
+			OutVizEpisodeData.KeyFrames.Emplace(MoveTemp(KeyFrameData));
 		}
 
-		// Add the timestamp
-		//OutVizEpisodeData.Timestamps[FrameIndex] = InMongoEpisodeData[FrameIndex].Key;
-		OutVizEpisodeData.Timestamps.Emplace(InMongoEpisodeData[FrameIndex].Key);
-
-		// Add the individuals poses
-		//OutFullEpisodeData.Frames[FrameIndex] = FullFrameData;
-		OutVizEpisodeData.FullFrames.Emplace(FullFrameData);
-		OutVizEpisodeData.CompactFrames.Emplace(CompactFrameData);
+		OutVizEpisodeData.Timestamps.Emplace(Timestamp);
+		OutVizEpisodeData.CompactFrames.Emplace(MoveTemp(CompactFrameData));
 	}
-	
-	double FollowingFramesDuration = FPlatformTime::Seconds() - ExecBegin - FirstFrameDuration;
-	UE_LOG(LogTemp, Log, TEXT("%s::%d Durations: first frame=[%f], following frames(num=%d)=[%f], total=[%f] seconds..;"),
-		*FString(__func__), __LINE__, FirstFrameDuration, OutVizEpisodeData.Timestamps.Num(),
-		FollowingFramesDuration, FPlatformTime::Seconds() - ExecBegin);
+
+	UE_LOG(LogTemp, Log, TEXT("%s::%d Durations: frames(num=%d, handles=%d)=[%f] seconds..;"),
+		*FString(__func__), __LINE__, OutVizEpisodeData.Timestamps.Num(), HandleTable.Num(),
+		FPlatformTime::Seconds() - ExecBegin);
+	UE_LOG(LogTemp, Log, TEXT("%s::%d Memory: keyframes(num=%d, interval=%d), total=[%.2f] MB..;"),
+		*FString(__func__), __LINE__, OutVizEpisodeData.KeyFrames.Num(), OutVizEpisodeData.KeyFrameInterval,
+		OutVizEpisodeData.GetAllocatedSize() / (1024.f * 1024.f));
 	return true;
 }
 
+// Build the replay frame data from a single mongo frame (returns false if some individuals are unknown)
+bool FSLVizEpisodeUtils::BuildFrameData(ASLIndividualManager* IndividualManager,
+	FSLVizEpisodeHandleTable& HandleTable,
+	const TMap<FString, FTransform>& InMongoFrameData,
+	FSLVizEpisodeFrameData& OutFrameData)
+{
+	bool bAllFound = true;
+	for (const auto& IndividualPosePair : InMongoFrameData)
+	{
+		const int32 Handle = GetOrAddHandle(IndividualManager, IndividualPosePair.Key, HandleTable);
+		if (Handle != INDEX_NONE)
+		{
+			HandleTable.AddPose(Handle, IndividualPosePair.Value, OutFrameData);
+		}
+		else
+		{
+			bAllFound = false;
+		}
+	}
+	return bAllFound;
+}
+
+// Get the handle of the individual, resolve and classify it on the first call (INDEX_NONE if it is unknown or not replayable)
+int32 FSLVizEpisodeUtils::GetOrAddHandle(ASLIndividualManager* IndividualManager, const FString& Id, FSLVizEpisodeHandleTable& HandleTable)
+{
+	if (const int32* Handle = HandleTable.IdToHandle.Find(Id))
+	{
+		return *Handle;
+	}
+
+	auto Individual = IndividualManager->GetIndividual(Id);
+	if (!Individual)
+	{
+		HandleTable.IdToHandle.Add(Id, INDEX_NONE);
+		return INDEX_NONE;
+	}
+
+	ESLVizEpisodeHandleKind Kind = ESLVizEpisodeHandleKind::None;
+	AActor* Actor = nullptr;
+	UPoseableMeshComponent* PMC = nullptr;
+	int32 BoneIndex = INDEX_NONE;
+	if (Individual->IsA(USLRigidIndividual::StaticClass())
+		|| Individual->IsA(USLSkeletalIndividual::StaticClass())
+		|| Individual->IsA(USLVirtualViewIndividual::StaticClass()))
+	{
+		Kind = ESLVizEpisodeHandleKind::Actor;
+		Actor = Individual->GetParentActor();
+	}
+	else if (auto BI = Cast<USLBoneIndividual>(Individual))
+	{
+		Kind = ESLVizEpisodeHandleKind::Bone;
+		PMC = BI->GetPoseableMeshComponent();
+		BoneIndex = BI->GetBoneIndex();
+	}
+	else if (auto VBI = Cast<USLVirtualBoneIndividual>(Individual))
+	{
+		Kind = ESLVizEpisodeHandleKind::VirtualBone;
+		PMC = VBI->GetPoseableMeshComponent();
+		BoneIndex = VBI->GetBoneIndex();
+	}
+
+	const int32 NewHandle = HandleTable.Kinds.Add(Kind);
+	HandleTable.Actors.Add(Actor);
+	HandleTable.PoseableMeshes.Add(PMC);
+	HandleTable.BoneIndexes.Add(BoneIndex);
+	HandleTable.IdToHandle.Add(Id, NewHandle);
+	return NewHandle;
+}
+
 
 // Executes a binary search for element Item in array Array using the <= operator (from ProfilerCommon::FBinaryFindIndex)
 int32 FSLVizEpisodeUtils::BinarySearchLessEqual(const TArray<float>& Array, float Value)
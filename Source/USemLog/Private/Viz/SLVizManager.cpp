@@ -121,7 +121,7 @@ void ASLVizManager::Reset()
 	MarkerManager = nullptr;
 	EpisodeManager = nullptr;
 	bIsInit = false;
-	CachedEpisodeData.Empty();
+	EpisodeCache.Empty();
 }
 
 
@@ -885,7 +885,8 @@ bool ASLVizManager::CacheEpisodeData(const FString& Id, const TArray<TPair<float
 	VizEpisodeData.Id = Id;
 	if (FSLVizEpisodeUtils::BuildEpisodeData(IndividualManager, InMongoEpisodeData, VizEpisodeData))
 	{
-		CachedEpisodeData.Add(Id, VizEpisodeData);
+		EpisodeCache.SetLimits(EpisodeCacheBudgetMB, MaxNumConcurrentEpisodeFetches);
+		EpisodeCache.Add(Id, MoveTemp(VizEpisodeData));
 		return true;
 	}
 	else
@@ -895,6 +896,71 @@ bool ASLVizManager::CacheEpisodeData(const FString& Id, const TArray<TPair<float
 	}
 }
 
+// Cache the episode data and store it in the local episode file
+bool ASLVizManager::CacheEpisodeData(const FString& TaskId, const FString& Id, const FSLVizEpisodeFileFingerprint& Fingerprint,
+	const TArray<TPair<float, TMap<FString, FTransform>>>& InMongoEpisodeData)
+{
+	if (!CacheEpisodeData(Id, InMongoEpisodeData))
+	{
+		return false;
+	}
+	if (Fingerprint.IsValid())
+	{
+		FSLVizEpisodeFile::Write(FSLVizEpisodeFile::GetPath(TaskId, Id), Fingerprint, InMongoEpisodeData);
+	}
+	return true;
+}
+
+// Cache the episode from the local episode file
+bool ASLVizManager::CacheEpisodeDataFromFile(const FString& TaskId, const FString& Id, const FSLVizEpisodeFileFingerprint& Fingerprint)
+{
+	if (!bIsInit)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d %s is not initialized, call init first.."), *FString(__FUNCTION__), __LINE__, *GetName());
+		return false;
+	}
+	if (IsEpisodeCached(Id))
+	{
+		return true;
+	}
+	if (!Fingerprint.IsValid())
+	{
+		return false;
+	}
+
+	FSLVizEpisodeHandleTable HandleTable;
+	FSLVizEpisodeUtils::BuildHandleTable(IndividualManager, HandleTable);
+
+	FSLVizEpisodeData VizEpisodeData;
+	VizEpisodeData.Id = Id;
+	if (FSLVizEpisodeFile::Read(FSLVizEpisodeFile::GetPath(TaskId, Id), Fingerprint, HandleTable, VizEpisodeData))
+	{
+		EpisodeCache.SetLimits(EpisodeCacheBudgetMB, MaxNumConcurrentEpisodeFetches);
+		EpisodeCache.Add(Id, MoveTemp(VizEpisodeData));
+		return true;
+	}
+	return false;
+}
+
+// Fetch and cache the episodes in the background
+bool ASLVizManager::CacheEpisodesAsync(const FString& ServerIp, uint16 ServerPort, const FString& TaskId, const TArray<FString>& EpisodeIds,
+	FSLVizEpisodeCachedCallback OnCached)
+{
+	if (!bIsInit)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d %s is not initialized, call init first.."), *FString(__FUNCTION__), __LINE__, *GetName());
+		return false;
+	}
+
+	// The individuals can only be accessed from the game thread, the workers use the resolved handles
+	TSharedRef<FSLVizEpisodeHandleTable, ESPMode::ThreadSafe> HandleTable = MakeShareable(new FSLVizEpisodeHandleTable());
+	FSLVizEpisodeUtils::BuildHandleTable(IndividualManager, *HandleTable);
+
+	EpisodeCache.SetLimits(EpisodeCacheBudgetMB, MaxNumConcurrentEpisodeFetches);
+	EpisodeCache.FetchAsync(ServerIp, ServerPort, TaskId, EpisodeIds, HandleTable, OnCached);
+	return true;
+}
+
 // Load cached episode data
 bool ASLVizManager::LoadCachedEpisodeData(const FString& Id)
 {
@@ -914,7 +980,7 @@ bool ASLVizManager::LoadCachedEpisodeData(const FString& Id)
 		return false;
 	}
 	
-	EpisodeManager->LoadEpisode(CachedEpisodeData[Id]);
+	EpisodeManager->LoadEpisode(*EpisodeCache.Get(Id));
 	return true;
 }
 
@@ -931,9 +997,10 @@ bool ASLVizManager::ReplayCachedEpisode(const FString& Id, const FSLVizEpisodePl
 		UE_LOG(LogTemp, Warning, TEXT("%s::%d %s episode (%s) is not cached.."), *FString(__FUNCTION__), __LINE__, *GetName(), *Id);
 		return false;
 	}
+	const FSLVizEpisodeData* CachedEpisode = EpisodeCache.Get(Id);
 	if (!EpisodeManager->GetEpisodeId().Equals(Id))
 	{
-		EpisodeManager->LoadEpisode(CachedEpisodeData[Id]);
+		EpisodeManager->LoadEpisode(*CachedEpisode);
 	}
 
 	return EpisodeManager->Play(Params);
@@ -952,14 +1019,26 @@ bool ASLVizManager::GotoCachedEpisodeFrame(const FString& Id, float Ts)
 		UE_LOG(LogTemp, Warning, TEXT("%s::%d %s episode (%s) is not cached.."), *FString(__FUNCTION__), __LINE__, *GetName(), *Id);
 		return false;
 	}
+	const FSLVizEpisodeData* CachedEpisode = EpisodeCache.Get(Id);
 	if (!EpisodeManager->GetEpisodeId().Equals(Id))
 	{
-		EpisodeManager->LoadEpisode(CachedEpisodeData[Id]);
+		EpisodeManager->LoadEpisode(*CachedEpisode);
 	}
 
 	return EpisodeManager->GotoFrame(Ts);
 }
 
+// Replay the frames from the episode streamer (no caching needed)
+bool ASLVizManager::ReplayEpisodeStream(TSharedPtr<FSLMongoEpisodeStreamer> EpisodeStreamer, const FSLVizEpisodePlayParams& Params)
+{
+	if (!bIsInit)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d %s is not initialized, call init first.."), *FString(__FUNCTION__), __LINE__, *GetName());
+		return false;
+	}
+	return EpisodeManager->PlayStream(EpisodeStreamer, IndividualManager, Params);
+}
+
 // Change the data into an episode format and load it to the episode replay manager
 void ASLVizManager::LoadEpisodeData(const TArray<TPair<float, TMap<FString, FTransform>>>& InMongoEpisodeData)
 {
@@ -13,6 +13,9 @@ ASLVizMarkerManager::ASLVizMarkerManager()
 	// Add a default root component to have the markers attached to something
 	// commented out since it is not being attached ATM
 	//RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("ManagerRootComponent"));
+
+	SkeletalMaxNumKeyPoses = INDEX_NONE;
+	SkeletalKeyPoseTolerance = -1.f;
 }
 
 // Called when actor removed from game or game ended
@@ -20,6 +23,7 @@ void ASLVizMarkerManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
 	Super::EndPlay(EndPlayReason);
 	ClearAllMarkers();
+	PoseableMeshPool.Empty();
 }
 
 // Clear marker
@@ -149,7 +153,7 @@ USLVizPrimitiveMarker* ASLVizMarkerManager::CreatePrimitiveMarkerTimeline(const
 USLVizSkeletalMeshMarker* ASLVizMarkerManager::CreateSkeletalMarker(const TPair<FTransform, TMap<int32, FTransform>>& SkeletalPose,
 	USkeletalMesh* SkelMesh)
 {
-	auto Marker = CreateAndAddNewMarker<USLVizSkeletalMeshMarker>(this);
+	auto Marker = CreateAndAddNewSkeletalMarker();
 	Marker->SetVisual(SkelMesh);
 	Marker->AddInstance(SkeletalPose);
 	return Marker;
@@ -159,7 +163,7 @@ USLVizSkeletalMeshMarker* ASLVizMarkerManager::CreateSkeletalMarker(const TPair<
 USLVizSkeletalMeshMarker* ASLVizMarkerManager::CreateSkeletalMarker(const TPair<FTransform, TMap<int32, FTransform>>& SkeletalPose,
 	USkeletalMesh* SkelMesh, const FLinearColor& InColor, ESLVizMaterialType MaterialType)
 {
-	auto Marker = CreateAndAddNewMarker<USLVizSkeletalMeshMarker>(this);
+	auto Marker = CreateAndAddNewSkeletalMarker();
 	Marker->SetVisual(SkelMesh, InColor, MaterialType);
 	Marker->AddInstance(SkeletalPose);
 	return Marker;
@@ -169,7 +173,7 @@ USLVizSkeletalMeshMarker* ASLVizMarkerManager::CreateSkeletalMarker(const TPair<
 USLVizSkeletalMeshMarker* ASLVizMarkerManager::CreateSkeletalMarker(const TArray<TPair<FTransform, TMap<int32, FTransform>>>& SkeletalPoses,
 	USkeletalMesh* SkelMesh)
 {
-	auto Marker = CreateAndAddNewMarker<USLVizSkeletalMeshMarker>(this);
+	auto Marker = CreateAndAddNewSkeletalMarker();
 	Marker->SetVisual(SkelMesh);
 	Marker->AddInstances(SkeletalPoses);
 	return Marker;
@@ -179,7 +183,7 @@ USLVizSkeletalMeshMarker* ASLVizMarkerManager::CreateSkeletalMarker(const TArray
 USLVizSkeletalMeshMarker* ASLVizMarkerManager::CreateSkeletalMarker(const TArray<TPair<FTransform, TMap<int32, FTransform>>>& SkeletalPoses,
 	USkeletalMesh* SkelMesh, const FLinearColor& InColor,ESLVizMaterialType MaterialType)
 {
-	auto Marker = CreateAndAddNewMarker<USLVizSkeletalMeshMarker>(this);
+	auto Marker = CreateAndAddNewSkeletalMarker();
 
 	Marker->SetVisual(SkelMesh, InColor, MaterialType);
 	Marker->AddInstances(SkeletalPoses);
@@ -189,7 +193,7 @@ USLVizSkeletalMeshMarker* ASLVizMarkerManager::CreateSkeletalMarker(const TArray
 // Create a skeletal mesh based timeline marker at the given poses (use original material)
 USLVizSkeletalMeshMarker* ASLVizMarkerManager::CreateSkeletalMarkerTimeline(const TArray<TPair<FTransform, TMap<int32, FTransform>>>& SkeletalPoses, USkeletalMesh* SkelMesh, const FSLVizTimelineParams& TimelineParams)
 {
-	auto Marker = CreateAndAddNewMarker<USLVizSkeletalMeshMarker>(this);
+	auto Marker = CreateAndAddNewSkeletalMarker();
 	Marker->SetVisual(SkelMesh);
 	Marker->AddInstances(SkeletalPoses, TimelineParams);
 	return Marker;
@@ -201,7 +205,7 @@ USLVizSkeletalMeshMarker* ASLVizMarkerManager::CreateSkeletalMarkerTimeline(cons
 	const FLinearColor& InColor, ESLVizMaterialType MaterialType,
 	const FSLVizTimelineParams& TimelineParams)
 {
-	auto Marker = CreateAndAddNewMarker<USLVizSkeletalMeshMarker>(this);
+	auto Marker = CreateAndAddNewSkeletalMarker();
 	Marker->SetVisual(SkelMesh, InColor, MaterialType);
 	Marker->AddInstances(SkeletalPoses, TimelineParams);
 	return Marker;
@@ -243,3 +247,11 @@ USLVizSkeletalMeshMarker* ASLVizMarkerManager::CreateSkeletalBoneMarker(const TA
 	return nullptr;
 }
 
+// Create a skeletal marker using the shared poseable mesh pool and the key pose parameters
+USLVizSkeletalMeshMarker* ASLVizMarkerManager::CreateAndAddNewSkeletalMarker()
+{
+	auto Marker = CreateAndAddNewMarker<USLVizSkeletalMeshMarker>(this);
+	Marker->SetPoseableMeshPool(&PoseableMeshPool);
+	Marker->SetKeyPoseParams(SkeletalMaxNumKeyPoses, SkeletalKeyPoseTolerance);
+	return Marker;
+}
@@ -13,6 +13,28 @@ void USLVizQCacheEpisodes::ExecuteImpl(ASLKnowrobManager* KRManager)
 	ASLVizManager* VizManager = KRManager->GetVizManager();
 	ASLMongoQueryManager* MongoQueryManager = KRManager->GetMongoQueryManager();
 
+	if (bAsync)
+	{
+		const FString TaskId = Task;
+		UE_LOG(LogTemp, Log, TEXT("%s::%d Collecting %d episodes of %s in the background .."),
+			*FString(__FUNCTION__), __LINE__, Episodes.Num(), *Task);
+		VizManager->CacheEpisodesAsync(MongoQueryManager->GetServerIp(), MongoQueryManager->GetServerPort(), Task, Episodes,
+			[TaskId](const FString& EpisodeId, bool bSuccess)
+			{
+				if (bSuccess)
+				{
+					UE_LOG(LogTemp, Log, TEXT("%s::%d Episode %s::%s is cached .."),
+						*FString(__FUNCTION__), __LINE__, *TaskId, *EpisodeId);
+				}
+				else
+				{
+					UE_LOG(LogTemp, Error, TEXT("%s::%d Could not cache episode %s::%s .."),
+						*FString(__FUNCTION__), __LINE__, *TaskId, *EpisodeId);
+				}
+			});
+		return;
+	}
+
 	for (const auto& Episode : Episodes)
 	{
 		if (!VizManager->IsEpisodeCached(Episode))
@@ -20,8 +42,15 @@ void USLVizQCacheEpisodes::ExecuteImpl(ASLKnowrobManager* KRManager)
 			UE_LOG(LogTemp, Log, TEXT("%s::%d Collecting episode %s::%s .."),
 				*FString(__FUNCTION__), __LINE__, *Task, *Episode);
 
-			auto EpisodeData = MongoQueryManager->GetEpisodeData(Task, Episode);
-			if (!VizManager->CacheEpisodeData(Episode, EpisodeData))
+			// Prefer the local episode file if the episode did not change since it was written
+			FSLVizEpisodeFileFingerprint Fingerprint;
+			MongoQueryManager->GetEpisodeFingerprint(Task, Episode, Fingerprint.NumDocs, Fingerprint.LastTs);
+			if (VizManager->CacheEpisodeDataFromFile(Task, Episode, Fingerprint))
+			{
+				UE_LOG(LogTemp, Log, TEXT("%s::%d Episode %s::%s loaded from the local episode file .."),
+					*FString(__FUNCTION__), __LINE__, *Task, *Episode);
+			}
+			else if (!VizManager->CacheEpisodeData(Task, Episode, Fingerprint, MongoQueryManager->GetEpisodeData(Task, Episode)))
 			{
 				UE_LOG(LogTemp, Error, TEXT("%s::%d Could not cache episode %s::%s, execution aborted .."),
 					*FString(__FUNCTION__), __LINE__, *Task, *Episode);
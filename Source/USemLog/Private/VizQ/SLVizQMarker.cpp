@@ -130,7 +130,7 @@ void USLVizQMarker::ExecuteImpl(ASLKnowrobManager* KRManager)
 		else if (EndTime > 0 && EndTime > StartTime)
 		{			
 			SkeletalPoses = MongoQueryManager->GetSkeletalIndividualTrajectory(Task, Episode, Individual,
-				StartTime, EndTime, DeltaT);
+				StartTime, EndTime, DeltaT, BoneIndexes);
 		}
 		else
 		{
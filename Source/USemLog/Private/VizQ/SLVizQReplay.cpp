@@ -50,13 +50,33 @@ void USLVizQReplay::ExecuteImpl(ASLKnowrobManager* KRManager)
 	ASLVizManager* VizManager = KRManager->GetVizManager();
 	ASLMongoQueryManager* MongoQueryManager = KRManager->GetMongoQueryManager();
 
+	// Stream the frames while replaying
+	if (bStream && Type == ESLVizQReplayType::Replay)
+	{
+		FSLVizEpisodePlayParams Params;
+		Params.StartTime = StartTime;
+		Params.EndTime = EndTime;
+		Params.bLoop = bLoop;
+		Params.UpdateRate = UpdateRate;
+		Params.StepSize = StepSize;
+		VizManager->ReplayEpisodeStream(MongoQueryManager->GetEpisodeDataAsync(Task, Episode, StartTime, EndTime), Params);
+		return;
+	}
+
 	// Retrieve and cache episode
 	if (!VizManager->IsEpisodeCached(Episode))
 	{
 		UE_LOG(LogTemp, Log, TEXT("%s::%d Collecting episode %s::%s .."),
 			*FString(__FUNCTION__), __LINE__, *Task, *Episode);
-		auto EpisodeData = MongoQueryManager->GetEpisodeData(Task, Episode);
-		if (!VizManager->CacheEpisodeData(Episode, EpisodeData))
+		// Prefer the local episode file if the episode did not change since it was written
+		FSLVizEpisodeFileFingerprint Fingerprint;
+		MongoQueryManager->GetEpisodeFingerprint(Task, Episode, Fingerprint.NumDocs, Fingerprint.LastTs);
+		if (VizManager->CacheEpisodeDataFromFile(Task, Episode, Fingerprint))
+		{
+			UE_LOG(LogTemp, Log, TEXT("%s::%d Episode %s::%s loaded from the local episode file .."),
+				*FString(__FUNCTION__), __LINE__, *Task, *Episode);
+		}
+		else if (!VizManager->CacheEpisodeData(Task, Episode, Fingerprint, MongoQueryManager->GetEpisodeData(Task, Episode)))
 		{
 			UE_LOG(LogTemp, Error, TEXT("%s::%d Could not cache episode %s::%s, execution aborted .."),
 				*FString(__FUNCTION__), __LINE__, *Task, *Episode);